@@ -22,8 +22,12 @@ namespace llvm
 namespace ctrace::stack::analysis
 {
     class CompilationDatabase;
+    class FrameSizeTable;
     struct GlobalReadBeforeWriteSummaryIndex;
+    struct ModuleStackSummary;
+    struct ResourceLifetimeModuleStates;
     struct ResourceSummaryIndex;
+    struct StackEscapeSummaryIndex;
     struct UninitializedSummaryIndex;
 } // namespace ctrace::stack::analysis
 
@@ -58,20 +62,26 @@ namespace ctrace::stack
 
         std::shared_ptr<const analysis::CompilationDatabase> compilationDatabase;
         std::shared_ptr<const analysis::ResourceSummaryIndex> resourceSummaryIndex;
+        std::shared_ptr<const analysis::ResourceLifetimeModuleStates> resourceLifetimeStates;
         std::shared_ptr<const analysis::UninitializedSummaryIndex> uninitializedSummaryIndex;
         std::shared_ptr<const analysis::GlobalReadBeforeWriteSummaryIndex>
             globalReadBeforeWriteSummaryIndex;
+        std::shared_ptr<const analysis::StackEscapeSummaryIndex> stackEscapeSummaryIndex;
+        std::shared_ptr<const analysis::FrameSizeTable> frameSizeTable; // --mode=abi only
 
         std::vector<std::string> excludeDirs;
         std::vector<std::string> extraCompileArgs;
         std::vector<std::string> onlyDirs;
         std::vector<std::string> onlyFiles;
         std::vector<std::string> onlyFunctions;
+        std::vector<std::string> stackUsagePaths; // .su/.ci files or directories
 
         std::vector<std::string> smtRules;
         std::string compileIRCacheDir;
         std::string smtSecondaryBackend;
         std::string smtBackend = "interval";
+        std::string smtCacheDir;
+        std::string smtCapturePath;
         std::string dumpIRPath;
         std::string escapeModelPath;
         std::string bufferModelPath;
@@ -90,6 +100,7 @@ namespace ctrace::stack
         // Keep flags in one 32-bit storage unit:
         // 4x u8 enums above + this u32 block keeps tail alignment compact on 64-bit builds.
         std::uint32_t compdbFast : 1 = 0;
+        std::uint32_t compilePCH : 1 = 0;
         std::uint32_t demangle : 1 = 0;
         std::uint32_t dumpFilter : 1 = 0;
         std::uint32_t dumpIRIsDir : 1 = 0;
@@ -102,8 +113,12 @@ namespace ctrace::stack
         std::uint32_t uninitializedCrossTU : 1 = 1;
         std::uint32_t resourceCrossTU : 1 = 1;
         std::uint32_t resourceSummaryMemoryOnly : 1 = 0;
+        std::uint32_t stackCrossTU : 1 = 1;
+        std::uint32_t escapeCrossTU : 1 = 1;
+        std::uint32_t stackSummaryExport : 1 = 0; // fill AnalysisResult::stackSummary
+        std::uint32_t stackUsageFromCompdb : 1 = 0;
         std::uint32_t warningsOnly : 1 = 0;
-        std::uint32_t reservedFlags : 18 = 0;
+        std::uint32_t reservedFlags : 13 = 0;
     };
 
     // Per-function result
@@ -280,6 +295,8 @@ namespace ctrace::stack
         // All messages are formatted and then printed in main().
         // std::vector<std::string> diagnostics;
         std::vector<Diagnostic> diagnostics;
+        // Input of the whole-program stack phase; only set with stackSummaryExport.
+        std::shared_ptr<const analysis::ModuleStackSummary> stackSummary;
     };
 
     [[nodiscard]] constexpr DiagnosticSummary
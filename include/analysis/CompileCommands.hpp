@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -14,13 +16,30 @@ namespace ctrace::stack::analysis
         std::vector<std::string> arguments;
     };
 
+    // Describes how raw database entries were collapsed to one command per source file.
+    struct CompilationDatabaseStats
+    {
+        // Sources listed with analysis-relevant flags (defines, include paths, language
+        // standard, target) that differ between entries. Sorted.
+        std::vector<std::string> divergentSources;
+        std::size_t entryCount = 0;
+        std::size_t collapsedEntryCount = 0;
+    };
+
     class CompilationDatabase
     {
       public:
-        static std::shared_ptr<CompilationDatabase> loadFromFile(const std::string& path,
-                                                                 std::string& error);
+        CompilationDatabase() = default;
+        CompilationDatabase(const CompilationDatabase&) = delete;
+        CompilationDatabase& operator=(const CompilationDatabase&) = delete;
+
+        // Large databases are parsed on up to maxJobs threads.
+        static std::shared_ptr<CompilationDatabase>
+        loadFromFile(const std::string& path, std::string& error, unsigned maxJobs = 1);
 
         const CompileCommand* findCommandForFile(const std::string& filePath) const;
+        // Only the entry whose canonical path is `filePath`'s; no suffix fallback.
+        const CompileCommand* findExactCommandForFile(const std::string& filePath) const;
         std::vector<std::string> listSourceFiles() const;
 
         const std::string& sourcePath() const
@@ -28,8 +47,28 @@ namespace ctrace::stack::analysis
             return sourcePath_;
         }
 
+        const CompilationDatabaseStats& stats() const
+        {
+            return stats_;
+        }
+
       private:
+        // Node of a trie over reversed path components ("a.c" -> "src" -> "proj").
+        // Each node records how many database entries end with the suffix it spells,
+        // so a fallback lookup walks at most one node per component of the query.
+        struct SuffixNode
+        {
+            std::unordered_map<std::string, std::uint32_t> children;
+            const CompileCommand* command = nullptr;
+            std::uint32_t entryCount = 0;
+            std::uint32_t reserved = 0;
+        };
+
+        void buildSuffixIndex();
+
         std::string sourcePath_;
+        CompilationDatabaseStats stats_;
         std::unordered_map<std::string, CompileCommand> commands_;
+        std::vector<SuffixNode> suffixNodes_;
     };
 } // namespace ctrace::stack::analysis
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+
+namespace llvm
+{
+    class BasicBlock;
+    class Function;
+} // namespace llvm
+
+namespace ctrace::stack::analysis
+{
+    // Reachable blocks of a function numbered in reverse post-order, with
+    // predecessor and successor lists restricted to reachable blocks. Index 0
+    // is the entry block. Forward dataflow analyses keep their per-block
+    // states in vectors indexed by this numbering and drive them with
+    // runForward().
+    class ForwardDataflowOrder
+    {
+      public:
+        static constexpr std::uint32_t kUnreachable = std::numeric_limits<std::uint32_t>::max();
+
+        explicit ForwardDataflowOrder(const llvm::Function& F);
+
+        std::uint32_t size() const
+        {
+            return static_cast<std::uint32_t>(blocks.size());
+        }
+
+        const llvm::BasicBlock* block(std::uint32_t idx) const
+        {
+            return blocks[idx];
+        }
+
+        std::uint32_t indexOf(const llvm::BasicBlock* BB) const
+        {
+            const auto it = indexByBlock.find(BB);
+            return it == indexByBlock.end() ? kUnreachable : it->second;
+        }
+
+        const std::vector<std::uint32_t>& predecessors(std::uint32_t idx) const
+        {
+            return preds[idx];
+        }
+
+        const std::vector<std::uint32_t>& successors(std::uint32_t idx) const
+        {
+            return succs[idx];
+        }
+
+        // Block visits runForward() needs for a monotone analysis whose
+        // per-block out-state can change at most latticeHeight times: besides
+        // its first visit, a block is only re-queued by a predecessor's change.
+        std::uint64_t visitBudget(std::uint64_t latticeHeight) const
+        {
+            std::uint64_t edges = 0;
+            for (const std::vector<std::uint32_t>& blockSuccs : succs)
+                edges += blockSuccs.size();
+            return (size() + edges) * std::max<std::uint64_t>(1, latticeHeight);
+        }
+
+        // Worklist iteration in ascending RPO: every block starts dirty, and
+        // visit(idx) returns true when the block's out-state changed, which
+        // re-queues its successors. Forward edges are picked up in the same
+        // sweep, back edges in the next one. Returns false if maxVisits block
+        // visits were spent before reaching a fixpoint.
+        template <typename VisitFn> bool runForward(VisitFn&& visit, std::uint64_t maxVisits) const
+        {
+            llvm::BitVector pending(size(), true);
+            std::uint64_t visits = 0;
+            while (pending.any())
+            {
+                for (int idx = pending.find_first(); idx != -1; idx = pending.find_next(idx))
+                {
+                    if (visits++ >= maxVisits)
+                        return false;
+                    pending.reset(static_cast<unsigned>(idx));
+                    if (!visit(static_cast<std::uint32_t>(idx)))
+                        continue;
+                    for (const std::uint32_t succ : succs[static_cast<std::uint32_t>(idx)])
+                        pending.set(succ);
+                }
+            }
+            return true;
+        }
+
+      private:
+        std::vector<const llvm::BasicBlock*> blocks;
+        llvm::DenseMap<const llvm::BasicBlock*, std::uint32_t> indexByBlock;
+        std::vector<std::vector<std::uint32_t>> preds;
+        std::vector<std::vector<std::uint32_t>> succs;
+    };
+} // namespace ctrace::stack::analysis
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ctrace::stack::analysis
+{
+    // Size and mtime of a file the compile cache depends on.
+    struct FileSnapshot
+    {
+        std::string path;
+        std::uint64_t size = 0;
+        std::int64_t mtimeNs = 0;
+    };
+
+    // Regular files only; anything else yields std::nullopt.
+    std::optional<FileSnapshot> statFileSnapshot(const std::filesystem::path& absolute);
+
+    // Snapshot cache shared by every loader worker. Most dependencies are the
+    // same headers recorded by many TUs, so each absolute path is stat'ed once
+    // per run instead of once per cache lookup. Missing files are cached as
+    // std::nullopt.
+    class FileSnapshotCache
+    {
+      public:
+        std::optional<FileSnapshot> capture(const std::string& absolutePath);
+
+        // Validates all snapshots with one lock acquisition per shard for
+        // cached paths; only uncached paths are stat'ed, outside the locks.
+        bool areCurrent(const std::vector<FileSnapshot>& expected);
+
+        // Re-stats a path the analyzer itself just wrote, replacing any
+        // earlier entry.
+        std::optional<FileSnapshot> refresh(const std::string& absolutePath);
+
+        void clear();
+
+      private:
+        static constexpr std::size_t kShardCount = 16;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::optional<FileSnapshot>> entries;
+        };
+
+        static std::size_t shardIndex(const std::string& path);
+
+        Shard& shardFor(const std::string& path)
+        {
+            return shards_[shardIndex(path)];
+        }
+
+        std::array<Shard, kShardCount> shards_;
+    };
+} // namespace ctrace::stack::analysis
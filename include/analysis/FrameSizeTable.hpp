@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "StackUsageAnalyzer.hpp"
+#include "analysis/StackComputation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm
+{
+    class Function;
+} // namespace llvm
+
+namespace ctrace::stack::analysis
+{
+    struct CompileCommand;
+
+    // One function's frame as the compiler backend reported it.
+    struct FrameSizeEntry
+    {
+        std::string name; // symbol (clang .su, .ci titles) or GCC's printable name
+        std::string file; // source basename; empty when the compiler printed none
+        StackSize bytes = 0;
+        unsigned line = 0;
+        std::uint32_t dynamic : 1 = false; // "dynamic" or "dynamic,bounded"
+        std::uint32_t bounded : 1 = false;
+        std::uint32_t origin : 30 = 0; // index of the .su/.ci file the table read it from
+    };
+
+    // Frame sizes read from -fstack-usage (.su) and GCC -fcallgraph-info (.ci)
+    // files. Used by --mode=abi in place of the IR estimate of
+    // computeLocalStackABI for every function the table knows.
+    class FrameSizeTable
+    {
+      public:
+        // Dispatches on the extension: ".ci" is VCG, anything else .su lines.
+        bool addFile(const std::string& path, std::string& error);
+
+        // Tries the symbol first, then the definition's file:line (GCC .su
+        // lines carry printable C++ names). When a function was compiled in
+        // several translation units, the largest frame wins. Records without
+        // a file are matched to the source through the name of their .su
+        // file; if that fails and several files list the symbol, they may be
+        // different static functions, so none of them is used.
+        const FrameSizeEntry* find(std::string_view symbol, std::string_view sourcePath,
+                                   unsigned line) const;
+
+        std::size_t entryCount() const
+        {
+            return entries_.size();
+        }
+
+        std::size_t fileCount() const
+        {
+            return fileCount_;
+        }
+
+      private:
+        void addEntry(FrameSizeEntry entry);
+
+        std::vector<FrameSizeEntry> entries_;
+        std::unordered_map<std::string, std::vector<std::uint32_t>> byName_;
+        std::unordered_map<std::string, std::vector<std::uint32_t>> byLocation_;
+        std::unordered_map<std::string, std::uint32_t> originByPath_;
+        std::vector<std::string> originStems_; // "a.c" for a.c.su, "a" for a.su
+        std::size_t fileCount_ = 0;
+    };
+
+    // Splits "path:line[:column]:rest". The first ":<digits>:" ends the path,
+    // so Windows drive letters and C++ scopes in `rest` are left alone.
+    // Returns false when the text has no location prefix.
+    bool splitLocation(std::string_view text, std::string_view& file, unsigned& line,
+                       std::string_view& rest);
+
+    // One -fstack-usage line:
+    //   GCC:   "file.c:12:5:name\t48\tstatic"
+    //   clang: "file.c:12:name\t48\tstatic", or "name\t48\tstatic" without debug info.
+    bool parseStackUsageLine(std::string_view text, FrameSizeEntry& entry);
+
+    // One node of a GCC -fcallgraph-info (VCG) file:
+    //   node: { title: "_Z3fooi" label: "foo\nfoo.c:3:5\n48 bytes (static)\n..." }
+    // Only definitions carry a "<n> bytes (<qualifiers>)" label line.
+    bool parseCallGraphInfoNode(std::string_view text, FrameSizeEntry& entry);
+
+    // `path` itself when it is a file, otherwise every .su/.ci file below it.
+    bool collectFrameSizeFiles(const std::string& path, std::vector<std::string>& out,
+                               std::string& error);
+
+    // Where the build wrote .su/.ci files for this command: next to its -o
+    // object, or next to the source stem in the working directory. Only
+    // existing files are returned.
+    std::vector<std::string> frameSizeFilesForCommand(const CompileCommand& command,
+                                                      const std::string& sourceFile);
+
+    // Replaces info's byte count with the measured frame of F, if known.
+    bool applyMeasuredFrameSize(const FrameSizeTable& table, const llvm::Function& F,
+                                LocalStackInfo& info);
+} // namespace ctrace::stack::analysis
@@ -47,6 +47,11 @@ namespace ctrace::stack::analysis
     GlobalReadBeforeWriteSummaryIndex buildGlobalReadBeforeWriteSummaryIndex(
         llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze);
 
+    // Folds one global summary into dst; merging every entry of src in
+    // iteration order is exactly mergeGlobalReadBeforeWriteSummaryIndex(dst, src).
+    bool mergeGlobalReadBeforeWriteSummaryEntry(GlobalReadBeforeWriteSummaryIndex& dst,
+                                                const std::string& name,
+                                                const GlobalReadBeforeWriteGlobalSummary& incoming);
     bool mergeGlobalReadBeforeWriteSummaryIndex(GlobalReadBeforeWriteSummaryIndex& dst,
                                                 const GlobalReadBeforeWriteSummaryIndex& src);
 
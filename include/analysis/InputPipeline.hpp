@@ -30,6 +30,10 @@ namespace ctrace::stack::analysis
 
     LanguageType detectLanguageFromFile(const std::string& path, llvm::LLVMContext& ctx);
 
+    // Drops the process-wide file snapshot cache used to validate compile cache entries.
+    // Snapshots are reused for the duration of a run; call this before starting a new one.
+    void resetFileSnapshotCache();
+
     ModuleLoadResult loadModuleForAnalysis(const std::string& filename,
                                            const AnalysisConfig& config, llvm::LLVMContext& ctx,
                                            llvm::SMDiagnostic& err);
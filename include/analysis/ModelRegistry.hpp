@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace ctrace::stack::analysis
+{
+    struct ModelFileStamp
+    {
+        std::uint64_t size = 0;
+        std::int64_t modifiedTicks = 0;
+        std::uint64_t exists : 1 = false;
+        std::uint64_t reservedFlags : 63 = 0;
+
+        bool operator==(const ModelFileStamp& other) const
+        {
+            return exists == other.exists && size == other.size &&
+                   modifiedTicks == other.modifiedTicks;
+        }
+    };
+
+    ModelFileStamp statModelFile(const std::string& path);
+    std::string hashModelFileContent(const std::string& path);
+
+    // Process-wide cache of parsed model files, one registry per model type.
+    // A path is parsed once and parsed again only when its size or mtime
+    // changes; paths with identical content share one immutable instance,
+    // which is dropped once no path refers to that content any more.
+    // Parse failures are cached with their error until the file changes.
+    template <typename Model> class ModelRegistry
+    {
+      public:
+        using ParseFn = bool (*)(const std::string& path, Model& out, std::string& error);
+
+        static ModelRegistry& instance()
+        {
+            static ModelRegistry registry;
+            return registry;
+        }
+
+        std::shared_ptr<const Model> load(const std::string& path, ParseFn parse,
+                                          std::string& error)
+        {
+            const ModelFileStamp stamp = statModelFile(path);
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto pathIt = byPath_.find(path);
+            if (pathIt != byPath_.end() && pathIt->second.stamp == stamp)
+            {
+                error = pathIt->second.error;
+                return pathIt->second.model;
+            }
+
+            Entry entry;
+            entry.stamp = stamp;
+            const std::string contentHash = stamp.exists ? hashModelFileContent(path) : "";
+            if (!contentHash.empty())
+            {
+                if (const auto it = byContent_.find(contentHash); it != byContent_.end())
+                    entry.model = it->second.model;
+            }
+            if (!entry.model)
+            {
+                auto parsed = std::make_shared<Model>();
+                if (parse(path, *parsed, entry.error))
+                {
+                    entry.model = std::move(parsed);
+                    if (!contentHash.empty())
+                        byContent_.insert_or_assign(contentHash, Content{entry.model, 0});
+                }
+            }
+            if (entry.model && !contentHash.empty())
+            {
+                entry.contentHash = contentHash;
+                ++byContent_[contentHash].pathCount;
+            }
+
+            // Released after the new reference is taken, so a reload with unchanged content
+            // keeps its instance.
+            if (pathIt != byPath_.end())
+                releaseContent(pathIt->second.contentHash);
+
+            error = entry.error;
+            std::shared_ptr<const Model> model = entry.model;
+            byPath_.insert_or_assign(path, std::move(entry));
+            return model;
+        }
+
+        // Distinct parsed contents still referenced by some path.
+        std::size_t contentCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return byContent_.size();
+        }
+
+      private:
+        struct Entry
+        {
+            ModelFileStamp stamp;
+            std::string error;
+            std::string contentHash; // empty when the model is not shared by content
+            std::shared_ptr<const Model> model;
+        };
+
+        struct Content
+        {
+            std::shared_ptr<const Model> model;
+            std::size_t pathCount = 0;
+        };
+
+        void releaseContent(const std::string& contentHash)
+        {
+            if (contentHash.empty())
+                return;
+            const auto it = byContent_.find(contentHash);
+            if (it != byContent_.end() && --it->second.pathCount == 0)
+                byContent_.erase(it);
+        }
+
+        std::mutex mutex_;
+        std::unordered_map<std::string, Entry> byPath_;
+        std::unordered_map<std::string, Content> byContent_;
+    };
+} // namespace ctrace::stack::analysis
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -64,10 +65,31 @@ namespace ctrace::stack::analysis
         ResourceLifetimeIssueKind kind = ResourceLifetimeIssueKind::MissingRelease;
     };
 
+    struct ResourceLifetimeModuleStateOpaque;
+
+    // Converged per-function summaries of one module, captured while building its
+    // summary index. analyzeResourceLifetime() reuses them instead of recomputing
+    // the fixpoint when the module, model path and consumed external summaries
+    // still match; the caller must use the same function filter for both calls.
+    struct ResourceLifetimeModuleState
+    {
+        std::shared_ptr<const ResourceLifetimeModuleStateOpaque> opaque;
+    };
+
+    struct ResourceLifetimeModuleStates
+    {
+        std::unordered_map<const llvm::Module*, ResourceLifetimeModuleState> byModule;
+    };
+
     ResourceSummaryIndex buildResourceLifetimeSummaryIndex(
         llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries = nullptr);
+        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries = nullptr,
+        ResourceLifetimeModuleState* stateOut = nullptr);
 
+    // Folds one function summary into dst; merging every entry of src in
+    // iteration order is exactly mergeResourceSummaryIndex(dst, src).
+    bool mergeResourceSummaryEntry(ResourceSummaryIndex& dst, const std::string& name,
+                                   const ResourceSummaryFunction& incoming);
     bool mergeResourceSummaryIndex(ResourceSummaryIndex& dst, const ResourceSummaryIndex& src);
     bool resourceSummaryIndexEquals(const ResourceSummaryIndex& lhs,
                                     const ResourceSummaryIndex& rhs);
@@ -78,5 +100,6 @@ namespace ctrace::stack::analysis
 
     std::vector<ResourceLifetimeIssue> analyzeResourceLifetime(
         llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries = nullptr);
+        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries = nullptr,
+        const ResourceLifetimeModuleState* reusableState = nullptr);
 } // namespace ctrace::stack::analysis
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "StackUsageAnalyzer.hpp"
@@ -19,6 +20,23 @@ namespace ctrace::stack::analysis
 {
     using CallGraph = std::map<const llvm::Function*, std::vector<const llvm::Function*>>;
 
+    using FunctionId = std::uint32_t;
+
+    // Call graph over dense function ids in CSR form: the callees of
+    // functions[id] are targets[offsets[id]] .. targets[offsets[id + 1] - 1].
+    struct DenseCallGraph
+    {
+        std::vector<const llvm::Function*> functions;
+        std::unordered_map<const llvm::Function*, FunctionId> ids;
+        std::vector<std::uint32_t> offsets{0};
+        std::vector<FunctionId> targets;
+
+        std::size_t size() const
+        {
+            return functions.size();
+        }
+    };
+
     struct StackEstimate
     {
         StackSize bytes = 0;
@@ -44,16 +62,36 @@ namespace ctrace::stack::analysis
 
     CallGraph buildCallGraph(llvm::Module& M);
 
+    // Ids follow `nodes`, then callees reachable from them in discovery order.
+    DenseCallGraph buildDenseCallGraph(const CallGraph& CG,
+                                       const std::vector<const llvm::Function*>& nodes);
+    CallGraph expandCallGraph(const DenseCallGraph& graph);
+
     LocalStackInfo computeLocalStack(llvm::Function& F, const llvm::DataLayout& DL,
                                      AnalysisMode mode);
 
+    // Max stack of every node of a CSR call graph (laid out as in
+    // DenseCallGraph), computed bottom-up over its SCC condensation. A node
+    // outside any cycle needs its frame plus its deepest callee. Every member
+    // of a cycle gets one frame of each member plus the larger of one re-entry
+    // (the largest member frame) and the deepest call leaving the cycle: the
+    // depth of a single unrolling, independent of visit order.
+    std::vector<StackEstimate> propagateMaxStack(const std::vector<std::uint32_t>& offsets,
+                                                 const std::vector<FunctionId>& targets,
+                                                 const std::vector<StackEstimate>& localById);
+
     InternalAnalysisState
     computeGlobalStackUsage(const CallGraph& CG,
                             const std::map<const llvm::Function*, LocalStackInfo>& LocalStack);
+    InternalAnalysisState
+    computeGlobalStackUsage(const DenseCallGraph& graph,
+                            const std::map<const llvm::Function*, LocalStackInfo>& LocalStack);
 
     std::vector<std::vector<const llvm::Function*>>
     computeRecursiveComponents(const CallGraph& CG,
                                const std::vector<const llvm::Function*>& nodes);
+    std::vector<std::vector<const llvm::Function*>>
+    computeRecursiveComponents(const DenseCallGraph& graph);
 
     bool detectInfiniteSelfRecursion(llvm::Function& F);
     bool detectInfiniteSelfRecursion(llvm::Function& F, const AnalysisConfig& config);
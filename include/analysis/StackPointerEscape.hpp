@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace llvm
@@ -14,6 +16,25 @@ namespace llvm
 
 namespace ctrace::stack::analysis
 {
+    enum class StackEscapeArgState : std::uint64_t
+    {
+        Unknown,
+        NoEscape,
+        MayEscape
+    };
+
+    struct StackEscapeSummaryFunction
+    {
+        std::vector<StackEscapeArgState> args;
+    };
+
+    // Per-argument escape states of externally visible functions, keyed by
+    // canonical symbol name, exchanged between translation units.
+    struct StackEscapeSummaryIndex
+    {
+        std::unordered_map<std::string, StackEscapeSummaryFunction> functions;
+    };
+
     struct StackPointerEscapeIssue
     {
         std::string funcName;
@@ -24,8 +45,24 @@ namespace ctrace::stack::analysis
         const llvm::Instruction* inst = nullptr;
     };
 
+    StackEscapeSummaryIndex
+    buildStackEscapeSummaryIndex(llvm::Module& mod,
+                                 const std::function<bool(const llvm::Function&)>& shouldAnalyze,
+                                 const std::string& escapeModelPath = "",
+                                 const StackEscapeSummaryIndex* externalSummaries = nullptr);
+
+    // Joins per argument (NoEscape < Unknown < MayEscape); merging every entry
+    // of src in iteration order is exactly mergeStackEscapeSummaryIndex(dst, src).
+    bool mergeStackEscapeSummaryEntry(StackEscapeSummaryIndex& dst, const std::string& name,
+                                      const StackEscapeSummaryFunction& incoming);
+    bool mergeStackEscapeSummaryIndex(StackEscapeSummaryIndex& dst,
+                                      const StackEscapeSummaryIndex& src);
+    bool stackEscapeSummaryIndexEquals(const StackEscapeSummaryIndex& lhs,
+                                       const StackEscapeSummaryIndex& rhs);
+
     std::vector<StackPointerEscapeIssue>
     analyzeStackPointerEscapes(llvm::Module& mod,
                                const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-                               const std::string& escapeModelPath = "");
+                               const std::string& escapeModelPath = "",
+                               const StackEscapeSummaryIndex* externalSummaries = nullptr);
 } // namespace ctrace::stack::analysis
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "StackUsageAnalyzer.hpp"
+#include "analysis/StackComputation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+    class Function;
+} // namespace llvm
+
+namespace ctrace::stack::analysis
+{
+    struct StackSummaryFunction
+    {
+        std::string name;     // symbol name, as in FunctionResult::name
+        std::string linkName; // canonical name other modules call it by; empty if not exported
+        std::vector<std::uint32_t> localCallees;  // indices into ModuleStackSummary::functions
+        std::vector<std::string> externalCallees; // canonical names of callees declared only
+        StackSize localStack = 0;
+        StackSize maxStack = 0; // through callees defined in the same module
+        unsigned line = 0;
+        unsigned column = 0;
+        std::uint64_t localStackUnknown : 1 = false;
+        std::uint64_t maxStackUnknown : 1 = false;
+        std::uint64_t reservedFlags : 62 = 0;
+    };
+
+    // What one module contributes to the whole-program stack phase. It holds
+    // no IR references, so the module can be released once it is built.
+    struct ModuleStackSummary
+    {
+        std::vector<StackSummaryFunction> functions;
+    };
+
+    ModuleStackSummary
+    buildModuleStackSummary(const std::vector<llvm::Function*>& definedFunctions,
+                            const std::map<const llvm::Function*, LocalStackInfo>& localStack,
+                            const InternalAnalysisState& state);
+
+    // Module summaries linked by name into one call graph. Function `j` of
+    // modules[i] has global id moduleBase[i] + j; totals are indexed by it.
+    struct WholeProgramStack
+    {
+        std::vector<std::shared_ptr<const ModuleStackSummary>> modules;
+        std::vector<std::uint32_t> moduleBase;
+        std::vector<std::uint32_t> offsets{0};
+        std::vector<FunctionId> targets;
+        std::vector<StackEstimate> totals;
+        std::size_t resolvedExternalCalls = 0;
+        std::size_t unresolvedExternalCalls = 0;
+    };
+
+    // External callees resolve to the first exported definition in module
+    // order; calls nothing defines (libc, assembly) add no stack, as within
+    // a module.
+    WholeProgramStack
+    linkWholeProgramStack(std::vector<std::shared_ptr<const ModuleStackSummary>> modules);
+
+    // Deepest call chain from `id`, as "f -> g -> h" (see buildMaxStackCallPath).
+    std::string wholeProgramCallPath(const WholeProgramStack& program, FunctionId id);
+} // namespace ctrace::stack::analysis
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ctrace::stack::analysis
+{
+    // Tarjan's strongly connected components over nodes 0..count-1, walked
+    // with an explicit frame stack so deep call chains and long CFGs cannot
+    // exhaust the analyzer's own stack. successorsOf(v) returns a reference
+    // to, or a view of, v's successor ids; nodes for which skip(v) holds are
+    // neither roots nor edge targets. emit(members) receives every component
+    // successors first (callees before callers, loop exits before loop
+    // bodies), members in Tarjan's pop order. The span is only valid during
+    // the call.
+    template <typename SuccessorsFn, typename SkipFn, typename EmitFn>
+    void forEachStronglyConnectedComponent(std::uint32_t count, SuccessorsFn&& successorsOf,
+                                           SkipFn&& skip, EmitFn&& emit)
+    {
+        using Range = decltype(successorsOf(std::uint32_t{}));
+        using Iterator = decltype(std::begin(std::declval<Range&>()));
+        constexpr std::uint32_t kUnvisited = std::numeric_limits<std::uint32_t>::max();
+
+        // A node's lowlink is only read while it is on the frame stack, so
+        // it lives in the frame rather than in a per-node array.
+        struct Frame
+        {
+            Iterator next;
+            Iterator end;
+            std::uint32_t node;
+            std::uint32_t lowlink;
+        };
+
+        std::vector<std::uint32_t> index(count, kUnvisited);
+        std::vector<char> onStack(count, 0);
+        std::vector<std::uint32_t> stack;
+        std::vector<std::uint32_t> component;
+        std::vector<Frame> frames;
+        std::uint32_t nextIndex = 0;
+
+        auto enter = [&](std::uint32_t v)
+        {
+            index[v] = nextIndex;
+            stack.push_back(v);
+            onStack[v] = 1;
+            auto&& successors = successorsOf(v);
+            frames.push_back(Frame{std::begin(successors), std::end(successors), v, nextIndex});
+            ++nextIndex;
+        };
+
+        for (std::uint32_t root = 0; root < count; ++root)
+        {
+            if (skip(root) || index[root] != kUnvisited)
+                continue;
+            enter(root);
+
+            while (!frames.empty())
+            {
+                Frame& top = frames.back();
+                if (top.next != top.end)
+                {
+                    const auto w = static_cast<std::uint32_t>(*top.next);
+                    ++top.next;
+                    if (skip(w))
+                        continue;
+                    if (index[w] == kUnvisited)
+                        enter(w);
+                    else if (onStack[w])
+                        top.lowlink = std::min(top.lowlink, index[w]);
+                    continue;
+                }
+
+                const std::uint32_t v = top.node;
+                const std::uint32_t lowlink = top.lowlink;
+                frames.pop_back();
+                if (!frames.empty())
+                    frames.back().lowlink = std::min(frames.back().lowlink, lowlink);
+                if (lowlink != index[v])
+                    continue;
+
+                component.clear();
+                std::uint32_t w = 0;
+                do
+                {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    component.push_back(w);
+                } while (w != v);
+                emit(std::span<const std::uint32_t>(component));
+            }
+        }
+    }
+
+    template <typename SuccessorsFn, typename EmitFn>
+    void forEachStronglyConnectedComponent(std::uint32_t count, SuccessorsFn&& successorsOf,
+                                           EmitFn&& emit)
+    {
+        forEachStronglyConnectedComponent(
+            count, std::forward<SuccessorsFn>(successorsOf), [](std::uint32_t) { return false; },
+            std::forward<EmitFn>(emit));
+    }
+} // namespace ctrace::stack::analysis
@@ -103,6 +103,10 @@ namespace ctrace::stack::analysis
                                    const PreparedUninitializedModuleContext* preparedModule,
                                    const PreparedUninitializedExternalSummaries* preparedExternal);
 
+    // Folds one function summary into dst; merging every entry of src in
+    // iteration order is exactly mergeUninitializedSummaryIndex(dst, src).
+    bool mergeUninitializedSummaryEntry(UninitializedSummaryIndex& dst, const std::string& name,
+                                        const UninitializedSummaryFunction& incoming);
     bool mergeUninitializedSummaryIndex(UninitializedSummaryIndex& dst,
                                         const UninitializedSummaryIndex& src);
 
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "analysis/smt/ConstraintIR.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace ctrace::stack::analysis::smt
+{
+    enum class PresolveOutcome : std::uint64_t
+    {
+        Sat,
+        Unsat,
+        Residual
+    };
+
+    struct PresolveResult
+    {
+        // Simplified, hash-consed IR equivalent to the input for every
+        // backend. Only set for Residual; when it is empty the input could not
+        // be simplified (or is malformed) and must be dispatched unchanged.
+        std::optional<ConstraintIR> residual;
+        PresolveOutcome outcome = PresolveOutcome::Residual;
+    };
+
+    // Decides the queries that do not need a solver and shrinks the others.
+    //
+    // Nodes are hash-consed and folded with the exact bit-vector semantics of
+    // the Z3 backend (constant operands, `Ite` over a constant condition,
+    // reflexive comparisons, boolean identities). Signed bounds are then
+    // propagated through Add/Sub/ZExt/SExt/Trunc, seeded by the assertions
+    // that compare a term with a constant: an empty range or an assertion
+    // refuted by the bounds makes the query Unsat. Sat is only reported when
+    // every assertion folds to true, so no backend could answer otherwise.
+    PresolveResult presolveConstraints(const ConstraintIR& ir);
+
+    struct PresolveStats
+    {
+        std::uint64_t queries = 0;
+        std::uint64_t decidedSat = 0;
+        std::uint64_t decidedUnsat = 0;
+        std::uint64_t residualInputNodes = 0;
+        std::uint64_t residualNodes = 0;
+    };
+
+    // Process-wide counters of presolveConstraints() calls.
+    PresolveStats presolveStats();
+} // namespace ctrace::stack::analysis::smt
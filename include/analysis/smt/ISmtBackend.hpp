@@ -3,15 +3,71 @@
 
 #include "analysis/smt/SolverTypes.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace ctrace::stack::analysis::smt
 {
+    // Cooperative cancellation shared by the backends racing on one query.
+    // Backends poll requested() between steps; a backend blocked in a solver
+    // call registers an interrupt hook for the duration of that call.
+    class SmtCancellation
+    {
+      public:
+        bool requested() const
+        {
+            return flag.load(std::memory_order_acquire);
+        }
+
+        void request()
+        {
+            flag.store(true, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (interrupt)
+                interrupt();
+        }
+
+        // Returns false (and keeps no hook) if cancellation was already requested.
+        bool setInterrupt(std::function<void()> hook)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (requested())
+                return false;
+            interrupt = std::move(hook);
+            return true;
+        }
+
+        void clearInterrupt()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            interrupt = nullptr;
+        }
+
+      private:
+        std::mutex mutex;
+        std::function<void()> interrupt;
+        std::atomic<bool> flag{false};
+        std::uint8_t reservedPadding[7] = {};
+    };
+
     class ISmtBackend
     {
       public:
         virtual ~ISmtBackend() = default;
         virtual std::string name() const = 0;
-        virtual SmtAnswer solve(const SmtQuery& query) const = 0;
+        // False for over-approximating backends whose Sat only means "not
+        // refuted"; such answers never end a portfolio race early, and such
+        // backends are never cancelled by one.
+        virtual bool reportsExactSat() const
+        {
+            return true;
+        }
+        // `cancellation` is null when the backend runs alone or cannot be
+        // cancelled.
+        virtual SmtAnswer solve(const SmtQuery& query, SmtCancellation* cancellation) const = 0;
     };
 } // namespace ctrace::stack::analysis::smt
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "analysis/smt/SolverTypes.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ctrace::stack::analysis::smt
+{
+    // One solver query as the analyzer issued it, with the decision it got
+    // and how long that took (cache lookup included).
+    struct SmtCaptureRecord
+    {
+        SmtQuery query;
+        std::uint64_t elapsedMicros = 0;
+        SmtStatus status = SmtStatus::Unknown;
+    };
+
+    std::string_view smtStatusName(SmtStatus status);
+    std::optional<SmtStatus> parseSmtStatusName(std::string_view name);
+
+    // Capture files start with kSmtCaptureSchema on its own line, followed by
+    // one line per record. Strings are length-prefixed, so symbol names and
+    // rule ids need no escaping.
+    inline constexpr const char* kSmtCaptureSchema = "ctrace-smt-capture-v1";
+
+    std::string serializeSmtCaptureRecord(const SmtQuery& query, SmtStatus status,
+                                          std::uint64_t elapsedMicros);
+    bool readSmtCaptureFile(const std::string& path, std::vector<SmtCaptureRecord>& out,
+                            std::string& error);
+
+    // Process-wide sink behind --smt-capture: SmtConstraintEvaluator hands it
+    // every query while a capture file is open.
+    class SmtQueryCapture
+    {
+      public:
+        static SmtQueryCapture& instance();
+
+        bool open(const std::string& path, std::string& error);
+        bool close(std::string& error);
+
+        bool active() const
+        {
+            return isOpen.load(std::memory_order_acquire);
+        }
+
+        void record(const SmtQuery& query, SmtStatus status, std::uint64_t elapsedMicros);
+
+        std::uint64_t recordedCount() const
+        {
+            return recorded.load(std::memory_order_relaxed);
+        }
+
+      private:
+        std::mutex mutex;
+        std::ofstream out;
+        std::string path;
+        std::atomic<std::uint64_t> recorded{0};
+        std::atomic<bool> isOpen{false};
+        std::uint8_t reservedPadding[7] = {};
+    };
+} // namespace ctrace::stack::analysis::smt
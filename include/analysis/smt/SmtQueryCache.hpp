@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "analysis/smt/SolverOrchestrator.hpp"
+#include "analysis/smt/SolverTypes.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ctrace::stack::analysis::smt
+{
+    struct SmtQueryCacheStats
+    {
+        std::uint64_t lookups = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t persistentEntries = 0;
+    };
+
+    // Process-wide memo of definitive (Sat/Unsat) solver decisions.
+    //
+    // Queries are keyed by a canonical form of their ConstraintIR: symbols are
+    // alpha-renamed in first-use order and only nodes reachable from the
+    // assertions are kept, so the same constraint shape over the same bounds
+    // hits the cache whichever function, module or LLVM value produced it. The
+    // solver settings that can change the answer (backends, mode, budgets) are
+    // part of the key. Timeouts and errors are never cached.
+    //
+    // An optional on-disk store keeps the decisions of previous runs. Its file
+    // name carries kPersistentSchema, which must be bumped whenever encoding
+    // or backend semantics change. Runs append their new decisions, so the
+    // file only grows: entries are never evicted, and a flush rewrites it
+    // without duplicated or torn lines once those outnumber the live ones.
+    // Deleting the directory is always safe.
+    class SmtQueryCache
+    {
+      public:
+        static constexpr const char* kPersistentSchema = "smt-query-cache-v1";
+
+        static SmtQueryCache& instance();
+
+        // Digest of the canonical form of `query` solved under `config`.
+        static std::string makeKey(const SmtQuery& query, const SolverOrchestratorConfig& config);
+
+        std::optional<SmtDecision> lookup(const std::string& key);
+        void store(const std::string& key, const SmtDecision& decision);
+
+        // Loads decisions stored by earlier runs under `cacheDir`; later
+        // store() calls are appended to the same file by flushPersistent().
+        bool loadPersistent(const std::string& cacheDir, std::string& error);
+        bool flushPersistent(std::string& error);
+
+        SmtQueryCacheStats stats() const;
+
+      private:
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_map<std::string, SmtStatus> decisions;
+        };
+
+        static constexpr std::size_t kShardCount = 16;
+
+        Shard& shardFor(const std::string& key);
+        // Caller holds persistentMutex.
+        bool compactPersistent(std::string& error);
+
+        std::array<Shard, kShardCount> shards;
+        std::mutex persistentMutex;
+        std::string persistentPath;
+        std::vector<std::pair<std::string, SmtStatus>> pendingPersistent;
+        std::uint64_t persistentWastedLines = 0;
+        std::atomic<std::uint64_t> lookupCount{0};
+        std::atomic<std::uint64_t> hitCount{0};
+        std::atomic<std::uint64_t> persistentCount{0};
+    };
+} // namespace ctrace::stack::analysis::smt
@@ -3,14 +3,18 @@
 
 #include "StackUsageAnalyzer.hpp"
 #include "analysis/smt/ConstraintIR.hpp"
+#include "analysis/smt/SmtCapture.hpp"
+#include "analysis/smt/SmtQueryCache.hpp"
 #include "analysis/smt/SolverOrchestrator.hpp"
 #include "analysis/smt/TextUtil.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace ctrace::stack::analysis::smt
 {
@@ -46,29 +50,118 @@ namespace ctrace::stack::analysis::smt
         {
             if (smtRuleEnabled(config, ruleId_))
             {
-                orchestrator_.emplace(
+                orchestratorConfig_ =
                     SolverOrchestratorConfig{.primaryBackend = config.smtBackend,
                                              .secondaryBackend = config.smtSecondaryBackend,
                                              .mode = config.smtMode,
                                              .budgetNodes = config.smtBudgetNodes,
-                                             .timeoutMs = config.smtTimeoutMs});
+                                             .timeoutMs = config.smtTimeoutMs,
+                                             .workerThreads = config.jobs};
+                orchestrator_.emplace(orchestratorConfig_);
             }
         }
 
       protected:
+        // False when the rule is not enabled: evaluateQuery() would only
+        // answer Inconclusive, so callers can skip encoding the query.
+        bool solverEnabled() const
+        {
+            return orchestrator_.has_value();
+        }
+
         SmtFeasibility evaluateQuery(ConstraintIR ir) const
         {
             if (!orchestrator_)
                 return SmtFeasibility::Inconclusive;
 
+            SmtQuery query = makeQuery(std::move(ir));
+
+            SmtQueryCapture& capture = SmtQueryCapture::instance();
+            const bool capturing = capture.active();
+            const auto start = capturing ? std::chrono::steady_clock::now()
+                                         : std::chrono::steady_clock::time_point{};
+
+            // Structurally identical queries recur across functions and TUs
+            // (inlined header code), so definitive answers are shared.
+            SmtQueryCache& cache = SmtQueryCache::instance();
+            const std::string cacheKey = SmtQueryCache::makeKey(query, orchestratorConfig_);
+            std::optional<SmtDecision> cached = cache.lookup(cacheKey);
+            if (!cached)
+            {
+                cached = orchestrator_->solve(query);
+                cache.store(cacheKey, *cached);
+            }
+
+            const SmtDecision& decision = *cached;
+            if (capturing)
+            {
+                const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+                capture.record(query, decision.status,
+                               static_cast<std::uint64_t>(elapsed.count()));
+            }
+            return toFeasibility(decision.status);
+        }
+
+        // Same answers as evaluateQuery() on each IR, in order. Cache misses
+        // go to the orchestrator as one batch, so backends with per-thread
+        // state encode what the queries of a function share once.
+        std::vector<SmtFeasibility> evaluateQueries(std::vector<ConstraintIR> irs) const
+        {
+            std::vector<SmtFeasibility> out;
+            out.reserve(irs.size());
+            // Captures record per-query latencies, which a batch cannot give.
+            if (!orchestrator_ || SmtQueryCapture::instance().active())
+            {
+                for (ConstraintIR& ir : irs)
+                    out.push_back(evaluateQuery(std::move(ir)));
+                return out;
+            }
+
+            SmtQueryCache& cache = SmtQueryCache::instance();
+            std::vector<SmtQuery> misses;
+            std::vector<std::string> missKeys;
+            std::vector<std::size_t> missSlots;
+            for (ConstraintIR& ir : irs)
+            {
+                SmtQuery query = makeQuery(std::move(ir));
+                std::string cacheKey = SmtQueryCache::makeKey(query, orchestratorConfig_);
+                if (std::optional<SmtDecision> cached = cache.lookup(cacheKey))
+                {
+                    out.push_back(toFeasibility(cached->status));
+                    continue;
+                }
+                missSlots.push_back(out.size());
+                out.push_back(SmtFeasibility::Inconclusive);
+                missKeys.push_back(std::move(cacheKey));
+                misses.push_back(std::move(query));
+            }
+            if (misses.empty())
+                return out;
+
+            const std::vector<SmtDecision> decisions = orchestrator_->solveAll(misses);
+            for (std::size_t i = 0; i < decisions.size(); ++i)
+            {
+                cache.store(missKeys[i], decisions[i]);
+                out[missSlots[i]] = toFeasibility(decisions[i].status);
+            }
+            return out;
+        }
+
+      private:
+        SmtQuery makeQuery(ConstraintIR ir) const
+        {
             SmtQuery query;
             query.ir = std::move(ir);
             query.ruleId = ruleId_;
             query.timeoutMs = timeoutMs_;
             query.budgetNodes = budgetNodes_;
+            return query;
+        }
 
-            const SmtDecision decision = orchestrator_->solve(query);
-            switch (decision.status)
+        static SmtFeasibility toFeasibility(SmtStatus status)
+        {
+            switch (status)
             {
             case SmtStatus::Sat:
                 return SmtFeasibility::Feasible;
@@ -82,8 +175,8 @@ namespace ctrace::stack::analysis::smt
             return SmtFeasibility::Inconclusive;
         }
 
-      private:
         std::string ruleId_;
+        SolverOrchestratorConfig orchestratorConfig_;
         std::optional<SolverOrchestrator> orchestrator_;
         std::uint64_t budgetNodes_ = 10000;
         std::uint32_t timeoutMs_ = 50;
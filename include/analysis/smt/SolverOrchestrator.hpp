@@ -4,7 +4,10 @@
 #include "analysis/smt/SolverTypes.hpp"
 
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace ctrace::stack::analysis::smt
 {
@@ -15,16 +18,37 @@ namespace ctrace::stack::analysis::smt
         SolverMode mode = SolverMode::Single;
         std::uint64_t budgetNodes = 10000;
         std::uint32_t timeoutMs = 50;
-        std::uint32_t reserved = 0;
+        // Cap of the process-wide pool running the non-primary members of
+        // concurrent modes; 0 = hardware_concurrency.
+        std::uint32_t workerThreads = 0;
     };
 
+    class ISmtBackend;
+    class ISolverStrategy;
+
+    // Backends and strategy are resolved once, at construction; solve() only
+    // dispatches.
     class SolverOrchestrator
     {
       public:
         explicit SolverOrchestrator(SolverOrchestratorConfig config);
         SmtDecision solve(const SmtQuery& query) const;
+        // Decisions in query order.
+        std::vector<SmtDecision> solveAll(std::span<const SmtQuery> queries) const;
 
       private:
         SolverOrchestratorConfig config_;
+        std::vector<std::shared_ptr<ISmtBackend>> backends_;
+        const ISolverStrategy* strategy_ = nullptr;
     };
+
+    struct SmtBackendWins
+    {
+        std::string backendName;
+        std::uint64_t wins = 0;
+    };
+
+    // Per backend, how often it delivered the first Sat/Unsat of a concurrent
+    // (portfolio, dual-consensus or cross-check) solve in this process.
+    std::vector<SmtBackendWins> concurrentSolveWins();
 } // namespace ctrace::stack::analysis::smt
@@ -3,14 +3,30 @@
 
 #include "analysis/smt/ISmtBackend.hpp"
 
+#include <cstdint>
+#include <optional>
+
 namespace ctrace::stack::analysis::smt
 {
+    // State of the calling thread's reused Z3 session. The counters are
+    // cumulative over the thread's lifetime.
+    struct Z3SessionStats
+    {
+        std::uint64_t trackedConstraints = 0;
+        std::uint64_t guardsCreated = 0;
+        std::uint64_t solverResets = 0;
+        std::uint64_t contextsCreated = 0;
+        std::optional<std::uint32_t> appliedTimeoutMs;
+    };
+
     class Z3Backend final : public ISmtBackend
     {
       public:
         Z3Backend() = default;
 
         std::string name() const override;
-        SmtAnswer solve(const SmtQuery& query) const override;
+        SmtAnswer solve(const SmtQuery& query, SmtCancellation* cancellation) const override;
+
+        static Z3SessionStats threadSessionStats();
     };
 } // namespace ctrace::stack::analysis::smt
@@ -19,6 +19,7 @@
 #include "analysis/SizeMinusKWrites.hpp"
 #include "analysis/StackBufferAnalysis.hpp"
 #include "analysis/StackPointerEscape.hpp"
+#include "analysis/StackSummary.hpp"
 #include "analysis/TOCTOUAnalysis.hpp"
 #include "analysis/TypeConfusionAnalysis.hpp"
 #include "analysis/UninitializedVarAnalysis.hpp"
@@ -53,6 +54,12 @@ namespace ctrace::stack::analyzer
     void emitSummaryDiagnostics(AnalysisResult& result, const PreparedModule& prepared,
                                 const FunctionAuxData& aux);
 
+    // Raises maxStack of result.functions (module `moduleIndex` of `program`)
+    // to the whole-program depth and reports stack limits that are only
+    // exceeded through callees in other translation units.
+    void applyWholeProgramStack(AnalysisResult& result, const analysis::WholeProgramStack& program,
+                                std::size_t moduleIndex);
+
     void appendStackBufferDiagnostics(
         AnalysisResult& result,
         const std::vector<analysis::StackBufferOverflowIssue>& bufferIssues);
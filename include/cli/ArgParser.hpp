@@ -36,9 +36,10 @@ namespace ctrace::stack::cli
         std::uint64_t compileCommandsExplicit : 1 = false;
         std::uint64_t analysisProfileExplicit : 1 = false;
         std::uint64_t includeCompdbDeps : 1 = false;
+        std::uint64_t compdbDedupe : 1 = false;
         std::uint64_t printEffectiveConfig : 1 = false;
         std::uint64_t verbose : 1 = false;
-        std::uint64_t reservedFlags : 59 = 0;
+        std::uint64_t reservedFlags : 58 = 0;
     };
 
     enum class ParseStatus : std::uint8_t
@@ -48,6 +48,9 @@ static void printHelp()
         << "  --compdb-fast          Speed up compdb builds (drops heavy flags)\n"
         << "  --include-compdb-deps Include _deps entries when auto-discovering files from "
            "compile_commands.json\n"
+        << "  --compdb-dedupe        Collapse inputs resolving to the same compdb source and "
+           "report\n"
+        << "                          sources whose entries disagree on defines/includes/std/target\n"
         << "  --jobs=<N|auto>        Parallel jobs for multi-file loading/analysis and cross-TU "
            "summary build (default: 1)\n"
         << "                          If no input files are provided, supported files are loaded\n"
@@ -62,6 +65,8 @@ static void printHelp()
         << "  --smt-timeout-ms=<N>   Per-query timeout budget in milliseconds\n"
         << "  --smt-budget-nodes=<N> Per-query complexity budget\n"
         << "  --smt-rules=<csv>      Restrict SMT to selected rules (example: recursion)\n"
+        << "  --smt-cache-dir=<path> Persist definitive SMT answers across runs\n"
+        << "  --smt-capture=<path>   Record every SMT query and decision (see smt_replay)\n"
         << "  --escape-model=<path>  Stack escape model file "
            "(noescape_arg rules)\n"
         << "  --buffer-model=<path>  Buffer write model file "
@@ -73,11 +78,19 @@ static void printHelp()
         << "  --resource-summary-cache-dir=<path>  Cache directory for cross-TU summaries\n"
         << "  --compile-ir-cache-dir=<path>  Cache directory for compiled LLVM IR per source "
            "file\n"
+        << "  --compile-pch          Reuse precompiled headers for TUs sharing flags and leading\n"
+        << "                          system includes (requires --compile-ir-cache-dir)\n"
         << "  --compile-ir-format=bc|ll  Compilation IR format for source inputs (default: bc)\n"
         << "  --resource-summary-cache-memory-only  Use in-memory cache only for cross-TU "
            "summaries\n"
         << "  --uninitialized-cross-tu    Enable cross-TU uninitialized summaries (default: on)\n"
         << "  --no-uninitialized-cross-tu Disable cross-TU uninitialized summaries\n"
+        << "  --stack-cross-tu       Follow calls across input files for max stack (default: on)\n"
+        << "  --no-stack-cross-tu    Stop max stack at calls into other input files\n"
+        << "  --escape-cross-tu      Enable cross-TU stack escape summaries (default: on)\n"
+        << "  --no-escape-cross-tu   Disable cross-TU stack escape summaries\n"
+        << "  --stack-usage=<path>   Compiler frame sizes for --mode=abi (.su/.ci file or dir)\n"
+        << "  --stack-usage-from-compdb Read .su/.ci files next to each compdb object\n"
         << "  --only-file=<path>     Only report functions from this source file\n"
         << "  --only-dir=<path>      Only report functions under this directory\n"
         << "  --exclude-dir=<path>   Exclude input files under this directory (comma-separated)\n"
@@ -154,6 +167,7 @@ static void printEffectiveConfig(const ctrace::stack::cli::ParsedArguments& pars
     llvm::errs() << "compile-commands: "
                  << (parsed.compileCommandsPath.empty() ? "<none>" : parsed.compileCommandsPath)
                  << "\n";
+    llvm::errs() << "compdb-dedupe: " << (parsed.compdbDedupe ? "true" : "false") << "\n";
     llvm::errs() << "analysis-profile: " << (cfg.profile == AnalysisProfile::Fast ? "fast" : "full")
                  << "\n";
     if (cfg.jobsAuto)
@@ -167,10 +181,16 @@ static void printEffectiveConfig(const ctrace::stack::cli::ParsedArguments& pars
                  << (cfg.resourceModelPath.empty() ? "<none>" : cfg.resourceModelPath) << "\n";
     llvm::errs() << "escape-model: "
                  << (cfg.escapeModelPath.empty() ? "<none>" : cfg.escapeModelPath) << "\n";
+    llvm::errs() << "stack-usage: "
+                 << (cfg.stackUsagePaths.empty() ? "<none>" : joinCsv(cfg.stackUsagePaths))
+                 << "\n";
+    llvm::errs() << "stack-usage-from-compdb: " << (cfg.stackUsageFromCompdb ? "true" : "false")
+                 << "\n";
     llvm::errs() << "buffer-model: "
                  << (cfg.bufferModelPath.empty() ? "<none>" : cfg.bufferModelPath) << "\n";
     llvm::errs() << "compile-ir-cache-dir: "
                  << (cfg.compileIRCacheDir.empty() ? "<none>" : cfg.compileIRCacheDir) << "\n";
+    llvm::errs() << "compile-pch: " << (cfg.compilePCH ? "true" : "false") << "\n";
     llvm::errs() << "compile-ir-format: " << compileIRFormatName(cfg.compileIRFormat) << "\n";
     llvm::errs() << "smt-enabled: " << (cfg.smtEnabled ? "true" : "false") << "\n";
     llvm::errs() << "smt-backend: " << cfg.smtBackend << "\n";
@@ -181,6 +201,10 @@ static void printEffectiveConfig(const ctrace::stack::cli::ParsedArguments& pars
     llvm::errs() << "smt-budget-nodes: " << cfg.smtBudgetNodes << "\n";
     llvm::errs() << "smt-rules: " << (cfg.smtRules.empty() ? "<all>" : joinCsv(cfg.smtRules))
                  << "\n";
+    llvm::errs() << "smt-cache-dir: " << (cfg.smtCacheDir.empty() ? "<none>" : cfg.smtCacheDir)
+                 << "\n";
+    llvm::errs() << "smt-capture: "
+                 << (cfg.smtCapturePath.empty() ? "<none>" : cfg.smtCapturePath) << "\n";
     llvm::errs() << "========================================\n";
 }
 
@@ -1337,6 +1337,9 @@ def check_cli_parsing_and_filters() -> bool:
         ("--escape-model", "Missing argument for --escape-model"),
         ("--buffer-model", "Missing argument for --buffer-model"),
         ("--resource-summary-cache-dir", "Missing argument for --resource-summary-cache-dir"),
+        ("--smt-cache-dir", "Missing argument for --smt-cache-dir"),
+        ("--smt-capture", "Missing argument for --smt-capture"),
+        ("--stack-usage", "Missing argument for --stack-usage"),
         ("--compile-ir-format", "Missing argument for --compile-ir-format"),
         ("--compile-commands", "Missing argument for --compile-commands"),
         ("--compdb", "Missing argument for --compdb"),
@@ -1407,6 +1410,10 @@ def check_cli_parsing_and_filters() -> bool:
         dump_ir_space = tmpdir / "dump-space.ll"
         dump_ir_eq = tmpdir / "dump-eq.ll"
         resource_cache = tmpdir / "resource-cache"
+        smt_cache = tmpdir / "smt-cache"
+        smt_capture = tmpdir / "smt-capture.txt"
+        stack_usage = tmpdir / "frames.su"
+        stack_usage.write_text("transition\t64\tstatic\n", encoding="utf-8")
         compdb = tmpdir / "compile_commands.json"
 
         entries = [
@@ -1451,6 +1458,7 @@ def check_cli_parsing_and_filters() -> bool:
             ("--jobs equals", [str(sample), "--jobs=2", "--only-function=transition"], ["Function:"], "text"),
             ("--compile-ir-format=bc", [str(sample_c), "--compile-ir-format=bc"], ["Function:"], "text"),
             ("--compile-ir-format=ll", [str(sample_c), "--compile-ir-format=ll"], ["Function:"], "text"),
+            ("--compile-pch", [str(sample_c), "--compile-pch"], ["Function:"], "text"),
             ("--timing", [str(sample), "--timing", "--only-function=transition"], ["Function:"], "text"),
             ("--resource-model space", [str(sample), "--resource-model", str(resource_model), "--only-function=transition"], ["Function:"], "text"),
             ("--resource-model equals", [str(sample), f"--resource-model={resource_model}", "--only-function=transition"], ["Function:"], "text"),
@@ -1462,9 +1470,17 @@ def check_cli_parsing_and_filters() -> bool:
             ("--no-resource-cross-tu", [str(sample), "--no-resource-cross-tu", "--only-function=transition"], ["Function:"], "text"),
             ("--uninitialized-cross-tu", [str(sample), "--uninitialized-cross-tu", "--only-function=transition"], ["Function:"], "text"),
             ("--no-uninitialized-cross-tu", [str(sample), "--no-uninitialized-cross-tu", "--only-function=transition"], ["Function:"], "text"),
+            ("--stack-cross-tu", [str(sample), "--stack-cross-tu", "--only-function=transition"], ["Function:"], "text"),
+            ("--no-stack-cross-tu", [str(sample), "--no-stack-cross-tu", "--only-function=transition"], ["Function:"], "text"),
+            ("--escape-cross-tu", [str(sample), "--escape-cross-tu", "--only-function=transition"], ["Function:"], "text"),
+            ("--no-escape-cross-tu", [str(sample), "--no-escape-cross-tu", "--only-function=transition"], ["Function:"], "text"),
             ("--resource-summary-cache-dir space", [str(sample), "--resource-summary-cache-dir", str(resource_cache), "--only-function=transition"], ["Function:"], "text"),
             ("--resource-summary-cache-dir equals", [str(sample), f"--resource-summary-cache-dir={resource_cache}", "--only-function=transition"], ["Function:"], "text"),
             ("--resource-summary-cache-memory-only", [str(sample), "--resource-summary-cache-memory-only", "--only-function=transition"], ["Function:"], "text"),
+            ("--smt-cache-dir space", [str(sample), "--smt", "--smt-cache-dir", str(smt_cache), "--only-function=transition"], ["Function:"], "text"),
+            ("--smt-cache-dir equals", [str(sample), "--smt", f"--smt-cache-dir={smt_cache}", "--only-function=transition"], ["Function:"], "text"),
+            ("--smt-capture space", [str(sample), "--smt", "--smt-capture", str(smt_capture), "--only-function=transition"], ["Function:"], "text"),
+            ("--smt-capture equals", [str(sample), "--smt", f"--smt-capture={smt_capture}", "--only-function=transition"], ["Function:"], "text"),
             (
                 "--warnings-only",
                 [str(sample_warning), "--warnings-only"],
@@ -1478,6 +1494,9 @@ def check_cli_parsing_and_filters() -> bool:
             ("--base-dir equals", [str(sample), "--format=sarif", f"--base-dir={sample.parent}"], [], "sarif"),
             ("--mode=ir", [str(sample), "--mode=ir", "--only-function=transition"], ["Function:"], "text"),
             ("--mode=abi", [str(sample), "--mode=abi", "--only-function=transition"], ["Function:"], "text"),
+            ("--stack-usage space", [str(sample), "--mode=abi", "--stack-usage", str(stack_usage), "--only-function=transition"], ["Function:"], "text"),
+            ("--stack-usage equals", [str(sample), "--mode=abi", f"--stack-usage={stack_usage}", "--only-function=transition"], ["Function:"], "text"),
+            ("--stack-usage-from-compdb", [str(sample), "--mode=abi", f"--compile-commands={compdb}", "--stack-usage-from-compdb", "--only-function=transition"], ["Function:"], "text"),
             ("--compile-commands space", [str(sample), "--compile-commands", str(compdb), "--only-function=transition"], ["Function:"], "text"),
             ("--compile-commands equals", [str(sample), f"--compile-commands={compdb}", "--only-function=transition"], ["Function:"], "text"),
             ("--compdb space", [str(sample), "--compdb", str(compdb), "--only-function=transition"], ["Function:"], "text"),
@@ -1571,6 +1590,100 @@ def check_compile_ir_format_switch() -> bool:
     return ok
 
 
+def check_compile_pch_parity() -> bool:
+    """
+    Regression: --compile-pch must not change results. Two TUs share their
+    leading system includes, so the second one is compiled against a
+    precompiled header; a later run with a cleared IR cache loads that
+    header instead of building it again.
+    """
+    print("=== Testing --compile-pch parity ===")
+    with tempfile.TemporaryDirectory(prefix="ct_compile_pch_") as tmp:
+        tmpdir = Path(tmp)
+        src_a = tmpdir / "pch_a.c"
+        src_b = tmpdir / "pch_b.c"
+        prelude = "#include <stdio.h>\n#include <string.h>\n\n"
+        src_a.write_text(
+            prelude
+            + "int pch_a(const char* s)\n{\n    char buf[64];\n"
+            + "    strcpy(buf, s);\n    return (int)strlen(buf);\n}\n",
+            encoding="utf-8",
+        )
+        src_b.write_text(
+            prelude
+            + "int pch_b(void)\n{\n    char buf[8];\n"
+            + "    snprintf(buf, 16, \"%d\", 42);\n    return buf[0];\n}\n",
+            encoding="utf-8",
+        )
+        inputs = [str(src_a), str(src_b), "--jobs=1"]
+
+        def run_and_parse(label: str, extra: list[str]):
+            result = run_analyzer_uncached([*inputs, *extra])
+            output = (result.stdout or "") + (result.stderr or "")
+            if result.returncode != 0:
+                fail_check(f"{label} run failed (code {result.returncode})", output)
+                return None
+            if "precompiled header failed" in output or "Precompiled header build failed" in output:
+                fail_check(f"{label} run could not use its precompiled header", output)
+                return None
+            return (
+                parse_human_functions(result.stdout or ""),
+                parse_human_diagnostic_messages(result.stdout or ""),
+            )
+
+        baseline = run_and_parse("baseline", [])
+        if baseline is None:
+            return False
+        if "pch_a" not in baseline[0] or "pch_b" not in baseline[0]:
+            return fail_check("baseline run is missing fixture functions")
+
+        cache_dir = tmpdir / "compile-ir-cache"
+        pch_dir = cache_dir / "pch"
+        pch_args = ["--compile-pch", f"--compile-ir-cache-dir={cache_dir}"]
+        with_pch = run_and_parse("--compile-pch build", pch_args)
+        if with_pch is None:
+            return False
+        if with_pch != baseline:
+            return fail_check("--compile-pch build output differs from a run without --compile-pch")
+        print("  ✅ --compile-pch build matches baseline")
+
+        built = sorted(pch_dir.glob("*.pch"))
+        if len(built) != 1:
+            return fail_check(f"--compile-pch produced {len(built)} precompiled header(s), expected 1")
+        built_stat = built[0].stat()
+        print("  ✅ --compile-pch produced a precompiled header")
+
+        # Drop the cached IR so both TUs are compiled again; only the PCH survives.
+        for entry in cache_dir.iterdir():
+            if entry == pch_dir:
+                continue
+            if entry.is_dir():
+                shutil.rmtree(entry)
+            else:
+                entry.unlink()
+
+        with_pch = run_and_parse("--compile-pch reuse", pch_args)
+        if with_pch is None:
+            return False
+        if with_pch != baseline:
+            return fail_check("--compile-pch reuse output differs from a run without --compile-pch")
+        print("  ✅ --compile-pch reuse matches baseline")
+
+        if not any(entry != pch_dir for entry in cache_dir.iterdir()):
+            return fail_check("--compile-pch reuse run did not recompile the cleared TUs")
+        if not built[0].exists():
+            return fail_check("--compile-pch reuse run discarded its precompiled header")
+        reused_stat = built[0].stat()
+        if (reused_stat.st_ino, reused_stat.st_mtime_ns) != (built_stat.st_ino, built_stat.st_mtime_ns):
+            return fail_check("--compile-pch reuse run rebuilt the precompiled header")
+        if list(pch_dir.glob("*.tmp")):
+            return fail_check("--compile-pch left a temporary precompiled header behind")
+        print("  ✅ --compile-pch reuse loaded the existing precompiled header")
+
+    print()
+    return True
+
+
 def check_pipeline_subscriber_rollout_parity() -> bool:
     """
     Integration check: diagnostics must remain stable when toggling the
@@ -2148,6 +2261,308 @@ def check_uninitialized_cross_tu() -> bool:
     return True
 
 
+def check_stack_escape_cross_tu() -> bool:
+    """
+    Regression: cross-TU stack escape summaries are built for multi-file runs,
+    add no warning for forwarders of NoEscape or MayEscape callees, and reuse
+    the per-module summary cache on a second run. --no-escape-cross-tu skips
+    the build.
+    """
+    print("=== Testing stack escape cross-TU summaries ===")
+
+    escape_def = RUN_CONFIG.test_dir / "escape-stack/cross-tu-escape-def.c"
+    escape_use = RUN_CONFIG.test_dir / "escape-stack/cross-tu-escape-use.c"
+    with tempfile.TemporaryDirectory(prefix="ct_escape_cross_tu_") as tmp:
+        cache_dir = Path(tmp) / "summary-cache"
+        args = [
+            str(escape_def),
+            str(escape_use),
+            "--jobs=2",
+            "--timing",
+            f"--resource-summary-cache-dir={cache_dir}",
+        ]
+
+        outputs = []
+        for run_label in ("cold", "warm"):
+            result = run_analyzer_uncached(args)
+            output = (result.stdout or "") + (result.stderr or "")
+            if not expect_returncode_zero(result, output, f"{run_label} cross-TU escape run failed"):
+                return False
+            if not expect_contains(
+                output,
+                "Cross-TU stack escape summary build done",
+                f"missing stack escape summary build in {run_label} run",
+            ):
+                return False
+            if not expect_not_contains(
+                output,
+                "stack pointer escape",
+                f"unexpected stack escape warning in {run_label} cross-TU run",
+            ):
+                return False
+            outputs.append(output)
+
+        if not list((cache_dir / "stack-escape").glob("*.json")):
+            return fail_check("stack escape summary cache is empty after cold run")
+        if not expect_contains(
+            outputs[0],
+            "0 cache hit(s)",
+            "cold run unexpectedly hit the stack escape summary cache",
+        ):
+            return False
+        if not expect_contains(
+            outputs[1],
+            "2 cache hit(s)",
+            "warm run did not reuse both stack escape module summaries",
+        ):
+            return False
+
+        result = run_analyzer_uncached([*args, "--no-escape-cross-tu"])
+        output = (result.stdout or "") + (result.stderr or "")
+        if not expect_returncode_zero(result, output, "--no-escape-cross-tu run failed"):
+            return False
+        if not expect_not_contains(
+            output,
+            "Cross-TU stack escape summary build done",
+            "--no-escape-cross-tu still built stack escape summaries",
+        ):
+            return False
+        if not expect_contains(
+            output,
+            "disabled by --no-escape-cross-tu",
+            "--no-escape-cross-tu did not report the disabled analysis",
+        ):
+            return False
+
+    print("  ✅ cross-TU stack escape summaries OK\n")
+    return True
+
+
+def check_stack_cross_tu() -> bool:
+    """
+    Regression: with several input files, max stack follows calls into other
+    translation units, so a shallow wrapper of a deep callee defined elsewhere
+    trips the stack limit; --no-stack-cross-tu keeps the module-local total.
+    """
+    print("=== Testing cross-TU max stack ===")
+
+    fixture_dir = RUN_CONFIG.test_dir / "test-multi-tu"
+    args = [
+        str(fixture_dir / "stack_wrapper.c"),
+        str(fixture_dir / "stack_deep.c"),
+        "--stack-limit=2048",
+    ]
+
+    def run_and_parse(label: str, extra: list[str]):
+        result = run_analyzer([*args, *extra])
+        output = (result.stdout or "") + (result.stderr or "")
+        if not expect_returncode_zero(result, output, f"{label} run failed"):
+            return None, output
+        functions = parse_human_functions(result.stdout or "")
+        if "mtu_shallow_wrapper" not in functions or "mtu_deep_stack" not in functions:
+            fail_check(f"{label} output is missing fixture functions", output)
+            return None, output
+        return functions, output
+
+    linked, output = run_and_parse("cross-TU", [])
+    if linked is None:
+        return False
+    wrapper = linked["mtu_shallow_wrapper"]
+    deep = linked["mtu_deep_stack"]
+    expected = wrapper["localStack"] + deep["maxStack"]
+    if wrapper["maxStackUnknown"] or wrapper["maxStack"] != expected:
+        return fail_check(
+            f"wrapper max stack {wrapper['maxStack']} does not include its callee "
+            f"(expected {expected})",
+            output,
+        )
+    if not wrapper["exceedsLimit"]:
+        return fail_check("wrapper of a deep cross-TU callee does not exceed the limit", output)
+    if not expect_contains(
+        output,
+        f"through callees in other translation units (whole-program max stack: {expected} bytes)",
+        "missing cross-TU stack overflow diagnostic",
+    ):
+        return False
+    if not expect_contains(
+        output,
+        "path: mtu_shallow_wrapper -> mtu_deep_stack",
+        "missing cross-TU call path",
+    ):
+        return False
+    print(f"  ✅ wrapper max stack raised to {expected} bytes")
+
+    local_only, output = run_and_parse("--no-stack-cross-tu", ["--no-stack-cross-tu"])
+    if local_only is None:
+        return False
+    wrapper = local_only["mtu_shallow_wrapper"]
+    if wrapper["maxStack"] >= expected or wrapper["exceedsLimit"]:
+        return fail_check("--no-stack-cross-tu still links the callee's stack", output)
+    if not expect_not_contains(
+        output,
+        "through callees in other translation units",
+        "--no-stack-cross-tu still reports a cross-TU stack overflow",
+    ):
+        return False
+    print("  ✅ --no-stack-cross-tu keeps the module-local total\n")
+    return True
+
+
+def check_stack_usage_abi() -> bool:
+    """
+    Regression: --mode=abi replaces the IR frame estimate with the size read
+    from a -fstack-usage file, and --mode=ir ignores the file with a warning.
+    """
+    print("=== Testing --stack-usage frame sizes ===")
+
+    fixture = RUN_CONFIG.test_dir / "test-multi-tu/worker.c"
+    with tempfile.TemporaryDirectory(prefix="ct_stack_usage_") as tmp:
+        su_file = Path(tmp) / "worker.su"
+        su_file.write_text("worker.c:4:mtu_worker\t12344\tstatic\n", encoding="utf-8")
+
+        result = run_analyzer_uncached([str(fixture), "--mode=abi", f"--stack-usage={su_file}"])
+        output = (result.stdout or "") + (result.stderr or "")
+        if not expect_returncode_zero(result, output, "--mode=abi --stack-usage run failed"):
+            return False
+        if not expect_contains(
+            output,
+            "Loaded 1 compiler frame size(s) from 1 file(s)",
+            "missing frame size load status",
+        ):
+            return False
+        worker = parse_human_functions(result.stdout or "").get("mtu_worker")
+        if worker is None or worker["localStack"] != 12344 or worker["localStackUnknown"]:
+            return fail_check("mtu_worker local stack is not the .su frame size", output)
+        print("  ✅ --mode=abi uses the .su frame size")
+
+        result = run_analyzer_uncached([str(fixture), "--mode=ir", f"--stack-usage={su_file}"])
+        output = (result.stdout or "") + (result.stderr or "")
+        if not expect_returncode_zero(result, output, "--mode=ir --stack-usage run failed"):
+            return False
+        if not expect_contains(
+            output,
+            "compiler frame sizes are only used with --mode=abi",
+            "--mode=ir did not warn about an ignored --stack-usage",
+        ):
+            return False
+        worker = parse_human_functions(result.stdout or "").get("mtu_worker")
+        if worker is None or worker["localStack"] == 12344:
+            return fail_check("--mode=ir applied the .su frame size", output)
+        print("  ✅ --mode=ir keeps the IR estimate\n")
+
+    return True
+
+
+def check_mutual_recursion_max_stack() -> bool:
+    """
+    Regression: a mutually recursive SCC is charged one pass over every member
+    frame plus its deepest continuation, and its callers build on that total.
+    """
+    print("=== Testing mutual recursion max stack ===")
+
+    fixture = RUN_CONFIG.test_dir / "recursion/c/mutual-recursion-stack.c"
+    result = run_analyzer([str(fixture)])
+    output = (result.stdout or "") + (result.stderr or "")
+    if not expect_returncode_zero(result, output, "mutual recursion run failed"):
+        return False
+
+    functions = parse_human_functions(result.stdout or "")
+    names = ("leaf", "ping", "pong", "main")
+    if any(name not in functions for name in names):
+        return fail_check("mutual recursion output is missing fixture functions", output)
+    if any(functions[name]["maxStackUnknown"] or functions[name]["localStackUnknown"]
+           for name in names):
+        return fail_check("mutual recursion fixture has an unknown stack size", output)
+    if not (functions["ping"]["isRecursive"] and functions["pong"]["isRecursive"]):
+        return fail_check("ping/pong are not reported as recursive", output)
+
+    local = {name: functions[name]["localStack"] for name in names}
+    total = {name: functions[name]["maxStack"] for name in names}
+    cycle = local["ping"] + local["pong"] + max(local["ping"], local["pong"], total["leaf"])
+    if total["ping"] != cycle or total["pong"] != cycle:
+        return fail_check(
+            f"SCC max stack mismatch: ping={total['ping']} pong={total['pong']} "
+            f"expected {cycle}",
+            output,
+        )
+    if total["main"] != local["main"] + cycle:
+        return fail_check(
+            f"caller of the SCC: main={total['main']} expected {local['main'] + cycle}",
+            output,
+        )
+
+    print(f"  ✅ mutual recursion SCC max stack = {cycle} bytes\n")
+    return True
+
+
+def check_smt_capture_replay() -> bool:
+    """
+    Queries captured with --smt-capture replay through smt_replay with the
+    decisions they were captured with.
+    """
+    print("=== Testing SMT capture and replay ===")
+    replay_bin = RUN_CONFIG.analyzer.parent / "smt_replay"
+    if not replay_bin.exists():
+        print("  [info] smt_replay binary not found, skipping")
+        print(f"     expected: {replay_bin}")
+        print()
+        return True
+
+    fixture = RUN_CONFIG.test_dir / "recursion/c/limited-recursion.c"
+    with tempfile.TemporaryDirectory(prefix="ct_smt_capture_") as tmp:
+        capture = Path(tmp) / "queries.txt"
+        result = run_analyzer_uncached(
+            [str(fixture), "--smt", "--smt-rules=recursion", f"--smt-capture={capture}"]
+        )
+        output = (result.stdout or "") + (result.stderr or "")
+        if not expect_returncode_zero(result, output, "capture run failed"):
+            return False
+        if not capture.exists():
+            return fail_check("capture file was not written", output)
+
+        lines = capture.read_text(encoding="utf-8").splitlines()
+        if not lines or lines[0] != "ctrace-smt-capture-v1":
+            return fail_check("capture file has no schema header", "\n".join(lines[:3]))
+        record_count = sum(1 for line in lines[1:] if line.strip())
+
+        replay_cases = [
+            ("default", []),
+            ("--mode=portfolio", ["--mode=portfolio", "--threads=2"]),
+            ("--mode=cross-check", ["--mode=cross-check", "--secondary-backend=interval"]),
+            ("--mode=dual-consensus", ["--mode=dual-consensus"]),
+            ("overrides", ["--timeout-ms=100", "--budget-nodes=5000", "--repeat=2"]),
+            ("--rules", ["--rules=recursion"]),
+        ]
+        for label, extra in replay_cases:
+            replay = subprocess.run(
+                [str(replay_bin), str(capture), "--fail-on-disagreement", *extra],
+                capture_output=True,
+                text=True,
+            )
+            replay_output = (replay.stdout or "") + (replay.stderr or "")
+            if not expect_returncode_zero(replay, replay_output, f"smt_replay {label} failed"):
+                return False
+            if not expect_contains(
+                replay_output,
+                f"smt_replay: {record_count} query(ies)",
+                f"smt_replay {label} did not load every captured record",
+            ):
+                return False
+            if not expect_contains(
+                replay_output,
+                "vs capture: 0 conflicting",
+                f"smt_replay {label} conflicts with the captured decisions",
+            ):
+                return False
+
+        missing = subprocess.run([str(replay_bin)], capture_output=True, text=True)
+        if missing.returncode == 0 or "missing capture file" not in (missing.stderr or ""):
+            return fail_check("smt_replay accepted a missing capture file", missing.stderr or "")
+
+    print("  ✅ SMT capture and replay OK\n")
+    return True
+
+
 def check_null_deref_nested_inter_tu() -> bool:
     """
     Regression: nested null-deref cases must still be reported when the analyzer
@@ -2607,6 +3022,83 @@ def check_compdb_as_default_input_source() -> bool:
     return True
 
 
+def check_compdb_dedupe() -> bool:
+    """
+    Regression: --compdb-dedupe must analyze a compdb source once even when it is
+    passed under several spellings, and report entries with divergent flags. A
+    different file that only shares the source's path suffix is kept.
+    """
+    print("=== Testing --compdb-dedupe ===")
+    with tempfile.TemporaryDirectory(prefix="ct_compdb_dedupe_") as tmp:
+        tmpdir = Path(tmp)
+        src_dir = tmpdir / "src"
+        src_dir.mkdir(parents=True, exist_ok=True)
+        c_file = src_dir / "dedupe.c"
+        compdb = tmpdir / "compile_commands.json"
+
+        c_file.write_text("int dedupe_fn(void) { return 7; }\n", encoding="utf-8")
+        vendor_file = tmpdir / "vendor" / "src" / "dedupe.c"
+        vendor_file.parent.mkdir(parents=True, exist_ok=True)
+        vendor_file.write_text("int vendor_dedupe_fn(void) { return 9; }\n", encoding="utf-8")
+
+        entries = [
+            {
+                "directory": str(tmpdir),
+                "file": str(c_file),
+                "arguments": ["clang", "-DVARIANT_SHARED", "-fPIC", "-c", str(c_file)],
+            },
+            {
+                "directory": str(src_dir),
+                "file": "dedupe.c",
+                "arguments": ["clang", "-DVARIANT_STATIC", "-c", "dedupe.c"],
+            },
+        ]
+        compdb.write_text(json.dumps(entries), encoding="utf-8")
+
+        alias = src_dir / ".." / "src" / "dedupe.c"
+        result = run_analyzer(
+            [
+                str(c_file),
+                str(alias),
+                str(vendor_file),
+                f"--compile-commands={compdb}",
+                "--compdb-dedupe",
+            ]
+        )
+        output = (result.stdout or "") + (result.stderr or "")
+        if result.returncode != 0:
+            print(f"  ❌ --compdb-dedupe run failed (code {result.returncode})")
+            print(output)
+            print()
+            return False
+
+        expected = [
+            "compdb dedupe: 2 entry/entries collapsed into 1 source file(s) "
+            "(1 source(s) with divergent analysis-relevant flags)",
+            "has entries with different defines/includes/std/target",
+            "compdb dedupe: skipped 1 input file(s) resolving to an already selected source",
+        ]
+        for needle in expected:
+            if needle not in output:
+                print(f"  ❌ missing dedupe status message: {needle}")
+                print(output)
+                print()
+                return False
+        if output.count("Function: dedupe_fn") != 1:
+            print("  ❌ expected deduplicated source to be analyzed exactly once")
+            print(output)
+            print()
+            return False
+        if output.count("Function: vendor_dedupe_fn") != 1:
+            print("  ❌ a suffix-matched file was deduplicated against the compdb source")
+            print(output)
+            print()
+            return False
+
+    print("  ✅ --compdb-dedupe OK\n")
+    return True
+
+
 def check_exclude_dir_filter() -> bool:
     """
     Regression: --exclude-dir must filter input files before analysis.
@@ -3104,6 +3596,7 @@ def main() -> int:
         check_multi_file_failure,
         check_cli_parsing_and_filters,
         check_compile_ir_format_switch,
+        check_compile_pch_parity,
         check_pipeline_subscriber_rollout_parity,
         check_pipeline_timing_traversal_instrumentation,
         check_only_func_uninitialized,
@@ -3113,10 +3606,16 @@ def main() -> int:
         check_uninitialized_optional_receiver_index_repro,
         check_unknown_alloca_virtual_callback_escape,
         check_compdb_as_default_input_source,
+        check_compdb_dedupe,
         check_exclude_dir_filter,
         check_multi_tu_folder_analysis,
         check_resource_lifetime_cross_tu,
         check_uninitialized_cross_tu,
+        check_stack_escape_cross_tu,
+        check_stack_cross_tu,
+        check_stack_usage_abi,
+        check_mutual_recursion_max_stack,
+        check_smt_capture_replay,
         check_null_deref_nested_inter_tu,
         check_integer_overflow_advanced_inter_tu,
         check_use_after_free_advanced_inter_tu,
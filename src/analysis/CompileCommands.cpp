@@ -2,10 +2,18 @@
 #include "analysis/CompileCommands.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -35,32 +43,69 @@ namespace ctrace::stack::analysis
             return out;
         }
 
-        bool pathHasSuffix(const std::string& path, const std::string& suffix)
+        std::string trimTrailingSlashes(std::string path)
         {
-            if (suffix.empty())
-                return false;
-            if (path.size() < suffix.size())
-                return false;
-            if (path.compare(path.size() - suffix.size(), suffix.size(), suffix) != 0)
-                return false;
-            if (path.size() == suffix.size())
-                return true;
-            return path[path.size() - suffix.size() - 1] == '/';
+            while (path.size() > 1 && path.back() == '/')
+                path.pop_back();
+            return path;
         }
 
-        std::vector<std::string> buildPathSuffixes(const std::string& path)
+        // Memoizes directory canonicalization so entries sharing a directory only pay the
+        // weakly_canonical syscalls once. Not thread-safe: each loader worker owns one.
+        class PathCanonicalizer
         {
-            std::vector<std::string> suffixes;
-            if (path.empty())
-                return suffixes;
+          public:
+            const std::string& normalizeDirectory(const std::filesystem::path& directory)
+            {
+                auto [it, inserted] = directories_.try_emplace(directory.generic_string());
+                if (inserted)
+                    it->second = normalizePath(directory);
+                return it->second;
+            }
+
+            std::string normalizeFile(const std::filesystem::path& file)
+            {
+                const std::filesystem::path name = file.filename();
+                const std::filesystem::path parent = file.parent_path();
+                if (name.empty() || name == "." || name == ".." || parent.empty())
+                    return normalizePath(file);
+
+                // weakly_canonical would resolve a symlinked leaf, so only reuse the cached
+                // parent when the leaf itself is not a link.
+                std::error_code ec;
+                const std::filesystem::file_status status =
+                    std::filesystem::symlink_status(file, ec);
+                if (!ec && std::filesystem::is_symlink(status))
+                    return normalizePath(file);
+
+                const std::string& parentKey = normalizeDirectory(parent);
+                if (parentKey.empty())
+                    return normalizePath(file);
+                std::string out = parentKey;
+                if (out.back() != '/')
+                    out.push_back('/');
+                out += name.generic_string();
+                return out;
+            }
+
+          private:
+            std::unordered_map<std::string, std::string> directories_;
+        };
 
-            suffixes.push_back(path);
-            for (std::size_t i = 1; i < path.size(); ++i)
+        std::vector<std::string> splitPathComponents(const std::string& path)
+        {
+            std::vector<std::string> components;
+            std::size_t start = 0;
+            while (start <= path.size())
             {
-                if (path[i] == '/' && i + 1 < path.size())
-                    suffixes.push_back(path.substr(i));
+                std::size_t end = path.find('/', start);
+                if (end == std::string::npos)
+                    end = path.size();
+                if (end > start)
+                    components.emplace_back(path, start, end - start);
+                start = end + 1;
             }
-            return suffixes;
+            return components;
         }
 
         std::vector<std::string> tokenizeCommandLine(const std::string& command)
@@ -176,7 +221,7 @@ namespace ctrace::stack::analysis
         }
 
         void stripInputFileArg(std::vector<std::string>& args, const std::string& directory,
-                               const std::string& fileKey)
+                               const std::string& fileKey, PathCanonicalizer& canonicalizer)
         {
             if (fileKey.empty())
                 return;
@@ -192,7 +237,15 @@ namespace ctrace::stack::analysis
                     std::filesystem::path argPath(arg);
                     if (argPath.is_relative())
                         argPath = std::filesystem::path(directory) / argPath;
-                    std::string argKey = normalizePath(argPath);
+                    // The key is already canonical, so a lexical match needs no filesystem
+                    // access; only fall back to canonicalization for differing spellings.
+                    if (trimTrailingSlashes(argPath.lexically_normal().generic_string()) ==
+                        fileKey)
+                    {
+                        removed = true;
+                        continue;
+                    }
+                    std::string argKey = canonicalizer.normalizeFile(argPath);
                     if (!argKey.empty() && argKey == fileKey)
                     {
                         removed = true;
@@ -305,10 +358,224 @@ namespace ctrace::stack::analysis
                 dirPath = compdbDir / dirPath;
             return dirPath;
         }
+
+        std::string resolveFlagPath(const std::string& value, const std::string& directory)
+        {
+            std::filesystem::path flagPath(value);
+            if (flagPath.is_relative())
+                flagPath = std::filesystem::path(directory) / flagPath;
+            return trimTrailingSlashes(flagPath.lexically_normal().generic_string());
+        }
+
+        struct SignatureFlag
+        {
+            std::string_view spelling;
+            std::string_view kind;  // recorded name; aliases share one
+            std::uint64_t isPath : 1 = false;   // resolved against the entry directory
+            std::uint64_t joinable : 1 = false; // "-Ifoo" as well as "-I foo" / "-I=foo"
+            std::uint64_t reservedFlags : 62 = 0;
+        };
+
+        // Value of `flag` at args[i]: the next argument for an exact match,
+        // the text after '=' for "flag=value", or the glued rest for joinable
+        // flags. Longer spellings never match a shorter flag ("-include-pch"
+        // is not "-include", "-stdlib=" is not "-std", "-isystem-after" is
+        // not "-isystem").
+        std::optional<std::string> matchSignatureFlag(const SignatureFlag& flag,
+                                                      const std::vector<std::string>& args,
+                                                      std::size_t& i)
+        {
+            const std::string& arg = args[i];
+            if (arg == flag.spelling)
+            {
+                if (i + 1 >= args.size())
+                    return std::nullopt;
+                return args[++i];
+            }
+            if (arg.rfind(flag.spelling, 0) != 0)
+                return std::nullopt;
+
+            std::string value = arg.substr(flag.spelling.size());
+            if (value.front() == '=')
+                return value.substr(1);
+            if (flag.joinable && value.front() != '-')
+                return value;
+            return std::nullopt;
+        }
+
+        // Builds a canonical description of the flags that change what the analyzer sees:
+        // preprocessor defines, include search paths, language standard and target. Paths are
+        // resolved against the entry directory so equivalent relative spellings compare equal.
+        std::string buildAnalysisSignature(const std::vector<std::string>& args,
+                                           const std::string& directory)
+        {
+            static constexpr std::array<SignatureFlag, 15> kFlags = {{
+                {"-isystem", "-isystem", true, true},
+                {"-iquote", "-iquote", true, true},
+                {"-idirafter", "-idirafter", true, true},
+                {"-isysroot", "-isysroot", true, true},
+                {"-include", "-include", true, false},
+                {"-include-pch", "-include-pch", true, false},
+                {"-imacros", "-imacros", true, true},
+                {"--sysroot", "--sysroot", true, false},
+                {"-I", "-I", true, true},
+                {"-D", "-D", false, true},
+                {"-U", "-U", false, true},
+                {"-std", "-std", false, false},
+                {"--std", "-std", false, false},
+                {"-stdlib", "-stdlib", false, false},
+                {"--stdlib", "-stdlib", false, false},
+            }};
+            static constexpr std::array<std::string_view, 3> kTargetFlags = {"-target", "-arch",
+                                                                             "-x"};
+
+            std::string signature;
+            auto append = [&](std::string_view kind, const std::string& value)
+            {
+                signature.append(kind);
+                signature.push_back('=');
+                signature.append(value);
+                signature.push_back('\n');
+            };
+
+            for (std::size_t i = 0; i < args.size(); ++i)
+            {
+                const std::string& arg = args[i];
+                if (arg.size() < 2 || arg[0] != '-')
+                    continue;
+
+                bool matched = false;
+                for (const SignatureFlag& flag : kFlags)
+                {
+                    std::optional<std::string> value = matchSignatureFlag(flag, args, i);
+                    if (!value)
+                        continue;
+                    append(flag.kind, flag.isPath ? resolveFlagPath(*value, directory) : *value);
+                    matched = true;
+                    break;
+                }
+                if (matched)
+                    continue;
+
+                const bool hasNext = i + 1 < args.size();
+                for (std::string_view flag : kTargetFlags)
+                {
+                    if (arg == flag && hasNext)
+                    {
+                        append(flag, args[++i]);
+                        matched = true;
+                        break;
+                    }
+                }
+                if (matched)
+                    continue;
+
+                if (arg.rfind("--target=", 0) == 0)
+                    append("-target", arg.substr(9));
+                else if (arg.rfind("-march=", 0) == 0 || arg.rfind("-mcpu=", 0) == 0 ||
+                         arg == "-m32" || arg == "-m64" || arg.rfind("-x", 0) == 0)
+                    append("-m", arg);
+            }
+            return signature;
+        }
+
+        struct ParsedCompileEntry
+        {
+            std::string fileKey;
+            std::string analysisSignature;
+            CompileCommand command;
+        };
+
+        void parseCompileEntry(const llvm::json::Value& entryValue,
+                               const std::filesystem::path& compdbDir,
+                               PathCanonicalizer& canonicalizer, ParsedCompileEntry& out)
+        {
+            const auto* obj = entryValue.getAsObject();
+            if (!obj)
+                return;
+
+            auto fileValue = obj->getString("file");
+            if (!fileValue)
+                return;
+
+            std::string fileStr = fileValue->str();
+            std::string dirStr;
+            if (auto directoryValue = obj->getString("directory"))
+                dirStr = directoryValue->str();
+
+            std::filesystem::path directoryPath = normalizeDirectoryPath(compdbDir, dirStr);
+            const std::string& directoryKey = canonicalizer.normalizeDirectory(directoryPath);
+            if (directoryKey.empty())
+                return;
+
+            std::filesystem::path filePath(fileStr);
+            if (filePath.is_relative())
+                filePath = directoryPath / filePath;
+            std::string fileKey = canonicalizer.normalizeFile(filePath);
+            if (fileKey.empty())
+                return;
+
+            std::vector<std::string> args = extractArguments(*obj);
+            if (args.empty())
+                return;
+
+            stripLeadingCommandTokens(args);
+            stripOutputAndDependencyArgs(args);
+            stripInputFileArg(args, directoryKey, fileKey, canonicalizer);
+
+            out.analysisSignature = buildAnalysisSignature(args, directoryKey);
+            out.fileKey = std::move(fileKey);
+            out.command.directory = directoryKey;
+            out.command.arguments = std::move(args);
+        }
+
+        // Entry normalization is dominated by filesystem canonicalization, so large databases
+        // are split into contiguous chunks parsed on up to maxJobs threads. Results stay in
+        // input order.
+        std::vector<ParsedCompileEntry> parseCompileEntries(const llvm::json::Array& array,
+                                                            const std::filesystem::path& compdbDir,
+                                                            unsigned maxJobs)
+        {
+            constexpr std::size_t kMinEntriesPerWorker = 512;
+
+            std::vector<ParsedCompileEntry> parsed(array.size());
+            std::size_t workerCount =
+                std::min<std::size_t>(maxJobs, array.size() / kMinEntriesPerWorker);
+            workerCount = std::max<std::size_t>(workerCount, 1);
+
+            const std::size_t chunkSize = (array.size() + workerCount - 1) / workerCount;
+            auto parseChunk = [&](std::size_t begin, std::size_t end)
+            {
+                PathCanonicalizer canonicalizer;
+                for (std::size_t i = begin; i < end; ++i)
+                    parseCompileEntry(array[i], compdbDir, canonicalizer, parsed[i]);
+            };
+
+            if (workerCount == 1)
+            {
+                parseChunk(0, array.size());
+                return parsed;
+            }
+
+            std::vector<std::thread> workers;
+            workers.reserve(workerCount - 1);
+            for (std::size_t w = 1; w < workerCount; ++w)
+            {
+                const std::size_t begin = w * chunkSize;
+                const std::size_t end = std::min(array.size(), begin + chunkSize);
+                if (begin >= end)
+                    break;
+                workers.emplace_back(parseChunk, begin, end);
+            }
+            parseChunk(0, std::min(array.size(), chunkSize));
+            for (auto& worker : workers)
+                worker.join();
+            return parsed;
+        }
     } // namespace
 
-    std::shared_ptr<CompilationDatabase> CompilationDatabase::loadFromFile(const std::string& path,
-                                                                           std::string& error)
+    std::shared_ptr<CompilationDatabase>
+    CompilationDatabase::loadFromFile(const std::string& path, std::string& error, unsigned maxJobs)
     {
         error.clear();
         auto bufferOrErr = llvm::MemoryBuffer::getFile(path);
@@ -345,54 +612,31 @@ namespace ctrace::stack::analysis
                 compdbDir = std::filesystem::path(".");
         }
 
-        for (const auto& entryValue : *array)
+        std::vector<ParsedCompileEntry> entries = parseCompileEntries(*array, compdbDir, maxJobs);
+        std::unordered_map<std::string, std::string> firstSignatureByFile;
+        std::unordered_set<std::string> divergentSources;
+        for (ParsedCompileEntry& entry : entries)
         {
-            const auto* obj = entryValue.getAsObject();
-            if (!obj)
-                continue;
-
-            auto fileValue = obj->getString("file");
-            if (!fileValue)
-                continue;
-
-            std::string fileStr = fileValue->str();
-            std::string dirStr;
-            if (auto directoryValue = obj->getString("directory"))
-                dirStr = directoryValue->str();
-
-            std::filesystem::path directoryPath = normalizeDirectoryPath(compdbDir, dirStr);
-            std::string directoryKey = normalizePath(directoryPath);
-            if (directoryKey.empty())
-                continue;
-
-            std::filesystem::path filePath(fileStr);
-            if (filePath.is_relative())
-                filePath = directoryPath / filePath;
-            std::string fileKey = normalizePath(filePath);
-            if (fileKey.empty())
+            if (entry.fileKey.empty())
                 continue;
 
-            std::vector<std::string> args = extractArguments(*obj);
-            if (args.empty())
-                continue;
-
-            stripLeadingCommandTokens(args);
-            stripOutputAndDependencyArgs(args);
-            stripInputFileArg(args, directoryKey, fileKey);
-
-            CompileCommand command;
-            command.directory = directoryKey;
-            command.arguments = std::move(args);
-            auto it = db->commands_.find(fileKey);
+            ++db->stats_.entryCount;
+            auto it = db->commands_.find(entry.fileKey);
             if (it == db->commands_.end())
             {
-                db->commands_.emplace(fileKey, std::move(command));
+                firstSignatureByFile.emplace(entry.fileKey, std::move(entry.analysisSignature));
+                db->commands_.emplace(std::move(entry.fileKey), std::move(entry.command));
                 continue;
             }
 
-            if (shouldPreferCandidateCommand(it->second, command))
-                it->second = std::move(command);
+            ++db->stats_.collapsedEntryCount;
+            if (firstSignatureByFile[entry.fileKey] != entry.analysisSignature)
+                divergentSources.insert(entry.fileKey);
+            if (shouldPreferCandidateCommand(it->second, entry.command))
+                it->second = std::move(entry.command);
         }
+        db->stats_.divergentSources.assign(divergentSources.begin(), divergentSources.end());
+        std::sort(db->stats_.divergentSources.begin(), db->stats_.divergentSources.end());
 
         if (db->commands_.empty())
         {
@@ -400,46 +644,77 @@ namespace ctrace::stack::analysis
             return nullptr;
         }
 
+        db->buildSuffixIndex();
         return db;
     }
 
-    const CompileCommand* CompilationDatabase::findCommandForFile(const std::string& filePath) const
+    void CompilationDatabase::buildSuffixIndex()
     {
-        if (filePath.empty())
-            return nullptr;
-        std::string key = normalizePath(std::filesystem::path(filePath));
-        auto it = commands_.find(key);
-        if (it == commands_.end())
+        suffixNodes_.clear();
+        suffixNodes_.emplace_back();
+        for (const auto& entry : commands_)
         {
-            auto suffixes = buildPathSuffixes(key);
-            if (!suffixes.empty())
+            const std::vector<std::string> components = splitPathComponents(entry.first);
+            std::uint32_t node = 0;
+            for (auto it = components.rbegin(); it != components.rend(); ++it)
             {
-                // Skip the full path; we already attempted exact lookup.
-                for (std::size_t s = 1; s < suffixes.size(); ++s)
+                auto childIt = suffixNodes_[node].children.find(*it);
+                std::uint32_t child = 0;
+                if (childIt == suffixNodes_[node].children.end())
                 {
-                    const std::string& suffix = suffixes[s];
-                    const CompileCommand* match = nullptr;
-                    std::size_t matchCount = 0;
-                    for (const auto& entry : commands_)
-                    {
-                        if (pathHasSuffix(entry.first, suffix))
-                        {
-                            ++matchCount;
-                            if (matchCount == 1)
-                                match = &entry.second;
-                            else
-                                break;
-                        }
-                    }
-                    if (matchCount == 1)
-                        return match;
-                    if (matchCount > 1)
-                        break;
+                    child = static_cast<std::uint32_t>(suffixNodes_.size());
+                    suffixNodes_[node].children.emplace(*it, child);
+                    suffixNodes_.emplace_back();
                 }
+                else
+                {
+                    child = childIt->second;
+                }
+
+                SuffixNode& childNode = suffixNodes_[child];
+                ++childNode.entryCount;
+                childNode.command = childNode.entryCount == 1 ? &entry.second : nullptr;
+                node = child;
             }
+        }
+    }
+
+    const CompileCommand*
+    CompilationDatabase::findExactCommandForFile(const std::string& filePath) const
+    {
+        if (filePath.empty())
             return nullptr;
+        const auto it = commands_.find(normalizePath(std::filesystem::path(filePath)));
+        return it != commands_.end() ? &it->second : nullptr;
+    }
+
+    const CompileCommand* CompilationDatabase::findCommandForFile(const std::string& filePath) const
+    {
+        if (filePath.empty())
+            return nullptr;
+        std::string key = normalizePath(std::filesystem::path(filePath));
+        auto it = commands_.find(key);
+        if (it != commands_.end())
+            return &it->second;
+        if (suffixNodes_.empty())
+            return nullptr;
+
+        // Fall back to the longest proper component suffix shared with database entries.
+        // The match must be unique; an ambiguous longest suffix yields no command, since
+        // shorter suffixes can only match more entries.
+        const std::vector<std::string> components = splitPathComponents(key);
+        std::uint32_t node = 0;
+        for (std::size_t depth = 1; depth < components.size(); ++depth)
+        {
+            const auto& children = suffixNodes_[node].children;
+            auto childIt = children.find(components[components.size() - depth]);
+            if (childIt == children.end())
+                break;
+            node = childIt->second;
         }
-        return &it->second;
+        if (node == 0)
+            return nullptr;
+        return suffixNodes_[node].command;
     }
 
     std::vector<std::string> CompilationDatabase::listSourceFiles() const
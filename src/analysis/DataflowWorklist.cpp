@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/DataflowWorklist.hpp"
+
+#include <algorithm>
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Function.h>
+
+namespace ctrace::stack::analysis
+{
+    ForwardDataflowOrder::ForwardDataflowOrder(const llvm::Function& F)
+    {
+        if (F.empty())
+            return;
+
+        llvm::ReversePostOrderTraversal<const llvm::Function*> rpot(&F);
+        for (const llvm::BasicBlock* BB : rpot)
+        {
+            indexByBlock[BB] = static_cast<std::uint32_t>(blocks.size());
+            blocks.push_back(BB);
+        }
+
+        preds.resize(blocks.size());
+        succs.resize(blocks.size());
+        for (std::uint32_t idx = 0; idx < size(); ++idx)
+        {
+            for (const llvm::BasicBlock* succ : llvm::successors(blocks[idx]))
+            {
+                const std::uint32_t succIdx = indexOf(succ);
+                if (succIdx == kUnreachable)
+                    continue;
+                // Switches may list the same successor several times.
+                if (std::find(succs[idx].begin(), succs[idx].end(), succIdx) != succs[idx].end())
+                    continue;
+                succs[idx].push_back(succIdx);
+                preds[succIdx].push_back(idx);
+            }
+        }
+    }
+} // namespace ctrace::stack::analysis
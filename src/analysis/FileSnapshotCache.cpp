@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/FileSnapshotCache.hpp"
+
+#include <chrono>
+#include <functional>
+#include <system_error>
+#include <utility>
+
+namespace ctrace::stack::analysis
+{
+    namespace
+    {
+        static bool matches(const std::optional<FileSnapshot>& current,
+                            const FileSnapshot& expected)
+        {
+            return current && current->size == expected.size &&
+                   current->mtimeNs == expected.mtimeNs;
+        }
+    } // namespace
+
+    std::optional<FileSnapshot> statFileSnapshot(const std::filesystem::path& absolute)
+    {
+        std::error_code ec;
+        const std::filesystem::file_status status = std::filesystem::status(absolute, ec);
+        if (ec || !std::filesystem::is_regular_file(status))
+            return std::nullopt;
+
+        const auto size = std::filesystem::file_size(absolute, ec);
+        if (ec)
+            return std::nullopt;
+
+        const auto mtime = std::filesystem::last_write_time(absolute, ec);
+        if (ec)
+            return std::nullopt;
+
+        const auto mtimeNs =
+            std::chrono::time_point_cast<std::chrono::nanoseconds>(mtime).time_since_epoch().count();
+
+        FileSnapshot snapshot;
+        snapshot.path = absolute.generic_string();
+        snapshot.size = static_cast<std::uint64_t>(size);
+        snapshot.mtimeNs = static_cast<std::int64_t>(mtimeNs);
+        return snapshot;
+    }
+
+    std::optional<FileSnapshot> FileSnapshotCache::capture(const std::string& absolutePath)
+    {
+        Shard& shard = shardFor(absolutePath);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(absolutePath);
+            if (it != shard.entries.end())
+                return it->second;
+        }
+
+        std::optional<FileSnapshot> snapshot = statFileSnapshot(absolutePath);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.entries.try_emplace(absolutePath, std::move(snapshot)).first->second;
+    }
+
+    bool FileSnapshotCache::areCurrent(const std::vector<FileSnapshot>& expected)
+    {
+        std::array<std::vector<std::size_t>, kShardCount> byShard;
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            byShard[shardIndex(expected[i].path)].push_back(i);
+
+        std::vector<std::size_t> misses;
+        for (std::size_t shardIdx = 0; shardIdx < kShardCount; ++shardIdx)
+        {
+            if (byShard[shardIdx].empty())
+                continue;
+            Shard& shard = shards_[shardIdx];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (std::size_t i : byShard[shardIdx])
+            {
+                auto it = shard.entries.find(expected[i].path);
+                if (it == shard.entries.end())
+                {
+                    misses.push_back(i);
+                    continue;
+                }
+                if (!matches(it->second, expected[i]))
+                    return false;
+            }
+        }
+
+        for (std::size_t i : misses)
+        {
+            if (!matches(capture(expected[i].path), expected[i]))
+                return false;
+        }
+        return true;
+    }
+
+    std::optional<FileSnapshot> FileSnapshotCache::refresh(const std::string& absolutePath)
+    {
+        std::optional<FileSnapshot> snapshot = statFileSnapshot(absolutePath);
+        Shard& shard = shardFor(absolutePath);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.insert_or_assign(absolutePath, snapshot);
+        return snapshot;
+    }
+
+    void FileSnapshotCache::clear()
+    {
+        for (Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+    }
+
+    std::size_t FileSnapshotCache::shardIndex(const std::string& path)
+    {
+        return std::hash<std::string>{}(path) % kShardCount;
+    }
+} // namespace ctrace::stack::analysis
@@ -0,0 +1,378 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/FrameSizeTable.hpp"
+
+#include "analysis/AnalyzerUtils.hpp"
+#include "analysis/CompileCommands.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+
+namespace ctrace::stack::analysis
+{
+    namespace
+    {
+        template <typename T> static bool parseNumber(std::string_view text, T& out)
+        {
+            if (text.empty())
+                return false;
+            const char* end = text.data() + text.size();
+            auto [ptr, ec] = std::from_chars(text.data(), end, out);
+            return ec == std::errc() && ptr == end;
+        }
+
+        static std::string basenameOf(std::string_view path)
+        {
+            const std::size_t slash = path.find_last_of("/\\");
+            if (slash == std::string_view::npos)
+                return std::string(path);
+            return std::string(path.substr(slash + 1));
+        }
+
+        // a.su and a.c.su were both written for a.c.
+        static bool originMatchesSource(const std::string& originStem,
+                                        const std::string& sourceBasename)
+        {
+            return originStem == sourceBasename ||
+                   originStem == std::filesystem::path(sourceBasename).stem().string();
+        }
+
+        static std::string locationKey(std::string_view file, unsigned line)
+        {
+            return std::string(file) + ":" + std::to_string(line);
+        }
+
+        // "static", "dynamic" or "dynamic,bounded".
+        static void parseQualifiers(std::string_view text, FrameSizeEntry& entry)
+        {
+            entry.dynamic = text.find("dynamic") != std::string_view::npos;
+            entry.bounded = text.find("bounded") != std::string_view::npos;
+        }
+
+        // Value of `key: "..."` on a VCG line, escapes left as written.
+        static std::string_view quotedField(std::string_view text, std::string_view key)
+        {
+            const std::size_t keyPos = text.find(key);
+            if (keyPos == std::string_view::npos)
+                return {};
+            const std::size_t open = text.find('"', keyPos + key.size());
+            if (open == std::string_view::npos)
+                return {};
+            for (std::size_t i = open + 1; i < text.size(); ++i)
+            {
+                if (text[i] == '\\')
+                    ++i;
+                else if (text[i] == '"')
+                    return text.substr(open + 1, i - open - 1);
+            }
+            return {};
+        }
+
+        static bool hasFrameSizeExtension(const std::filesystem::path& path)
+        {
+            const std::filesystem::path ext = path.extension();
+            return ext == ".su" || ext == ".ci";
+        }
+
+        // Clang driver flags spelled with a leading "-o" that are not -o<path>.
+        static bool isOPrefixedDriverFlag(std::string_view arg)
+        {
+            return arg.starts_with("-objc") || arg == "-object";
+        }
+    } // namespace
+
+    bool splitLocation(std::string_view text, std::string_view& file, unsigned& line,
+                       std::string_view& rest)
+    {
+        for (std::size_t colon = text.find(':'); colon != std::string_view::npos;
+             colon = text.find(':', colon + 1))
+        {
+            std::size_t digitsEnd = colon + 1;
+            while (digitsEnd < text.size() && text[digitsEnd] >= '0' && text[digitsEnd] <= '9')
+                ++digitsEnd;
+            if (digitsEnd == colon + 1 || (digitsEnd < text.size() && text[digitsEnd] != ':'))
+                continue;
+            if (colon == 0 || !parseNumber(text.substr(colon + 1, digitsEnd - colon - 1), line))
+                return false;
+
+            file = text.substr(0, colon);
+            rest = digitsEnd < text.size() ? text.substr(digitsEnd + 1) : std::string_view{};
+            std::size_t columnEnd = 0;
+            while (columnEnd < rest.size() && rest[columnEnd] >= '0' && rest[columnEnd] <= '9')
+                ++columnEnd;
+            if (columnEnd > 0 && columnEnd < rest.size() && rest[columnEnd] == ':')
+                rest.remove_prefix(columnEnd + 1);
+            else if (columnEnd == rest.size())
+                rest = {};
+            return true;
+        }
+        return false;
+    }
+
+    bool parseStackUsageLine(std::string_view text, FrameSizeEntry& entry)
+    {
+        const std::size_t qualifierTab = text.rfind('\t');
+        if (qualifierTab == std::string_view::npos || qualifierTab == 0)
+            return false;
+        const std::size_t sizeTab = text.rfind('\t', qualifierTab - 1);
+        if (sizeTab == std::string_view::npos)
+            return false;
+
+        if (!parseNumber(text.substr(sizeTab + 1, qualifierTab - sizeTab - 1), entry.bytes))
+            return false;
+        parseQualifiers(text.substr(qualifierTab + 1), entry);
+
+        std::string_view head = text.substr(0, sizeTab);
+        std::string_view file;
+        std::string_view name = head;
+        if (splitLocation(head, file, entry.line, name))
+            entry.file = basenameOf(file);
+        if (name.empty())
+            return false;
+        entry.name = std::string(name);
+        return true;
+    }
+
+    bool parseCallGraphInfoNode(std::string_view text, FrameSizeEntry& entry)
+    {
+        const std::string_view title = quotedField(text, "title:");
+        const std::string_view label = quotedField(text, "label:");
+        if (title.empty() || label.empty())
+            return false;
+
+        bool haveSize = false;
+        std::size_t fieldIndex = 0;
+        std::size_t begin = 0;
+        while (begin <= label.size())
+        {
+            std::size_t end = label.find("\\n", begin);
+            if (end == std::string_view::npos)
+                end = label.size();
+            const std::string_view field = label.substr(begin, end - begin);
+
+            std::string_view file;
+            std::string_view rest;
+            if (fieldIndex == 1 && splitLocation(field, file, entry.line, rest))
+                entry.file = basenameOf(file);
+
+            const std::size_t bytesPos = field.find(" bytes (");
+            if (!haveSize && bytesPos != std::string_view::npos &&
+                parseNumber(field.substr(0, bytesPos), entry.bytes))
+            {
+                parseQualifiers(field.substr(bytesPos), entry);
+                haveSize = true;
+            }
+
+            ++fieldIndex;
+            begin = end + 2;
+        }
+
+        if (!haveSize)
+            return false;
+        entry.name = std::string(title);
+        return true;
+    }
+
+    bool FrameSizeTable::addFile(const std::string& path, std::string& error)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            error = "cannot open stack usage file: " + path;
+            return false;
+        }
+
+        // --stack-usage and --stack-usage-from-compdb may name the same file.
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+        if (ec)
+            canonical = std::filesystem::path(path).lexically_normal();
+        const auto [originIt, inserted] = originByPath_.try_emplace(
+            canonical.generic_string(), static_cast<std::uint32_t>(originStems_.size()));
+        if (!inserted)
+            return true;
+        originStems_.push_back(canonical.stem().string());
+        const std::uint32_t origin = originIt->second;
+
+        const bool callGraphInfo = std::filesystem::path(path).extension() == ".ci";
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            FrameSizeEntry entry;
+            entry.origin = origin;
+            if (callGraphInfo)
+            {
+                const std::size_t start = line.find_first_not_of(" \t");
+                if (start == std::string::npos || line.compare(start, 5, "node:") != 0)
+                    continue;
+                if (parseCallGraphInfoNode(line, entry))
+                    addEntry(std::move(entry));
+            }
+            else if (parseStackUsageLine(line, entry))
+            {
+                addEntry(std::move(entry));
+            }
+        }
+
+        ++fileCount_;
+        return true;
+    }
+
+    void FrameSizeTable::addEntry(FrameSizeEntry entry)
+    {
+        const auto index = static_cast<std::uint32_t>(entries_.size());
+        byName_[entry.name].push_back(index);
+        if (!entry.file.empty() && entry.line != 0)
+            byLocation_[locationKey(entry.file, entry.line)].push_back(index);
+        entries_.push_back(std::move(entry));
+    }
+
+    const FrameSizeEntry* FrameSizeTable::find(std::string_view symbol,
+                                               std::string_view sourcePath, unsigned line) const
+    {
+        const std::string file = basenameOf(sourcePath);
+        const FrameSizeEntry* best = nullptr;
+        auto consider = [this, &best](std::uint32_t index)
+        {
+            const FrameSizeEntry& entry = entries_[index];
+            if (!best || entry.bytes > best->bytes)
+                best = &entry;
+        };
+
+        if (auto it = byName_.find(std::string(symbol)); it != byName_.end())
+        {
+            // Same-named local functions of different files must not alias.
+            const FrameSizeEntry* unattributed = nullptr;
+            bool ambiguous = false;
+            for (std::uint32_t index : it->second)
+            {
+                const FrameSizeEntry& entry = entries_[index];
+                if (!entry.file.empty())
+                {
+                    if (file.empty() || entry.file == file)
+                        consider(index);
+                    continue;
+                }
+                if (!file.empty() && originMatchesSource(originStems_[entry.origin], file))
+                {
+                    consider(index);
+                    continue;
+                }
+                ambiguous = ambiguous || (unattributed && unattributed->origin != entry.origin);
+                if (!unattributed || entry.bytes > unattributed->bytes)
+                    unattributed = &entry;
+            }
+            if (!best && !ambiguous)
+                best = unattributed;
+        }
+        if (best || file.empty() || line == 0)
+            return best;
+
+        if (auto it = byLocation_.find(locationKey(file, line)); it != byLocation_.end())
+        {
+            for (std::uint32_t index : it->second)
+                consider(index);
+        }
+        return best;
+    }
+
+    bool collectFrameSizeFiles(const std::string& path, std::vector<std::string>& out,
+                               std::string& error)
+    {
+        std::error_code ec;
+        const std::filesystem::file_status status = std::filesystem::status(path, ec);
+        if (ec || !std::filesystem::exists(status))
+        {
+            error = "stack usage path not found: " + path;
+            return false;
+        }
+        if (!std::filesystem::is_directory(status))
+        {
+            out.push_back(path);
+            return true;
+        }
+
+        std::vector<std::string> found;
+        const auto options = std::filesystem::directory_options::skip_permission_denied;
+        for (std::filesystem::recursive_directory_iterator it(path, options, ec), end;
+             !ec && it != end; it.increment(ec))
+        {
+            if (it->is_regular_file(ec) && hasFrameSizeExtension(it->path()))
+                found.push_back(it->path().string());
+        }
+        if (ec)
+        {
+            error = "cannot scan stack usage directory " + path + ": " + ec.message();
+            return false;
+        }
+
+        std::sort(found.begin(), found.end());
+        out.insert(out.end(), found.begin(), found.end());
+        return true;
+    }
+
+    std::vector<std::string> frameSizeFilesForCommand(const CompileCommand& command,
+                                                      const std::string& sourceFile)
+    {
+        std::string output;
+        const std::vector<std::string>& args = command.arguments;
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            const std::string_view arg = args[i];
+            if ((arg == "-o" || arg == "--output") && i + 1 < args.size())
+                output = args[++i];
+            else if (arg.starts_with("--output="))
+                output = arg.substr(9);
+            else if (arg.size() > 2 && arg.starts_with("-o") && !isOPrefixedDriverFlag(arg))
+                output = arg.substr(2);
+        }
+
+        std::filesystem::path base;
+        if (!output.empty())
+            base = output;
+        else
+            base = std::filesystem::path(sourceFile).filename();
+        if (base.is_relative() && !command.directory.empty())
+            base = std::filesystem::path(command.directory) / base;
+
+        std::vector<std::string> files;
+        for (const char* extension : {".su", ".ci"})
+        {
+            std::filesystem::path candidate = base;
+            candidate.replace_extension(extension);
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(candidate, ec))
+                files.push_back(candidate.string());
+        }
+        return files;
+    }
+
+    bool applyMeasuredFrameSize(const FrameSizeTable& table, const llvm::Function& F,
+                                LocalStackInfo& info)
+    {
+        std::string sourcePath;
+        unsigned line = 0;
+        if (const llvm::DISubprogram* subprogram = F.getSubprogram())
+        {
+            sourcePath = getFunctionSourcePath(F);
+            line = subprogram->getLine();
+        }
+
+        const FrameSizeEntry* entry = table.find(F.getName(), sourcePath, line);
+        if (!entry)
+            return false;
+
+        info.bytes = entry->bytes;
+        info.unknown = entry->dynamic && !entry->bounded;
+        return true;
+    }
+} // namespace ctrace::stack::analysis
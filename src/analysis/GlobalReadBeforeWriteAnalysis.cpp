@@ -286,27 +286,28 @@ namespace ctrace::stack::analysis
         return out;
     }
 
+    bool mergeGlobalReadBeforeWriteSummaryEntry(GlobalReadBeforeWriteSummaryIndex& dst,
+                                                const std::string& name,
+                                                const GlobalReadBeforeWriteGlobalSummary& incoming)
+    {
+        auto [it, inserted] = dst.globals.try_emplace(name, incoming);
+        if (inserted)
+            return true;
+
+        GlobalReadBeforeWriteGlobalSummary& merged = it->second;
+        const bool beforeTracked = merged.zeroInitializedArray;
+        const bool beforeWrite = merged.hasAnyWrite;
+        merged.zeroInitializedArray |= incoming.zeroInitializedArray;
+        merged.hasAnyWrite |= incoming.hasAnyWrite;
+        return merged.zeroInitializedArray != beforeTracked || merged.hasAnyWrite != beforeWrite;
+    }
+
     bool mergeGlobalReadBeforeWriteSummaryIndex(GlobalReadBeforeWriteSummaryIndex& dst,
                                                 const GlobalReadBeforeWriteSummaryIndex& src)
     {
         bool changed = false;
         for (const auto& entry : src.globals)
-        {
-            auto [it, inserted] = dst.globals.try_emplace(entry.first, entry.second);
-            if (inserted)
-            {
-                changed = true;
-                continue;
-            }
-
-            GlobalReadBeforeWriteGlobalSummary& merged = it->second;
-            const bool beforeTracked = merged.zeroInitializedArray;
-            const bool beforeWrite = merged.hasAnyWrite;
-            merged.zeroInitializedArray |= entry.second.zeroInitializedArray;
-            merged.hasAnyWrite |= entry.second.hasAnyWrite;
-            if (merged.zeroInitializedArray != beforeTracked || merged.hasAnyWrite != beforeWrite)
-                changed = true;
-        }
+            changed |= mergeGlobalReadBeforeWriteSummaryEntry(dst, entry.first, entry.second);
         return changed;
     }
 
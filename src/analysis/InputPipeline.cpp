@@ -1,20 +1,24 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "analysis/InputPipeline.hpp"
 #include "analysis/CompileCommands.hpp"
+#include "analysis/FileSnapshotCache.hpp"
 #include "analysis/FrontendDiagnostics.hpp"
 #include "analyzer/HotspotProfiler.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <optional>
 #include <sstream>
 #include <system_error>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -28,6 +32,7 @@
 #include <llvm/Support/JSON.h>
 #include <llvm/Support/MD5.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Process.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -195,13 +200,6 @@ namespace ctrace::stack::analysis
 
         constexpr llvm::StringLiteral kCompileIRCacheSchema = "compile-ir-cache-v2";
 
-        struct FileSnapshot
-        {
-            std::string path;
-            std::uint64_t size = 0;
-            std::int64_t mtimeNs = 0;
-        };
-
         struct CompileIRCachePaths
         {
             std::filesystem::path directory;
@@ -244,47 +242,31 @@ namespace ctrace::stack::analysis
             return absPath.lexically_normal().generic_string();
         }
 
-        static std::optional<FileSnapshot> captureFileSnapshot(const std::string& path)
+        // Process-wide, so each dependency is stat'ed once per run.
+        FileSnapshotCache& fileSnapshotCache()
+        {
+            static FileSnapshotCache cache;
+            return cache;
+        }
+
+        static std::string absoluteSnapshotPath(const std::string& path)
         {
             if (path.empty())
-                return std::nullopt;
+                return {};
 
             std::error_code ec;
             std::filesystem::path absolute = std::filesystem::absolute(path, ec);
             if (ec)
-                return std::nullopt;
-            absolute = absolute.lexically_normal();
-
-            if (!std::filesystem::exists(absolute, ec) || ec)
-                return std::nullopt;
-            if (!std::filesystem::is_regular_file(absolute, ec) || ec)
-                return std::nullopt;
-
-            const auto size = std::filesystem::file_size(absolute, ec);
-            if (ec)
-                return std::nullopt;
-
-            const auto mtime = std::filesystem::last_write_time(absolute, ec);
-            if (ec)
-                return std::nullopt;
-
-            const auto mtimeNs = std::chrono::time_point_cast<std::chrono::nanoseconds>(mtime)
-                                     .time_since_epoch()
-                                     .count();
-
-            FileSnapshot snapshot;
-            snapshot.path = absolute.generic_string();
-            snapshot.size = static_cast<std::uint64_t>(size);
-            snapshot.mtimeNs = static_cast<std::int64_t>(mtimeNs);
-            return snapshot;
+                return {};
+            return absolute.lexically_normal().generic_string();
         }
 
-        static bool isSnapshotCurrent(const FileSnapshot& expected)
+        static std::optional<FileSnapshot> captureFileSnapshot(const std::string& path)
         {
-            const auto current = captureFileSnapshot(expected.path);
-            if (!current)
-                return false;
-            return current->size == expected.size && current->mtimeNs == expected.mtimeNs;
+            const std::string absolute = absoluteSnapshotPath(path);
+            if (absolute.empty())
+                return std::nullopt;
+            return fileSnapshotCache().capture(absolute);
         }
 
         static llvm::json::Object encodeSnapshot(const FileSnapshot& snapshot)
@@ -489,19 +471,25 @@ namespace ctrace::stack::analysis
             const auto* sourceValue = root->get("source");
             if (!sourceValue)
                 return std::nullopt;
-            const auto sourceSnapshot = decodeSnapshot(*sourceValue);
-            if (!sourceSnapshot || !isSnapshotCurrent(*sourceSnapshot))
+            auto sourceSnapshot = decodeSnapshot(*sourceValue);
+            if (!sourceSnapshot)
                 return std::nullopt;
 
             const auto* depsArray = root->getArray("dependencies");
             if (!depsArray)
                 return std::nullopt;
+            std::vector<FileSnapshot> expectedSnapshots;
+            expectedSnapshots.reserve(depsArray->size() + 1);
+            expectedSnapshots.push_back(std::move(*sourceSnapshot));
             for (const auto& depValue : *depsArray)
             {
-                const auto depSnapshot = decodeSnapshot(depValue);
-                if (!depSnapshot || !isSnapshotCurrent(*depSnapshot))
+                auto depSnapshot = decodeSnapshot(depValue);
+                if (!depSnapshot)
                     return std::nullopt;
+                expectedSnapshots.push_back(std::move(*depSnapshot));
             }
+            if (!fileSnapshotCache().areCurrent(expectedSnapshots))
+                return std::nullopt;
 
             std::string llvmBitcode;
             (void)readTextFile(cachePaths.bcFile, llvmBitcode);
@@ -582,6 +570,349 @@ namespace ctrace::stack::analysis
             args.push_back("coretrace_compile_ir_cache_target");
         }
 
+        constexpr llvm::StringLiteral kPrecompiledHeaderSchema = "compile-pch-v1";
+
+        // Leading `#include <...>` lines of a source file, before any other directive or code.
+        // Quoted includes end the prefix: they resolve relative to the including file, which
+        // a header generated in the cache directory cannot reproduce.
+        static std::vector<std::string> scanLeadingSystemIncludes(const std::string& sourcePath)
+        {
+            std::vector<std::string> includes;
+            std::string text;
+            if (!readTextFile(sourcePath, text))
+                return includes;
+
+            std::size_t pos = 0;
+            if (text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+                pos = 3;
+            bool inBlockComment = false;
+            while (pos < text.size())
+            {
+                std::size_t lineEnd = text.find('\n', pos);
+                if (lineEnd == std::string::npos)
+                    lineEnd = text.size();
+                std::string_view line(text.data() + pos, lineEnd - pos);
+                pos = lineEnd + 1;
+
+                std::size_t i = 0;
+                auto skipSpaces = [&]()
+                {
+                    while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i])))
+                        ++i;
+                };
+
+                bool lineHasInclude = false;
+                while (true)
+                {
+                    if (inBlockComment)
+                    {
+                        const std::size_t close = line.find("*/", i);
+                        if (close == std::string_view::npos)
+                        {
+                            i = line.size();
+                            break;
+                        }
+                        inBlockComment = false;
+                        i = close + 2;
+                    }
+                    skipSpaces();
+                    if (line.substr(i, 2) == "/*")
+                    {
+                        inBlockComment = true;
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                if (i >= line.size() || line.substr(i, 2) == "//")
+                    continue;
+                if (line[i] != '#')
+                    return includes;
+
+                ++i;
+                skipSpaces();
+                if (line.substr(i, 7) != "include" || line.size() <= i + 7 ||
+                    !(std::isspace(static_cast<unsigned char>(line[i + 7])) || line[i + 7] == '<'))
+                {
+                    return includes;
+                }
+                i += 7;
+                skipSpaces();
+                if (i < line.size() && line[i] == '<')
+                {
+                    const std::size_t close = line.find('>', i);
+                    if (close != std::string_view::npos)
+                    {
+                        includes.emplace_back(line.substr(i, close - i + 1));
+                        lineHasInclude = true;
+                        i = close + 1;
+                        skipSpaces();
+                        if (i < line.size() && line.substr(i, 2) != "//")
+                            return includes;
+                    }
+                }
+                if (!lineHasInclude)
+                    return includes;
+            }
+            return includes;
+        }
+
+        struct PrecompiledHeaderCluster
+        {
+            std::mutex mutex;
+            std::string pchPath;
+            std::uint32_t requestCount = 0;
+            std::uint32_t buildAttempted : 1 = false;
+            std::uint32_t reservedFlags : 31 = 0;
+        };
+
+        // Clusters are keyed by identical compile flags + identical leading system include
+        // sequence. The first member of a cluster seen in a run compiles normally; the PCH is
+        // built when a second member shows up, then reused by later members and later runs.
+        class PrecompiledHeaderRegistry
+        {
+          public:
+            PrecompiledHeaderCluster& cluster(const std::string& key)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::unique_ptr<PrecompiledHeaderCluster>& slot = clusters_[key];
+                if (!slot)
+                    slot = std::make_unique<PrecompiledHeaderCluster>();
+                return *slot;
+            }
+
+          private:
+            std::mutex mutex_;
+            std::unordered_map<std::string, std::unique_ptr<PrecompiledHeaderCluster>> clusters_;
+        };
+
+        PrecompiledHeaderRegistry& precompiledHeaderRegistry()
+        {
+            static PrecompiledHeaderRegistry registry;
+            return registry;
+        }
+
+        using PchCompileFn = std::function<std::optional<compilerlib::CompileResult>(
+            const std::vector<std::string>&)>;
+
+        static bool isPrecompiledHeaderCurrent(const std::filesystem::path& metaFile)
+        {
+            std::string metadataText;
+            if (!readTextFile(metaFile, metadataText))
+                return false;
+            auto parsed = llvm::json::parse(metadataText);
+            if (!parsed)
+                return false;
+            const auto* root = parsed->getAsObject();
+            if (!root)
+                return false;
+            const auto schema = root->getString("schema");
+            if (!schema || *schema != kPrecompiledHeaderSchema)
+                return false;
+            const auto* depsArray = root->getArray("dependencies");
+            if (!depsArray || depsArray->empty())
+                return false;
+
+            std::vector<FileSnapshot> expected;
+            expected.reserve(depsArray->size());
+            for (const auto& depValue : *depsArray)
+            {
+                auto snapshot = decodeSnapshot(depValue);
+                if (!snapshot)
+                    return false;
+                expected.push_back(std::move(*snapshot));
+            }
+            return fileSnapshotCache().areCurrent(expected);
+        }
+
+        static bool buildPrecompiledHeader(const std::vector<std::string>& compileArgs,
+                                           LanguageType language,
+                                           const std::vector<std::string>& includes,
+                                           const std::filesystem::path& headerFile,
+                                           const std::filesystem::path& pchFile,
+                                           const std::filesystem::path& metaFile,
+                                           const std::string& workingDir,
+                                           const PchCompileFn& compile)
+        {
+            std::string headerText;
+            for (const std::string& include : includes)
+                headerText += "#include " + include + "\n";
+            if (!writeTextFile(headerFile, headerText))
+                return false;
+
+            // Compile beside the final path and rename into place, so a concurrent run never
+            // loads a half-written PCH.
+            const std::filesystem::path tempPchFile =
+                pchFile.string() + "." + std::to_string(llvm::sys::Process::getProcessId()) +
+                ".tmp";
+            const std::filesystem::path depFile = tempPchFile.string() + ".d";
+            std::vector<std::string> args(compileArgs.begin(), compileArgs.end() - 1);
+            args.erase(std::remove_if(args.begin(), args.end(),
+                                      [](const std::string& arg)
+                                      { return arg == "-emit-llvm" || arg == "-S" || arg == "-c"; }),
+                       args.end());
+            removeOutputPathArgs(args);
+            args.push_back("-MD");
+            args.push_back("-MF");
+            args.push_back(depFile.string());
+            args.push_back("-MT");
+            args.push_back("coretrace_compile_pch_target");
+            args.push_back("-x");
+            args.push_back(language == LanguageType::CXX ? "c++-header" : "c-header");
+            args.push_back(headerFile.string());
+            args.push_back("-o");
+            args.push_back(tempPchFile.string());
+
+            std::error_code removeErr;
+            const auto res = compile(args);
+            const auto dependencies = (res && res->success)
+                                          ? parseDepfileDependencies(depFile, workingDir)
+                                          : std::nullopt;
+            std::filesystem::remove(depFile, removeErr);
+            const auto dependencySnapshots =
+                dependencies ? buildDependencySnapshots(*dependencies) : std::nullopt;
+            if (!dependencySnapshots)
+            {
+                std::filesystem::remove(tempPchFile, removeErr);
+                return false;
+            }
+            std::error_code renameErr;
+            std::filesystem::rename(tempPchFile, pchFile, renameErr);
+            if (renameErr)
+            {
+                std::filesystem::remove(tempPchFile, removeErr);
+                return false;
+            }
+
+            llvm::json::Array dependenciesArray;
+            for (const FileSnapshot& dependency : *dependencySnapshots)
+                dependenciesArray.push_back(encodeSnapshot(dependency));
+            for (const std::filesystem::path& produced : {headerFile, pchFile})
+            {
+                const auto snapshot =
+                    fileSnapshotCache().refresh(absoluteSnapshotPath(produced.string()));
+                if (!snapshot)
+                    return false;
+                dependenciesArray.push_back(encodeSnapshot(*snapshot));
+            }
+
+            llvm::json::Object root;
+            root["schema"] = kPrecompiledHeaderSchema;
+            root["dependencies"] = std::move(dependenciesArray);
+            std::string metadataText;
+            llvm::raw_string_ostream metadataStream(metadataText);
+            metadataStream << llvm::formatv("{0:2}", llvm::json::Value(std::move(root)));
+            metadataStream.flush();
+            return writeTextFile(metaFile, metadataText);
+        }
+
+        // Returns the PCH to inject for this TU, or an empty string when the TU should be
+        // compiled without one. `compileArgs` must end with the input file.
+        static std::string acquirePrecompiledHeader(const AnalysisConfig& config,
+                                                    const std::string& filename,
+                                                    LanguageType language,
+                                                    const std::vector<std::string>& compileArgs,
+                                                    const std::string& workingDir,
+                                                    const PchCompileFn& compile)
+        {
+            using ctrace::stack::analyzer::ScopedHotspot;
+            if (!config.compilePCH || config.compileIRCacheDir.empty() || compileArgs.empty())
+                return {};
+            if (language != LanguageType::C && language != LanguageType::CXX)
+                return {};
+
+            const std::vector<std::string> includes =
+                scanLeadingSystemIncludes(makeAbsolutePathFrom(filename, workingDir));
+            if (includes.empty())
+                return {};
+
+            std::ostringstream keyPayload;
+            keyPayload << std::string(kPrecompiledHeaderSchema) << "\n";
+            keyPayload << "language:" << static_cast<int>(language) << "\n";
+            keyPayload << "workingDir:" << makeAbsolutePathFrom(workingDir, "") << "\n";
+            for (std::size_t i = 0; i + 1 < compileArgs.size(); ++i)
+                keyPayload << "arg:" << compileArgs[i] << "\n";
+            for (const std::string& include : includes)
+                keyPayload << "include:" << include << "\n";
+            const std::string key = md5Hex(keyPayload.str());
+
+            const std::filesystem::path directory =
+                std::filesystem::path(makeAbsolutePathFrom(config.compileIRCacheDir, "")) / "pch";
+            const std::filesystem::path headerFile = directory / (key + ".h");
+            const std::filesystem::path pchFile = directory / (key + ".pch");
+            const std::filesystem::path metaFile = directory / (key + ".json");
+
+            PrecompiledHeaderCluster& cluster = precompiledHeaderRegistry().cluster(key);
+            std::lock_guard<std::mutex> lock(cluster.mutex);
+            ++cluster.requestCount;
+            if (!cluster.pchPath.empty())
+                return cluster.pchPath;
+            if (cluster.buildAttempted)
+                return {};
+
+            {
+                const ScopedHotspot hotspot(config.timing, "input.pch.lookup");
+                if (isPrecompiledHeaderCurrent(metaFile))
+                {
+                    cluster.pchPath = pchFile.string();
+                    return cluster.pchPath;
+                }
+            }
+            if (cluster.requestCount < 2)
+                return {};
+
+            cluster.buildAttempted = true;
+            if (!ensureDirectoryExists(directory))
+                return {};
+            const ScopedHotspot hotspot(config.timing, "input.pch.build");
+            if (!buildPrecompiledHeader(compileArgs, language, includes, headerFile, pchFile,
+                                        metaFile, workingDir, compile))
+            {
+                coretrace::log(coretrace::Level::Warn,
+                               "Precompiled header build failed for {}; compiling without\n",
+                               filename);
+                return {};
+            }
+            if (config.timing)
+            {
+                coretrace::log(coretrace::Level::Info,
+                               "Built precompiled header ({} leading include(s)) for {}\n",
+                               includes.size(), filename);
+            }
+            cluster.pchPath = pchFile.string();
+            return cluster.pchPath;
+        }
+
+        // Drops a PCH the compiler rejected although its metadata looked current, so neither
+        // later TUs of this run nor later runs load it again.
+        static void discardPrecompiledHeader(const std::string& pchPath)
+        {
+            const std::filesystem::path pchFile(pchPath);
+            PrecompiledHeaderCluster& cluster =
+                precompiledHeaderRegistry().cluster(pchFile.stem().string());
+            {
+                std::lock_guard<std::mutex> lock(cluster.mutex);
+                if (cluster.pchPath != pchPath)
+                    return;
+                cluster.pchPath.clear();
+            }
+            std::filesystem::path metaFile = pchFile;
+            metaFile.replace_extension(".json");
+            std::error_code removeErr;
+            std::filesystem::remove(metaFile, removeErr);
+            std::filesystem::remove(pchFile, removeErr);
+        }
+
+        static std::vector<std::string> withPrecompiledHeader(std::vector<std::string> args,
+                                                              const std::string& pchPath)
+        {
+            if (pchPath.empty())
+                return args;
+            args.push_back("-include-pch");
+            args.push_back(pchPath);
+            return args;
+        }
+
         static bool resolveDumpIRPath(const AnalysisConfig& config, const std::string& inputPath,
                                       const std::filesystem::path& baseDir,
                                       std::filesystem::path& outPath, std::string& error)
@@ -807,6 +1138,11 @@ namespace ctrace::stack::analysis
         return detectFromExtension(path);
     }
 
+    void resetFileSnapshotCache()
+    {
+        fileSnapshotCache().clear();
+    }
+
     ModuleLoadResult loadModuleForAnalysis(const std::string& filename,
                                            const AnalysisConfig& config, llvm::LLVMContext& ctx,
                                            llvm::SMDiagnostic& err)
@@ -1045,16 +1381,44 @@ namespace ctrace::stack::analysis
             {
                 std::error_code removeErr;
                 std::filesystem::remove(cachePaths.depFile, removeErr);
+                const std::string pchPath = acquirePrecompiledHeader(
+                    config, filename, result.language, args, workingDir,
+                    [&](const std::vector<std::string>& pchArgs)
+                    {
+                        bool retriedForPch = false;
+                        return compileWithConfiguredWorkingDir(
+                            pchArgs, compilerlib::OutputMode::ToFile, retriedForPch);
+                    });
                 std::vector<std::string> cacheCompileArgs =
                     preferBitcodeCompile ? bitcodeArgs : args;
                 appendDependencyCaptureArgs(cacheCompileArgs, cachePaths.depFile);
 
                 bool retriedForDependencyCompile = false;
-                res = compileWithConfiguredWorkingDir(cacheCompileArgs,
-                                                      preferBitcodeCompile
-                                                          ? compilerlib::OutputMode::ToFile
-                                                          : compilerlib::OutputMode::ToMemory,
-                                                      retriedForDependencyCompile);
+                const compilerlib::OutputMode cacheOutputMode =
+                    preferBitcodeCompile ? compilerlib::OutputMode::ToFile
+                                         : compilerlib::OutputMode::ToMemory;
+                if (!pchPath.empty())
+                {
+                    res = compileWithConfiguredWorkingDir(
+                        withPrecompiledHeader(cacheCompileArgs, pchPath), cacheOutputMode,
+                        retriedForDependencyCompile);
+                    if (!res || !res->success)
+                    {
+                        coretrace::log(coretrace::Level::Warn,
+                                       "Compilation with precompiled header failed for {}; "
+                                       "retrying without\n",
+                                       filename);
+                    }
+                }
+                if (pchPath.empty() || !res || !res->success)
+                {
+                    std::filesystem::remove(cachePaths.depFile, removeErr);
+                    res = compileWithConfiguredWorkingDir(cacheCompileArgs, cacheOutputMode,
+                                                          retriedForDependencyCompile);
+                    // The TU compiles on its own, so the PCH was what the compiler rejected.
+                    if (!pchPath.empty() && res && res->success)
+                        discardPrecompiledHeader(pchPath);
+                }
                 retriedWithWorkingDir = retriedForDependencyCompile;
 
                 if (preferBitcodeCompile && (!res || !res->success))
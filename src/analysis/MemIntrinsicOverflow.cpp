@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "analysis/MemIntrinsicOverflow.hpp"
 #include "analysis/BufferWriteModel.hpp"
+#include "analysis/ModelRegistry.hpp"
 
 #include <iostream>
+#include <memory>
 #include <optional>
 
 #include <llvm/IR/Constants.h>
@@ -253,21 +255,17 @@ namespace ctrace::stack::analysis
                                  const std::function<bool(const llvm::Function&)>& shouldAnalyze,
                                  const std::string& bufferModelPath)
     {
-        BufferWriteModel externalModel;
+        std::shared_ptr<const BufferWriteModel> externalModel;
         BufferWriteRuleMatcher ruleMatcher;
-        const BufferWriteModel* externalModelPtr = nullptr;
         if (!bufferModelPath.empty())
         {
             std::string parseError;
-            if (!parseBufferWriteModel(bufferModelPath, externalModel, parseError))
-            {
+            externalModel = ModelRegistry<BufferWriteModel>::instance().load(
+                bufferModelPath, &parseBufferWriteModel, parseError);
+            if (!externalModel)
                 std::cerr << "Buffer model load error: " << parseError << "\n";
-            }
-            else
-            {
-                externalModelPtr = &externalModel;
-            }
         }
+        const BufferWriteModel* externalModelPtr = externalModel.get();
 
         std::vector<MemIntrinsicIssue> issues;
         for (llvm::Function& F : mod)
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/ModelRegistry.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MD5.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace ctrace::stack::analysis
+{
+    ModelFileStamp statModelFile(const std::string& path)
+    {
+        ModelFileStamp stamp;
+        std::error_code ec;
+        const std::filesystem::path filePath(path);
+        if (!std::filesystem::is_regular_file(filePath, ec) || ec)
+            return stamp;
+        const std::uintmax_t size = std::filesystem::file_size(filePath, ec);
+        if (ec)
+            return stamp;
+        const auto modified = std::filesystem::last_write_time(filePath, ec);
+        if (ec)
+            return stamp;
+        stamp.size = static_cast<std::uint64_t>(size);
+        stamp.modifiedTicks = static_cast<std::int64_t>(modified.time_since_epoch().count());
+        stamp.exists = true;
+        return stamp;
+    }
+
+    std::string hashModelFileContent(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return {};
+        const std::string content((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+        llvm::MD5 hasher;
+        hasher.update(content);
+        llvm::MD5::MD5Result digest;
+        hasher.final(digest);
+        llvm::SmallString<32> hex;
+        llvm::MD5::stringifyResult(digest, hex);
+        return std::string(hex.str());
+    }
+} // namespace ctrace::stack::analysis
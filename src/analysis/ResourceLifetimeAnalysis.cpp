@@ -5,22 +5,29 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdint>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/Analysis/CFG.h>
 #include <llvm/Analysis/CaptureTracking.h>
 #include <llvm/Analysis/ValueTracking.h>
 #include <llvm/IR/Argument.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/Instructions.h>
@@ -31,6 +38,8 @@
 #include <coretrace/logger.hpp>
 
 #include "analysis/IRValueUtils.hpp"
+#include "analysis/ModelRegistry.hpp"
+#include "analysis/StronglyConnectedComponents.hpp"
 #include "mangle.hpp"
 
 namespace ctrace::stack::analysis
@@ -81,9 +90,20 @@ namespace ctrace::stack::analysis
             RuleAction action = RuleAction::AcquireOut;
         };
 
+        struct GlobRuleEntry
+        {
+            std::string literalPrefix;
+            std::uint32_t ruleIndex = 0;
+            std::uint32_t reserved = 0;
+        };
+
         struct ResourceModel
         {
             std::vector<ResourceRule> rules;
+            // Filled by compileResourceModel(): exact patterns are hashed, glob
+            // patterns keep their literal prefix as a cheap pre-filter.
+            std::unordered_map<std::string, std::vector<std::uint32_t>> exactRuleIndices;
+            std::vector<GlobRuleEntry> globRules;
         };
 
         struct MethodClassInfo
@@ -269,27 +289,81 @@ namespace ctrace::stack::analysis
             return p == pattern.size();
         }
 
-        static bool ruleMatchesFunction(const ResourceRule& rule, const llvm::Function& callee)
+        static bool isGlobPattern(llvm::StringRef pattern)
         {
-            const std::string calleeName = callee.getName().str();
-            const std::string demangled = ctrace_tools::demangle(calleeName.c_str());
-            std::string demangledBase = demangled;
-            if (const std::size_t pos = demangledBase.find('('); pos != std::string::npos)
-                demangledBase = demangledBase.substr(0, pos);
+            return pattern.contains('*') || pattern.contains('?') || pattern.contains('[');
+        }
 
-            const llvm::StringRef pattern(rule.functionPattern);
-            const bool hasGlob =
-                pattern.contains('*') || pattern.contains('?') || pattern.contains('[');
-            if (!hasGlob)
+        static void compileResourceModel(ResourceModel& model)
+        {
+            model.exactRuleIndices.clear();
+            model.globRules.clear();
+            for (std::uint32_t index = 0; index < model.rules.size(); ++index)
             {
-                return rule.functionPattern == calleeName || rule.functionPattern == demangled ||
-                       rule.functionPattern == demangledBase;
+                const std::string& pattern = model.rules[index].functionPattern;
+                if (!isGlobPattern(pattern))
+                {
+                    model.exactRuleIndices[pattern].push_back(index);
+                    continue;
+                }
+                GlobRuleEntry entry;
+                entry.literalPrefix = pattern.substr(0, pattern.find_first_of("*?["));
+                entry.ruleIndex = index;
+                model.globRules.push_back(std::move(entry));
             }
-
-            return globMatches(pattern, calleeName) || globMatches(pattern, demangled) ||
-                   globMatches(pattern, demangledBase);
         }
 
+        // Memoizes, per callee, the indices of the rules matching it in model
+        // order. A rule matches when its pattern matches the mangled name, the
+        // demangled name or the demangled name without its parameter list.
+        class ResourceRuleMatcher
+        {
+          public:
+            const std::vector<std::uint32_t>& matchingRules(const ResourceModel& model,
+                                                            const llvm::Function& callee)
+            {
+                if (const auto it = matchCache.find(&callee); it != matchCache.end())
+                    return it->second;
+
+                const std::string calleeName = callee.getName().str();
+                const std::string demangled = ctrace_tools::demangle(calleeName.c_str());
+                std::string demangledBase = demangled;
+                if (const std::size_t pos = demangledBase.find('('); pos != std::string::npos)
+                    demangledBase = demangledBase.substr(0, pos);
+                const std::array<const std::string*, 3> names = {&calleeName, &demangled,
+                                                                 &demangledBase};
+
+                std::vector<std::uint32_t> matched;
+                for (const std::string* name : names)
+                {
+                    const auto it = model.exactRuleIndices.find(*name);
+                    if (it != model.exactRuleIndices.end())
+                        matched.insert(matched.end(), it->second.begin(), it->second.end());
+                }
+                for (const GlobRuleEntry& entry : model.globRules)
+                {
+                    const llvm::StringRef pattern(model.rules[entry.ruleIndex].functionPattern);
+                    for (const std::string* name : names)
+                    {
+                        const llvm::StringRef text(*name);
+                        if (text.starts_with(entry.literalPrefix) && globMatches(pattern, text))
+                        {
+                            matched.push_back(entry.ruleIndex);
+                            break;
+                        }
+                    }
+                }
+                std::sort(matched.begin(), matched.end());
+                matched.erase(std::unique(matched.begin(), matched.end()), matched.end());
+
+                auto [insertedIt, _] = matchCache.emplace(&callee, std::move(matched));
+                return insertedIt->second;
+            }
+
+          private:
+            std::unordered_map<const llvm::Function*, std::vector<std::uint32_t>> matchCache;
+        };
+
         static bool parseResourceModel(const std::string& path, ResourceModel& out,
                                        std::string& error)
         {
@@ -380,6 +454,7 @@ namespace ctrace::stack::analysis
                 out.rules.push_back(std::move(rule));
             }
 
+            compileResourceModel(out);
             return true;
         }
 
@@ -1260,14 +1335,10 @@ namespace ctrace::stack::analysis
         }
 
         static bool callMatchesAnyResourceRule(const ResourceModel& model,
+                                               ResourceRuleMatcher& ruleMatcher,
                                                const llvm::Function& callee)
         {
-            for (const ResourceRule& rule : model.rules)
-            {
-                if (ruleMatchesFunction(rule, callee))
-                    return true;
-            }
-            return false;
+            return !ruleMatcher.matchingRules(model, callee).empty();
         }
 
         static bool callParamHasNonCaptureLikeAttr(const llvm::CallBase& CB, unsigned argIndex)
@@ -1337,18 +1408,17 @@ namespace ctrace::stack::analysis
 
         static bool callArgumentIsDirectReleaseArg(const llvm::CallBase& CB,
                                                    const llvm::Function* callee,
-                                                   const ResourceModel& model, unsigned argIndex)
+                                                   const ResourceModel& model,
+                                                   ResourceRuleMatcher& ruleMatcher,
+                                                   unsigned argIndex)
         {
             if (!callee)
                 return false;
 
-            for (const ResourceRule& rule : model.rules)
+            for (const std::uint32_t ruleIndex : ruleMatcher.matchingRules(model, *callee))
             {
-                if (rule.action != RuleAction::ReleaseArg)
-                    continue;
-                if (rule.argIndex != argIndex)
-                    continue;
-                if (ruleMatchesFunction(rule, *callee))
+                const ResourceRule& rule = model.rules[ruleIndex];
+                if (rule.action == RuleAction::ReleaseArg && rule.argIndex == argIndex)
                     return true;
             }
 
@@ -1389,7 +1459,97 @@ namespace ctrace::stack::analysis
             return false;
         }
 
-        static bool instructionMayReach(const llvm::Instruction& from, const llvm::Instruction& to)
+        // Components of a dense graph, successors first: callees before
+        // callers and loop exits before loop bodies. Members are sorted.
+        static std::vector<std::vector<std::uint32_t>>
+        computeBottomUpSCCs(const std::vector<std::vector<std::uint32_t>>& successors)
+        {
+            std::vector<std::vector<std::uint32_t>> components;
+            forEachStronglyConnectedComponent(
+                static_cast<std::uint32_t>(successors.size()),
+                [&](std::uint32_t v) -> const std::vector<std::uint32_t>& { return successors[v]; },
+                [&](std::span<const std::uint32_t> members)
+                {
+                    std::vector<std::uint32_t> component(members.begin(), members.end());
+                    std::sort(component.begin(), component.end());
+                    components.push_back(std::move(component));
+                });
+            return components;
+        }
+
+        // Block-level transitive closure of one function's CFG over its SCC
+        // condensation. Built on the first query so each later one is a lookup.
+        // The closure is quadratic in the number of components, so functions
+        // above kMaxClosureComponents keep llvm::isPotentiallyReachable.
+        class BlockReachabilityIndex
+        {
+          public:
+            static constexpr std::size_t kMaxClosureComponents = 4096; // 2 MiB of bits
+
+            explicit BlockReachabilityIndex(const llvm::Function& F)
+            {
+                llvm::DenseMap<const llvm::BasicBlock*, std::uint32_t> blockIds;
+                for (const llvm::BasicBlock& BB : F)
+                    blockIds.try_emplace(&BB, static_cast<std::uint32_t>(blockIds.size()));
+
+                std::vector<std::vector<std::uint32_t>> successors(blockIds.size());
+                for (const llvm::BasicBlock& BB : F)
+                {
+                    std::vector<std::uint32_t>& out = successors[blockIds.lookup(&BB)];
+                    for (const llvm::BasicBlock* succ : llvm::successors(&BB))
+                        out.push_back(blockIds.lookup(succ));
+                }
+
+                const auto components = computeBottomUpSCCs(successors);
+                if (components.size() > kMaxClosureComponents)
+                    return;
+                std::vector<std::uint32_t> blockComponent(successors.size(), 0);
+                for (std::uint32_t c = 0; c < components.size(); ++c)
+                {
+                    for (std::uint32_t block : components[c])
+                        blockComponent[block] = c;
+                }
+
+                // Successor components always come first, so their closure is final
+                // when a predecessor component unions it in.
+                reachable.assign(components.size(), llvm::BitVector(components.size()));
+                for (std::uint32_t c = 0; c < components.size(); ++c)
+                {
+                    for (std::uint32_t block : components[c])
+                    {
+                        for (std::uint32_t succ : successors[block])
+                        {
+                            const std::uint32_t target = blockComponent[succ];
+                            reachable[c].set(target);
+                            if (target != c)
+                                reachable[c] |= reachable[target];
+                        }
+                    }
+                }
+
+                componentOf.reserve(blockIds.size());
+                for (const auto& [block, id] : blockIds)
+                    componentOf.try_emplace(block, blockComponent[id]);
+            }
+
+            bool mayReach(const llvm::Instruction& from, const llvm::Instruction& to) const
+            {
+                if (reachable.empty())
+                    return llvm::isPotentiallyReachable(&from, &to);
+                const auto fromIt = componentOf.find(from.getParent());
+                const auto toIt = componentOf.find(to.getParent());
+                if (fromIt == componentOf.end() || toIt == componentOf.end())
+                    return true;
+                return reachable[fromIt->second].test(toIt->second);
+            }
+
+          private:
+            llvm::DenseMap<const llvm::BasicBlock*, std::uint32_t> componentOf;
+            std::vector<llvm::BitVector> reachable;
+        };
+
+        static bool instructionMayReach(const llvm::Instruction& from, const llvm::Instruction& to,
+                                        std::optional<BlockReachabilityIndex>& reachability)
         {
             if (from.getFunction() != to.getFunction())
                 return false;
@@ -1397,11 +1557,14 @@ namespace ctrace::stack::analysis
                 return true;
             if (from.getParent() == to.getParent())
                 return from.comesBefore(&to);
-            return llvm::isPotentiallyReachable(&from, &to);
+            if (!reachability)
+                reachability.emplace(*from.getFunction());
+            return reachability->mayReach(from, to);
         }
 
         static bool
         valueFeedsOnlyDirectReleaseArgs(const llvm::Value* value, const ResourceModel& model,
+                                        ResourceRuleMatcher& ruleMatcher,
                                         llvm::SmallPtrSet<const llvm::Value*, 32>& visited,
                                         bool& sawReleaseUse, unsigned depth = 0)
         {
@@ -1438,7 +1601,8 @@ namespace ctrace::stack::analysis
                             continue;
 
                         sawMeaningfulUse = true;
-                        if (!callArgumentIsDirectReleaseArg(*CB, callee, model, argIdx))
+                        if (!callArgumentIsDirectReleaseArg(*CB, callee, model, ruleMatcher,
+                                                            argIdx))
                             return false;
 
                         callUseIsReleaseOnly = true;
@@ -1452,8 +1616,8 @@ namespace ctrace::stack::analysis
                 if (const auto* CI = llvm::dyn_cast<llvm::CastInst>(user))
                 {
                     sawMeaningfulUse = true;
-                    if (!valueFeedsOnlyDirectReleaseArgs(CI, model, visited, sawReleaseUse,
-                                                         depth + 1))
+                    if (!valueFeedsOnlyDirectReleaseArgs(CI, model, ruleMatcher, visited,
+                                                         sawReleaseUse, depth + 1))
                     {
                         return false;
                     }
@@ -1462,8 +1626,8 @@ namespace ctrace::stack::analysis
                 if (const auto* BC = llvm::dyn_cast<llvm::BitCastOperator>(user))
                 {
                     sawMeaningfulUse = true;
-                    if (!valueFeedsOnlyDirectReleaseArgs(BC, model, visited, sawReleaseUse,
-                                                         depth + 1))
+                    if (!valueFeedsOnlyDirectReleaseArgs(BC, model, ruleMatcher, visited,
+                                                         sawReleaseUse, depth + 1))
                     {
                         return false;
                     }
@@ -1472,8 +1636,8 @@ namespace ctrace::stack::analysis
                 if (const auto* GEP = llvm::dyn_cast<llvm::GEPOperator>(user))
                 {
                     sawMeaningfulUse = true;
-                    if (!valueFeedsOnlyDirectReleaseArgs(GEP, model, visited, sawReleaseUse,
-                                                         depth + 1))
+                    if (!valueFeedsOnlyDirectReleaseArgs(GEP, model, ruleMatcher, visited,
+                                                         sawReleaseUse, depth + 1))
                     {
                         return false;
                     }
@@ -1482,8 +1646,8 @@ namespace ctrace::stack::analysis
                 if (const auto* PN = llvm::dyn_cast<llvm::PHINode>(user))
                 {
                     sawMeaningfulUse = true;
-                    if (!valueFeedsOnlyDirectReleaseArgs(PN, model, visited, sawReleaseUse,
-                                                         depth + 1))
+                    if (!valueFeedsOnlyDirectReleaseArgs(PN, model, ruleMatcher, visited,
+                                                         sawReleaseUse, depth + 1))
                     {
                         return false;
                     }
@@ -1492,8 +1656,8 @@ namespace ctrace::stack::analysis
                 if (const auto* Sel = llvm::dyn_cast<llvm::SelectInst>(user))
                 {
                     sawMeaningfulUse = true;
-                    if (!valueFeedsOnlyDirectReleaseArgs(Sel, model, visited, sawReleaseUse,
-                                                         depth + 1))
+                    if (!valueFeedsOnlyDirectReleaseArgs(Sel, model, ruleMatcher, visited,
+                                                         sawReleaseUse, depth + 1))
                     {
                         return false;
                     }
@@ -1509,11 +1673,12 @@ namespace ctrace::stack::analysis
         }
 
         static bool loadFeedsOnlyDirectReleaseArgs(const llvm::LoadInst& load,
-                                                   const ResourceModel& model)
+                                                   const ResourceModel& model,
+                                                   ResourceRuleMatcher& ruleMatcher)
         {
             llvm::SmallPtrSet<const llvm::Value*, 32> visited;
             bool sawReleaseUse = false;
-            if (!valueFeedsOnlyDirectReleaseArgs(&load, model, visited, sawReleaseUse))
+            if (!valueFeedsOnlyDirectReleaseArgs(&load, model, ruleMatcher, visited, sawReleaseUse))
                 return false;
             return sawReleaseUse;
         }
@@ -1615,6 +1780,7 @@ namespace ctrace::stack::analysis
 
         static bool localAddressEscapesToUnmodeledCall(
             const llvm::Function& F, const llvm::AllocaInst& sourceSlot, const ResourceModel& model,
+            ResourceRuleMatcher& ruleMatcher,
             const std::unordered_map<const llvm::Function*, FunctionLifetimeSummary>& summaries,
             const std::unordered_map<std::string, FunctionLifetimeSummary>* externalSummariesByName,
             const llvm::DataLayout& DL,
@@ -1639,7 +1805,7 @@ namespace ctrace::stack::analysis
                     bool modeledCall = false;
                     if (callee)
                     {
-                        if (callMatchesAnyResourceRule(model, *callee))
+                        if (callMatchesAnyResourceRule(model, ruleMatcher, *callee))
                         {
                             modeledCall = true;
                         }
@@ -1964,7 +2130,7 @@ namespace ctrace::stack::analysis
         }
 
         static FunctionLifetimeSummary buildFunctionLifetimeSummary(
-            const llvm::Function& F, const ResourceModel& model,
+            const llvm::Function& F, const ResourceModel& model, ResourceRuleMatcher& ruleMatcher,
             const std::unordered_map<const llvm::Function*, FunctionLifetimeSummary>& summaries,
             const std::unordered_map<std::string, FunctionLifetimeSummary>* externalSummariesByName,
             const llvm::DataLayout& DL,
@@ -1987,10 +2153,9 @@ namespace ctrace::stack::analysis
                         continue;
 
                     bool matchedDirectRule = false;
-                    for (const ResourceRule& rule : model.rules)
+                    for (const std::uint32_t ruleIndex : ruleMatcher.matchingRules(model, *callee))
                     {
-                        if (!ruleMatchesFunction(rule, *callee))
-                            continue;
+                        const ResourceRule& rule = model.rules[ruleIndex];
                         matchedDirectRule = true;
 
                         if (rule.action == RuleAction::AcquireOut)
@@ -2225,115 +2390,284 @@ namespace ctrace::stack::analysis
             return first;
         }
 
+        struct SummaryCallGraph
+        {
+            std::vector<llvm::Function*> nodes;
+            std::vector<std::vector<std::uint32_t>> callees;
+            std::vector<std::vector<std::uint32_t>> callers;
+        };
+
+        // Only direct calls to in-scope definitions feed a caller's summary, so
+        // these are the only edges the summary fixpoint has to respect.
+        static SummaryCallGraph buildSummaryCallGraph(llvm::Module& mod)
+        {
+            SummaryCallGraph graph;
+            std::unordered_map<const llvm::Function*, std::uint32_t> ids;
+            for (llvm::Function& F : mod)
+            {
+                if (F.isDeclaration())
+                    continue;
+                if (shouldIgnoreStdLibSummaryPropagation(F))
+                    continue;
+                ids.emplace(&F, static_cast<std::uint32_t>(graph.nodes.size()));
+                graph.nodes.push_back(&F);
+            }
+
+            graph.callees.resize(graph.nodes.size());
+            graph.callers.resize(graph.nodes.size());
+            for (std::uint32_t id = 0; id < graph.nodes.size(); ++id)
+            {
+                std::unordered_set<std::uint32_t> seen;
+                for (const llvm::BasicBlock& BB : *graph.nodes[id])
+                {
+                    for (const llvm::Instruction& I : BB)
+                    {
+                        const auto* CB = llvm::dyn_cast<llvm::CallBase>(&I);
+                        if (!CB)
+                            continue;
+                        const llvm::Function* callee = resolveDirectCallee(*CB);
+                        if (!callee)
+                            continue;
+                        const auto it = ids.find(callee);
+                        if (it == ids.end() || !seen.insert(it->second).second)
+                            continue;
+                        graph.callees[id].push_back(it->second);
+                        graph.callers[it->second].push_back(id);
+                    }
+                }
+            }
+            return graph;
+        }
+
         static std::unordered_map<const llvm::Function*, FunctionLifetimeSummary>
         computeFunctionLifetimeSummaries(
-            llvm::Module& mod, const ResourceModel& model,
+            llvm::Module& mod, const ResourceModel& model, ResourceRuleMatcher& ruleMatcher,
             const std::function<bool(const llvm::Function&)>& shouldAnalyze,
             const std::unordered_map<std::string, FunctionLifetimeSummary>* externalSummariesByName)
         {
+            // Same precision budget as the former 8 whole-module sweeps, applied
+            // per recursive component.
+            constexpr std::size_t kMaxRebuildsPerMember = 8;
+
             const llvm::DataLayout& DL = mod.getDataLayout();
+            const SummaryCallGraph graph = buildSummaryCallGraph(mod);
             std::unordered_map<const llvm::Function*, FunctionLifetimeSummary> functionSummaries;
-            for (llvm::Function& F : mod)
+            functionSummaries.reserve(graph.nodes.size());
+            for (const llvm::Function* F : graph.nodes)
+                functionSummaries[F] = {};
+
+            auto rebuild = [&](std::uint32_t id) -> bool
+            {
+                const llvm::Function& F = *graph.nodes[id];
+                FunctionLifetimeSummary nextSummary = buildFunctionLifetimeSummary(
+                    F, model, ruleMatcher, functionSummaries, externalSummariesByName, DL,
+                    shouldAnalyze);
+                FunctionLifetimeSummary& currentSummary = functionSummaries[&F];
+                if (functionLifetimeSummaryEquals(currentSummary, nextSummary))
+                    return false;
+                currentSummary = std::move(nextSummary);
+                return true;
+            };
+
+            std::vector<std::uint32_t> componentOf(graph.nodes.size(), 0);
+            std::vector<char> queued(graph.nodes.size(), 0);
+            const auto components = computeBottomUpSCCs(graph.callees);
+            for (std::uint32_t c = 0; c < components.size(); ++c)
             {
-                if (F.isDeclaration())
-                    continue;
-                if (shouldIgnoreStdLibSummaryPropagation(F))
-                    continue;
-                functionSummaries[&F] = {};
+                for (std::uint32_t id : components[c])
+                    componentOf[id] = c;
             }
 
-            bool changed = true;
-            for (unsigned iter = 0; iter < 8 && changed; ++iter)
+            for (std::uint32_t c = 0; c < components.size(); ++c)
             {
-                changed = false;
-                for (llvm::Function& F : mod)
+                const std::vector<std::uint32_t>& component = components[c];
+                const std::uint32_t head = component.front();
+                const bool selfRecursive =
+                    std::find(graph.callees[head].begin(), graph.callees[head].end(), head) !=
+                    graph.callees[head].end();
+                if (component.size() == 1 && !selfRecursive)
                 {
-                    if (F.isDeclaration())
-                        continue;
-                    if (shouldIgnoreStdLibSummaryPropagation(F))
+                    (void)rebuild(head);
+                    continue;
+                }
+
+                // Callees outside the component are final; only re-queue callers
+                // inside it when a member's summary actually changed.
+                std::deque<std::uint32_t> worklist(component.begin(), component.end());
+                for (std::uint32_t id : component)
+                    queued[id] = 1;
+                std::size_t budget = kMaxRebuildsPerMember * component.size();
+                while (!worklist.empty() && budget > 0)
+                {
+                    const std::uint32_t id = worklist.front();
+                    worklist.pop_front();
+                    queued[id] = 0;
+                    --budget;
+                    if (!rebuild(id))
                         continue;
-                    FunctionLifetimeSummary nextSummary = buildFunctionLifetimeSummary(
-                        F, model, functionSummaries, externalSummariesByName, DL, shouldAnalyze);
-                    FunctionLifetimeSummary& currentSummary = functionSummaries[&F];
-                    if (!functionLifetimeSummaryEquals(currentSummary, nextSummary))
+                    for (std::uint32_t caller : graph.callers[id])
                     {
-                        currentSummary = std::move(nextSummary);
-                        changed = true;
+                        if (componentOf[caller] != c || queued[caller])
+                            continue;
+                        queued[caller] = 1;
+                        worklist.push_back(caller);
                     }
                 }
+                for (std::uint32_t id : worklist)
+                    queued[id] = 0;
             }
             return functionSummaries;
         }
+
+        using ExternalSummarySnapshot =
+            std::vector<std::pair<std::string, std::optional<FunctionLifetimeSummary>>>;
+
+        // External summaries are only ever looked up by the canonical name of a
+        // function referenced by the module, so recording those entries is enough
+        // to tell whether a later external index would change the fixpoint.
+        static ExternalSummarySnapshot snapshotConsumedExternalSummaries(
+            const llvm::Module& mod,
+            const std::unordered_map<std::string, FunctionLifetimeSummary>& externalMap)
+        {
+            ExternalSummarySnapshot snapshot;
+            for (const llvm::Function& F : mod)
+            {
+                if (!F.hasName() || F.getName().empty())
+                    continue;
+                std::string canon = ctrace_tools::canonicalizeMangledName(F.getName().str());
+                const auto it = externalMap.find(canon);
+                if (it == externalMap.end())
+                    snapshot.emplace_back(std::move(canon), std::nullopt);
+                else
+                    snapshot.emplace_back(std::move(canon), it->second);
+            }
+            return snapshot;
+        }
+
+        static bool externalSnapshotMatches(
+            const ExternalSummarySnapshot& snapshot,
+            const std::unordered_map<std::string, FunctionLifetimeSummary>& externalMap)
+        {
+            for (const auto& [name, recorded] : snapshot)
+            {
+                const auto it = externalMap.find(name);
+                if (it == externalMap.end())
+                {
+                    if (recorded)
+                        return false;
+                    continue;
+                }
+                if (!recorded || !functionLifetimeSummaryEquals(*recorded, it->second))
+                    return false;
+            }
+            return true;
+        }
+
+        static std::shared_ptr<const ResourceModel> loadResourceModel(const std::string& path)
+        {
+            std::string parseError;
+            std::shared_ptr<const ResourceModel> model =
+                ModelRegistry<ResourceModel>::instance().load(path, &parseResourceModel,
+                                                              parseError);
+            if (!model || model->rules.empty())
+            {
+                if (!parseError.empty())
+                    std::cerr << "Resource model load error: " << parseError << "\n";
+                return nullptr;
+            }
+            return model;
+        }
     } // namespace
 
+    struct ResourceLifetimeModuleStateOpaque
+    {
+        const llvm::Module* module = nullptr;
+        std::shared_ptr<const ResourceModel> model;
+        std::unordered_map<const llvm::Function*, FunctionLifetimeSummary> functionSummaries;
+        ExternalSummarySnapshot externalSnapshot;
+    };
+
     ResourceSummaryIndex buildResourceLifetimeSummaryIndex(
         llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries)
+        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries,
+        ResourceLifetimeModuleState* stateOut)
     {
         ResourceSummaryIndex index;
         if (modelPath.empty())
             return index;
 
-        ResourceModel model;
-        std::string parseError;
-        if (!parseResourceModel(modelPath, model, parseError) || model.rules.empty())
-        {
-            if (!parseError.empty())
-                std::cerr << "Resource model load error: " << parseError << "\n";
+        std::shared_ptr<const ResourceModel> model = loadResourceModel(modelPath);
+        if (!model)
             return index;
-        }
 
         const auto externalMap = importExternalSummaryMap(externalSummaries);
-        const auto summaries = computeFunctionLifetimeSummaries(
-            mod, model, shouldAnalyze, externalMap.empty() ? nullptr : &externalMap);
-        return exportSummaryIndexForModule(mod, shouldAnalyze, summaries);
+        ResourceRuleMatcher ruleMatcher;
+        auto summaries =
+            computeFunctionLifetimeSummaries(mod, *model, ruleMatcher, shouldAnalyze,
+                                             externalMap.empty() ? nullptr : &externalMap);
+        index = exportSummaryIndexForModule(mod, shouldAnalyze, summaries);
+        if (stateOut)
+        {
+            auto opaque = std::make_shared<ResourceLifetimeModuleStateOpaque>();
+            opaque->module = &mod;
+            opaque->model = std::move(model);
+            opaque->functionSummaries = std::move(summaries);
+            opaque->externalSnapshot = snapshotConsumedExternalSummaries(mod, externalMap);
+            stateOut->opaque = std::move(opaque);
+        }
+        return index;
     }
 
-    bool mergeResourceSummaryIndex(ResourceSummaryIndex& dst, const ResourceSummaryIndex& src)
+    bool mergeResourceSummaryEntry(ResourceSummaryIndex& dst, const std::string& name,
+                                   const ResourceSummaryFunction& incoming)
     {
-        bool changed = false;
-        for (const auto& entry : src.functions)
+        auto it = dst.functions.find(name);
+        if (it == dst.functions.end())
         {
-            auto it = dst.functions.find(entry.first);
-            if (it == dst.functions.end())
-            {
-                dst.functions.emplace(entry.first, entry.second);
-                changed = true;
-                continue;
-            }
+            dst.functions.emplace(name, incoming);
+            return true;
+        }
 
-            std::unordered_set<std::string> existingKeys;
-            existingKeys.reserve(it->second.effects.size());
-            for (const ResourceSummaryEffect& effect : it->second.effects)
-            {
-                ParamLifetimeEffect tmp;
-                tmp.action = fromPublicSummaryAction(effect.action);
-                tmp.argIndex = effect.argIndex;
-                tmp.offset = effect.offset;
-                tmp.viaPointerSlot = effect.viaPointerSlot;
-                tmp.resourceKind = effect.resourceKind;
-                existingKeys.insert(encodeSummaryEffectKey(tmp));
-            }
+        std::unordered_set<std::string> existingKeys;
+        existingKeys.reserve(it->second.effects.size());
+        for (const ResourceSummaryEffect& effect : it->second.effects)
+        {
+            ParamLifetimeEffect tmp;
+            tmp.action = fromPublicSummaryAction(effect.action);
+            tmp.argIndex = effect.argIndex;
+            tmp.offset = effect.offset;
+            tmp.viaPointerSlot = effect.viaPointerSlot;
+            tmp.resourceKind = effect.resourceKind;
+            existingKeys.insert(encodeSummaryEffectKey(tmp));
+        }
 
-            for (const ResourceSummaryEffect& effect : entry.second.effects)
+        bool changed = false;
+        for (const ResourceSummaryEffect& effect : incoming.effects)
+        {
+            ParamLifetimeEffect tmp;
+            tmp.action = fromPublicSummaryAction(effect.action);
+            tmp.argIndex = effect.argIndex;
+            tmp.offset = effect.offset;
+            tmp.viaPointerSlot = effect.viaPointerSlot;
+            tmp.resourceKind = effect.resourceKind;
+            const std::string key = encodeSummaryEffectKey(tmp);
+            if (existingKeys.insert(key).second)
             {
-                ParamLifetimeEffect tmp;
-                tmp.action = fromPublicSummaryAction(effect.action);
-                tmp.argIndex = effect.argIndex;
-                tmp.offset = effect.offset;
-                tmp.viaPointerSlot = effect.viaPointerSlot;
-                tmp.resourceKind = effect.resourceKind;
-                const std::string key = encodeSummaryEffectKey(tmp);
-                if (existingKeys.insert(key).second)
-                {
-                    it->second.effects.push_back(effect);
-                    changed = true;
-                }
+                it->second.effects.push_back(effect);
+                changed = true;
             }
         }
         return changed;
     }
 
+    bool mergeResourceSummaryIndex(ResourceSummaryIndex& dst, const ResourceSummaryIndex& src)
+    {
+        bool changed = false;
+        for (const auto& entry : src.functions)
+            changed |= mergeResourceSummaryEntry(dst, entry.first, entry.second);
+        return changed;
+    }
+
     bool resourceSummaryIndexEquals(const ResourceSummaryIndex& lhs,
                                     const ResourceSummaryIndex& rhs)
     {
@@ -2442,26 +2776,40 @@ namespace ctrace::stack::analysis
 
     std::vector<ResourceLifetimeIssue> analyzeResourceLifetime(
         llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries)
+        const std::string& modelPath, const ResourceSummaryIndex* externalSummaries,
+        const ResourceLifetimeModuleState* reusableState)
     {
         std::vector<ResourceLifetimeIssue> issues;
         if (modelPath.empty())
             return issues;
 
-        ResourceModel model;
-        std::string parseError;
-        if (!parseResourceModel(modelPath, model, parseError) || model.rules.empty())
-        {
-            if (!parseError.empty())
-                std::cerr << "Resource model load error: " << parseError << "\n";
+        const std::shared_ptr<const ResourceModel> sharedModel = loadResourceModel(modelPath);
+        if (!sharedModel)
             return issues;
-        }
+        const ResourceModel& model = *sharedModel;
+
+        // The registry hands out one instance per model content, so pointer
+        // equality means the summaries were computed against the same rules.
+        const ResourceLifetimeModuleStateOpaque* reuse =
+            reusableState ? reusableState->opaque.get() : nullptr;
+        if (reuse && (reuse->module != &mod || reuse->model != sharedModel))
+            reuse = nullptr;
 
-        const llvm::DataLayout& DL = mod.getDataLayout();
         const auto externalMap = importExternalSummaryMap(externalSummaries);
-        std::unordered_map<const llvm::Function*, FunctionLifetimeSummary> functionSummaries =
-            computeFunctionLifetimeSummaries(mod, model, shouldAnalyze,
-                                             externalMap.empty() ? nullptr : &externalMap);
+        if (reuse && !externalSnapshotMatches(reuse->externalSnapshot, externalMap))
+            reuse = nullptr;
+
+        const llvm::DataLayout& DL = mod.getDataLayout();
+        ResourceRuleMatcher ruleMatcher;
+        std::unordered_map<const llvm::Function*, FunctionLifetimeSummary> computedSummaries;
+        if (!reuse)
+        {
+            computedSummaries =
+                computeFunctionLifetimeSummaries(mod, model, ruleMatcher, shouldAnalyze,
+                                                 externalMap.empty() ? nullptr : &externalMap);
+        }
+        const std::unordered_map<const llvm::Function*, FunctionLifetimeSummary>&
+            functionSummaries = reuse ? reuse->functionSummaries : computedSummaries;
 
         std::unordered_map<std::string, ClassLifecycleSummary> classSummaries;
 
@@ -2473,6 +2821,7 @@ namespace ctrace::stack::analysis
                 continue;
 
             const MethodClassInfo methodInfo = describeMethodClass(F);
+            std::optional<BlockReachabilityIndex> blockReachability;
             std::unordered_map<std::string, LocalHandleState> localStates;
             std::unordered_map<const llvm::AllocaInst*, bool> unknownAcquireEscapeCache;
             std::unordered_set<std::string> interprocUncertaintyReported;
@@ -2541,7 +2890,7 @@ namespace ctrace::stack::analysis
                     {
                         if (!releaseInst)
                             continue;
-                        if (instructionMayReach(*releaseInst, *anchorInst))
+                        if (instructionMayReach(*releaseInst, *anchorInst, blockReachability))
                         {
                             reachableRelease = true;
                             break;
@@ -2708,7 +3057,8 @@ namespace ctrace::stack::analysis
                         {
                             const bool mayEscapeToUnknownAcquire =
                                 localAddressEscapesToUnmodeledCall(
-                                    F, *state.storage.localAlloca, model, functionSummaries,
+                                    F, *state.storage.localAlloca, model, ruleMatcher,
+                                    functionSummaries,
                                     externalMap.empty() ? nullptr : &externalMap, DL,
                                     shouldAnalyze);
                             cacheIt =
@@ -2763,7 +3113,7 @@ namespace ctrace::stack::analysis
                 {
                     if (const auto* LI = llvm::dyn_cast<llvm::LoadInst>(&I))
                     {
-                        if (loadFeedsOnlyDirectReleaseArgs(*LI, model))
+                        if (loadFeedsOnlyDirectReleaseArgs(*LI, model, ruleMatcher))
                             continue;
                         StorageKey storage =
                             resolveHandleStorage(LI->getPointerOperand(), F, DL, methodInfo);
@@ -2802,7 +3152,8 @@ namespace ctrace::stack::analysis
                         const llvm::Value* arg = CB->getArgOperand(argIdx);
                         if (!arg || !arg->getType()->isPointerTy())
                             continue;
-                        if (callArgumentIsDirectReleaseArg(*CB, callee, model, argIdx))
+                        if (callArgumentIsDirectReleaseArg(*CB, callee, model, ruleMatcher,
+                                                           argIdx))
                             continue;
                         if (!callArgumentLikelyDereferenced(*CB, callee, argIdx))
                             continue;
@@ -2812,10 +3163,9 @@ namespace ctrace::stack::analysis
                     }
 
                     bool matchedDirectRule = false;
-                    for (const ResourceRule& rule : model.rules)
+                    for (const std::uint32_t ruleIndex : ruleMatcher.matchingRules(model, *callee))
                     {
-                        if (!ruleMatchesFunction(rule, *callee))
-                            continue;
+                        const ResourceRule& rule = model.rules[ruleIndex];
                         matchedDirectRule = true;
 
                         switch (rule.action)
@@ -2991,7 +3341,7 @@ namespace ctrace::stack::analysis
                     continue;
                 if (state.storage.localAlloca &&
                     localAddressEscapesToUnmodeledCall(
-                        F, *state.storage.localAlloca, model, functionSummaries,
+                        F, *state.storage.localAlloca, model, ruleMatcher, functionSummaries,
                         externalMap.empty() ? nullptr : &externalMap, DL, shouldAnalyze))
                 {
                     continue;
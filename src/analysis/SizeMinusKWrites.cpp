@@ -8,6 +8,7 @@
 #include <map>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/SmallPtrSet.h>
@@ -76,14 +77,24 @@ namespace ctrace::stack::analysis
             {
             }
 
-            SmtFeasibility
-            isSignedLessEqualFeasible(const std::map<const llvm::Value*, IntRange>& ranges,
-                                      const llvm::Value& lhs, std::int64_t rhsConstant,
-                                      const llvm::Instruction* contextInst) const
+            bool enabled() const
             {
-                return smt::SmtConstraintEvaluator::evaluateQuery(
-                    smt::encodeSignedComparisonFeasibility(ranges, lhs, rhsConstant, false,
-                                                           contextInst));
+                return solverEnabled();
+            }
+
+            // Query "lhs <= rhsConstant" under `ranges`, for evaluateAll().
+            static smt::ConstraintIR
+            encodeSignedLessEqual(const std::map<const llvm::Value*, IntRange>& ranges,
+                                  const llvm::Value& lhs, std::int64_t rhsConstant,
+                                  const llvm::Instruction* contextInst)
+            {
+                return smt::encodeSignedComparisonFeasibility(ranges, lhs, rhsConstant, false,
+                                                              contextInst);
+            }
+
+            std::vector<SmtFeasibility> evaluateAll(std::vector<smt::ConstraintIR> queries) const
+            {
+                return smt::SmtConstraintEvaluator::evaluateQueries(std::move(queries));
             }
         };
 
@@ -479,6 +490,12 @@ namespace ctrace::stack::analysis
                 return v;
             };
 
+            // Candidates whose size could not be shown above k are refined by
+            // one SMT batch per function once every sink has been visited.
+            std::vector<SizeMinusKWriteIssue> candidates;
+            std::vector<smt::ConstraintIR> sizeQueries;
+            std::vector<std::size_t> sizeQueryCandidates;
+
             auto emitIssue = [&](Instruction* at, Value* dest, Value* sizeBase, StringRef sinkName,
                                  bool hasPtrDest, int64_t k)
             {
@@ -488,22 +505,23 @@ namespace ctrace::stack::analysis
                 issue.hasPointerDest = hasPtrDest;
                 issue.ptrNonNull = hasPtrDest ? isNonNullAt(dest, at, LVI) : true;
                 issue.sizeAboveK = isGreaterThanAt(sizeBase, k, at, LVI);
-                if (!issue.sizeAboveK && sizeBase && sizeBase->getType()->isIntegerTy())
+                issue.k = k;
+                issue.inst = at;
+                if (issue.ptrNonNull && issue.sizeAboveK)
+                    return;
+                if (!issue.sizeAboveK && evaluator.enabled() && sizeBase &&
+                    sizeBase->getType()->isIntegerTy())
                 {
                     const std::map<const llvm::Value*, IntRange> queryRanges =
                         buildValueQueryRanges(*sizeBase, ranges);
                     if (!queryRanges.empty())
                     {
-                        const SmtFeasibility sizeAtMostKFeasible =
-                            evaluator.isSignedLessEqualFeasible(queryRanges, *sizeBase, k, at);
-                        if (sizeAtMostKFeasible == SmtFeasibility::Infeasible)
-                            issue.sizeAboveK = true;
+                        sizeQueryCandidates.push_back(candidates.size());
+                        sizeQueries.push_back(SizeMinusKConstraintEvaluator::encodeSignedLessEqual(
+                            queryRanges, *sizeBase, k, at));
                     }
                 }
-                issue.k = k;
-                issue.inst = at;
-                if (!issue.ptrNonNull || !issue.sizeAboveK)
-                    out.push_back(std::move(issue));
+                candidates.push_back(std::move(issue));
             };
 
             for (Instruction& I : instructions(F))
@@ -568,6 +586,19 @@ namespace ctrace::stack::analysis
                               "store (idx = size-k)", true, match.k);
                 }
             }
+
+            const std::vector<SmtFeasibility> sizeAtMostK =
+                evaluator.evaluateAll(std::move(sizeQueries));
+            for (std::size_t i = 0; i < sizeAtMostK.size(); ++i)
+            {
+                if (sizeAtMostK[i] == SmtFeasibility::Infeasible)
+                    candidates[sizeQueryCandidates[i]].sizeAboveK = true;
+            }
+            for (SizeMinusKWriteIssue& issue : candidates)
+            {
+                if (!issue.ptrNonNull || !issue.sizeAboveK)
+                    out.push_back(std::move(issue));
+            }
         }
     } // namespace
 
@@ -5,11 +5,14 @@
 #include <cstdint>
 #include <deque>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <llvm/ADT/Hashing.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Constants.h>
@@ -22,6 +25,7 @@
 
 #include "analysis/IntRanges.hpp"
 #include "analysis/IRValueUtils.hpp"
+#include "analysis/StronglyConnectedComponents.hpp"
 #include "analysis/smt/SmtEncoding.hpp"
 #include "analysis/smt/SmtRefinement.hpp"
 #include "analysis/smt/SolverOrchestrator.hpp"
@@ -36,13 +40,6 @@ namespace ctrace::stack::analysis
             return F && F->hasFnAttribute(llvm::Attribute::NoRecurse);
         }
 
-        enum VisitState
-        {
-            NotVisited = 0,
-            Visiting = 1,
-            Visited = 2
-        };
-
         static bool hasNonSelfCall(const llvm::Function& F)
         {
             const llvm::Function* Self = &F;
@@ -152,80 +149,6 @@ namespace ctrace::stack::analysis
             return info;
         }
 
-        static StackEstimate
-        dfsComputeStack(const llvm::Function* F, const CallGraph& CG,
-                        const std::map<const llvm::Function*, LocalStackInfo>& LocalStack,
-                        std::map<const llvm::Function*, VisitState>& State,
-                        InternalAnalysisState& Res)
-        {
-            auto itState = State.find(F);
-            if (itState != State.end())
-            {
-                if (itState->second == Visiting)
-                {
-                    auto itLocal = LocalStack.find(F);
-                    if (itLocal != LocalStack.end())
-                    {
-                        return StackEstimate{itLocal->second.bytes, itLocal->second.unknown};
-                    }
-                    return {};
-                }
-                else if (itState->second == Visited)
-                {
-                    auto itTotal = Res.TotalStack.find(F);
-                    return (itTotal != Res.TotalStack.end()) ? itTotal->second : StackEstimate{};
-                }
-            }
-
-            State[F] = Visiting;
-
-            auto itLocal = LocalStack.find(F);
-            StackEstimate local = {};
-            if (itLocal != LocalStack.end())
-            {
-                local.bytes = itLocal->second.bytes;
-                local.unknown = itLocal->second.unknown;
-            }
-            StackEstimate maxCallee = {};
-
-            auto itCG = CG.find(F);
-            if (itCG != CG.end())
-            {
-                for (const llvm::Function* Callee : itCG->second)
-                {
-                    StackEstimate calleeStack = dfsComputeStack(Callee, CG, LocalStack, State, Res);
-                    if (calleeStack.bytes > maxCallee.bytes)
-                        maxCallee.bytes = calleeStack.bytes;
-                    if (calleeStack.unknown)
-                        maxCallee.unknown = true;
-                }
-            }
-
-            StackEstimate total;
-            total.bytes = local.bytes + maxCallee.bytes;
-            total.unknown = local.unknown || maxCallee.unknown;
-            Res.TotalStack[F] = total;
-            State[F] = Visited;
-            return total;
-        }
-
-        static bool hasSelfCall(const llvm::Function* F, const CallGraph& CG)
-        {
-            if (!F || hasNoRecurseContract(F))
-                return false;
-
-            auto it = CG.find(F);
-            if (it == CG.end())
-                return false;
-
-            for (const llvm::Function* Callee : it->second)
-            {
-                if (Callee == F)
-                    return true;
-            }
-            return false;
-        }
-
         template <typename IsRecursiveCallee>
         static bool detectInfiniteRecursionByDominance(const llvm::Function& F,
                                                        IsRecursiveCallee&& isRecursiveCallee)
@@ -320,23 +243,71 @@ namespace ctrace::stack::analysis
                                         const llvm::BasicBlock* incomingBlock = nullptr) const
             {
                 const ConstraintSat fallbackDecision = evaluateIntervalSatisfiability(ranges);
-                const smt::SmtFeasibility feasibility =
-                    smt::SmtConstraintEvaluator::evaluateQuery(encoder_.encode(
-                        ranges, edgeCondition, takesTrueEdge, edgeBlock, incomingBlock));
-                switch (feasibility)
+                if (!solverEnabled())
+                    return fallbackDecision;
+
+                // Sibling paths, and every member of a recursive component,
+                // reach the same branch under the same ranges; answer those
+                // repeats without encoding the query again.
+                QueryKey key =
+                    makeQueryKey(ranges, edgeCondition, takesTrueEdge, edgeBlock, incomingBlock);
+                if (auto it = decisions_.find(key); it != decisions_.end())
+                    return it->second;
+
+                ConstraintSat decision = fallbackDecision;
+                switch (smt::SmtConstraintEvaluator::evaluateQuery(encoder_.encode(
+                    ranges, edgeCondition, takesTrueEdge, edgeBlock, incomingBlock)))
                 {
                 case smt::SmtFeasibility::Feasible:
-                    return ConstraintSat::Sat;
+                    decision = ConstraintSat::Sat;
+                    break;
                 case smt::SmtFeasibility::Infeasible:
-                    return ConstraintSat::Unsat;
+                    decision = ConstraintSat::Unsat;
+                    break;
                 case smt::SmtFeasibility::Inconclusive:
                     // Fail-safe: preserve baseline behavior when SMT is inconclusive.
-                    return fallbackDecision;
+                    break;
                 }
-                return fallbackDecision;
+                decisions_.emplace(std::move(key), decision);
+                return decision;
             }
 
           private:
+            using QueryKey = std::vector<std::uint64_t>;
+
+            struct QueryKeyHash
+            {
+                std::size_t operator()(const QueryKey& key) const
+                {
+                    return llvm::hash_combine_range(key.begin(), key.end());
+                }
+            };
+
+            static QueryKey makeQueryKey(const std::map<const llvm::Value*, IntRange>& ranges,
+                                         const llvm::Value* edgeCondition, bool takesTrueEdge,
+                                         const llvm::BasicBlock* edgeBlock,
+                                         const llvm::BasicBlock* incomingBlock)
+            {
+                auto word = [](const void* pointer)
+                { return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer)); };
+
+                QueryKey key;
+                key.reserve(4 + ranges.size() * 4);
+                key.push_back(word(edgeCondition));
+                key.push_back(word(edgeBlock));
+                key.push_back(word(incomingBlock));
+                key.push_back(takesTrueEdge ? 1 : 0);
+                for (const auto& [value, range] : ranges)
+                {
+                    key.push_back(word(value));
+                    key.push_back(static_cast<std::uint64_t>(range.lower));
+                    key.push_back(static_cast<std::uint64_t>(range.upper));
+                    key.push_back((range.hasLower ? 1u : 0u) | (range.hasUpper ? 2u : 0u));
+                }
+                return key;
+            }
+
+            mutable std::unordered_map<QueryKey, ConstraintSat, QueryKeyHash> decisions_;
             [[no_unique_address]] smt::LlvmConstraintEncoder encoder_;
         };
 
@@ -554,30 +525,69 @@ namespace ctrace::stack::analysis
             return outKey != nullptr;
         }
 
-        static bool applyConstraintToState(std::map<const llvm::Value*, IntRange>& ranges,
-                                           const llvm::Value* key, const IntRange& constraint)
+        using RangeMap = std::map<const llvm::Value*, IntRange>;
+
+        // Path states share their range map until an edge actually narrows
+        // it; most edges (unconditional ones, or conditions on values with
+        // no range) hand the parent's map on unchanged.
+        using SharedRanges = std::shared_ptr<const RangeMap>;
+
+        // Intersects `constraint` into the range of `key`. Returns false when
+        // the result is empty; `out` is `ranges` itself unless it changed.
+        static bool narrowRanges(const SharedRanges& ranges, const llvm::Value* key,
+                                 const IntRange& constraint, SharedRanges& out)
         {
-            IntRange& cur = ranges[key];
+            IntRange cur;
+            if (auto it = ranges->find(key); it != ranges->end())
+                cur = it->second;
 
-            if (constraint.hasLower)
+            bool changed = false;
+            if (constraint.hasLower && (!cur.hasLower || constraint.lower > cur.lower))
             {
-                if (!cur.hasLower || constraint.lower > cur.lower)
-                {
-                    cur.hasLower = true;
-                    cur.lower = constraint.lower;
-                }
+                cur.hasLower = true;
+                cur.lower = constraint.lower;
+                changed = true;
+            }
+            if (constraint.hasUpper && (!cur.hasUpper || constraint.upper < cur.upper))
+            {
+                cur.hasUpper = true;
+                cur.upper = constraint.upper;
+                changed = true;
             }
 
-            if (constraint.hasUpper)
+            if (cur.hasLower && cur.hasUpper && cur.lower > cur.upper)
+                return false;
+            if (!changed)
             {
-                if (!cur.hasUpper || constraint.upper < cur.upper)
-                {
-                    cur.hasUpper = true;
-                    cur.upper = constraint.upper;
-                }
+                out = ranges;
+                return true;
             }
 
-            return !(cur.hasLower && cur.hasUpper && cur.lower > cur.upper);
+            auto narrowed = std::make_shared<RangeMap>(*ranges);
+            (*narrowed)[key] = cur;
+            out = std::move(narrowed);
+            return true;
+        }
+
+        // True when every range in `looser` contains the matching range of
+        // `tighter`: all paths feasible under `tighter` are feasible under
+        // `looser` too.
+        static bool rangesSubsume(const RangeMap& looser, const RangeMap& tighter)
+        {
+            for (const auto& [key, bound] : looser)
+            {
+                if (!bound.hasLower && !bound.hasUpper)
+                    continue;
+                auto it = tighter.find(key);
+                if (it == tighter.end())
+                    return false;
+                const IntRange& range = it->second;
+                if (bound.hasLower && (!range.hasLower || range.lower < bound.lower))
+                    return false;
+                if (bound.hasUpper && (!range.hasUpper || range.upper > bound.upper))
+                    return false;
+            }
+            return true;
         }
 
         enum class NonRecursiveReturnFeasibility
@@ -587,6 +597,12 @@ namespace ctrace::stack::analysis
             Inconclusive
         };
 
+        // Breadth-first search for a return that no recursive call precedes.
+        // A state whose ranges are at least as tight as those of a state
+        // already expanded at the same (block, predecessor, sawRecursiveCall)
+        // can reach nothing new and is dropped before it counts against
+        // kMaxStates. The predecessor is part of the key because the
+        // evaluator encodes phis through it.
         template <typename IsRecursiveCallee>
         static NonRecursiveReturnFeasibility
         hasFeasibleNonRecursiveReturnPath(const llvm::Function& F,
@@ -602,11 +618,28 @@ namespace ctrace::stack::analysis
             {
                 const BasicBlock* block = nullptr;
                 const BasicBlock* predecessor = nullptr;
-                std::map<const Value*, IntRange> ranges;
+                SharedRanges ranges;
                 std::uint64_t depth = 0;
                 std::uint64_t sawRecursiveCall = 0;
             };
 
+            struct ExpandedKey
+            {
+                const BasicBlock* block = nullptr;
+                const BasicBlock* predecessor = nullptr;
+                std::uint64_t sawRecursiveCall = 0;
+
+                bool operator==(const ExpandedKey&) const = default;
+            };
+
+            struct ExpandedKeyHash
+            {
+                std::size_t operator()(const ExpandedKey& key) const
+                {
+                    return llvm::hash_combine(key.block, key.predecessor, key.sawRecursiveCall);
+                }
+            };
+
             constexpr unsigned kMaxStates = 4096;
             constexpr unsigned kMaxDepth = 1024;
             constexpr unsigned kMaxVisitsPerNode = 128;
@@ -614,11 +647,12 @@ namespace ctrace::stack::analysis
             std::deque<PathState> worklist;
             worklist.push_back(PathState{.block = &F.getEntryBlock(),
                                          .predecessor = nullptr,
-                                         .ranges = {},
+                                         .ranges = std::make_shared<const RangeMap>(),
                                          .depth = 0,
                                          .sawRecursiveCall = 0});
 
             std::map<std::pair<const BasicBlock*, bool>, unsigned> visits;
+            std::unordered_map<ExpandedKey, std::vector<SharedRanges>, ExpandedKeyHash> expanded;
             unsigned exploredStates = 0;
             bool sawAnyRecursivePath = false;
 
@@ -627,6 +661,18 @@ namespace ctrace::stack::analysis
                 PathState current = std::move(worklist.front());
                 worklist.pop_front();
 
+                std::vector<SharedRanges>& expandedHere = expanded[ExpandedKey{
+                    current.block, current.predecessor, current.sawRecursiveCall}];
+                const bool subsumed =
+                    std::any_of(expandedHere.begin(), expandedHere.end(),
+                                [&current](const SharedRanges& seen)
+                                {
+                                    return seen == current.ranges ||
+                                           rangesSubsume(*seen, *current.ranges);
+                                });
+                if (subsumed)
+                    continue;
+
                 if (++exploredStates > kMaxStates)
                     return NonRecursiveReturnFeasibility::Inconclusive;
                 if (current.depth > kMaxDepth)
@@ -636,6 +682,7 @@ namespace ctrace::stack::analysis
                 unsigned& visitCount = visits[visitKey];
                 if (visitCount++ > kMaxVisitsPerNode)
                     continue;
+                expandedHere.push_back(current.ranges);
 
                 const BasicBlock* BB = current.block;
                 bool sawRecursiveCall = current.sawRecursiveCall;
@@ -691,7 +738,8 @@ namespace ctrace::stack::analysis
                             IntRange edgeConstraint;
                             if (deriveEdgeConstraint(*icmp, succIndex == 0, key, edgeConstraint))
                             {
-                                if (!applyConstraintToState(next.ranges, key, edgeConstraint))
+                                if (!narrowRanges(current.ranges, key, edgeConstraint,
+                                                  next.ranges))
                                     continue;
                             }
                         }
@@ -699,7 +747,7 @@ namespace ctrace::stack::analysis
                         const llvm::Value* edgeCondition =
                             branch->getCondition()->stripPointerCasts();
                         const ConstraintSat sat = evaluator.isSatisfiable(
-                            next.ranges, edgeCondition, succIndex == 0, BB, current.predecessor);
+                            *next.ranges, edgeCondition, succIndex == 0, BB, current.predecessor);
                         if (sat == ConstraintSat::Unsat)
                             continue;
                         if (sat == ConstraintSat::Unknown)
@@ -726,99 +774,89 @@ namespace ctrace::stack::analysis
                                        : NonRecursiveReturnFeasibility::Exists;
         }
 
-        struct TarjanState
-        {
-            std::unordered_map<const llvm::Function*, int> index;
-            std::unordered_map<const llvm::Function*, int> lowlink;
-            std::vector<const llvm::Function*> stack;
-            std::unordered_set<const llvm::Function*> onStack;
-            std::set<const llvm::Function*> recursive;
-            std::vector<std::vector<const llvm::Function*>> recursiveComponents;
-            int nextIndex = 0;
-            int reserved = 0;
-        };
-
-        static void strongConnect(const llvm::Function* V, const CallGraph& CG, TarjanState& state)
+        // Strongly connected components of a DenseCallGraph. Components come
+        // out callees-first (reverse topological order); members keep
+        // Tarjan's pop order.
+        struct SccDecomposition
         {
-            state.index[V] = state.nextIndex;
-            state.lowlink[V] = state.nextIndex;
-            ++state.nextIndex;
-            state.stack.push_back(V);
-            state.onStack.insert(V);
+            std::vector<std::uint32_t> componentOf;
+            std::vector<std::uint32_t> offsets{0};
+            std::vector<FunctionId> members;
 
-            if (!hasNoRecurseContract(V))
+            std::size_t componentCount() const
             {
-                auto it = CG.find(V);
-                if (it != CG.end())
-                {
-                    for (const llvm::Function* W : it->second)
-                    {
-                        if (hasNoRecurseContract(W))
-                            continue;
-
-                        if (state.index.find(W) == state.index.end())
-                        {
-                            strongConnect(W, CG, state);
-                            state.lowlink[V] = std::min(state.lowlink[V], state.lowlink[W]);
-                        }
-                        else if (state.onStack.count(W))
-                        {
-                            state.lowlink[V] = std::min(state.lowlink[V], state.index[W]);
-                        }
-                    }
-                }
+                return offsets.size() - 1;
             }
+        };
 
-            if (state.lowlink[V] == state.index[V])
-            {
-                std::vector<const llvm::Function*> component;
-                const llvm::Function* W = nullptr;
-                do
+        // Nodes flagged in `excluded` are neither roots nor edge targets.
+        static SccDecomposition computeSccs(const std::vector<std::uint32_t>& offsets,
+                                            const std::vector<FunctionId>& targets,
+                                            const std::vector<char>& excluded)
+        {
+            const auto count = static_cast<std::uint32_t>(offsets.size() - 1);
+
+            SccDecomposition result;
+            result.componentOf.assign(count, std::numeric_limits<std::uint32_t>::max());
+            result.members.reserve(count);
+            forEachStronglyConnectedComponent(
+                count,
+                [&](FunctionId v)
                 {
-                    W = state.stack.back();
-                    state.stack.pop_back();
-                    state.onStack.erase(W);
-                    component.push_back(W);
-                } while (W != V);
-
-                if (component.size() > 1)
+                    return std::span<const FunctionId>(targets.data() + offsets[v],
+                                                       targets.data() + offsets[v + 1]);
+                },
+                [&](FunctionId v) { return excluded[v] != 0; },
+                [&](std::span<const FunctionId> members)
                 {
-                    for (const llvm::Function* Fn : component)
+                    const auto component = static_cast<std::uint32_t>(result.componentCount());
+                    for (const FunctionId w : members)
                     {
-                        state.recursive.insert(Fn);
+                        result.componentOf[w] = component;
+                        result.members.push_back(w);
                     }
-                    state.recursiveComponents.push_back(std::move(component));
-                }
-                else if (hasSelfCall(V, CG))
-                {
-                    state.recursive.insert(V);
-                    state.recursiveComponents.push_back(std::move(component));
-                }
+                    result.offsets.push_back(static_cast<std::uint32_t>(result.members.size()));
+                });
+            return result;
+        }
+
+        static bool hasSelfEdge(const std::vector<std::uint32_t>& offsets,
+                                const std::vector<FunctionId>& targets, FunctionId id)
+        {
+            for (std::uint32_t edge = offsets[id]; edge < offsets[id + 1]; ++edge)
+            {
+                if (targets[edge] == id)
+                    return true;
             }
+            return false;
         }
 
-        static std::set<const llvm::Function*>
-        computeRecursiveFunctions(const CallGraph& CG,
-                                  const std::vector<const llvm::Function*>& nodes)
+        static std::vector<std::vector<const llvm::Function*>>
+        collectRecursiveComponents(const DenseCallGraph& graph)
         {
-            TarjanState state;
-            state.index.reserve(nodes.size());
-            state.lowlink.reserve(nodes.size());
-            state.stack.reserve(nodes.size());
-            state.onStack.reserve(nodes.size());
+            std::vector<char> noRecurse(graph.size(), 0);
+            for (FunctionId id = 0; id < graph.size(); ++id)
+                noRecurse[id] = hasNoRecurseContract(graph.functions[id]) ? 1 : 0;
 
-            for (const llvm::Function* V : nodes)
+            const SccDecomposition sccs = computeSccs(graph.offsets, graph.targets, noRecurse);
+            std::vector<std::vector<const llvm::Function*>> components;
+            for (std::size_t c = 0; c < sccs.componentCount(); ++c)
             {
-                if (hasNoRecurseContract(V))
+                const std::uint32_t begin = sccs.offsets[c];
+                const std::uint32_t end = sccs.offsets[c + 1];
+                if (end - begin == 1 &&
+                    !hasSelfEdge(graph.offsets, graph.targets, sccs.members[begin]))
                     continue;
-                if (state.index.find(V) == state.index.end())
-                {
-                    strongConnect(V, CG, state);
-                }
-            }
 
-            return state.recursive;
+                std::vector<const llvm::Function*> component;
+                component.reserve(end - begin);
+                for (std::uint32_t i = begin; i < end; ++i)
+                    component.push_back(graph.functions[sccs.members[i]]);
+                components.push_back(std::move(component));
+            }
+            return components;
         }
+
     } // namespace
 
     CallGraph buildCallGraph(llvm::Module& M)
@@ -871,56 +909,149 @@ namespace ctrace::stack::analysis
         return {};
     }
 
+    DenseCallGraph buildDenseCallGraph(const CallGraph& CG,
+                                       const std::vector<const llvm::Function*>& nodes)
+    {
+        DenseCallGraph graph;
+        graph.functions.reserve(nodes.size());
+        graph.ids.reserve(nodes.size());
+        graph.offsets.reserve(nodes.size() + 1);
+
+        auto intern = [&graph](const llvm::Function* F)
+        {
+            auto [it, inserted] =
+                graph.ids.try_emplace(F, static_cast<FunctionId>(graph.functions.size()));
+            if (inserted)
+                graph.functions.push_back(F);
+            return it->second;
+        };
+
+        for (const llvm::Function* F : nodes)
+            intern(F);
+
+        // Rows are emitted in id order; callees first seen here get ids past
+        // the end and their rows follow in the same loop.
+        for (FunctionId id = 0; id < graph.functions.size(); ++id)
+        {
+            auto it = CG.find(graph.functions[id]);
+            if (it != CG.end())
+            {
+                for (const llvm::Function* Callee : it->second)
+                    graph.targets.push_back(intern(Callee));
+            }
+            graph.offsets.push_back(static_cast<std::uint32_t>(graph.targets.size()));
+        }
+
+        return graph;
+    }
+
+    CallGraph expandCallGraph(const DenseCallGraph& graph)
+    {
+        CallGraph CG;
+        for (FunctionId id = 0; id < graph.size(); ++id)
+        {
+            auto& callees = CG[graph.functions[id]];
+            callees.reserve(graph.offsets[id + 1] - graph.offsets[id]);
+            for (std::uint32_t edge = graph.offsets[id]; edge < graph.offsets[id + 1]; ++edge)
+                callees.push_back(graph.functions[graph.targets[edge]]);
+        }
+        return CG;
+    }
+
     InternalAnalysisState
     computeGlobalStackUsage(const CallGraph& CG,
                             const std::map<const llvm::Function*, LocalStackInfo>& LocalStack)
     {
-        InternalAnalysisState Res;
-        std::map<const llvm::Function*, VisitState> State;
-
         std::vector<const llvm::Function*> nodes;
         nodes.reserve(LocalStack.size());
+        for (const auto& entry : LocalStack)
+            nodes.push_back(entry.first);
 
-        for (auto& p : LocalStack)
-        {
-            State[p.first] = NotVisited;
-            nodes.push_back(p.first);
-        }
+        return computeGlobalStackUsage(buildDenseCallGraph(CG, nodes), LocalStack);
+    }
 
-        Res.RecursiveFuncs = computeRecursiveFunctions(CG, nodes);
+    std::vector<StackEstimate> propagateMaxStack(const std::vector<std::uint32_t>& offsets,
+                                                 const std::vector<FunctionId>& targets,
+                                                 const std::vector<StackEstimate>& localById)
+    {
+        const std::size_t count = offsets.size() - 1;
+        const SccDecomposition sccs = computeSccs(offsets, targets, std::vector<char>(count, 0));
+        std::vector<StackEstimate> totalById(count);
 
-        for (auto& p : LocalStack)
+        for (std::size_t c = 0; c < sccs.componentCount(); ++c)
         {
-            const llvm::Function* F = p.first;
-            if (State[F] == NotVisited)
+            const std::uint32_t begin = sccs.offsets[c];
+            const std::uint32_t end = sccs.offsets[c + 1];
+            const bool cyclic =
+                end - begin > 1 || hasSelfEdge(offsets, targets, sccs.members[begin]);
+
+            StackEstimate frames = {};
+            StackSize largestFrame = 0;
+            StackEstimate deepestExit = {};
+            for (std::uint32_t i = begin; i < end; ++i)
             {
-                dfsComputeStack(F, CG, LocalStack, State, Res);
+                const FunctionId v = sccs.members[i];
+                frames.bytes += localById[v].bytes;
+                frames.unknown = frames.unknown || localById[v].unknown;
+                largestFrame = std::max(largestFrame, localById[v].bytes);
+
+                for (std::uint32_t edge = offsets[v]; edge < offsets[v + 1]; ++edge)
+                {
+                    const FunctionId w = targets[edge];
+                    if (sccs.componentOf[w] == c)
+                        continue;
+                    deepestExit.bytes = std::max(deepestExit.bytes, totalById[w].bytes);
+                    deepestExit.unknown = deepestExit.unknown || totalById[w].unknown;
+                }
             }
+
+            StackEstimate total;
+            total.bytes = frames.bytes + (cyclic ? std::max(largestFrame, deepestExit.bytes)
+                                                 : deepestExit.bytes);
+            total.unknown = frames.unknown || deepestExit.unknown;
+            for (std::uint32_t i = begin; i < end; ++i)
+                totalById[sccs.members[i]] = total;
         }
 
-        return Res;
+        return totalById;
     }
 
-    std::vector<std::vector<const llvm::Function*>>
-    computeRecursiveComponents(const CallGraph& CG, const std::vector<const llvm::Function*>& nodes)
+    InternalAnalysisState
+    computeGlobalStackUsage(const DenseCallGraph& graph,
+                            const std::map<const llvm::Function*, LocalStackInfo>& LocalStack)
     {
-        TarjanState state;
-        state.index.reserve(nodes.size());
-        state.lowlink.reserve(nodes.size());
-        state.stack.reserve(nodes.size());
-        state.onStack.reserve(nodes.size());
-
-        for (const llvm::Function* V : nodes)
+        std::vector<StackEstimate> localById(graph.size());
+        for (const auto& [F, info] : LocalStack)
         {
-            if (hasNoRecurseContract(V))
+            auto it = graph.ids.find(F);
+            if (it == graph.ids.end())
                 continue;
-            if (state.index.find(V) == state.index.end())
-            {
-                strongConnect(V, CG, state);
-            }
+            localById[it->second].bytes = info.bytes;
+            localById[it->second].unknown = info.unknown;
         }
 
-        return state.recursiveComponents;
+        InternalAnalysisState Res;
+        const std::vector<StackEstimate> totalById =
+            propagateMaxStack(graph.offsets, graph.targets, localById);
+        for (FunctionId id = 0; id < graph.size(); ++id)
+            Res.TotalStack.emplace(graph.functions[id], totalById[id]);
+
+        for (const auto& component : collectRecursiveComponents(graph))
+            Res.RecursiveFuncs.insert(component.begin(), component.end());
+
+        return Res;
+    }
+
+    std::vector<std::vector<const llvm::Function*>>
+    computeRecursiveComponents(const CallGraph& CG, const std::vector<const llvm::Function*>& nodes)
+    {
+        return computeRecursiveComponents(buildDenseCallGraph(CG, nodes));
+    }
+
+    std::vector<std::vector<const llvm::Function*>>
+    computeRecursiveComponents(const DenseCallGraph& graph)
+    {
+        return collectRecursiveComponents(graph);
     }
 
     bool detectInfiniteSelfRecursion(llvm::Function& F)
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "analysis/StackPointerEscape.hpp"
 #include "analysis/IRValueUtils.hpp"
+#include "analysis/ModelRegistry.hpp"
+#include "mangle.hpp"
 #include "StackPointerEscapeInternal.hpp"
 
 #include <llvm/Analysis/ValueTracking.h>
@@ -14,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -265,6 +268,82 @@ namespace ctrace::stack::analysis
             return summaries.find(callee) == summaries.end();
         }
 
+        static EscapeSummaryState fromPublicArgState(StackEscapeArgState state)
+        {
+            switch (state)
+            {
+            case StackEscapeArgState::NoEscape:
+                return EscapeSummaryState::NoEscape;
+            case StackEscapeArgState::MayEscape:
+                return EscapeSummaryState::MayEscape;
+            case StackEscapeArgState::Unknown:
+                break;
+            }
+            return EscapeSummaryState::Unknown;
+        }
+
+        static StackEscapeArgState toPublicArgState(EscapeSummaryState state)
+        {
+            switch (state)
+            {
+            case EscapeSummaryState::NoEscape:
+                return StackEscapeArgState::NoEscape;
+            case EscapeSummaryState::MayEscape:
+                return StackEscapeArgState::MayEscape;
+            case EscapeSummaryState::Unknown:
+                break;
+            }
+            return StackEscapeArgState::Unknown;
+        }
+
+        static unsigned publicArgStateRank(StackEscapeArgState state)
+        {
+            switch (state)
+            {
+            case StackEscapeArgState::NoEscape:
+                return 0;
+            case StackEscapeArgState::Unknown:
+                return 1;
+            case StackEscapeArgState::MayEscape:
+                return 2;
+            }
+            return 1;
+        }
+
+        // Resolves direct calls to functions without a local summary against
+        // summaries exported by other translation units. Canonical names are
+        // computed once per callee.
+        class ExternalEscapeSummaryLookup
+        {
+          public:
+            explicit ExternalEscapeSummaryLookup(const StackEscapeSummaryIndex* index)
+                : index(index)
+            {
+            }
+
+            std::optional<EscapeSummaryState> stateForArg(const llvm::Function* callee,
+                                                          unsigned argIndex)
+            {
+                if (!index || !callee || !callee->hasName() || index->functions.empty())
+                    return std::nullopt;
+                auto [it, inserted] = byCallee.try_emplace(callee, nullptr);
+                if (inserted)
+                {
+                    const auto found = index->functions.find(
+                        ctrace_tools::canonicalizeMangledName(callee->getName().str()));
+                    if (found != index->functions.end())
+                        it->second = &found->second;
+                }
+                if (!it->second || argIndex >= it->second->args.size())
+                    return std::nullopt;
+                return fromPublicArgState(it->second->args[argIndex]);
+            }
+
+          private:
+            const StackEscapeSummaryIndex* index = nullptr;
+            std::unordered_map<const llvm::Function*, const StackEscapeSummaryFunction*> byCallee;
+        };
+
         static std::optional<unsigned>
         inferReturnedPointerArgAlias(const llvm::Function& F,
                                      const ReturnedPointerArgAliasMap& returnedArgAliases)
@@ -355,6 +434,7 @@ namespace ctrace::stack::analysis
                                 const IndirectTargetResolver& targetResolver,
                                 const ReturnedPointerArgAliasMap& returnedArgAliases,
                                 const StackEscapeModel& model, StackEscapeRuleMatcher& ruleMatcher,
+                                ExternalEscapeSummaryLookup& externalSummaries,
                                 ParamEscapeFacts& facts)
         {
             using namespace llvm;
@@ -454,10 +534,18 @@ namespace ctrace::stack::analysis
 
                                 if (directCallee->isDeclaration() || !shouldAnalyze(*directCallee))
                                 {
-                                    // Opaque external declaration (or function intentionally
-                                    // excluded from analysis). Without attributes/model we keep
-                                    // the state unknown instead of forcing an escape.
-                                    facts.hasOpaqueExternalCall = true;
+                                    // Defined in another TU (or intentionally excluded from
+                                    // analysis): use its cross-TU summary when one exists.
+                                    // Without attributes/model/summary we keep the state
+                                    // unknown instead of forcing an escape.
+                                    const std::optional<EscapeSummaryState> externalState =
+                                        externalSummaries.stateForArg(directCallee, argIndex);
+                                    if (externalState == EscapeSummaryState::NoEscape)
+                                        continue;
+                                    if (externalState == EscapeSummaryState::MayEscape)
+                                        facts.externalMayEscape = true;
+                                    else
+                                        facts.hasOpaqueExternalCall = true;
                                     continue;
                                 }
 
@@ -558,7 +646,8 @@ namespace ctrace::stack::analysis
                                  const std::function<bool(const llvm::Function&)>& shouldAnalyze,
                                  const IndirectTargetResolver& targetResolver,
                                  const ReturnedPointerArgAliasMap& returnedArgAliases,
-                                 const StackEscapeModel& model, StackEscapeRuleMatcher& ruleMatcher)
+                                 const StackEscapeModel& model, StackEscapeRuleMatcher& ruleMatcher,
+                                 ExternalEscapeSummaryLookup& externalSummaries)
         {
             FunctionEscapeFactsMap factsMap;
 
@@ -577,7 +666,7 @@ namespace ctrace::stack::analysis
                         continue;
                     collectParamEscapeFacts(F, arg, shouldAnalyze, targetResolver,
                                             returnedArgAliases, model, ruleMatcher,
-                                            facts.perArg[arg.getArgNo()]);
+                                            externalSummaries, facts.perArg[arg.getArgNo()]);
                 }
                 factsMap.emplace(&F, std::move(facts));
             }
@@ -588,10 +677,12 @@ namespace ctrace::stack::analysis
             llvm::Module& mod, const std::function<bool(const llvm::Function&)>& shouldAnalyze,
             const IndirectTargetResolver& targetResolver,
             const ReturnedPointerArgAliasMap& returnedArgAliases, const StackEscapeModel& model,
-            StackEscapeRuleMatcher& ruleMatcher, FunctionArgHardEscapeMap* hardEscapesOut)
+            StackEscapeRuleMatcher& ruleMatcher, ExternalEscapeSummaryLookup& externalSummaries,
+            FunctionArgHardEscapeMap* hardEscapesOut)
         {
-            FunctionEscapeFactsMap factsMap = buildFunctionEscapeFacts(
-                mod, shouldAnalyze, targetResolver, returnedArgAliases, model, ruleMatcher);
+            FunctionEscapeFactsMap factsMap =
+                buildFunctionEscapeFacts(mod, shouldAnalyze, targetResolver, returnedArgAliases,
+                                         model, ruleMatcher, externalSummaries);
 
             if (hardEscapesOut)
             {
@@ -644,7 +735,7 @@ namespace ctrace::stack::analysis
                         EscapeSummaryState nextState = EscapeSummaryState::NoEscape;
                         bool hasUnknownDependency = paramFacts.hasOpaqueExternalCall;
 
-                        if (paramFacts.hardEscape)
+                        if (paramFacts.hardEscape || paramFacts.externalMayEscape)
                         {
                             nextState = EscapeSummaryState::MayEscape;
                         }
@@ -727,7 +818,8 @@ namespace ctrace::stack::analysis
             const FunctionArgHardEscapeMap& hardEscapesByArg,
             IndirectTargetResolver& targetResolver,
             const ReturnedPointerArgAliasMap& returnedArgAliases, const StackEscapeModel& model,
-            StackEscapeRuleMatcher& ruleMatcher, std::vector<StackPointerEscapeIssue>& out)
+            StackEscapeRuleMatcher& ruleMatcher, ExternalEscapeSummaryLookup& externalSummaries,
+            std::vector<StackPointerEscapeIssue>& out)
         {
             using namespace llvm;
 
@@ -879,6 +971,12 @@ namespace ctrace::stack::analysis
                                         {
                                             continue;
                                         }
+                                        if (externalSummaries.stateForArg(directCallee,
+                                                                          argIndex) ==
+                                            EscapeSummaryState::NoEscape)
+                                        {
+                                            continue;
+                                        }
                                         if (ruleMatcher.modelSaysNoEscapeArg(model, directCallee,
                                                                              argIndex))
                                         {
@@ -1027,31 +1125,132 @@ namespace ctrace::stack::analysis
         }
     } // namespace
 
-    std::vector<StackPointerEscapeIssue>
-    analyzeStackPointerEscapes(llvm::Module& mod,
-                               const std::function<bool(const llvm::Function&)>& shouldAnalyze,
-                               const std::string& escapeModelPath)
+    namespace
     {
-        std::vector<StackPointerEscapeIssue> issues;
-
-        StackEscapeModel model;
-        if (!escapeModelPath.empty())
+        static std::shared_ptr<const StackEscapeModel>
+        loadStackEscapeModel(const std::string& escapeModelPath)
         {
+            if (escapeModelPath.empty())
+                return nullptr;
             std::string parseError;
-            if (!parseStackEscapeModel(escapeModelPath, model, parseError))
+            std::shared_ptr<const StackEscapeModel> loaded =
+                ModelRegistry<StackEscapeModel>::instance().load(
+                    escapeModelPath, &parseStackEscapeModel, parseError);
+            if (!loaded)
             {
                 coretrace::log(coretrace::Level::Warn, "stack escape model ignored: {}\n",
                                parseError);
             }
+            return loaded;
         }
+    } // namespace
+
+    StackEscapeSummaryIndex
+    buildStackEscapeSummaryIndex(llvm::Module& mod,
+                                 const std::function<bool(const llvm::Function&)>& shouldAnalyze,
+                                 const std::string& escapeModelPath,
+                                 const StackEscapeSummaryIndex* externalSummaries)
+    {
+        const StackEscapeModel emptyModel;
+        const std::shared_ptr<const StackEscapeModel> loadedModel =
+            loadStackEscapeModel(escapeModelPath);
+        const StackEscapeModel& model = loadedModel ? *loadedModel : emptyModel;
+
+        IndirectTargetResolver targetResolver(mod);
+        StackEscapeRuleMatcher ruleMatcher;
+        ExternalEscapeSummaryLookup externalLookup(externalSummaries);
+        const ReturnedPointerArgAliasMap returnedArgAliases = buildReturnedPointerArgAliases(mod);
+        const FunctionEscapeSummaryMap summaries =
+            buildFunctionEscapeSummaries(mod, shouldAnalyze, targetResolver, returnedArgAliases,
+                                         model, ruleMatcher, externalLookup, nullptr);
+
+        StackEscapeSummaryIndex index;
+        for (const auto& entry : summaries)
+        {
+            const llvm::Function* F = entry.first;
+            // Cross-TU exchange by symbol name is meaningful only for externally
+            // visible functions.
+            if (!F->hasName() || F->getName().empty() || F->hasLocalLinkage())
+                continue;
+            StackEscapeSummaryFunction exported;
+            exported.args.reserve(entry.second.size());
+            for (EscapeSummaryState state : entry.second)
+                exported.args.push_back(toPublicArgState(state));
+            index.functions[ctrace_tools::canonicalizeMangledName(F->getName().str())] =
+                std::move(exported);
+        }
+        return index;
+    }
+
+    bool mergeStackEscapeSummaryEntry(StackEscapeSummaryIndex& dst, const std::string& name,
+                                      const StackEscapeSummaryFunction& incoming)
+    {
+        auto [it, inserted] = dst.functions.try_emplace(name, incoming);
+        if (inserted)
+            return true;
+
+        bool changed = false;
+        std::vector<StackEscapeArgState>& args = it->second.args;
+        if (args.size() < incoming.args.size())
+        {
+            args.resize(incoming.args.size(), StackEscapeArgState::Unknown);
+            changed = true;
+        }
+        for (std::size_t i = 0; i < incoming.args.size(); ++i)
+        {
+            if (publicArgStateRank(incoming.args[i]) > publicArgStateRank(args[i]))
+            {
+                args[i] = incoming.args[i];
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool mergeStackEscapeSummaryIndex(StackEscapeSummaryIndex& dst,
+                                      const StackEscapeSummaryIndex& src)
+    {
+        bool changed = false;
+        for (const auto& entry : src.functions)
+            changed |= mergeStackEscapeSummaryEntry(dst, entry.first, entry.second);
+        return changed;
+    }
+
+    bool stackEscapeSummaryIndexEquals(const StackEscapeSummaryIndex& lhs,
+                                       const StackEscapeSummaryIndex& rhs)
+    {
+        if (lhs.functions.size() != rhs.functions.size())
+            return false;
+        for (const auto& entry : lhs.functions)
+        {
+            const auto it = rhs.functions.find(entry.first);
+            if (it == rhs.functions.end() || it->second.args != entry.second.args)
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<StackPointerEscapeIssue>
+    analyzeStackPointerEscapes(llvm::Module& mod,
+                               const std::function<bool(const llvm::Function&)>& shouldAnalyze,
+                               const std::string& escapeModelPath,
+                               const StackEscapeSummaryIndex* externalSummaries)
+    {
+        std::vector<StackPointerEscapeIssue> issues;
+
+        const StackEscapeModel emptyModel;
+        const std::shared_ptr<const StackEscapeModel> loadedModel =
+            loadStackEscapeModel(escapeModelPath);
+        const StackEscapeModel& model = loadedModel ? *loadedModel : emptyModel;
 
         IndirectTargetResolver targetResolver(mod);
         StackEscapeRuleMatcher ruleMatcher;
+        ExternalEscapeSummaryLookup externalLookup(externalSummaries);
         const ReturnedPointerArgAliasMap returnedArgAliases = buildReturnedPointerArgAliases(mod);
         FunctionArgHardEscapeMap hardEscapesByArg;
         const FunctionEscapeSummaryMap summaries =
             buildFunctionEscapeSummaries(mod, shouldAnalyze, targetResolver, returnedArgAliases,
-                                         model, ruleMatcher, &hardEscapesByArg);
+                                         model, ruleMatcher, externalLookup, &hardEscapesByArg);
 
         for (llvm::Function& F : mod)
         {
@@ -1060,7 +1259,8 @@ namespace ctrace::stack::analysis
             if (!shouldAnalyze(F))
                 continue;
             analyzeStackPointerEscapesInFunction(F, summaries, hardEscapesByArg, targetResolver,
-                                                 returnedArgAliases, model, ruleMatcher, issues);
+                                                 returnedArgAliases, model, ruleMatcher,
+                                                 externalLookup, issues);
         }
         return issues;
     }
@@ -57,7 +57,9 @@ namespace ctrace::stack::analysis
         std::vector<IndirectCallDependency> indirectDeps;
         std::uint64_t hardEscape : 1 = false;
         std::uint64_t hasOpaqueExternalCall : 1 = false;
-        std::uint64_t reservedFlags : 62 = 0;
+        // Passed to a callee whose cross-TU summary says the argument may escape.
+        std::uint64_t externalMayEscape : 1 = false;
+        std::uint64_t reservedFlags : 61 = 0;
     };
 
     struct FunctionEscapeFacts
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/StackSummary.hpp"
+
+#include "analysis/AnalyzerUtils.hpp"
+#include "mangle.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+
+namespace ctrace::stack::analysis
+{
+    ModuleStackSummary
+    buildModuleStackSummary(const std::vector<llvm::Function*>& definedFunctions,
+                            const std::map<const llvm::Function*, LocalStackInfo>& localStack,
+                            const InternalAnalysisState& state)
+    {
+        ModuleStackSummary summary;
+        summary.functions.resize(definedFunctions.size());
+
+        std::unordered_map<const llvm::Function*, std::uint32_t> indices;
+        indices.reserve(definedFunctions.size());
+        for (std::uint32_t i = 0; i < definedFunctions.size(); ++i)
+            indices.emplace(definedFunctions[i], i);
+
+        for (std::uint32_t i = 0; i < definedFunctions.size(); ++i)
+        {
+            const llvm::Function& F = *definedFunctions[i];
+            StackSummaryFunction& fn = summary.functions[i];
+            fn.name = F.getName().str();
+            if (!F.hasLocalLinkage() && !fn.name.empty())
+                fn.linkName = ctrace_tools::canonicalizeMangledName(fn.name);
+            (void)getFunctionSourceLocation(F, fn.line, fn.column);
+
+            if (auto it = localStack.find(&F); it != localStack.end())
+            {
+                fn.localStack = it->second.bytes;
+                fn.localStackUnknown = it->second.unknown;
+            }
+            if (auto it = state.TotalStack.find(&F); it != state.TotalStack.end())
+            {
+                fn.maxStack = it->second.bytes;
+                fn.maxStackUnknown = it->second.unknown;
+            }
+
+            for (const llvm::BasicBlock& BB : F)
+            {
+                for (const llvm::Instruction& I : BB)
+                {
+                    const auto* CB = llvm::dyn_cast<llvm::CallBase>(&I);
+                    const llvm::Function* callee = CB ? CB->getCalledFunction() : nullptr;
+                    if (!callee || callee->isIntrinsic())
+                        continue;
+                    if (auto it = indices.find(callee); it != indices.end())
+                        fn.localCallees.push_back(it->second);
+                    else if (callee->isDeclaration() && callee->hasName())
+                        fn.externalCallees.push_back(
+                            ctrace_tools::canonicalizeMangledName(callee->getName().str()));
+                }
+            }
+        }
+
+        return summary;
+    }
+
+    WholeProgramStack
+    linkWholeProgramStack(std::vector<std::shared_ptr<const ModuleStackSummary>> modules)
+    {
+        WholeProgramStack program;
+        program.modules = std::move(modules);
+
+        std::uint32_t count = 0;
+        program.moduleBase.reserve(program.modules.size());
+        for (const auto& module : program.modules)
+        {
+            program.moduleBase.push_back(count);
+            count += static_cast<std::uint32_t>(module->functions.size());
+        }
+
+        std::unordered_map<std::string_view, FunctionId> definitions;
+        definitions.reserve(count);
+        std::vector<StackEstimate> localById(count);
+        for (std::size_t m = 0; m < program.modules.size(); ++m)
+        {
+            const auto& functions = program.modules[m]->functions;
+            for (std::uint32_t i = 0; i < functions.size(); ++i)
+            {
+                const FunctionId id = program.moduleBase[m] + i;
+                localById[id].bytes = functions[i].localStack;
+                localById[id].unknown = functions[i].localStackUnknown;
+                if (!functions[i].linkName.empty())
+                    definitions.try_emplace(functions[i].linkName, id);
+            }
+        }
+
+        program.offsets.reserve(static_cast<std::size_t>(count) + 1);
+        for (std::size_t m = 0; m < program.modules.size(); ++m)
+        {
+            const FunctionId base = program.moduleBase[m];
+            for (const StackSummaryFunction& fn : program.modules[m]->functions)
+            {
+                for (std::uint32_t callee : fn.localCallees)
+                    program.targets.push_back(base + callee);
+                for (const std::string& callee : fn.externalCallees)
+                {
+                    auto it = definitions.find(callee);
+                    if (it == definitions.end())
+                    {
+                        ++program.unresolvedExternalCalls;
+                        continue;
+                    }
+                    program.targets.push_back(it->second);
+                    ++program.resolvedExternalCalls;
+                }
+                program.offsets.push_back(static_cast<std::uint32_t>(program.targets.size()));
+            }
+        }
+
+        program.totals = propagateMaxStack(program.offsets, program.targets, localById);
+
+        // Never report less than the module-local pass already did.
+        for (std::size_t m = 0; m < program.modules.size(); ++m)
+        {
+            const auto& functions = program.modules[m]->functions;
+            for (std::uint32_t i = 0; i < functions.size(); ++i)
+            {
+                StackEstimate& total = program.totals[program.moduleBase[m] + i];
+                total.bytes = std::max(total.bytes, functions[i].maxStack);
+                total.unknown = total.unknown || functions[i].maxStackUnknown;
+            }
+        }
+
+        return program;
+    }
+
+    std::string wholeProgramCallPath(const WholeProgramStack& program, FunctionId id)
+    {
+        auto functionName = [&program](FunctionId node) -> const std::string&
+        {
+            const auto it =
+                std::upper_bound(program.moduleBase.begin(), program.moduleBase.end(), node);
+            const std::size_t module =
+                static_cast<std::size_t>(std::distance(program.moduleBase.begin(), it)) - 1;
+            return program.modules[module]->functions[node - program.moduleBase[module]].name;
+        };
+
+        std::string path;
+        std::unordered_set<FunctionId> visited;
+        FunctionId current = id;
+        while (visited.insert(current).second)
+        {
+            if (!path.empty())
+                path += " -> ";
+            path += functionName(current);
+
+            const std::uint32_t begin = program.offsets[current];
+            const std::uint32_t end = program.offsets[current + 1];
+            if (begin == end)
+                break;
+
+            FunctionId best = program.targets[begin];
+            for (std::uint32_t edge = begin + 1; edge < end; ++edge)
+            {
+                if (program.totals[program.targets[edge]].bytes > program.totals[best].bytes)
+                    best = program.targets[edge];
+            }
+            if (program.totals[best].bytes == 0)
+                break;
+            current = best;
+        }
+
+        return path;
+    }
+} // namespace ctrace::stack::analysis
@@ -37,6 +37,7 @@
 #include <coretrace/logger.hpp>
 
 #include "analysis/AnalyzerUtils.hpp"
+#include "analysis/DataflowWorklist.hpp"
 #include "analysis/IRValueUtils.hpp"
 
 namespace ctrace::stack::analysis
@@ -220,9 +221,9 @@ namespace ctrace::stack::analysis
             ranges.erase(it + 1, next);
         }
 
-        static RangeSet intersectRanges(const RangeSet& lhs, const RangeSet& rhs)
+        static void intersectRanges(const RangeSet& lhs, const RangeSet& rhs, RangeSet& out)
         {
-            RangeSet out;
+            out.clear();
             std::size_t i = 0;
             std::size_t j = 0;
             while (i < lhs.size() && j < rhs.size())
@@ -237,7 +238,6 @@ namespace ctrace::stack::analysis
                 else
                     ++j;
             }
-            return out;
         }
 
         static bool isRangeCovered(const RangeSet& initialized, std::uint64_t begin,
@@ -1150,83 +1150,43 @@ namespace ctrace::stack::analysis
             return top;
         }
 
-        static void meetMustState(InitRangeState& accum, const InitRangeState& incoming)
+        // Intersects incoming into accum in place; scratch is a reusable buffer
+        // so converged loops stop allocating.
+        static void meetMustState(InitRangeState& accum, const InitRangeState& incoming,
+                                  RangeSet& scratch)
         {
             if (accum.size() != incoming.size())
                 return;
             for (std::size_t idx = 0; idx < accum.size(); ++idx)
             {
-                accum[idx] = intersectRanges(accum[idx], incoming[idx]);
-            }
-        }
-
-        static bool statesEqual(const InitRangeState& lhs, const InitRangeState& rhs)
-        {
-            return lhs == rhs;
-        }
-
-        static void computeReachableBlocks(const llvm::Function& F,
-                                           llvm::DenseMap<const llvm::BasicBlock*, bool>& reachable)
-        {
-            reachable.clear();
-            if (F.empty())
-                return;
-
-            llvm::SmallVector<const llvm::BasicBlock*, 16> worklist;
-            worklist.push_back(&F.getEntryBlock());
-            reachable[&F.getEntryBlock()] = true;
-
-            while (!worklist.empty())
-            {
-                const llvm::BasicBlock* BB = worklist.pop_back_val();
-                for (const llvm::BasicBlock* succ : llvm::successors(BB))
-                {
-                    if (!succ)
-                        continue;
-                    auto [it, inserted] = reachable.try_emplace(succ, true);
-                    if (inserted)
-                    {
-                        worklist.push_back(succ);
-                    }
-                    else
-                    {
-                        it->second = true;
-                    }
-                }
+                RangeSet& lhs = accum[idx];
+                const RangeSet& rhs = incoming[idx];
+                if (lhs == rhs)
+                    continue;
+                intersectRanges(lhs, rhs, scratch);
+                lhs.swap(scratch);
             }
         }
 
-        static InitRangeState
-        computeInState(const llvm::BasicBlock& BB, const llvm::BasicBlock* entryBlock,
-                       const llvm::DenseMap<const llvm::BasicBlock*, bool>& reachable,
-                       const llvm::DenseMap<const llvm::BasicBlock*, InitRangeState>& outState,
-                       const TrackedObjectContext& tracked)
+        // Must-meet of the reachable predecessors' out-states into in, reusing
+        // its storage. The entry block starts with nothing initialized.
+        static void computeInState(std::uint32_t blockIdx, const ForwardDataflowOrder& order,
+                                   const std::vector<InitRangeState>& outState,
+                                   const InitRangeState& top, InitRangeState& in,
+                                   RangeSet& scratch)
         {
-            InitRangeState in = makeBottomState(tracked.objects.size());
-            if (&BB == entryBlock)
-                return in;
-
-            bool havePred = false;
-            InitRangeState merged = makeTopState(tracked);
-            for (const llvm::BasicBlock* pred : llvm::predecessors(&BB))
+            const std::vector<std::uint32_t>& preds = order.predecessors(blockIdx);
+            if (blockIdx == 0 || preds.empty())
             {
-                auto itReach = reachable.find(pred);
-                if (itReach == reachable.end() || !itReach->second)
-                    continue;
-                havePred = true;
-
-                auto itOut = outState.find(pred);
-                if (itOut == outState.end())
-                {
-                    merged = makeBottomState(tracked.objects.size());
-                    break;
-                }
-                meetMustState(merged, itOut->second);
+                in.resize(top.size());
+                for (RangeSet& ranges : in)
+                    ranges.clear();
+                return;
             }
 
-            if (!havePred)
-                return in;
-            return merged;
+            in = top;
+            for (const std::uint32_t pred : preds)
+                meetMustState(in, outState[pred], scratch);
         }
 
         static const llvm::Instruction* getAllocaDebugAnchor(const llvm::AllocaInst* AI)
@@ -3270,148 +3230,71 @@ namespace ctrace::stack::analysis
 
             const unsigned trackedCount = static_cast<unsigned>(tracked.objects.size());
 
-            llvm::DenseMap<const llvm::BasicBlock*, bool> reachable;
-            computeReachableBlocks(F, reachable);
+            const ForwardDataflowOrder order(F);
+            const std::uint32_t reachableBlocks = order.size();
+            const InitRangeState top = makeTopState(tracked);
 
-            llvm::DenseMap<const llvm::BasicBlock*, InitRangeState> inState;
-            llvm::DenseMap<const llvm::BasicBlock*, InitRangeState> outState;
-
-            for (const llvm::BasicBlock& BB : F)
+            // States are indexed by RPO number. Every non-entry block starts at
+            // top so loops converge to the greatest must-initialized fixpoint.
+            std::vector<InitRangeState> inState(reachableBlocks, top);
+            std::vector<InitRangeState> outState(reachableBlocks, top);
+            if (reachableBlocks != 0)
             {
-                if (!reachable.lookup(&BB))
-                    continue;
-                const bool isEntry = (&BB == &F.getEntryBlock());
-                inState[&BB] = isEntry ? makeBottomState(trackedCount) : makeTopState(tracked);
-                outState[&BB] = isEntry ? makeBottomState(trackedCount) : makeTopState(tracked);
+                inState[0] = makeBottomState(trackedCount);
+                outState[0] = makeBottomState(trackedCount);
             }
 
-            const unsigned reachableBlocks = static_cast<unsigned>(outState.size());
-
-            // Leaf function optimization: if no call in this function targets a
-            // function in summaries or externalSummariesByName, the dataflow
-            // converges in exactly 1 iteration (no interprocedural effects).
-            bool isLeaf = true;
-            for (const llvm::BasicBlock& BB : F)
+            // States only shrink, and each shrink of an object's ranges drops
+            // at least one segment between write boundaries, so the lattice
+            // height is bounded by the objects plus two boundaries per write.
+            std::uint64_t writeCount = 0;
+            for (std::uint32_t idx = 0; idx < reachableBlocks; ++idx)
             {
-                if (!isLeaf)
-                    break;
-                if (!reachable.lookup(&BB))
-                    continue;
-                for (const llvm::Instruction& I : BB)
-                {
-                    const auto* CB = llvm::dyn_cast<llvm::CallBase>(&I);
-                    if (!CB)
-                        continue;
-                    const llvm::Function* callee = CB->getCalledFunction();
-                    if (!callee)
-                        continue;
-                    if (summaries.find(callee) != summaries.end())
-                    {
-                        isLeaf = false;
-                        break;
-                    }
-                    if (externalSummariesByName && canonicalCalleeNames)
-                    {
-                        auto nameIt = canonicalCalleeNames->find(callee);
-                        if (nameIt != canonicalCalleeNames->end() &&
-                            externalSummariesByName->find(nameIt->second) !=
-                                externalSummariesByName->end())
-                        {
-                            isLeaf = false;
-                            break;
-                        }
-                    }
-                }
+                for (const llvm::Instruction& I : *order.block(idx))
+                    writeCount += I.mayWriteToMemory() ? 1 : 0;
             }
+            const std::uint64_t maxBlockVisits =
+                order.visitBudget(1 + trackedCount + 2 * writeCount);
 
-            // Leaf functions have no inter-procedural deps so the *summary*
-            // converges in one outer iteration, but the intra-function
-            // dataflow (loops, phi-nodes) still needs the full BB iteration
-            // budget to stabilize.
-            const unsigned maxIterations = std::max(64u, reachableBlocks * 16u);
-
-            // When in issue-collection mode (outSummary == nullptr), we fuse
-            // the issue collection into the fixpoint loop. On each iteration
-            // we collect issues opportunistically; if the fixpoint hasn't
-            // converged yet, we reset and recollect on the next iteration.
-            // When it converges, the collected issues are final, saving one
-            // full function traversal.
-            const bool fuseIssueCollection = (outSummary == nullptr && outIssues != nullptr);
-
-            llvm::BitVector writeSeen(trackedCount, false);
-            llvm::BitVector constructedSeen(trackedCount, false);
-            llvm::BitVector defaultCtorSeen(trackedCount, false);
-            llvm::BitVector readBeforeInitSeen(trackedCount, false);
-            std::vector<UninitializedLocalReadIssue> pendingIssues;
-
-            bool changed = true;
-            unsigned iteration = 0;
-            while (changed && iteration < maxIterations)
-            {
-                ++iteration;
-                changed = false;
-
-                if (fuseIssueCollection)
+            // A block is re-evaluated only when one of its predecessors'
+            // out-states changed; an unchanged in-state after the first visit
+            // implies an unchanged out-state, so the transfer is skipped.
+            llvm::BitVector visited(reachableBlocks, false);
+            InitRangeState newIn;
+            InitRangeState state;
+            RangeSet scratch;
+            order.runForward(
+                [&](std::uint32_t idx)
                 {
-                    writeSeen.reset();
-                    constructedSeen.reset();
-                    defaultCtorSeen.reset();
-                    readBeforeInitSeen.reset();
-                    pendingIssues.clear();
-                }
-
-                for (const llvm::BasicBlock& BB : F)
-                {
-                    if (!reachable.lookup(&BB))
-                        continue;
-
-                    InitRangeState newIn =
-                        computeInState(BB, &F.getEntryBlock(), reachable, outState, tracked);
-
-                    InitRangeState state = newIn;
-                    if (fuseIssueCollection)
-                    {
-                        for (const llvm::Instruction& I : BB)
-                        {
-                            transferInstruction(I, tracked, DL, summaries, externalSummariesByName,
-                                                canonicalCalleeNames, state, &writeSeen,
-                                                &constructedSeen, &defaultCtorSeen,
-                                                &readBeforeInitSeen, nullptr, &pendingIssues);
-                        }
-                    }
-                    else
-                    {
-                        for (const llvm::Instruction& I : BB)
-                        {
-                            transferInstruction(I, tracked, DL, summaries, externalSummariesByName,
-                                                canonicalCalleeNames, state, nullptr, nullptr,
-                                                nullptr, nullptr, nullptr, nullptr);
-                        }
-                    }
+                    computeInState(idx, order, outState, top, newIn, scratch);
+                    if (visited.test(idx) && newIn == inState[idx])
+                        return false;
+                    visited.set(idx);
+                    inState[idx].swap(newIn);
 
-                    InitRangeState& oldIn = inState[&BB];
-                    InitRangeState& oldOut = outState[&BB];
-                    if (!statesEqual(oldIn, newIn))
+                    state = inState[idx];
+                    for (const llvm::Instruction& I : *order.block(idx))
                     {
-                        oldIn = std::move(newIn);
-                        changed = true;
-                    }
-                    if (!statesEqual(oldOut, state))
-                    {
-                        oldOut = std::move(state);
-                        changed = true;
+                        transferInstruction(I, tracked, DL, summaries, externalSummariesByName,
+                                            canonicalCalleeNames, state, nullptr, nullptr, nullptr,
+                                            nullptr, nullptr, nullptr);
                     }
-                }
-            }
+                    if (state == outState[idx])
+                        return false;
+                    outState[idx].swap(state);
+                    return true;
+                },
+                maxBlockVisits);
 
             if (outSummary)
             {
                 for (const llvm::BasicBlock& BB : F)
                 {
-                    if (!reachable.lookup(&BB))
+                    const std::uint32_t idx = order.indexOf(&BB);
+                    if (idx == ForwardDataflowOrder::kUnreachable)
                         continue;
 
-                    InitRangeState state = inState[&BB];
+                    state = inState[idx];
                     for (const llvm::Instruction& I : BB)
                     {
                         transferInstruction(I, tracked, DL, summaries, externalSummariesByName,
@@ -3422,17 +3305,32 @@ namespace ctrace::stack::analysis
                 return;
             }
 
-            if (!fuseIssueCollection)
-            {
-                // Fallback: separate issue collection traversal
-                // (only reached if outIssues == nullptr, i.e. no-op mode)
+            if (!outIssues)
                 return;
-            }
 
-            // Issues were collected during the last fixpoint iteration.
-            // Transfer pendingIssues to the output.
-            if (outIssues)
-                outIssues->insert(outIssues->end(), pendingIssues.begin(), pendingIssues.end());
+            // Issue collection replays the converged in-states once, in layout
+            // order so diagnostics keep their source-order emission.
+            llvm::BitVector writeSeen(trackedCount, false);
+            llvm::BitVector constructedSeen(trackedCount, false);
+            llvm::BitVector defaultCtorSeen(trackedCount, false);
+            llvm::BitVector readBeforeInitSeen(trackedCount, false);
+            std::vector<UninitializedLocalReadIssue> pendingIssues;
+            for (const llvm::BasicBlock& BB : F)
+            {
+                const std::uint32_t idx = order.indexOf(&BB);
+                if (idx == ForwardDataflowOrder::kUnreachable)
+                    continue;
+
+                state = inState[idx];
+                for (const llvm::Instruction& I : BB)
+                {
+                    transferInstruction(I, tracked, DL, summaries, externalSummariesByName,
+                                        canonicalCalleeNames, state, &writeSeen, &constructedSeen,
+                                        &defaultCtorSeen, &readBeforeInitSeen, nullptr,
+                                        &pendingIssues);
+                }
+            }
+            outIssues->insert(outIssues->end(), pendingIssues.begin(), pendingIssues.end());
 
             for (unsigned idx = 0; idx < trackedCount; ++idx)
             {
@@ -3992,31 +3890,31 @@ namespace ctrace::stack::analysis
         return exportSummaryIndexForModule(mod, summaries);
     }
 
+    bool mergeUninitializedSummaryEntry(UninitializedSummaryIndex& dst, const std::string& name,
+                                        const UninitializedSummaryFunction& incoming)
+    {
+        const std::size_t srcSize = effectivePublicParamEffectCount(incoming);
+        if (srcSize == 0)
+            return false;
+
+        auto it = dst.functions.find(name);
+        if (it == dst.functions.end())
+        {
+            UninitializedSummaryFunction normalized = incoming;
+            trimTrailingEmptyPublicParamEffects(normalized);
+            dst.functions.emplace(name, std::move(normalized));
+            return true;
+        }
+
+        return mergePublicFunctionSummary(it->second, incoming);
+    }
+
     bool mergeUninitializedSummaryIndex(UninitializedSummaryIndex& dst,
                                         const UninitializedSummaryIndex& src)
     {
         bool changed = false;
         for (const auto& entry : src.functions)
-        {
-            const std::size_t srcSize = effectivePublicParamEffectCount(entry.second);
-            if (srcSize == 0)
-                continue;
-
-            auto it = dst.functions.find(entry.first);
-            if (it == dst.functions.end())
-            {
-                UninitializedSummaryFunction normalized = entry.second;
-                trimTrailingEmptyPublicParamEffects(normalized);
-                dst.functions.emplace(entry.first, std::move(normalized));
-                changed = true;
-                continue;
-            }
-
-            if (mergePublicFunctionSummary(it->second, entry.second))
-            {
-                changed = true;
-            }
-        }
+            changed |= mergeUninitializedSummaryEntry(dst, entry.first, entry.second);
         return changed;
     }
 
@@ -0,0 +1,1061 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/smt/ConstraintPresolver.hpp"
+
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace ctrace::stack::analysis::smt
+{
+    namespace
+    {
+        using TermId = std::uint32_t;
+
+        // Boolean constants have no ExprKind of their own: they are the first
+        // two terms of every table and are only materialized when a residual
+        // node cannot do without them.
+        constexpr TermId kTrue = 0;
+        constexpr TermId kFalse = 1;
+        // Width recorded for boolean terms; bit-vector widths are always >= 1.
+        constexpr std::uint32_t kBoolWidth = 0;
+
+        struct PresolveCounters
+        {
+            std::atomic<std::uint64_t> queries{0};
+            std::atomic<std::uint64_t> decidedSat{0};
+            std::atomic<std::uint64_t> decidedUnsat{0};
+            std::atomic<std::uint64_t> residualInputNodes{0};
+            std::atomic<std::uint64_t> residualNodes{0};
+        };
+
+        static PresolveCounters& counters()
+        {
+            static PresolveCounters instance;
+            return instance;
+        }
+
+        static std::uint32_t normalizeBitWidth(std::uint32_t bitWidth)
+        {
+            return bitWidth == 0 ? 1 : bitWidth;
+        }
+
+        // Signed range of a bit-vector term of at most 64 bits. Unknown for
+        // booleans and wider terms; lo > hi is the empty range.
+        struct SignedRange
+        {
+            std::int64_t lo = 0;
+            std::int64_t hi = 0;
+            std::uint64_t known : 1 = false;
+            std::uint64_t reservedFlags : 63 = 0;
+        };
+
+        static SignedRange makeRange(std::int64_t lo, std::int64_t hi)
+        {
+            return SignedRange{.lo = lo, .hi = hi, .known = true};
+        }
+
+        static SignedRange fullRange(std::uint32_t width)
+        {
+            if (width == kBoolWidth || width > 64)
+                return {};
+            if (width == 64)
+                return makeRange(std::numeric_limits<std::int64_t>::min(),
+                                 std::numeric_limits<std::int64_t>::max());
+            const std::int64_t half = std::int64_t{1} << (width - 1);
+            return makeRange(-half, half - 1);
+        }
+
+        static bool isEmpty(const SignedRange& range)
+        {
+            return range.known && range.lo > range.hi;
+        }
+
+        static bool contains(const SignedRange& outer, const SignedRange& inner)
+        {
+            return outer.known && inner.known && outer.lo <= inner.lo && inner.hi <= outer.hi;
+        }
+
+        static SignedRange intersect(const SignedRange& a, const SignedRange& b)
+        {
+            if (!a.known)
+                return b;
+            if (!b.known)
+                return a;
+            return makeRange(std::max(a.lo, b.lo), std::min(a.hi, b.hi));
+        }
+
+        static SignedRange hull(const SignedRange& a, const SignedRange& b)
+        {
+            if (!a.known || !b.known)
+                return {};
+            return makeRange(std::min(a.lo, b.lo), std::max(a.hi, b.hi));
+        }
+
+        // Value of a raw IR constant as the Z3 backend builds it: the 64-bit
+        // pattern zero-extended or truncated to the node width.
+        static llvm::APInt rawConstant(std::int64_t raw, std::uint32_t width)
+        {
+            return llvm::APInt(64, static_cast<std::uint64_t>(raw)).zextOrTrunc(width);
+        }
+
+        static bool isComparison(ExprKind kind)
+        {
+            switch (kind)
+            {
+            case ExprKind::Eq:
+            case ExprKind::Ne:
+            case ExprKind::Ult:
+            case ExprKind::Ule:
+            case ExprKind::Ugt:
+            case ExprKind::Uge:
+            case ExprKind::Slt:
+            case ExprKind::Sle:
+            case ExprKind::Sgt:
+            case ExprKind::Sge:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Predicate P' such that `a P b` == `b P' a`.
+        static ExprKind mirroredComparison(ExprKind kind)
+        {
+            switch (kind)
+            {
+            case ExprKind::Ult:
+                return ExprKind::Ugt;
+            case ExprKind::Ule:
+                return ExprKind::Uge;
+            case ExprKind::Ugt:
+                return ExprKind::Ult;
+            case ExprKind::Uge:
+                return ExprKind::Ule;
+            case ExprKind::Slt:
+                return ExprKind::Sgt;
+            case ExprKind::Sle:
+                return ExprKind::Sge;
+            case ExprKind::Sgt:
+                return ExprKind::Slt;
+            case ExprKind::Sge:
+                return ExprKind::Sle;
+            default:
+                return kind;
+            }
+        }
+
+        // Predicate P' such that `a P' b` == `!(a P b)`.
+        static ExprKind negatedComparison(ExprKind kind)
+        {
+            switch (kind)
+            {
+            case ExprKind::Eq:
+                return ExprKind::Ne;
+            case ExprKind::Ne:
+                return ExprKind::Eq;
+            case ExprKind::Ult:
+                return ExprKind::Uge;
+            case ExprKind::Ule:
+                return ExprKind::Ugt;
+            case ExprKind::Ugt:
+                return ExprKind::Ule;
+            case ExprKind::Uge:
+                return ExprKind::Ult;
+            case ExprKind::Slt:
+                return ExprKind::Sge;
+            case ExprKind::Sle:
+                return ExprKind::Sgt;
+            case ExprKind::Sgt:
+                return ExprKind::Sle;
+            case ExprKind::Sge:
+                return ExprKind::Slt;
+            default:
+                return kind;
+            }
+        }
+
+        static bool evaluateComparison(ExprKind kind, const llvm::APInt& l, const llvm::APInt& r)
+        {
+            switch (kind)
+            {
+            case ExprKind::Eq:
+                return l == r;
+            case ExprKind::Ne:
+                return l != r;
+            case ExprKind::Ult:
+                return l.ult(r);
+            case ExprKind::Ule:
+                return l.ule(r);
+            case ExprKind::Ugt:
+                return l.ugt(r);
+            case ExprKind::Uge:
+                return l.uge(r);
+            case ExprKind::Slt:
+                return l.slt(r);
+            case ExprKind::Sle:
+                return l.sle(r);
+            case ExprKind::Sgt:
+                return l.sgt(r);
+            default:
+                return l.sge(r);
+            }
+        }
+
+        static llvm::APInt evaluateArithmetic(ExprKind kind, const llvm::APInt& l,
+                                              const llvm::APInt& r)
+        {
+            // Shifts by the width or more follow SMT-LIB: APInt clamps the
+            // amount, which yields 0 (shl/lshr) or the sign fill (ashr).
+            switch (kind)
+            {
+            case ExprKind::Add:
+                return l + r;
+            case ExprKind::Sub:
+                return l - r;
+            case ExprKind::Mul:
+                return l * r;
+            case ExprKind::Shl:
+                return l.shl(r);
+            case ExprKind::LShr:
+                return l.lshr(r);
+            default:
+                return l.ashr(r);
+            }
+        }
+
+        static std::optional<bool> compareRanges(ExprKind kind, const SignedRange& l,
+                                                 const SignedRange& r)
+        {
+            if (!l.known || !r.known)
+                return std::nullopt;
+            switch (kind)
+            {
+            case ExprKind::Ult:
+            case ExprKind::Ule:
+            case ExprKind::Ugt:
+            case ExprKind::Uge:
+                // Both operands non-negative: unsigned and signed orders agree.
+                if (l.lo < 0 || r.lo < 0)
+                    return std::nullopt;
+                break;
+            default:
+                break;
+            }
+
+            switch (kind)
+            {
+            case ExprKind::Eq:
+            case ExprKind::Ne:
+            {
+                std::optional<bool> equal;
+                if (l.hi < r.lo || r.hi < l.lo)
+                    equal = false;
+                else if (l.lo == l.hi && r.lo == r.hi)
+                    equal = true;
+                if (!equal)
+                    return std::nullopt;
+                return kind == ExprKind::Eq ? *equal : !*equal;
+            }
+            case ExprKind::Ult:
+            case ExprKind::Slt:
+                if (l.hi < r.lo)
+                    return true;
+                if (l.lo >= r.hi)
+                    return false;
+                return std::nullopt;
+            case ExprKind::Ule:
+            case ExprKind::Sle:
+                if (l.hi <= r.lo)
+                    return true;
+                if (l.lo > r.hi)
+                    return false;
+                return std::nullopt;
+            case ExprKind::Ugt:
+            case ExprKind::Sgt:
+                return compareRanges(ExprKind::Slt, r, l);
+            default:
+                return compareRanges(ExprKind::Sle, r, l);
+            }
+        }
+
+        struct ExprNodeHash
+        {
+            std::size_t operator()(const ExprNode& node) const
+            {
+                return static_cast<std::size_t>(
+                    llvm::hash_combine(static_cast<std::uint64_t>(node.kind), node.symbol,
+                                       node.constant, node.bitWidth, node.lhs, node.rhs,
+                                       node.extra));
+            }
+        };
+
+        struct ExprNodeEqual
+        {
+            bool operator()(const ExprNode& a, const ExprNode& b) const
+            {
+                return a.kind == b.kind && a.symbol == b.symbol && a.constant == b.constant &&
+                       a.bitWidth == b.bitWidth && a.lhs == b.lhs && a.rhs == b.rhs &&
+                       a.extra == b.extra;
+            }
+        };
+
+        // Folds one query into a hash-consed term table. Term operands always
+        // precede their users, so ranges can be computed in id order. A term
+        // that the Z3 backend would reject (mismatched sorts or widths, symbol
+        // id 0) aborts presolving: the backends must report it themselves.
+        class Presolver
+        {
+          public:
+            explicit Presolver(const ConstraintIR& ir) : ir(ir), folded(ir.nodes.size())
+            {
+                addTerm(ExprNode{.kind = ExprKind::Constant, .constant = 1, .bitWidth = 0},
+                        kBoolWidth);
+                addTerm(ExprNode{.kind = ExprKind::Constant, .constant = 0, .bitWidth = 0},
+                        kBoolWidth);
+            }
+
+            PresolveResult run()
+            {
+                if (ir.assertions.empty())
+                    return presolveIntervals();
+
+                std::vector<TermId> roots;
+                roots.reserve(ir.assertions.size());
+                for (ExprId id : ir.assertions)
+                {
+                    const std::optional<TermId> term = fold(id);
+                    if (!term || widths[*term] != kBoolWidth)
+                        return {};
+                    roots.push_back(*term);
+                }
+
+                std::vector<TermId> assertions;
+                std::unordered_set<TermId> seen;
+                for (TermId root : roots)
+                    flattenConjunction(root, assertions, seen);
+                if (seen.contains(kFalse))
+                    return PresolveResult{.residual = std::nullopt,
+                                          .outcome = PresolveOutcome::Unsat};
+                if (assertions.empty())
+                {
+                    // Keep the backends' historical disagreement on malformed
+                    // intervals: the interval backend refutes them, Z3 does
+                    // not see them next to assertions.
+                    for (const IntervalConstraint& interval : ir.intervals)
+                    {
+                        if (interval.hasLower && interval.hasUpper &&
+                            interval.lower > interval.upper)
+                            return {};
+                    }
+                    return PresolveResult{.residual = std::nullopt,
+                                          .outcome = PresolveOutcome::Sat};
+                }
+                if (refutedByBounds(assertions))
+                    return PresolveResult{.residual = std::nullopt,
+                                          .outcome = PresolveOutcome::Unsat};
+
+                ConstraintIR residual;
+                residual.symbols = ir.symbols;
+                residual.intervals = ir.intervals;
+                std::vector<std::optional<ExprId>> emitted(terms.size());
+                residual.assertions.reserve(assertions.size());
+                for (TermId assertion : assertions)
+                    residual.assertions.push_back(emit(assertion, residual, emitted));
+                return PresolveResult{.residual = std::move(residual),
+                                      .outcome = PresolveOutcome::Residual};
+            }
+
+          private:
+            TermId addTerm(const ExprNode& node, std::uint32_t width)
+            {
+                const TermId id = static_cast<TermId>(terms.size());
+                terms.push_back(node);
+                widths.push_back(width);
+                ranges.push_back({});
+                ranges.back() = computeRange(id, ranges);
+                return id;
+            }
+
+            TermId intern(const ExprNode& node, std::uint32_t width)
+            {
+                if (const auto it = index.find(node); it != index.end())
+                    return it->second;
+                const TermId id = addTerm(node, width);
+                index.emplace(node, id);
+                return id;
+            }
+
+            std::optional<llvm::APInt> constantValue(TermId id) const
+            {
+                if (widths[id] == kBoolWidth || terms[id].kind != ExprKind::Constant)
+                    return std::nullopt;
+                return rawConstant(terms[id].constant, widths[id]);
+            }
+
+            // Constants wider than 64 bits only fit an ExprNode while their
+            // value does.
+            std::optional<TermId> constantTerm(const llvm::APInt& value)
+            {
+                const std::uint32_t width = value.getBitWidth();
+                if (width > 64 && value.getActiveBits() > 64)
+                    return std::nullopt;
+                const std::uint64_t raw = value.zextOrTrunc(64).getZExtValue();
+                return intern(ExprNode{.kind = ExprKind::Constant,
+                                       .constant = static_cast<std::int64_t>(raw),
+                                       .bitWidth = width},
+                              width);
+            }
+
+            SignedRange computeRange(TermId id, const std::vector<SignedRange>& source) const
+            {
+                const ExprNode& term = terms[id];
+                const std::uint32_t width = widths[id];
+                if (width == kBoolWidth || width > 64)
+                    return {};
+
+                switch (term.kind)
+                {
+                case ExprKind::Constant:
+                {
+                    const std::int64_t value = rawConstant(term.constant, width).getSExtValue();
+                    return makeRange(value, value);
+                }
+                case ExprKind::Add:
+                case ExprKind::Sub:
+                {
+                    const SignedRange& l = source[term.lhs];
+                    const SignedRange& r = source[term.rhs];
+                    if (!l.known || !r.known || isEmpty(l) || isEmpty(r))
+                        return fullRange(width);
+                    std::int64_t lo = 0;
+                    std::int64_t hi = 0;
+                    bool overflow = false;
+                    if (term.kind == ExprKind::Add)
+                        overflow = llvm::AddOverflow(l.lo, r.lo, lo) != 0 ||
+                                   llvm::AddOverflow(l.hi, r.hi, hi) != 0;
+                    else
+                        overflow = llvm::SubOverflow(l.lo, r.hi, lo) != 0 ||
+                                   llvm::SubOverflow(l.hi, r.lo, hi) != 0;
+                    const SignedRange result = makeRange(lo, hi);
+                    // A result that may wrap covers the whole width.
+                    return !overflow && contains(fullRange(width), result) ? result
+                                                                           : fullRange(width);
+                }
+                case ExprKind::ZExt:
+                {
+                    const SignedRange& operand = source[term.lhs];
+                    if (operand.known && operand.lo >= 0)
+                        return operand;
+                    const std::uint32_t operandWidth = widths[term.lhs];
+                    return makeRange(0, (std::int64_t{1} << operandWidth) - 1);
+                }
+                case ExprKind::SExt:
+                    return source[term.lhs];
+                case ExprKind::Trunc:
+                {
+                    const SignedRange& operand = source[term.lhs];
+                    return contains(fullRange(width), operand) ? operand : fullRange(width);
+                }
+                case ExprKind::Ite:
+                {
+                    const SignedRange merged = hull(source[term.rhs], source[term.extra]);
+                    return merged.known ? merged : fullRange(width);
+                }
+                default:
+                    return fullRange(width);
+                }
+            }
+
+            std::optional<TermId> fold(ExprId id)
+            {
+                if (id >= ir.nodes.size())
+                    return std::nullopt;
+                if (folded[id])
+                    return folded[id];
+                const std::optional<TermId> term = foldNode(ir.nodes[id]);
+                folded[id] = term;
+                return term;
+            }
+
+            std::optional<TermId> foldNode(const ExprNode& node)
+            {
+                switch (node.kind)
+                {
+                case ExprKind::Symbol:
+                    return foldSymbol(node);
+                case ExprKind::Constant:
+                    return constantTerm(
+                        rawConstant(node.constant, normalizeBitWidth(node.bitWidth)));
+                case ExprKind::Ite:
+                    return foldIte(node);
+                case ExprKind::Add:
+                case ExprKind::Sub:
+                case ExprKind::Mul:
+                case ExprKind::Shl:
+                case ExprKind::LShr:
+                case ExprKind::AShr:
+                {
+                    const std::optional<TermId> lhs = fold(node.lhs);
+                    const std::optional<TermId> rhs = fold(node.rhs);
+                    if (!lhs || !rhs || widths[*lhs] == kBoolWidth || widths[*lhs] != widths[*rhs])
+                        return std::nullopt;
+                    return makeArithmetic(node.kind, *lhs, *rhs);
+                }
+                case ExprKind::And:
+                case ExprKind::Or:
+                {
+                    const std::optional<TermId> lhs = fold(node.lhs);
+                    const std::optional<TermId> rhs = fold(node.rhs);
+                    if (!lhs || !rhs || widths[*lhs] != kBoolWidth || widths[*rhs] != kBoolWidth)
+                        return std::nullopt;
+                    return makeConnective(node.kind, *lhs, *rhs);
+                }
+                case ExprKind::Not:
+                {
+                    const std::optional<TermId> operand = fold(node.lhs);
+                    if (!operand || widths[*operand] != kBoolWidth)
+                        return std::nullopt;
+                    return makeNot(*operand);
+                }
+                case ExprKind::ZExt:
+                case ExprKind::SExt:
+                case ExprKind::Trunc:
+                    return foldCast(node);
+                default:
+                {
+                    const std::optional<TermId> lhs = fold(node.lhs);
+                    const std::optional<TermId> rhs = fold(node.rhs);
+                    if (!lhs || !rhs || widths[*lhs] != widths[*rhs])
+                        return std::nullopt;
+                    if (widths[*lhs] != kBoolWidth)
+                        return makeComparison(node.kind, *lhs, *rhs);
+                    if (node.kind != ExprKind::Eq && node.kind != ExprKind::Ne)
+                        return std::nullopt;
+                    return makeBoolEquality(node.kind, *lhs, *rhs);
+                }
+                }
+            }
+
+            std::optional<TermId> foldSymbol(const ExprNode& node)
+            {
+                if (node.symbol == 0)
+                    return std::nullopt;
+                const std::uint32_t width = normalizeBitWidth(node.bitWidth);
+                const auto [it, inserted] = symbolWidths.emplace(node.symbol, width);
+                if (!inserted && it->second != width)
+                    return std::nullopt;
+                return intern(ExprNode{.kind = ExprKind::Symbol, .symbol = node.symbol,
+                                       .bitWidth = width},
+                              width);
+            }
+
+            std::optional<TermId> foldIte(const ExprNode& node)
+            {
+                std::optional<TermId> cond = fold(node.lhs);
+                std::optional<TermId> onTrue = fold(node.rhs);
+                std::optional<TermId> onFalse = fold(node.extra);
+                if (!cond || !onTrue || !onFalse || widths[*cond] != kBoolWidth ||
+                    widths[*onTrue] != widths[*onFalse])
+                    return std::nullopt;
+
+                if (*cond == kTrue || *onTrue == *onFalse)
+                    return onTrue;
+                if (*cond == kFalse)
+                    return onFalse;
+                if (terms[*cond].kind == ExprKind::Not)
+                {
+                    cond = terms[*cond].lhs;
+                    std::swap(onTrue, onFalse);
+                }
+
+                const std::uint32_t width = widths[*onTrue];
+                if (width == kBoolWidth)
+                {
+                    if (*onTrue == kTrue && *onFalse == kFalse)
+                        return cond;
+                    if (*onTrue == kFalse && *onFalse == kTrue)
+                        return makeNot(*cond);
+                }
+                return intern(ExprNode{.kind = ExprKind::Ite,
+                                       .bitWidth = width == kBoolWidth ? 1 : width,
+                                       .lhs = *cond,
+                                       .rhs = *onTrue,
+                                       .extra = *onFalse},
+                              width);
+            }
+
+            std::optional<TermId> foldCast(const ExprNode& node)
+            {
+                std::optional<TermId> operand = fold(node.lhs);
+                if (!operand || widths[*operand] == kBoolWidth)
+                    return std::nullopt;
+
+                const std::uint32_t sourceWidth = widths[*operand];
+                const std::uint32_t targetWidth = normalizeBitWidth(node.bitWidth);
+                const bool isTrunc = node.kind == ExprKind::Trunc;
+                if (isTrunc ? targetWidth > sourceWidth : targetWidth < sourceWidth)
+                    return std::nullopt;
+                if (targetWidth == sourceWidth)
+                    return operand;
+
+                if (const std::optional<llvm::APInt> value = constantValue(*operand))
+                {
+                    const llvm::APInt result = isTrunc ? value->trunc(targetWidth)
+                                               : node.kind == ExprKind::ZExt
+                                                   ? value->zext(targetWidth)
+                                                   : value->sext(targetWidth);
+                    if (const std::optional<TermId> constant = constantTerm(result))
+                        return constant;
+                }
+
+                // zext(zext x), sext(sext x) and trunc(trunc x) are one cast;
+                // trunc(ext x) back to the width of x is x.
+                const ExprNode inner = terms[*operand];
+                if (inner.kind == node.kind)
+                    operand = inner.lhs;
+                else if (isTrunc &&
+                         (inner.kind == ExprKind::ZExt || inner.kind == ExprKind::SExt) &&
+                         widths[inner.lhs] == targetWidth)
+                    return inner.lhs;
+
+                return intern(
+                    ExprNode{.kind = node.kind, .bitWidth = targetWidth, .lhs = *operand},
+                    targetWidth);
+            }
+
+            TermId makeArithmetic(ExprKind kind, TermId lhs, TermId rhs)
+            {
+                const std::uint32_t width = widths[lhs];
+                const std::optional<llvm::APInt> l = constantValue(lhs);
+                const std::optional<llvm::APInt> r = constantValue(rhs);
+                if (l && r)
+                {
+                    if (const std::optional<TermId> value =
+                            constantTerm(evaluateArithmetic(kind, *l, *r)))
+                        return *value;
+                }
+
+                const bool isShift =
+                    kind == ExprKind::Shl || kind == ExprKind::LShr || kind == ExprKind::AShr;
+                if (r && r->isZero() && (kind == ExprKind::Add || kind == ExprKind::Sub || isShift))
+                    return lhs;
+                if (l && l->isZero() && kind == ExprKind::Add)
+                    return rhs;
+                if ((l && l->isZero() && (kind == ExprKind::Mul || isShift)) ||
+                    (r && r->isZero() && kind == ExprKind::Mul) ||
+                    (kind == ExprKind::Sub && lhs == rhs))
+                    return *constantTerm(llvm::APInt(width, 0));
+                if (kind == ExprKind::Mul && r && r->isOne())
+                    return lhs;
+                if (kind == ExprKind::Mul && l && l->isOne())
+                    return rhs;
+
+                if ((kind == ExprKind::Add || kind == ExprKind::Mul) && lhs > rhs)
+                    std::swap(lhs, rhs);
+                return intern(ExprNode{.kind = kind, .bitWidth = width, .lhs = lhs, .rhs = rhs},
+                              width);
+            }
+
+            std::optional<bool> decideComparison(ExprKind kind, TermId lhs, TermId rhs,
+                                                 const std::vector<SignedRange>& source) const
+            {
+                if (lhs == rhs)
+                {
+                    return kind == ExprKind::Eq || kind == ExprKind::Ule ||
+                           kind == ExprKind::Uge || kind == ExprKind::Sle || kind == ExprKind::Sge;
+                }
+                const std::optional<llvm::APInt> l = constantValue(lhs);
+                const std::optional<llvm::APInt> r = constantValue(rhs);
+                if (l && r)
+                    return evaluateComparison(kind, *l, *r);
+                if (r && r->isZero() && (kind == ExprKind::Ult || kind == ExprKind::Uge))
+                    return kind == ExprKind::Uge;
+                if (l && l->isZero() && (kind == ExprKind::Ugt || kind == ExprKind::Ule))
+                    return kind == ExprKind::Ule;
+                return compareRanges(kind, source[lhs], source[rhs]);
+            }
+
+            TermId makeComparison(ExprKind kind, TermId lhs, TermId rhs)
+            {
+                if (const std::optional<bool> value = decideComparison(kind, lhs, rhs, ranges))
+                    return *value ? kTrue : kFalse;
+                if ((kind == ExprKind::Eq || kind == ExprKind::Ne) && lhs > rhs)
+                    std::swap(lhs, rhs);
+                return intern(ExprNode{.kind = kind, .bitWidth = 1, .lhs = lhs, .rhs = rhs},
+                              kBoolWidth);
+            }
+
+            TermId makeBoolEquality(ExprKind kind, TermId lhs, TermId rhs)
+            {
+                if (lhs == rhs)
+                    return kind == ExprKind::Eq ? kTrue : kFalse;
+                if (lhs == kTrue || lhs == kFalse)
+                    std::swap(lhs, rhs);
+                if (rhs == kTrue || rhs == kFalse)
+                    return (rhs == kTrue) == (kind == ExprKind::Eq) ? lhs : makeNot(lhs);
+                if (lhs > rhs)
+                    std::swap(lhs, rhs);
+                return intern(ExprNode{.kind = kind, .bitWidth = 1, .lhs = lhs, .rhs = rhs},
+                              kBoolWidth);
+            }
+
+            TermId makeConnective(ExprKind kind, TermId lhs, TermId rhs)
+            {
+                const TermId absorbing = kind == ExprKind::And ? kFalse : kTrue;
+                const TermId neutral = kind == ExprKind::And ? kTrue : kFalse;
+                if (lhs == absorbing || rhs == absorbing)
+                    return absorbing;
+                if (lhs == neutral || lhs == rhs)
+                    return rhs;
+                if (rhs == neutral)
+                    return lhs;
+                if (lhs > rhs)
+                    std::swap(lhs, rhs);
+                return intern(ExprNode{.kind = kind, .bitWidth = 1, .lhs = lhs, .rhs = rhs},
+                              kBoolWidth);
+            }
+
+            TermId makeNot(TermId operand)
+            {
+                if (operand == kTrue || operand == kFalse)
+                    return operand == kTrue ? kFalse : kTrue;
+                const ExprNode term = terms[operand];
+                if (term.kind == ExprKind::Not)
+                    return term.lhs;
+                if (isComparison(term.kind))
+                {
+                    const ExprKind negated = negatedComparison(term.kind);
+                    return widths[term.lhs] == kBoolWidth
+                               ? makeBoolEquality(negated, term.lhs, term.rhs)
+                               : makeComparison(negated, term.lhs, term.rhs);
+                }
+                return intern(ExprNode{.kind = ExprKind::Not, .bitWidth = 1, .lhs = operand},
+                              kBoolWidth);
+            }
+
+            void flattenConjunction(TermId term, std::vector<TermId>& out,
+                                    std::unordered_set<TermId>& seen) const
+            {
+                if (terms[term].kind == ExprKind::And && widths[term] == kBoolWidth &&
+                    term != kTrue && term != kFalse)
+                {
+                    flattenConjunction(terms[term].lhs, out, seen);
+                    flattenConjunction(terms[term].rhs, out, seen);
+                    return;
+                }
+                if (term == kTrue || !seen.insert(term).second)
+                    return;
+                if (term != kFalse)
+                    out.push_back(term);
+            }
+
+            // Bound implied on `term` by the assertion `term kind constant`;
+            // unknown when the assertion is not an interval.
+            SignedRange boundFromComparison(ExprKind kind, TermId term,
+                                            const llvm::APInt& constant) const
+            {
+                const SignedRange full = fullRange(widths[term]);
+                const std::int64_t value = constant.getSExtValue();
+                const bool nonNegative = constant.isNonNegative();
+                const bool termNonNegative = ranges[term].known && ranges[term].lo >= 0;
+                const SignedRange empty = makeRange(1, 0);
+                switch (kind)
+                {
+                case ExprKind::Eq:
+                    return makeRange(value, value);
+                case ExprKind::Sge:
+                    return makeRange(value, full.hi);
+                case ExprKind::Sgt:
+                    return value == full.hi ? empty : makeRange(value + 1, full.hi);
+                case ExprKind::Sle:
+                    return makeRange(full.lo, value);
+                case ExprKind::Slt:
+                    return value == full.lo ? empty : makeRange(full.lo, value - 1);
+                case ExprKind::Ule:
+                    return nonNegative ? makeRange(0, value) : SignedRange{};
+                case ExprKind::Ult:
+                    if (!nonNegative)
+                        return {};
+                    return value == 0 ? empty : makeRange(0, value - 1);
+                case ExprKind::Uge:
+                    return nonNegative && termNonNegative ? makeRange(value, full.hi)
+                                                          : SignedRange{};
+                case ExprKind::Ugt:
+                    if (!nonNegative || !termNonNegative)
+                        return {};
+                    return value == full.hi ? empty : makeRange(value + 1, full.hi);
+                default:
+                    return {};
+                }
+            }
+
+            // Seeds per-term bounds with the `term cmp constant` assertions,
+            // propagates them to the users of those terms and reports whether
+            // a bound became empty or an assertion is false under the bounds.
+            // Bounds are derived from the assertions themselves, so they are
+            // only used to refute, never to drop an assertion.
+            bool refutedByBounds(const std::vector<TermId>& assertions) const
+            {
+                std::unordered_map<TermId, SignedRange> facts;
+                std::vector<std::pair<TermId, std::int64_t>> disequalities;
+                for (TermId assertion : assertions)
+                {
+                    ExprKind kind = terms[assertion].kind;
+                    TermId lhs = terms[assertion].lhs;
+                    TermId rhs = terms[assertion].rhs;
+                    if (!isComparison(kind) || widths[lhs] == kBoolWidth || widths[lhs] > 64)
+                        continue;
+                    std::optional<llvm::APInt> constant = constantValue(rhs);
+                    if (!constant)
+                    {
+                        constant = constantValue(lhs);
+                        if (!constant)
+                            continue;
+                        kind = mirroredComparison(kind);
+                        std::swap(lhs, rhs);
+                    }
+                    if (kind == ExprKind::Ne)
+                    {
+                        disequalities.emplace_back(lhs, constant->getSExtValue());
+                        continue;
+                    }
+                    const SignedRange bound = boundFromComparison(kind, lhs, *constant);
+                    if (!bound.known)
+                        continue;
+                    const auto [it, inserted] = facts.emplace(lhs, bound);
+                    if (!inserted)
+                        it->second = intersect(it->second, bound);
+                }
+                // x != c only trims a bound that ends at c.
+                for (const auto& [term, value] : disequalities)
+                {
+                    const auto it = facts.find(term);
+                    SignedRange range = it != facts.end() ? it->second : ranges[term];
+                    if (!range.known || isEmpty(range))
+                        continue;
+                    if (range.lo == value && range.hi == value)
+                        range = makeRange(1, 0);
+                    else if (range.lo == value)
+                        range.lo += 1;
+                    else if (range.hi == value)
+                        range.hi -= 1;
+                    facts[term] = range;
+                }
+                if (facts.empty())
+                    return false;
+
+                std::vector<SignedRange> refined;
+                refined.reserve(terms.size());
+                for (TermId id = 0; id < terms.size(); ++id)
+                {
+                    refined.push_back(computeRange(id, refined));
+                    if (const auto it = facts.find(id); it != facts.end())
+                        refined.back() = intersect(refined.back(), it->second);
+                    if (isEmpty(refined.back()))
+                        return true;
+                }
+                for (TermId assertion : assertions)
+                {
+                    if (evaluateUnder(assertion, refined) == std::optional<bool>(false))
+                        return true;
+                }
+                return false;
+            }
+
+            std::optional<bool> evaluateUnder(TermId term,
+                                              const std::vector<SignedRange>& source) const
+            {
+                if (term == kTrue || term == kFalse)
+                    return term == kTrue;
+                const ExprNode& node = terms[term];
+                if (widths[term] != kBoolWidth)
+                    return std::nullopt;
+                if (isComparison(node.kind))
+                {
+                    if (widths[node.lhs] == kBoolWidth)
+                        return std::nullopt;
+                    return decideComparison(node.kind, node.lhs, node.rhs, source);
+                }
+                switch (node.kind)
+                {
+                case ExprKind::Not:
+                {
+                    const std::optional<bool> operand = evaluateUnder(node.lhs, source);
+                    if (!operand)
+                        return std::nullopt;
+                    return !*operand;
+                }
+                case ExprKind::And:
+                case ExprKind::Or:
+                {
+                    const bool isAnd = node.kind == ExprKind::And;
+                    const std::optional<bool> l = evaluateUnder(node.lhs, source);
+                    const std::optional<bool> r = evaluateUnder(node.rhs, source);
+                    if (l == std::optional<bool>(!isAnd) || r == std::optional<bool>(!isAnd))
+                        return !isAnd;
+                    if (l && r)
+                        return isAnd;
+                    return std::nullopt;
+                }
+                default:
+                    return std::nullopt;
+                }
+            }
+
+            ExprId emit(TermId term, ConstraintIR& out,
+                        std::vector<std::optional<ExprId>>& emitted) const
+            {
+                if (emitted[term])
+                    return *emitted[term];
+
+                ExprNode node = terms[term];
+                if (term == kTrue || term == kFalse)
+                {
+                    // (0 == 0) / (0 != 0) over one bit: the IR has no boolean
+                    // literal.
+                    const ExprId zero = static_cast<ExprId>(out.nodes.size());
+                    out.nodes.push_back(ExprNode{.kind = ExprKind::Constant, .bitWidth = 1});
+                    node = ExprNode{.kind = term == kTrue ? ExprKind::Eq : ExprKind::Ne,
+                                    .bitWidth = 1,
+                                    .lhs = zero,
+                                    .rhs = zero};
+                }
+                else
+                {
+                    switch (node.kind)
+                    {
+                    case ExprKind::Symbol:
+                    case ExprKind::Constant:
+                        break;
+                    case ExprKind::Not:
+                    case ExprKind::ZExt:
+                    case ExprKind::SExt:
+                    case ExprKind::Trunc:
+                        node.lhs = emit(node.lhs, out, emitted);
+                        break;
+                    case ExprKind::Ite:
+                        node.lhs = emit(node.lhs, out, emitted);
+                        node.rhs = emit(node.rhs, out, emitted);
+                        node.extra = emit(node.extra, out, emitted);
+                        break;
+                    default:
+                        node.lhs = emit(node.lhs, out, emitted);
+                        node.rhs = emit(node.rhs, out, emitted);
+                        break;
+                    }
+                }
+
+                const ExprId id = static_cast<ExprId>(out.nodes.size());
+                out.nodes.push_back(node);
+                emitted[term] = id;
+                return id;
+            }
+
+            // Without assertions the backends only see the intervals: Z3
+            // asserts each of them in the width of its symbol, on one constant
+            // per solver name.
+            PresolveResult presolveIntervals() const
+            {
+                std::unordered_map<SymbolId, std::uint32_t> symbolWidthById;
+                for (const ExprNode& node : ir.nodes)
+                {
+                    if (node.kind == ExprKind::Symbol && node.symbol != 0)
+                        symbolWidthById.emplace(node.symbol, normalizeBitWidth(node.bitWidth));
+                }
+                std::unordered_map<SymbolId, std::string> names;
+                for (const SymbolInfo& symbol : ir.symbols)
+                {
+                    if (symbol.id != 0 && !symbol.debugName.empty())
+                        names[symbol.id] = symbol.debugName;
+                }
+
+                std::map<std::pair<std::string, std::uint32_t>, SignedRange> bySolverConstant;
+                for (const IntervalConstraint& interval : ir.intervals)
+                {
+                    if (interval.symbol == 0 ||
+                        (interval.hasLower && interval.hasUpper && interval.lower > interval.upper))
+                        return {};
+                    const auto widthIt = symbolWidthById.find(interval.symbol);
+                    const std::uint32_t width =
+                        widthIt != symbolWidthById.end() ? widthIt->second : 64;
+                    if (width > 64)
+                        return {};
+
+                    SignedRange bound = fullRange(width);
+                    if (interval.hasLower)
+                        bound.lo = rawConstant(interval.lower, width).getSExtValue();
+                    if (interval.hasUpper)
+                        bound.hi = rawConstant(interval.upper, width).getSExtValue();
+
+                    const auto nameIt = names.find(interval.symbol);
+                    std::string name = nameIt != names.end()
+                                           ? nameIt->second
+                                           : "sym_" + std::to_string(interval.symbol);
+                    const auto [it, inserted] =
+                        bySolverConstant.emplace(std::make_pair(std::move(name), width), bound);
+                    if (!inserted)
+                        it->second = intersect(it->second, bound);
+                    if (isEmpty(it->second))
+                        return PresolveResult{.residual = std::nullopt,
+                                              .outcome = PresolveOutcome::Unsat};
+                }
+                return PresolveResult{.residual = std::nullopt, .outcome = PresolveOutcome::Sat};
+            }
+
+            const ConstraintIR& ir;
+            std::vector<std::optional<TermId>> folded;
+            std::vector<ExprNode> terms;
+            std::vector<std::uint32_t> widths;
+            std::vector<SignedRange> ranges;
+            std::unordered_map<ExprNode, TermId, ExprNodeHash, ExprNodeEqual> index;
+            std::unordered_map<SymbolId, std::uint32_t> symbolWidths;
+        };
+    } // namespace
+
+    PresolveResult presolveConstraints(const ConstraintIR& ir)
+    {
+        PresolveResult result = Presolver(ir).run();
+
+        PresolveCounters& stats = counters();
+        stats.queries.fetch_add(1, std::memory_order_relaxed);
+        switch (result.outcome)
+        {
+        case PresolveOutcome::Sat:
+            stats.decidedSat.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case PresolveOutcome::Unsat:
+            stats.decidedUnsat.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case PresolveOutcome::Residual:
+            if (result.residual)
+            {
+                stats.residualInputNodes.fetch_add(ir.nodes.size(), std::memory_order_relaxed);
+                stats.residualNodes.fetch_add(result.residual->nodes.size(),
+                                              std::memory_order_relaxed);
+            }
+            break;
+        }
+        return result;
+    }
+
+    PresolveStats presolveStats()
+    {
+        const PresolveCounters& stats = counters();
+        return PresolveStats{
+            .queries = stats.queries.load(std::memory_order_relaxed),
+            .decidedSat = stats.decidedSat.load(std::memory_order_relaxed),
+            .decidedUnsat = stats.decidedUnsat.load(std::memory_order_relaxed),
+            .residualInputNodes = stats.residualInputNodes.load(std::memory_order_relaxed),
+            .residualNodes = stats.residualNodes.load(std::memory_order_relaxed)};
+    }
+} // namespace ctrace::stack::analysis::smt
@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/smt/SmtCapture.hpp"
+
+#include <istream>
+#include <sstream>
+#include <utility>
+
+namespace ctrace::stack::analysis::smt
+{
+    namespace
+    {
+        static void writeString(std::ostream& out, std::string_view text)
+        {
+            out << text.size() << ':' << text;
+        }
+
+        // Bytes of the record line not consumed yet; counts and string
+        // lengths beyond it come from a corrupt file and must not be
+        // allocated.
+        static std::size_t bytesLeft(std::istream& in, std::size_t lineSize)
+        {
+            const std::streamoff position = in.tellg();
+            if (position < 0 || static_cast<std::size_t>(position) > lineSize)
+                return 0;
+            return lineSize - static_cast<std::size_t>(position);
+        }
+
+        static bool readString(std::istream& in, std::size_t lineSize, std::string& text)
+        {
+            std::size_t size = 0;
+            char colon = 0;
+            if (!(in >> size) || !in.get(colon) || colon != ':' || size > bytesLeft(in, lineSize))
+                return false;
+            text.assign(size, '\0');
+            return size == 0 || static_cast<bool>(in.read(text.data(), static_cast<long>(size)));
+        }
+
+        // `tag count`, where each of the `count` items takes at least
+        // `minItemBytes` characters of the line.
+        static bool readSection(std::istream& in, std::size_t lineSize, char tag,
+                                std::size_t minItemBytes, std::size_t& count)
+        {
+            char actual = 0;
+            return static_cast<bool>(in >> actual) && actual == tag &&
+                   static_cast<bool>(in >> count) &&
+                   count <= bytesLeft(in, lineSize) / minItemBytes;
+        }
+
+        static bool readRecord(const std::string& line, SmtCaptureRecord& record,
+                               std::string& error)
+        {
+            auto fail = [&](const char* what)
+            {
+                error = std::string("malformed capture record: ") + what;
+                return false;
+            };
+
+            std::istringstream in(line);
+            const std::size_t lineSize = line.size();
+            std::string status;
+            if (!(in >> status))
+                return fail("status");
+            const std::optional<SmtStatus> decoded = parseSmtStatusName(status);
+            if (!decoded)
+                return fail("unknown status");
+            record = SmtCaptureRecord{};
+            record.status = *decoded;
+            if (!(in >> record.elapsedMicros >> record.query.budgetNodes >>
+                  record.query.timeoutMs) ||
+                !readString(in, lineSize, record.query.ruleId))
+                return fail("header");
+
+            ConstraintIR& ir = record.query.ir;
+            std::size_t count = 0;
+            // " <id> <len>:"
+            if (!readSection(in, lineSize, 'S', 5, count))
+                return fail("symbols");
+            ir.symbols.resize(count);
+            for (SymbolInfo& symbol : ir.symbols)
+            {
+                if (!(in >> symbol.id) || !readString(in, lineSize, symbol.debugName))
+                    return fail("symbol");
+            }
+
+            // Seven space-separated numbers.
+            if (!readSection(in, lineSize, 'N', 14, count))
+                return fail("nodes");
+            ir.nodes.resize(count);
+            for (ExprNode& node : ir.nodes)
+            {
+                std::uint64_t kind = 0;
+                if (!(in >> kind >> node.symbol >> node.constant >> node.bitWidth >> node.lhs >>
+                      node.rhs >> node.extra) ||
+                    kind > static_cast<std::uint64_t>(ExprKind::Trunc))
+                    return fail("node");
+                node.kind = static_cast<ExprKind>(kind);
+            }
+
+            if (!readSection(in, lineSize, 'A', 2, count))
+                return fail("assertions");
+            ir.assertions.resize(count);
+            for (ExprId& assertion : ir.assertions)
+            {
+                if (!(in >> assertion))
+                    return fail("assertion");
+            }
+
+            if (!readSection(in, lineSize, 'I', 8, count))
+                return fail("intervals");
+            ir.intervals.resize(count);
+            for (IntervalConstraint& interval : ir.intervals)
+            {
+                unsigned flags = 0;
+                if (!(in >> interval.symbol >> interval.lower >> interval.upper >> flags))
+                    return fail("interval");
+                interval.hasLower = (flags & 1u) != 0;
+                interval.hasUpper = (flags & 2u) != 0;
+            }
+
+            char tag = 0;
+            std::string entry;
+            if (!(in >> tag) || tag != 'E' || !(in >> entry))
+                return fail("entry condition");
+            if (entry != "-")
+            {
+                std::istringstream parsed(entry);
+                ExprId id = 0;
+                if (!(parsed >> id) || !parsed.eof())
+                    return fail("entry condition");
+                ir.entryCondition = id;
+            }
+            if (!(in >> std::ws).eof())
+                return fail("trailing data");
+            return true;
+        }
+    } // namespace
+
+    std::string_view smtStatusName(SmtStatus status)
+    {
+        switch (status)
+        {
+        case SmtStatus::Sat:
+            return "sat";
+        case SmtStatus::Unsat:
+            return "unsat";
+        case SmtStatus::Unknown:
+            return "unknown";
+        case SmtStatus::Timeout:
+            return "timeout";
+        case SmtStatus::Error:
+            return "error";
+        }
+        return "unknown";
+    }
+
+    std::optional<SmtStatus> parseSmtStatusName(std::string_view name)
+    {
+        for (SmtStatus status : {SmtStatus::Sat, SmtStatus::Unsat, SmtStatus::Unknown,
+                                 SmtStatus::Timeout, SmtStatus::Error})
+        {
+            if (smtStatusName(status) == name)
+                return status;
+        }
+        return std::nullopt;
+    }
+
+    std::string serializeSmtCaptureRecord(const SmtQuery& query, SmtStatus status,
+                                          std::uint64_t elapsedMicros)
+    {
+        const ConstraintIR& ir = query.ir;
+        std::ostringstream out;
+        out << smtStatusName(status) << ' ' << elapsedMicros << ' '
+            << query.budgetNodes << ' ' << query.timeoutMs << ' ';
+        writeString(out, query.ruleId);
+
+        out << " S " << ir.symbols.size();
+        for (const SymbolInfo& symbol : ir.symbols)
+        {
+            out << ' ' << symbol.id << ' ';
+            writeString(out, symbol.debugName);
+        }
+
+        out << " N " << ir.nodes.size();
+        for (const ExprNode& node : ir.nodes)
+        {
+            out << ' ' << static_cast<std::uint64_t>(node.kind) << ' ' << node.symbol << ' '
+                << node.constant << ' ' << node.bitWidth << ' ' << node.lhs << ' ' << node.rhs
+                << ' ' << node.extra;
+        }
+
+        out << " A " << ir.assertions.size();
+        for (ExprId assertion : ir.assertions)
+            out << ' ' << assertion;
+
+        out << " I " << ir.intervals.size();
+        for (const IntervalConstraint& interval : ir.intervals)
+        {
+            const unsigned flags = (interval.hasLower ? 1u : 0u) | (interval.hasUpper ? 2u : 0u);
+            out << ' ' << interval.symbol << ' ' << interval.lower << ' ' << interval.upper << ' '
+                << flags;
+        }
+
+        out << " E ";
+        if (ir.entryCondition)
+            out << *ir.entryCondition;
+        else
+            out << '-';
+        out << '\n';
+        return out.str();
+    }
+
+    bool readSmtCaptureFile(const std::string& path, std::vector<SmtCaptureRecord>& out,
+                            std::string& error)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            error = "cannot open SMT capture file '" + path + "'";
+            return false;
+        }
+        std::string schema;
+        if (!std::getline(in, schema) || schema != kSmtCaptureSchema)
+        {
+            error = "'" + path + "' is not a " + kSmtCaptureSchema + " file";
+            return false;
+        }
+
+        // One record per line: a line torn by an interrupted run is reported
+        // without desynchronizing the records before it.
+        std::string line;
+        SmtCaptureRecord record;
+        while (std::getline(in, line))
+        {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            if (!readRecord(line, record, error))
+            {
+                error = path + ": record " + std::to_string(out.size() + 1) + ": " + error;
+                return false;
+            }
+            out.push_back(std::move(record));
+        }
+        return true;
+    }
+
+    SmtQueryCapture& SmtQueryCapture::instance()
+    {
+        static SmtQueryCapture capture;
+        return capture;
+    }
+
+    bool SmtQueryCapture::open(const std::string& capturePath, std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        out = std::ofstream(capturePath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            error = "cannot write SMT capture file '" + capturePath + "'";
+            return false;
+        }
+        out << kSmtCaptureSchema << '\n';
+        path = capturePath;
+        recorded.store(0, std::memory_order_relaxed);
+        isOpen.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool SmtQueryCapture::close(std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isOpen.exchange(false, std::memory_order_acq_rel))
+            return true;
+        out.close();
+        if (!out)
+        {
+            error = "failed to write SMT capture file '" + path + "'";
+            return false;
+        }
+        return true;
+    }
+
+    void SmtQueryCapture::record(const SmtQuery& query, SmtStatus status,
+                                 std::uint64_t elapsedMicros)
+    {
+        // Format outside the lock: only the append is serialized.
+        const std::string line = serializeSmtCaptureRecord(query, status, elapsedMicros);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isOpen.load(std::memory_order_relaxed))
+            return;
+        out << line;
+        recorded.fetch_add(1, std::memory_order_relaxed);
+    }
+} // namespace ctrace::stack::analysis::smt
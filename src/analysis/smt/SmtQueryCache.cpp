@@ -0,0 +1,359 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "analysis/smt/SmtQueryCache.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Process.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace ctrace::stack::analysis::smt
+{
+    namespace
+    {
+        static std::uint32_t normalizeBitWidth(std::uint32_t bitWidth)
+        {
+            return bitWidth == 0 ? 1 : bitWidth;
+        }
+
+        // Serializes the part of a query a backend can observe. Node and
+        // symbol ids are replaced by their first-visit order; symbols that
+        // share a debug name (and therefore one solver constant) are tagged
+        // with the canonical id of their first homonym.
+        class CanonicalQueryWriter
+        {
+          public:
+            explicit CanonicalQueryWriter(const ConstraintIR& ir) : ir(ir)
+            {
+                for (const SymbolInfo& symbol : ir.symbols)
+                {
+                    if (symbol.id != 0 && !symbol.debugName.empty())
+                        names.emplace(symbol.id, symbol.debugName);
+                }
+                for (const ExprNode& node : ir.nodes)
+                {
+                    if (node.kind == ExprKind::Symbol && node.symbol != 0)
+                        widths.emplace(node.symbol, normalizeBitWidth(node.bitWidth));
+                }
+            }
+
+            std::string write(std::string_view salt, std::uint64_t budgetNodes)
+            {
+                out << salt << "|over-budget="
+                    << (budgetNodes != 0 && ir.nodes.size() > budgetNodes ? 1 : 0) << "\n";
+                for (ExprId assertion : ir.assertions)
+                    out << "a" << visit(assertion) << "\n";
+
+                std::vector<std::string> intervals;
+                intervals.reserve(ir.intervals.size());
+                for (const IntervalConstraint& interval : ir.intervals)
+                {
+                    std::ostringstream line;
+                    const auto width = widths.find(interval.symbol);
+                    line << "i" << canonicalSymbol(interval.symbol) << ":"
+                         << (width != widths.end() ? width->second : 64u) << ":";
+                    if (interval.hasLower)
+                        line << interval.lower;
+                    line << ":";
+                    if (interval.hasUpper)
+                        line << interval.upper;
+                    intervals.push_back(line.str());
+                }
+                // Backends combine intervals as a conjunction: order is irrelevant.
+                std::sort(intervals.begin(), intervals.end());
+                for (const std::string& interval : intervals)
+                    out << interval << "\n";
+                return out.str();
+            }
+
+          private:
+            std::uint64_t visit(ExprId id)
+            {
+                if (const auto it = visitedNodes.find(id); it != visitedNodes.end())
+                    return it->second;
+                if (id >= ir.nodes.size())
+                {
+                    out << "bad" << id << "\n";
+                    return visitedNodes.emplace(id, nextNode++).first->second;
+                }
+
+                const ExprNode& node = ir.nodes[id];
+                std::ostringstream line;
+                line << static_cast<std::uint64_t>(node.kind) << "/"
+                     << normalizeBitWidth(node.bitWidth);
+                switch (node.kind)
+                {
+                case ExprKind::Symbol:
+                    line << " s" << canonicalSymbol(node.symbol);
+                    break;
+                case ExprKind::Constant:
+                    line << " c" << node.constant;
+                    break;
+                case ExprKind::Ite:
+                {
+                    const std::uint64_t cond = visit(node.lhs);
+                    const std::uint64_t onTrue = visit(node.rhs);
+                    const std::uint64_t onFalse = visit(node.extra);
+                    line << " " << cond << " " << onTrue << " " << onFalse;
+                    break;
+                }
+                case ExprKind::Not:
+                case ExprKind::ZExt:
+                case ExprKind::SExt:
+                case ExprKind::Trunc:
+                    line << " " << visit(node.lhs);
+                    break;
+                default:
+                {
+                    const std::uint64_t lhs = visit(node.lhs);
+                    const std::uint64_t rhs = visit(node.rhs);
+                    line << " " << lhs << " " << rhs;
+                    break;
+                }
+                }
+
+                const std::uint64_t canonical = nextNode++;
+                visitedNodes.emplace(id, canonical);
+                out << "n" << canonical << " " << line.str() << "\n";
+                return canonical;
+            }
+
+            std::uint64_t canonicalSymbol(SymbolId id)
+            {
+                if (id == 0)
+                    return 0;
+                if (const auto it = visitedSymbols.find(id); it != visitedSymbols.end())
+                    return it->second;
+
+                const std::uint64_t canonical = nextSymbol++;
+                visitedSymbols.emplace(id, canonical);
+                const auto name = names.find(id);
+                const std::string solverName =
+                    name != names.end() ? name->second : "sym_" + std::to_string(id);
+                const auto [homonym, inserted] = symbolByName.emplace(solverName, canonical);
+                if (!inserted)
+                    out << "alias " << canonical << " " << homonym->second << "\n";
+                return canonical;
+            }
+
+            const ConstraintIR& ir;
+            std::ostringstream out;
+            std::unordered_map<SymbolId, std::string> names;
+            std::unordered_map<SymbolId, std::uint32_t> widths;
+            std::unordered_map<ExprId, std::uint64_t> visitedNodes;
+            std::unordered_map<SymbolId, std::uint64_t> visitedSymbols;
+            std::unordered_map<std::string, std::uint64_t> symbolByName;
+            std::uint64_t nextNode = 0;
+            std::uint64_t nextSymbol = 1;
+        };
+
+        static char encodeStatus(SmtStatus status)
+        {
+            return status == SmtStatus::Sat ? 's' : 'u';
+        }
+
+        // One "<32 hex digits> <s|u>" line of the persistent store. Anything
+        // else (a line torn by a concurrent writer, a foreign file) is skipped.
+        static std::optional<std::pair<std::string, SmtStatus>>
+        parsePersistentLine(std::string_view line)
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            constexpr std::size_t kKeySize = 32;
+            if (line.size() != kKeySize + 2 || line[kKeySize] != ' ')
+                return std::nullopt;
+            const std::string_view key = line.substr(0, kKeySize);
+            if (!std::all_of(key.begin(), key.end(), [](char c)
+                             { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); }))
+            {
+                return std::nullopt;
+            }
+            switch (line.back())
+            {
+            case 's':
+                return std::make_pair(std::string(key), SmtStatus::Sat);
+            case 'u':
+                return std::make_pair(std::string(key), SmtStatus::Unsat);
+            default:
+                return std::nullopt;
+            }
+        }
+
+        static SmtDecision makeCachedDecision(SmtStatus status)
+        {
+            return SmtDecision{
+                .answers = {SmtAnswer{
+                    .backendName = "cache", .reason = std::nullopt, .status = status}},
+                .status = status};
+        }
+    } // namespace
+
+    SmtQueryCache& SmtQueryCache::instance()
+    {
+        static SmtQueryCache cache;
+        return cache;
+    }
+
+    std::string SmtQueryCache::makeKey(const SmtQuery& query,
+                                       const SolverOrchestratorConfig& config)
+    {
+        std::ostringstream salt;
+        salt << config.primaryBackend << "|" << config.secondaryBackend << "|"
+             << static_cast<std::uint64_t>(config.mode) << "|" << query.timeoutMs << "|"
+             << query.budgetNodes;
+        const std::string canonical =
+            CanonicalQueryWriter(query.ir).write(salt.str(), query.budgetNodes);
+
+        llvm::MD5 hasher;
+        hasher.update(canonical);
+        llvm::MD5::MD5Result digest;
+        hasher.final(digest);
+        llvm::SmallString<32> hex;
+        llvm::MD5::stringifyResult(digest, hex);
+        return std::string(hex.str());
+    }
+
+    SmtQueryCache::Shard& SmtQueryCache::shardFor(const std::string& key)
+    {
+        return shards[std::hash<std::string>{}(key) % kShardCount];
+    }
+
+    std::optional<SmtDecision> SmtQueryCache::lookup(const std::string& key)
+    {
+        lookupCount.fetch_add(1, std::memory_order_relaxed);
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.decisions.find(key);
+        if (it == shard.decisions.end())
+            return std::nullopt;
+        hitCount.fetch_add(1, std::memory_order_relaxed);
+        return makeCachedDecision(it->second);
+    }
+
+    void SmtQueryCache::store(const std::string& key, const SmtDecision& decision)
+    {
+        if (decision.status != SmtStatus::Sat && decision.status != SmtStatus::Unsat)
+            return;
+        {
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (!shard.decisions.emplace(key, decision.status).second)
+                return;
+        }
+        std::lock_guard<std::mutex> lock(persistentMutex);
+        if (!persistentPath.empty())
+            pendingPersistent.emplace_back(key, decision.status);
+    }
+
+    bool SmtQueryCache::loadPersistent(const std::string& cacheDir, std::string& error)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+        if (ec)
+        {
+            error = "cannot create SMT cache directory '" + cacheDir + "': " + ec.message();
+            return false;
+        }
+        const std::filesystem::path path =
+            std::filesystem::path(cacheDir) / (std::string(kPersistentSchema) + ".txt");
+
+        std::uint64_t loaded = 0;
+        std::uint64_t lines = 0;
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            ++lines;
+            std::optional<std::pair<std::string, SmtStatus>> entry = parsePersistentLine(line);
+            if (!entry)
+                continue;
+            Shard& shard = shardFor(entry->first);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.decisions.emplace(std::move(entry->first), entry->second).second)
+                ++loaded;
+        }
+
+        std::lock_guard<std::mutex> lock(persistentMutex);
+        persistentPath = path.string();
+        persistentWastedLines = lines - loaded;
+        persistentCount.fetch_add(loaded, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool SmtQueryCache::flushPersistent(std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(persistentMutex);
+        if (persistentPath.empty() || pendingPersistent.empty())
+            return true;
+        if (persistentWastedLines > persistentCount.load(std::memory_order_relaxed))
+            return compactPersistent(error);
+
+        // Appending keeps concurrent CI jobs sharing one directory safe enough:
+        // a duplicated line is harmless and a torn one is skipped on load.
+        std::ofstream out(persistentPath, std::ios::app);
+        if (!out)
+        {
+            error = "cannot write SMT cache file '" + persistentPath + "'";
+            return false;
+        }
+        for (const auto& [key, status] : pendingPersistent)
+            out << key << " " << encodeStatus(status) << "\n";
+        pendingPersistent.clear();
+        return static_cast<bool>(out);
+    }
+
+    bool SmtQueryCache::compactPersistent(std::string& error)
+    {
+        // Rewrites every known decision once and swaps the file in with a
+        // rename. Lines another process appends to the old file in between
+        // are lost, which only costs that process's answers a re-solve.
+        const std::string tempPath =
+            persistentPath + "." + std::to_string(llvm::sys::Process::getProcessId()) + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            if (!out)
+            {
+                error = "cannot write SMT cache file '" + tempPath + "'";
+                return false;
+            }
+            for (Shard& shard : shards)
+            {
+                std::lock_guard<std::mutex> shardLock(shard.mutex);
+                for (const auto& [key, status] : shard.decisions)
+                    out << key << " " << encodeStatus(status) << "\n";
+            }
+            if (!out.flush())
+            {
+                error = "cannot write SMT cache file '" + tempPath + "'";
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, persistentPath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            error = "cannot replace SMT cache file '" + persistentPath + "'";
+            return false;
+        }
+        pendingPersistent.clear();
+        persistentWastedLines = 0;
+        return true;
+    }
+
+    SmtQueryCacheStats SmtQueryCache::stats() const
+    {
+        return SmtQueryCacheStats{.lookups = lookupCount.load(std::memory_order_relaxed),
+                                  .hits = hitCount.load(std::memory_order_relaxed),
+                                  .persistentEntries =
+                                      persistentCount.load(std::memory_order_relaxed)};
+    }
+} // namespace ctrace::stack::analysis::smt
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "analysis/smt/SolverOrchestrator.hpp"
 
+#include "analysis/smt/ConstraintPresolver.hpp"
 #include "analysis/smt/ISolverStrategy.hpp"
 #include "analysis/smt/TextUtil.hpp"
 
@@ -9,9 +10,18 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace ctrace::stack::analysis::smt
@@ -26,10 +36,21 @@ namespace ctrace::stack::analysis::smt
                 return "interval";
             }
 
-            SmtAnswer solve(const SmtQuery& query) const override
+            bool reportsExactSat() const override
+            {
+                return false;
+            }
+
+            SmtAnswer solve(const SmtQuery& query, SmtCancellation* cancellation) const override
             {
                 for (const IntervalConstraint& c : query.ir.intervals)
                 {
+                    if (cancellation && cancellation->requested())
+                    {
+                        return SmtAnswer{.backendName = name(),
+                                         .reason = std::string("cancelled"),
+                                         .status = SmtStatus::Unknown};
+                    }
                     if (c.hasLower && c.hasUpper && c.lower > c.upper)
                     {
                         return SmtAnswer{.backendName = name(),
@@ -55,7 +76,7 @@ namespace ctrace::stack::analysis::smt
                 return backendName_;
             }
 
-            SmtAnswer solve(const SmtQuery&) const override
+            SmtAnswer solve(const SmtQuery&, SmtCancellation*) const override
             {
                 return SmtAnswer{
                     .backendName = backendName_,
@@ -99,6 +120,184 @@ namespace ctrace::stack::analysis::smt
                 out.push_back(std::move(backend));
         }
 
+        // Long-lived threads for the non-primary members of concurrent solves.
+        // Threads persist so backends keep their per-thread solver state
+        // (see Z3Backend) across queries. They are started on demand, up to
+        // the largest count an orchestrator asked for.
+        class SolverWorkerPool
+        {
+          public:
+            static SolverWorkerPool& instance()
+            {
+                static SolverWorkerPool pool;
+                return pool;
+            }
+
+            void reserve(unsigned count)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (workers.size() < count)
+                    workers.emplace_back([this]() { workerLoop(); });
+            }
+
+            void submit(std::function<void()> task)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    tasks.push_back(std::move(task));
+                }
+                wakeup.notify_one();
+            }
+
+            ~SolverWorkerPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wakeup.notify_all();
+                for (std::thread& worker : workers)
+                    worker.join();
+            }
+
+            SolverWorkerPool(const SolverWorkerPool&) = delete;
+            SolverWorkerPool& operator=(const SolverWorkerPool&) = delete;
+
+          private:
+            SolverWorkerPool() = default;
+
+            void workerLoop()
+            {
+                for (;;)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        wakeup.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty())
+                            return;
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            std::mutex mutex;
+            std::condition_variable wakeup;
+            std::deque<std::function<void()>> tasks;
+            std::vector<std::thread> workers;
+            std::uint64_t stopping : 1 = false;
+            std::uint64_t reservedFlags : 63 = 0;
+        };
+
+        class WinCounter
+        {
+          public:
+            static WinCounter& instance()
+            {
+                static WinCounter counter;
+                return counter;
+            }
+
+            void record(const std::string& backendName)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++wins[backendName];
+            }
+
+            std::vector<SmtBackendWins> snapshot()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::vector<SmtBackendWins> out;
+                out.reserve(wins.size());
+                for (const auto& [backendName, count] : wins)
+                    out.push_back(SmtBackendWins{.backendName = backendName, .wins = count});
+                return out;
+            }
+
+          private:
+            std::mutex mutex;
+            std::map<std::string, std::uint64_t> wins;
+        };
+
+        static bool isDefinitive(SmtStatus status)
+        {
+            return status == SmtStatus::Sat || status == SmtStatus::Unsat;
+        }
+
+        static bool isExactSat(const ISmtBackend& backend, SmtStatus status)
+        {
+            return status == SmtStatus::Sat && backend.reportsExactSat();
+        }
+
+        // Decides, from one finished member, whether the others can be cancelled.
+        using StopPredicate = bool (*)(const ISmtBackend& backend, std::size_t backendIndex,
+                                       SmtStatus status);
+
+        // Runs backends[0] on the calling thread and the others on the worker
+        // pool. Once `shouldStop` accepts an answer, the remaining members are
+        // cancelled and that backend is credited with a win; cancelled
+        // members still report (as Unknown) so the result keeps one entry per
+        // backend, in backend order.
+        //
+        // Only backends with exact Sat answers are cancellable. A sound exact
+        // backend cannot contradict the answer that stopped the race, but an
+        // over-approximating one (interval) can, and dropping its answer would
+        // make the aggregated status depend on thread timing.
+        static std::vector<SmtAnswer>
+        raceBackends(const SmtQuery& query, std::span<const std::shared_ptr<ISmtBackend>> backends,
+                     StopPredicate shouldStop)
+        {
+            struct RaceState
+            {
+                std::mutex mutex;
+                std::condition_variable finished;
+                std::vector<std::optional<SmtAnswer>> answers;
+                SmtCancellation cancellation;
+                std::size_t pending = 0;
+                std::uint64_t stopped : 1 = false;
+                std::uint64_t reservedFlags : 63 = 0;
+            };
+
+            RaceState race;
+            race.answers.resize(backends.size());
+            race.pending = backends.size();
+
+            auto runMember = [&](std::size_t index)
+            {
+                SmtCancellation* cancellation =
+                    backends[index]->reportsExactSat() ? &race.cancellation : nullptr;
+                SmtAnswer answer = backends[index]->solve(query, cancellation);
+                std::lock_guard<std::mutex> lock(race.mutex);
+                if (!race.stopped && shouldStop(*backends[index], index, answer.status))
+                {
+                    race.stopped = true;
+                    WinCounter::instance().record(answer.backendName);
+                    race.cancellation.request();
+                }
+                race.answers[index] = std::move(answer);
+                --race.pending;
+                // Notify under the lock: the waiter owns `race` and may
+                // destroy it as soon as it observes pending == 0.
+                race.finished.notify_all();
+            };
+
+            SolverWorkerPool& pool = SolverWorkerPool::instance();
+            for (std::size_t index = 1; index < backends.size(); ++index)
+                pool.submit([&runMember, index]() { runMember(index); });
+            runMember(0);
+
+            std::unique_lock<std::mutex> lock(race.mutex);
+            race.finished.wait(lock, [&race]() { return race.pending == 0; });
+
+            std::vector<SmtAnswer> answers;
+            answers.reserve(race.answers.size());
+            for (std::optional<SmtAnswer>& answer : race.answers)
+                answers.push_back(std::move(*answer));
+            return answers;
+        }
+
         class SingleSolverStrategy final : public ISolverStrategy
         {
           public:
@@ -108,25 +307,56 @@ namespace ctrace::stack::analysis::smt
             {
                 if (backends.empty())
                     return {};
-                return {backends.front()->solve(query)};
+                return {backends.front()->solve(query, nullptr)};
             }
         };
 
+        // Portfolio: the first Unsat or exact Sat settles the query.
+        // DualConsensus: only an exact Sat settles early, Unsat needs every
+        // member. Aggregation is unchanged, so a race only skips work whose
+        // answer could not change the aggregated status.
         class PortfolioSolverStrategy final : public ISolverStrategy
         {
           public:
+            explicit PortfolioSolverStrategy(bool requireConsensusOnUnsat)
+                : requireConsensusOnUnsat(requireConsensusOnUnsat)
+            {
+            }
+
             std::vector<SmtAnswer>
             run(const SmtQuery& query,
                 const std::vector<std::shared_ptr<ISmtBackend>>& backends) const override
             {
-                std::vector<SmtAnswer> answers;
-                answers.reserve(backends.size());
-                for (const std::shared_ptr<ISmtBackend>& backend : backends)
-                    answers.push_back(backend->solve(query));
-                return answers;
+                if (backends.size() <= 1)
+                {
+                    if (backends.empty())
+                        return {};
+                    return {backends.front()->solve(query, nullptr)};
+                }
+                if (requireConsensusOnUnsat)
+                {
+                    return raceBackends(query, backends, &stopsConsensus);
+                }
+                return raceBackends(query, backends, &stopsPortfolio);
+            }
+
+          private:
+            static bool stopsPortfolio(const ISmtBackend& backend, std::size_t, SmtStatus status)
+            {
+                return status == SmtStatus::Unsat || isExactSat(backend, status);
             }
+
+            static bool stopsConsensus(const ISmtBackend& backend, std::size_t, SmtStatus status)
+            {
+                return isExactSat(backend, status);
+            }
+
+            std::uint64_t requireConsensusOnUnsat : 1 = false;
+            std::uint64_t reservedFlags : 63 = 0;
         };
 
+        // The secondary starts speculatively next to the primary and is only
+        // reported when the primary is inconclusive.
         class CrossCheckSolverStrategy final : public ISolverStrategy
         {
           public:
@@ -136,20 +366,15 @@ namespace ctrace::stack::analysis::smt
             {
                 if (backends.empty())
                     return {};
-
-                std::vector<SmtAnswer> answers;
-                answers.reserve(std::min<std::size_t>(2, backends.size()));
-
-                SmtAnswer primary = backends.front()->solve(query);
-                answers.push_back(primary);
-
-                if ((primary.status == SmtStatus::Unknown || primary.status == SmtStatus::Timeout ||
-                     primary.status == SmtStatus::Error) &&
-                    backends.size() >= 2)
-                {
-                    answers.push_back(backends[1]->solve(query));
-                }
-
+                if (backends.size() < 2)
+                    return {backends.front()->solve(query, nullptr)};
+
+                std::vector<SmtAnswer> answers =
+                    raceBackends(query, std::span(backends).first(2),
+                                 [](const ISmtBackend&, std::size_t index, SmtStatus status)
+                                 { return index == 0 && isDefinitive(status); });
+                if (isDefinitive(answers.front().status))
+                    answers.pop_back();
                 return answers;
             }
         };
@@ -200,6 +425,27 @@ namespace ctrace::stack::analysis::smt
             return SmtStatus::Unknown;
         }
 
+        // Strategies are stateless and shared by every orchestrator.
+        static const ISolverStrategy* strategyFor(SolverMode mode)
+        {
+            static const SingleSolverStrategy single;
+            static const PortfolioSolverStrategy portfolio(false);
+            static const CrossCheckSolverStrategy crossCheck;
+            static const PortfolioSolverStrategy dualConsensus(true);
+            switch (mode)
+            {
+            case SolverMode::Single:
+                return &single;
+            case SolverMode::Portfolio:
+                return &portfolio;
+            case SolverMode::CrossCheck:
+                return &crossCheck;
+            case SolverMode::DualConsensus:
+                return &dualConsensus;
+            }
+            return &single;
+        }
+
         static std::vector<std::shared_ptr<ISmtBackend>>
         resolveBackends(const SolverOrchestratorConfig& config)
         {
@@ -235,14 +481,21 @@ namespace ctrace::stack::analysis::smt
     } // namespace
 
     SolverOrchestrator::SolverOrchestrator(SolverOrchestratorConfig config)
-        : config_(std::move(config))
+        : config_(std::move(config)), backends_(resolveBackends(config_)),
+          strategy_(strategyFor(config_.mode))
     {
+        if (config_.mode != SolverMode::Single && backends_.size() > 1)
+        {
+            const unsigned workers = config_.workerThreads != 0
+                                         ? config_.workerThreads
+                                         : std::max(2u, std::thread::hardware_concurrency());
+            SolverWorkerPool::instance().reserve(workers);
+        }
     }
 
     SmtDecision SolverOrchestrator::solve(const SmtQuery& query) const
     {
-        std::vector<std::shared_ptr<ISmtBackend>> backends = resolveBackends(config_);
-        if (backends.empty())
+        if (backends_.empty())
         {
             return SmtDecision{.answers = {SmtAnswer{.backendName = "orchestrator",
                                                      .reason = std::string("no backend available"),
@@ -250,31 +503,60 @@ namespace ctrace::stack::analysis::smt
                                .status = SmtStatus::Error};
         }
 
-        SmtQuery runtimeQuery = query;
-        if (runtimeQuery.timeoutMs == 0)
-            runtimeQuery.timeoutMs = config_.timeoutMs;
-        if (runtimeQuery.budgetNodes == 0)
-            runtimeQuery.budgetNodes = config_.budgetNodes;
+        // Queries decided by folding and bound propagation never reach a
+        // backend; the others are dispatched on their simplified residual.
+        PresolveResult presolved = presolveConstraints(query.ir);
+        if (presolved.outcome != PresolveOutcome::Residual)
+        {
+            const SmtStatus status =
+                presolved.outcome == PresolveOutcome::Sat ? SmtStatus::Sat : SmtStatus::Unsat;
+            return SmtDecision{
+                .answers = {SmtAnswer{
+                    .backendName = "presolve", .reason = std::nullopt, .status = status}},
+                .status = status};
+        }
 
-        std::unique_ptr<ISolverStrategy> strategy;
-        switch (config_.mode)
+        // Only copy the query (and its IR) when it was rewritten or a default
+        // must be filled in.
+        std::optional<SmtQuery> rewritten;
+        if (presolved.residual)
+        {
+            rewritten = SmtQuery{.ir = std::move(*presolved.residual),
+                                 .ruleId = query.ruleId,
+                                 .budgetNodes = query.budgetNodes,
+                                 .timeoutMs = query.timeoutMs};
+        }
+        else if (query.timeoutMs == 0 || query.budgetNodes == 0)
+        {
+            rewritten = query;
+        }
+        if (rewritten)
         {
-        case SolverMode::Single:
-            strategy = std::make_unique<SingleSolverStrategy>();
-            break;
-        case SolverMode::Portfolio:
-            strategy = std::make_unique<PortfolioSolverStrategy>();
-            break;
-        case SolverMode::CrossCheck:
-            strategy = std::make_unique<CrossCheckSolverStrategy>();
-            break;
-        case SolverMode::DualConsensus:
-            strategy = std::make_unique<PortfolioSolverStrategy>();
-            break;
+            if (rewritten->timeoutMs == 0)
+                rewritten->timeoutMs = config_.timeoutMs;
+            if (rewritten->budgetNodes == 0)
+                rewritten->budgetNodes = config_.budgetNodes;
         }
 
-        std::vector<SmtAnswer> answers = strategy->run(runtimeQuery, backends);
+        std::vector<SmtAnswer> answers = strategy_->run(rewritten ? *rewritten : query, backends_);
         const SmtStatus status = aggregateStatuses(answers, config_.mode);
         return SmtDecision{.answers = std::move(answers), .status = status};
     }
+
+    std::vector<SmtDecision> SolverOrchestrator::solveAll(std::span<const SmtQuery> queries) const
+    {
+        // Queries of one batch run back to back on this thread, so backends
+        // with per-thread state (Z3's shared guarded constraints) encode the
+        // constraints they have in common once.
+        std::vector<SmtDecision> decisions;
+        decisions.reserve(queries.size());
+        for (const SmtQuery& query : queries)
+            decisions.push_back(solve(query));
+        return decisions;
+    }
+
+    std::vector<SmtBackendWins> concurrentSolveWins()
+    {
+        return WinCounter::instance().snapshot();
+    }
 } // namespace ctrace::stack::analysis::smt
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "analysis/smt/backends/Z3Backend.hpp"
 
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -36,6 +38,166 @@ namespace ctrace::stack::analysis::smt
             return ctx.bv_val(std::to_string(raw).c_str(), normalizeBitWidth(bitWidth));
         }
 
+        // Z3 state kept alive across queries on one worker thread. Creating a
+        // context costs more than solving the small range/overflow queries the
+        // analyses emit, so each thread owns one context and one solver.
+        //
+        // Every distinct constraint is asserted once as `guard => constraint`
+        // and queries only pass the guards of their own constraints as
+        // assumptions. Queries from the same function share most of their
+        // range constraints, which Z3 hash-conses to the same AST and thus to
+        // the same guard. Guards of other queries stay unassumed, so their
+        // implications are trivially satisfied and do not affect the answer.
+        class Z3ThreadSession
+        {
+          public:
+            z3::context& context()
+            {
+                ensureInitialized();
+                return *ctx_;
+            }
+
+            // Drops the solver's tracked constraints once they grow past the
+            // cap, so stale guards do not slow down later checks.
+            void beginQuery(std::uint32_t timeoutMs)
+            {
+                ensureInitialized();
+                if (guards_.size() >= kMaxTrackedConstraints)
+                {
+                    guards_.clear();
+                    solver_->reset();
+                    appliedTimeoutMs_.reset();
+                    ++solverResets_;
+                }
+                if (appliedTimeoutMs_ != timeoutMs)
+                {
+                    z3::params params(*ctx_);
+                    // The solver outlives the query: 0 must restore Z3's own
+                    // "no timeout" default instead of keeping the previous one.
+                    params.set("timeout", timeoutMs > 0 ? timeoutMs
+                                                        : std::numeric_limits<unsigned>::max());
+                    solver_->set(params);
+                    appliedTimeoutMs_ = timeoutMs;
+                }
+            }
+
+            z3::expr declareBv(const std::string& name, std::uint32_t width)
+            {
+                const auto it = symbols_.find(name);
+                if (it != symbols_.end() && it->second.bitWidth == width)
+                    return it->second.expr;
+                z3::expr symbolExpr = ctx_->bv_const(name.c_str(), width);
+                symbols_.insert_or_assign(name, SymbolEntry(name, width, symbolExpr));
+                return symbolExpr;
+            }
+
+            z3::expr guardFor(const z3::expr& constraint)
+            {
+                const unsigned astId = Z3_get_ast_id(*ctx_, constraint);
+                const auto it = guards_.find(astId);
+                if (it != guards_.end())
+                    return it->second.guard;
+
+                z3::expr guard =
+                    ctx_->bool_const(("__ctrace_guard_" + std::to_string(nextGuardId_++)).c_str());
+                solver_->add(z3::implies(guard, constraint));
+                // Keeping the constraint referenced pins its AST id.
+                guards_.emplace(astId, TrackedConstraint{constraint, guard});
+                return guard;
+            }
+
+            z3::solver& solver()
+            {
+                return *solver_;
+            }
+
+            // After a Z3 exception the solver state is not trusted anymore.
+            void reset()
+            {
+                guards_.clear();
+                symbols_.clear();
+                solver_.reset();
+                ctx_.reset();
+                appliedTimeoutMs_.reset();
+                ++solverResets_;
+            }
+
+            Z3SessionStats stats() const
+            {
+                return Z3SessionStats{.trackedConstraints = guards_.size(),
+                                      .guardsCreated = nextGuardId_,
+                                      .solverResets = solverResets_,
+                                      .contextsCreated = contextsCreated_,
+                                      .appliedTimeoutMs = appliedTimeoutMs_};
+            }
+
+          private:
+            struct TrackedConstraint
+            {
+                z3::expr constraint;
+                z3::expr guard;
+            };
+
+            static constexpr std::size_t kMaxTrackedConstraints = 1024;
+
+            void ensureInitialized()
+            {
+                if (ctx_)
+                    return;
+                ctx_ = std::make_unique<z3::context>();
+                solver_ = std::make_unique<z3::solver>(*ctx_);
+                ++contextsCreated_;
+            }
+
+            // Declaration order matters: expressions must be released before
+            // the context that owns them.
+            std::unique_ptr<z3::context> ctx_;
+            std::unique_ptr<z3::solver> solver_;
+            std::unordered_map<std::string, SymbolEntry> symbols_;
+            std::unordered_map<unsigned, TrackedConstraint> guards_;
+            std::optional<std::uint32_t> appliedTimeoutMs_;
+            std::uint64_t nextGuardId_ = 0;
+            std::uint64_t solverResets_ = 0;
+            std::uint64_t contextsCreated_ = 0;
+        };
+
+        // Keeps a context interrupt hook registered while a check is running.
+        class ScopedInterrupt
+        {
+          public:
+            ScopedInterrupt(SmtCancellation* cancellation, z3::context& ctx)
+                : cancellation(cancellation)
+            {
+                if (cancellation)
+                    armed = cancellation->setInterrupt([&ctx]() { ctx.interrupt(); });
+            }
+
+            ~ScopedInterrupt()
+            {
+                if (cancellation && armed)
+                    cancellation->clearInterrupt();
+            }
+
+            ScopedInterrupt(const ScopedInterrupt&) = delete;
+            ScopedInterrupt& operator=(const ScopedInterrupt&) = delete;
+
+            bool cancelledBeforeStart() const
+            {
+                return cancellation && !armed;
+            }
+
+          private:
+            SmtCancellation* cancellation = nullptr;
+            std::uint64_t armed : 1 = false;
+            std::uint64_t reservedFlags : 63 = 0;
+        };
+
+        static Z3ThreadSession& threadSession()
+        {
+            thread_local Z3ThreadSession session;
+            return session;
+        }
+
         static std::unordered_map<SymbolId, std::uint32_t> collectBitWidths(const ConstraintIR& ir)
         {
             std::unordered_map<SymbolId, std::uint32_t> widths;
@@ -62,7 +224,7 @@ namespace ctrace::stack::analysis::smt
         }
 
         static std::optional<z3::expr>
-        getOrCreateSymbol(z3::context& ctx, SymbolId id, std::uint32_t bitWidth,
+        getOrCreateSymbol(Z3ThreadSession& session, SymbolId id, std::uint32_t bitWidth,
                           std::unordered_map<SymbolId, SymbolEntry>& symbols,
                           const std::unordered_map<SymbolId, std::string>& names,
                           std::string& error)
@@ -89,14 +251,14 @@ namespace ctrace::stack::analysis::smt
                 (nameIt != names.end()) ? nameIt->second : ("sym_" + std::to_string(id));
 
             const std::uint32_t width = normalizeBitWidth(bitWidth);
-            z3::expr symbolExpr = ctx.bv_const(symbolName.c_str(), width);
+            z3::expr symbolExpr = session.declareBv(symbolName, width);
             auto inserted =
                 symbols.emplace(id, SymbolEntry(symbolName, width, std::move(symbolExpr))).first;
             return inserted->second.expr;
         }
 
         static std::optional<z3::expr>
-        buildExpr(ExprId id, const ConstraintIR& ir, z3::context& ctx,
+        buildExpr(ExprId id, const ConstraintIR& ir, Z3ThreadSession& session,
                   std::unordered_map<ExprId, z3::expr>& cache,
                   std::unordered_map<SymbolId, SymbolEntry>& symbols,
                   const std::unordered_map<SymbolId, std::string>& names, std::string& error)
@@ -110,6 +272,7 @@ namespace ctrace::stack::analysis::smt
                 return std::nullopt;
             }
 
+            z3::context& ctx = session.context();
             const ExprNode& node = ir.nodes[id];
             const std::uint32_t bitWidth = normalizeBitWidth(node.bitWidth);
 
@@ -121,17 +284,17 @@ namespace ctrace::stack::analysis::smt
             };
 
             auto lhs = [&]() -> std::optional<z3::expr>
-            { return buildExpr(node.lhs, ir, ctx, cache, symbols, names, error); };
+            { return buildExpr(node.lhs, ir, session, cache, symbols, names, error); };
 
             auto rhs = [&]() -> std::optional<z3::expr>
-            { return buildExpr(node.rhs, ir, ctx, cache, symbols, names, error); };
+            { return buildExpr(node.rhs, ir, session, cache, symbols, names, error); };
 
             switch (node.kind)
             {
             case ExprKind::Symbol:
             {
                 std::optional<z3::expr> symbol =
-                    getOrCreateSymbol(ctx, node.symbol, bitWidth, symbols, names, error);
+                    getOrCreateSymbol(session, node.symbol, bitWidth, symbols, names, error);
                 if (!symbol)
                     return std::nullopt;
                 return memoize(*symbol);
@@ -142,7 +305,7 @@ namespace ctrace::stack::analysis::smt
             {
                 auto cond = lhs();
                 auto onTrue = rhs();
-                auto onFalse = buildExpr(node.extra, ir, ctx, cache, symbols, names, error);
+                auto onFalse = buildExpr(node.extra, ir, session, cache, symbols, names, error);
                 if (!cond || !onTrue || !onFalse)
                     return std::nullopt;
                 if (!cond->is_bool())
@@ -356,8 +519,19 @@ namespace ctrace::stack::analysis::smt
         return "z3";
     }
 
-    SmtAnswer Z3Backend::solve(const SmtQuery& query) const
+    Z3SessionStats Z3Backend::threadSessionStats()
     {
+        return threadSession().stats();
+    }
+
+    SmtAnswer Z3Backend::solve(const SmtQuery& query, SmtCancellation* cancellation) const
+    {
+        const SmtAnswer cancelled{.backendName = name(),
+                                  .reason = std::string("cancelled: another backend answered"),
+                                  .status = SmtStatus::Unknown};
+        if (cancellation && cancellation->requested())
+            return cancelled;
+
         if (query.budgetNodes != 0 && query.ir.nodes.size() > query.budgetNodes)
         {
             return SmtAnswer{.backendName = name(),
@@ -366,17 +540,12 @@ namespace ctrace::stack::analysis::smt
                              .status = SmtStatus::Timeout};
         }
 
+        Z3ThreadSession& session = threadSession();
         try
         {
-            z3::context ctx;
-            z3::solver solver(ctx);
-
-            if (query.timeoutMs > 0)
-            {
-                z3::params params(ctx);
-                params.set("timeout", query.timeoutMs);
-                solver.set(params);
-            }
+            session.beginQuery(query.timeoutMs);
+            z3::context& ctx = session.context();
+            z3::expr_vector assumptions(ctx);
 
             const auto bitWidths = collectBitWidths(query.ir);
             const auto names = collectNames(query.ir);
@@ -393,16 +562,18 @@ namespace ctrace::stack::analysis::smt
                         bitWidths.contains(interval.symbol) ? bitWidths.at(interval.symbol) : 64;
 
                     std::string error;
-                    std::optional<z3::expr> symbol =
-                        getOrCreateSymbol(ctx, interval.symbol, bitWidth, symbols, names, error);
+                    std::optional<z3::expr> symbol = getOrCreateSymbol(
+                        session, interval.symbol, bitWidth, symbols, names, error);
                     if (!symbol)
                         return SmtAnswer{
                             .backendName = name(), .reason = error, .status = SmtStatus::Unknown};
 
                     if (interval.hasLower)
-                        solver.add(z3::sge(*symbol, makeBvConstant(ctx, interval.lower, bitWidth)));
+                        assumptions.push_back(session.guardFor(
+                            z3::sge(*symbol, makeBvConstant(ctx, interval.lower, bitWidth))));
                     if (interval.hasUpper)
-                        solver.add(z3::sle(*symbol, makeBvConstant(ctx, interval.upper, bitWidth)));
+                        assumptions.push_back(session.guardFor(
+                            z3::sle(*symbol, makeBvConstant(ctx, interval.upper, bitWidth))));
                 }
             }
 
@@ -411,7 +582,7 @@ namespace ctrace::stack::analysis::smt
             {
                 std::string error;
                 std::optional<z3::expr> assertion =
-                    buildExpr(assertionId, query.ir, ctx, cache, symbols, names, error);
+                    buildExpr(assertionId, query.ir, session, cache, symbols, names, error);
                 if (!assertion)
                 {
                     return SmtAnswer{.backendName = name(),
@@ -424,10 +595,14 @@ namespace ctrace::stack::analysis::smt
                                      .reason = std::string("non-boolean assertion"),
                                      .status = SmtStatus::Unknown};
                 }
-                solver.add(*assertion);
+                assumptions.push_back(session.guardFor(*assertion));
             }
 
-            const z3::check_result result = solver.check();
+            z3::solver& solver = session.solver();
+            const ScopedInterrupt interrupt(cancellation, ctx);
+            if (interrupt.cancelledBeforeStart())
+                return cancelled;
+            const z3::check_result result = solver.check(assumptions);
             if (result == z3::sat)
                 return SmtAnswer{
                     .backendName = name(), .reason = std::nullopt, .status = SmtStatus::Sat};
@@ -435,14 +610,18 @@ namespace ctrace::stack::analysis::smt
                 return SmtAnswer{
                     .backendName = name(), .reason = std::nullopt, .status = SmtStatus::Unsat};
 
+            if (cancellation && cancellation->requested())
+                return cancelled;
             const std::string reason = solver.reason_unknown();
-            if (reason == "timeout")
+            // Incremental checks report an expired timeout as "canceled".
+            if (reason == "timeout" || reason == "canceled")
                 return SmtAnswer{
                     .backendName = name(), .reason = reason, .status = SmtStatus::Timeout};
             return SmtAnswer{.backendName = name(), .reason = reason, .status = SmtStatus::Unknown};
         }
         catch (const z3::exception& ex)
         {
+            session.reset();
             return SmtAnswer{
                 .backendName = name(), .reason = std::string(ex.msg()), .status = SmtStatus::Error};
         }
@@ -19,6 +19,7 @@
 #include "analysis/IntegerOverflowAnalysis.hpp"
 #include "analysis/InvalidBaseReconstruction.hpp"
 #include "analysis/MemIntrinsicOverflow.hpp"
+#include "analysis/ModelRegistry.hpp"
 #include "analysis/NullDerefAnalysis.hpp"
 #include "analysis/OOBReadAnalysis.hpp"
 #include "analysis/ResourceLifetimeAnalysis.hpp"
@@ -26,6 +27,7 @@
 #include "analysis/StackBufferAnalysis.hpp"
 #include "analysis/StackComputation.hpp"
 #include "analysis/StackPointerEscape.hpp"
+#include "analysis/StackSummary.hpp"
 #include "analysis/TOCTOUAnalysis.hpp"
 #include "analysis/TypeConfusionAnalysis.hpp"
 #include "analysis/UninitializedVarAnalysis.hpp"
@@ -309,6 +311,18 @@ namespace ctrace::stack::analyzer
         steps.push_back({"Build results", [](PipelineData& state)
                          { state.result = buildResults(*state.prepared, state.aux); }});
 
+        steps.push_back({"Export stack summary", [](PipelineData& state)
+                         {
+                             if (!state.config.stackSummaryExport)
+                                 return;
+                             const PreparedModule& prepared = *state.prepared;
+                             state.result.stackSummary =
+                                 std::make_shared<const analysis::ModuleStackSummary>(
+                                     analysis::buildModuleStackSummary(
+                                         prepared.ctx.allDefinedFunctions, prepared.localStack,
+                                         prepared.recursionState));
+                         }});
+
         steps.push_back({"Emit summary diagnostics", [](PipelineData& state)
                          { emitSummaryDiagnostics(state.result, *state.prepared, state.aux); }});
 
@@ -387,23 +401,20 @@ namespace ctrace::stack::analyzer
                  {
                      const llvm::DataLayout& dataLayout = *state.prepared->ctx.dataLayout;
 
-                     // Parse model once for all functions.
-                     analysis::BufferWriteModel externalModel;
+                     // Shared parsed model for all functions (and all modules).
+                     std::shared_ptr<const analysis::BufferWriteModel> externalModel;
                      analysis::BufferWriteRuleMatcher ruleMatcher;
-                     const analysis::BufferWriteModel* modelPtr = nullptr;
                      if (!state.config.bufferModelPath.empty())
                      {
                          std::string parseError;
-                         if (analysis::parseBufferWriteModel(state.config.bufferModelPath,
-                                                             externalModel, parseError))
-                         {
-                             modelPtr = &externalModel;
-                         }
-                         else
-                         {
+                         externalModel =
+                             analysis::ModelRegistry<analysis::BufferWriteModel>::instance().load(
+                                 state.config.bufferModelPath, &analysis::parseBufferWriteModel,
+                                 parseError);
+                         if (!externalModel)
                              std::cerr << "Buffer model load error: " << parseError << "\n";
-                         }
                      }
+                     const analysis::BufferWriteModel* modelPtr = externalModel.get();
 
                      std::vector<analysis::MemIntrinsicIssue> issues;
                      for (const auto& [func, data] : cache->data())
@@ -505,8 +516,9 @@ namespace ctrace::stack::analyzer
                              auto shouldAnalyze = [&](const llvm::Function& F) -> bool
                              { return state.prepared->ctx.shouldAnalyze(F); };
                              const std::vector<analysis::StackPointerEscapeIssue> issues =
-                                 analysis::analyzeStackPointerEscapes(state.mod, shouldAnalyze,
-                                                                      state.config.escapeModelPath);
+                                 analysis::analyzeStackPointerEscapes(
+                                     state.mod, shouldAnalyze, state.config.escapeModelPath,
+                                     state.config.stackEscapeSummaryIndex.get());
                              appendStackPointerEscapeDiagnostics(state.result, issues);
                          }});
 
@@ -615,10 +627,17 @@ namespace ctrace::stack::analyzer
 
                  auto shouldAnalyze = [&](const llvm::Function& F) -> bool
                  { return state.prepared->ctx.shouldAnalyze(F); };
+                 const analysis::ResourceLifetimeModuleState* reusableState = nullptr;
+                 if (const auto& states = state.config.resourceLifetimeStates)
+                 {
+                     const auto it = states->byModule.find(&state.mod);
+                     if (it != states->byModule.end())
+                         reusableState = &it->second;
+                 }
                  const std::vector<analysis::ResourceLifetimeIssue> issues =
-                     analysis::analyzeResourceLifetime(state.mod, shouldAnalyze,
-                                                       state.config.resourceModelPath,
-                                                       state.config.resourceSummaryIndex.get());
+                     analysis::analyzeResourceLifetime(
+                         state.mod, shouldAnalyze, state.config.resourceModelPath,
+                         state.config.resourceSummaryIndex.get(), reusableState);
                  appendResourceLifetimeDiagnostics(state.result, issues);
              }});
 
@@ -647,6 +666,7 @@ namespace ctrace::stack::analyzer
         setStepMeta("Collect IR facts", kPrepared, kIRFacts | kPipelineSignals, true,
                     ExecutionModel::Utility);
         setStepMeta("Build results", kPrepared, kNone, false, ExecutionModel::Utility);
+        setStepMeta("Export stack summary", kPrepared, kNone, false, ExecutionModel::Utility);
         setStepMeta("Emit summary diagnostics", kPrepared, kNone, false, ExecutionModel::Utility);
         setStepMeta("Compute alloca threshold", kNone, kAllocaThreshold, false,
                     ExecutionModel::Utility);
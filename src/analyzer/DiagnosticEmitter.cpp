@@ -9,6 +9,7 @@
 #include <map>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Function.h>
@@ -350,6 +351,65 @@ namespace ctrace::stack::analyzer
         }
     }
 
+    void applyWholeProgramStack(AnalysisResult& result, const analysis::WholeProgramStack& program,
+                                std::size_t moduleIndex)
+    {
+        const analysis::ModuleStackSummary& summary = *program.modules[moduleIndex];
+        std::unordered_map<std::string_view, std::uint32_t> summaryIndex;
+        summaryIndex.reserve(summary.functions.size());
+        for (std::uint32_t i = 0; i < summary.functions.size(); ++i)
+            summaryIndex.emplace(summary.functions[i].name, i);
+
+        for (FunctionResult& functionResult : result.functions)
+        {
+            const auto itIndex = summaryIndex.find(functionResult.name);
+            if (itIndex == summaryIndex.end())
+                continue;
+
+            const analysis::FunctionId id = program.moduleBase[moduleIndex] + itIndex->second;
+            const analysis::StackEstimate& total = program.totals[id];
+            if (total.bytes <= functionResult.maxStack &&
+                (!total.unknown || functionResult.maxStackUnknown))
+            {
+                continue;
+            }
+
+            const bool exceededLocally = functionResult.exceedsLimit;
+            functionResult.maxStack = std::max(functionResult.maxStack, total.bytes);
+            functionResult.maxStackUnknown = functionResult.maxStackUnknown || total.unknown;
+            functionResult.exceedsLimit =
+                exceededLocally || (!functionResult.maxStackUnknown &&
+                                    functionResult.maxStack > result.config.stackLimit);
+            if (exceededLocally || !functionResult.exceedsLimit)
+                continue;
+
+            const analysis::StackSummaryFunction& fn = summary.functions[itIndex->second];
+            DiagnosticBuilder builder;
+            builder.function(functionResult.name)
+                .filePath(functionResult.filePath)
+                .severity(DiagnosticSeverity::Error)
+                .errCode(DescriptiveErrorCode::StackFrameTooLarge);
+            if (fn.line != 0)
+                builder.lineColumn(fn.line, fn.column);
+
+            std::string message = "\t" + std::string(prefixForSeverity(DiagnosticSeverity::Error)) +
+                                  " potential stack overflow: exceeds limit of " +
+                                  std::to_string(result.config.stackLimit) + " bytes\n" +
+                                  "\t\t ↳ through callees in other translation units "
+                                  "(whole-program max stack: " +
+                                  std::to_string(functionResult.maxStack) + " bytes)\n";
+            if (!functionResult.isRecursive)
+            {
+                const std::string path = analysis::wholeProgramCallPath(program, id);
+                if (!path.empty())
+                    message += "\t\t ↳ path: " + path + "\n";
+            }
+
+            builder.message(std::move(message));
+            result.diagnostics.push_back(builder.build());
+        }
+    }
+
     void appendStackBufferDiagnostics(
         AnalysisResult& result, const std::vector<analysis::StackBufferOverflowIssue>& bufferIssues)
     {
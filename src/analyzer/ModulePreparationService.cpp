@@ -2,6 +2,7 @@
 #include "analyzer/ModulePreparationService.hpp"
 
 #include "analyzer/HotspotProfiler.hpp"
+#include "analysis/FrameSizeTable.hpp"
 #include "analysis/FunctionFilter.hpp"
 
 #include <llvm/IR/CFG.h>
@@ -47,6 +48,8 @@ namespace ctrace::stack::analyzer
             {
                 analysis::LocalStackInfo info =
                     analysis::computeLocalStack(*F, *ctx.dataLayout, ctx.config.mode);
+                if (ctx.config.frameSizeTable && ctx.config.mode == AnalysisMode::ABI)
+                    analysis::applyMeasuredFrameSize(*ctx.config.frameSizeTable, *F, info);
                 localStack[F] = info;
             }
             return localStack;
@@ -127,12 +130,22 @@ namespace ctrace::stack::analyzer
             return artifacts;
         }
 
-        static analysis::CallGraph buildCallGraphFiltered(const ModuleAnalysisContext& ctx)
+        // Ids follow ctx.allDefinedFunctions; callees outside that set are dropped.
+        static analysis::DenseCallGraph buildCallGraphFiltered(const ModuleAnalysisContext& ctx)
         {
-            analysis::CallGraph graph;
+            analysis::DenseCallGraph graph;
+            const std::size_t count = ctx.allDefinedFunctions.size();
+            graph.functions.reserve(count);
+            graph.ids.reserve(count);
+            graph.offsets.reserve(count + 1);
+            for (llvm::Function* F : ctx.allDefinedFunctions)
+            {
+                graph.ids.emplace(F, static_cast<analysis::FunctionId>(graph.functions.size()));
+                graph.functions.push_back(F);
+            }
+
             for (llvm::Function* F : ctx.allDefinedFunctions)
             {
-                auto& callees = graph[F];
                 for (llvm::BasicBlock& BB : *F)
                 {
                     for (llvm::Instruction& I : BB)
@@ -143,27 +156,26 @@ namespace ctrace::stack::analyzer
                         else if (auto* II = llvm::dyn_cast<llvm::InvokeInst>(&I))
                             callee = II->getCalledFunction();
 
-                        if (callee && !callee->isDeclaration() && ctx.isDefined(*callee))
-                            callees.push_back(callee);
+                        if (!callee || callee->isDeclaration())
+                            continue;
+                        if (auto it = graph.ids.find(callee); it != graph.ids.end())
+                            graph.targets.push_back(it->second);
                     }
                 }
+                graph.offsets.push_back(static_cast<std::uint32_t>(graph.targets.size()));
             }
             return graph;
         }
 
         static analysis::InternalAnalysisState
-        computeRecursionState(const ModuleAnalysisContext& ctx, const analysis::CallGraph& graph,
+        computeRecursionState(const ModuleAnalysisContext& ctx,
+                              const analysis::DenseCallGraph& graph,
                               const LocalStackMap& localStack)
         {
             analysis::InternalAnalysisState state =
                 analysis::computeGlobalStackUsage(graph, localStack);
 
-            std::vector<const llvm::Function*> nodes;
-            nodes.reserve(ctx.allDefinedFunctions.size());
-            for (llvm::Function* F : ctx.allDefinedFunctions)
-                nodes.push_back(F);
-
-            const auto recursiveComponents = analysis::computeRecursiveComponents(graph, nodes);
+            const auto recursiveComponents = analysis::computeRecursiveComponents(graph);
             for (const auto& component : recursiveComponents)
             {
                 if (!analysis::detectInfiniteRecursionComponent(component, ctx.config))
@@ -209,7 +221,7 @@ namespace ctrace::stack::analyzer
             return computeLocalStacks(ctx);
         }();
 
-        analysis::CallGraph callGraph = [&]()
+        analysis::DenseCallGraph denseCallGraph = [&]()
         {
             const ScopedHotspot hotspot(timingEnabled, "prepare.call_graph");
             return buildCallGraphFiltered(ctx);
@@ -218,9 +230,13 @@ namespace ctrace::stack::analyzer
         analysis::InternalAnalysisState recursionState = [&]()
         {
             const ScopedHotspot hotspot(timingEnabled, "prepare.recursion_state");
-            return computeRecursionState(ctx, callGraph, localStack);
+            return computeRecursionState(ctx, denseCallGraph, localStack);
         }();
 
+        // Per-function consumers (max-stack call paths) still look callees up
+        // by function.
+        analysis::CallGraph callGraph = analysis::expandCallGraph(denseCallGraph);
+
         return PreparedModule{std::move(ctx), std::move(derivedArtifacts), std::move(localStack),
                               std::move(callGraph), std::move(recursionState)};
     }
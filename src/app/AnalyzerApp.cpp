@@ -2,6 +2,7 @@
 #include "app/AnalyzerApp.hpp"
 
 #include "StackUsageAnalyzer.hpp"
+#include "analyzer/DiagnosticEmitter.hpp"
 #include "analyzer/HotspotProfiler.hpp"
 #include "cli/ArgParser.hpp"
 
@@ -13,18 +14,23 @@
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <optional>
+#include <span>
 #include <sstream>
+#include <string_view>
 #include <system_error>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -33,12 +39,21 @@
 #include <llvm/Support/MD5.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
 #include "analysis/CompileCommands.hpp"
+#include "analysis/FrameSizeTable.hpp"
 #include "analysis/FunctionFilter.hpp"
 #include "analysis/GlobalReadBeforeWriteAnalysis.hpp"
 #include "analysis/InputPipeline.hpp"
 #include "analysis/ResourceLifetimeAnalysis.hpp"
+#include "analysis/StackPointerEscape.hpp"
+#include "analysis/StackSummary.hpp"
+#include "analysis/StronglyConnectedComponents.hpp"
 #include "analysis/UninitializedVarAnalysis.hpp"
+#include "analysis/smt/ConstraintPresolver.hpp"
+#include "analysis/smt/SmtCapture.hpp"
+#include "analysis/smt/SmtQueryCache.hpp"
+#include "analysis/smt/SolverOrchestrator.hpp"
 #include "mangle.hpp"
 
 #include <coretrace/logger.hpp>
@@ -146,66 +161,23 @@ static constexpr std::size_t kDestructiveCacheLineBytes = 64;
 
 // ── Tarjan SCC algorithm on module indices ──
 // Used by both resource and uninit cross-TU loops to compute strongly
-// connected components of the inter-module call graph.
-struct ModuleTarjan
+// connected components of the inter-module call graph. Members of each
+// component are sorted for deterministic output.
+static std::vector<std::vector<std::size_t>>
+computeModuleSCCs(std::size_t N, const std::vector<std::unordered_set<std::size_t>>& edges)
 {
-    std::vector<int> index;
-    std::vector<int> lowlink;
-    std::vector<bool> onStack;
-    std::vector<std::size_t> stack;
     std::vector<std::vector<std::size_t>> sccs;
-    int nextIndex = 0;
-    std::byte padding1[64 - sizeof(int)]{}; // cache line isolation
-
-    void run(std::size_t N, const std::vector<std::unordered_set<std::size_t>>& edges)
-    {
-        index.assign(N, -1);
-        lowlink.assign(N, -1);
-        onStack.assign(N, false);
-        stack.reserve(N);
-        for (std::size_t v = 0; v < N; ++v)
-        {
-            if (index[v] < 0)
-                strongConnect(v, edges);
-        }
-    }
-
-    void strongConnect(std::size_t v, const std::vector<std::unordered_set<std::size_t>>& edges)
-    {
-        index[v] = lowlink[v] = nextIndex++;
-        stack.push_back(v);
-        onStack[v] = true;
-
-        for (std::size_t w : edges[v])
-        {
-            if (index[w] < 0)
-            {
-                strongConnect(w, edges);
-                lowlink[v] = std::min(lowlink[v], lowlink[w]);
-            }
-            else if (onStack[w])
-            {
-                lowlink[v] = std::min(lowlink[v], index[w]);
-            }
-        }
-
-        if (lowlink[v] == index[v])
+    ctrace::stack::analysis::forEachStronglyConnectedComponent(
+        static_cast<std::uint32_t>(N),
+        [&](std::uint32_t v) -> const std::unordered_set<std::size_t>& { return edges[v]; },
+        [&](std::span<const std::uint32_t> members)
         {
-            std::vector<std::size_t> component;
-            std::size_t w;
-            do
-            {
-                w = stack.back();
-                stack.pop_back();
-                onStack[w] = false;
-                component.push_back(w);
-            } while (w != v);
-            // Sort for deterministic output.
+            std::vector<std::size_t> component(members.begin(), members.end());
             std::sort(component.begin(), component.end());
             sccs.push_back(std::move(component));
-        }
-    }
-};
+        });
+    return sccs;
+}
 
 // Build the single-def filtered inter-module edge graph.
 // Only edges through functions with exactly one definition across all modules
@@ -241,9 +213,7 @@ static std::vector<std::vector<std::size_t>>
 computeTopologicalSCCOrder(std::size_t N,
                            const std::vector<std::unordered_set<std::size_t>>& filteredEdges)
 {
-    ModuleTarjan tarjan;
-    tarjan.run(N, filteredEdges);
-    return std::move(tarjan.sccs);
+    return computeModuleSCCs(N, filteredEdges);
 }
 
 // Compute topological levels for SCCs given the filtered edge graph.
@@ -342,6 +312,83 @@ static void runParallelWork(std::size_t workItemCount, unsigned maxJobs, WorkFn&
         llvm::report_fatal_error("parallel work scheduler inconsistency");
 }
 
+// Folds `sources` into dst with mergeEntry and returns whether dst changed.
+// Every symbol sees the same sequence of merges as a sequential fold in
+// source order, so results match it exactly. Large merges partition symbols
+// by hash into shards that fold concurrently into shard-local copies of the
+// touched dst entries; those are then moved back into dst.
+template <typename Index, typename Entries, typename MergeEntryFn>
+static bool mergeSummaryIndicesInOrder(Index& dst, Entries Index::*entries,
+                                       const std::vector<const Index*>& sources,
+                                       unsigned maxJobs, MergeEntryFn&& mergeEntry)
+{
+    constexpr std::size_t kMinEntriesForShardedMerge = 2048;
+    std::size_t totalEntries = 0;
+    for (const Index* src : sources)
+        totalEntries += (src->*entries).size();
+
+    if (maxJobs <= 1 || sources.size() <= 1 || totalEntries < kMinEntriesForShardedMerge)
+    {
+        bool changed = false;
+        for (const Index* src : sources)
+        {
+            for (const auto& entry : src->*entries)
+                changed |= mergeEntry(dst, entry.first, entry.second);
+        }
+        return changed;
+    }
+
+    using EntryRef = const typename Entries::value_type*;
+    const std::size_t shardCount = static_cast<std::size_t>(maxJobs) * 4;
+
+    // Bucket each source's entries by shard once, keeping iteration order.
+    std::vector<std::vector<std::vector<EntryRef>>> buckets(sources.size());
+    runParallelWork(sources.size(), maxJobs,
+                    [&](std::size_t srcIndex)
+                    {
+                        const typename Entries::hasher hasher;
+                        buckets[srcIndex].resize(shardCount);
+                        for (const auto& entry : sources[srcIndex]->*entries)
+                            buckets[srcIndex][hasher(entry.first) % shardCount].push_back(&entry);
+                    });
+
+    std::vector<Index> shardResults(shardCount);
+    std::vector<char> shardChanged(shardCount, 0);
+    runParallelWork(shardCount, maxJobs,
+                    [&](std::size_t shard)
+                    {
+                        Index& local = shardResults[shard];
+                        const Entries& base = dst.*entries;
+                        bool changed = false;
+                        for (const auto& sourceBuckets : buckets)
+                        {
+                            for (EntryRef entry : sourceBuckets[shard])
+                            {
+                                if (!(local.*entries).count(entry->first))
+                                {
+                                    if (const auto it = base.find(entry->first); it != base.end())
+                                        (local.*entries).emplace(*it);
+                                }
+                                changed |= mergeEntry(local, entry->first, entry->second);
+                            }
+                        }
+                        shardChanged[shard] = changed ? 1 : 0;
+                    });
+
+    bool changed = false;
+    for (std::size_t shard = 0; shard < shardCount; ++shard)
+    {
+        changed |= shardChanged[shard] != 0;
+        Entries& local = shardResults[shard].*entries;
+        while (!local.empty())
+        {
+            auto node = local.extract(local.begin());
+            (dst.*entries).insert_or_assign(std::move(node.key()), std::move(node.mapped()));
+        }
+    }
+    return changed;
+}
+
 static NormalizedPathFilters buildNormalizedPathFilters(const AnalysisConfig& cfg)
 {
     NormalizedPathFilters filters;
@@ -648,27 +695,73 @@ static AnalysisResult filterFunctionsWithDiagnostics(const AnalysisResult& resul
     return filtered;
 }
 
+// Per-module inputs of the cross-TU summary builders. They only depend on the
+// module itself, so they are computed by the load task on the worker thread
+// that owns the module's LLVMContext, while other inputs are still compiling.
+struct SharedModulePrep
+{
+    std::string irHash;
+    std::vector<std::string> definedNames;
+    std::unordered_set<std::string> directCalleeNames;
+    std::unordered_set<std::string> uninitializedCalleeNames;
+    std::optional<ctrace::stack::analysis::PreparedUninitializedModuleContext>
+        uninitializedContext;
+    std::optional<ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex> globalReadSummary;
+};
+
+struct SharedModulePrepPlan
+{
+    std::uint32_t resource : 1 = false;
+    std::uint32_t uninitialized : 1 = false;
+    std::uint32_t globalRead : 1 = false;
+    std::uint32_t stackEscape : 1 = false;
+    std::uint32_t reservedFlags : 28 = 0;
+};
+
 struct LoadedInputModule
 {
     std::string filename;
     std::unique_ptr<llvm::LLVMContext> context;
     std::unique_ptr<llvm::Module> module;
     std::vector<Diagnostic> frontendDiagnostics;
+    std::unique_ptr<SharedModulePrep> prep;
+    // Serializes IR reads of the summary builders, which run concurrently.
+    std::unique_ptr<std::mutex> irMutex;
 };
 
+// Summary builders of different kinds run concurrently over the same modules;
+// every IR read they make holds the module's lock, so a module's LLVMContext
+// is only ever used by one thread at a time.
+static std::unique_lock<std::mutex> lockModuleIR(const LoadedInputModule& loaded)
+{
+    if (!loaded.irMutex)
+        return {};
+    return std::unique_lock<std::mutex>(*loaded.irMutex);
+}
+
 using AnalysisEntry = std::pair<std::string, AnalysisResult>;
 
+static std::unique_ptr<SharedModulePrep> prepareSharedModule(llvm::Module& mod,
+                                                             const AnalysisConfig& cfg,
+                                                             SharedModulePrepPlan plan);
+
 static std::shared_ptr<ctrace::stack::analysis::ResourceSummaryIndex>
-buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                         const AnalysisConfig& cfg);
+buildCrossTUSummaryIndex(
+    const std::vector<LoadedInputModule>& loadedModules, const AnalysisConfig& cfg,
+    unsigned maxJobs,
+    std::shared_ptr<const ctrace::stack::analysis::ResourceLifetimeModuleStates>& statesOut);
 
 static std::shared_ptr<ctrace::stack::analysis::UninitializedSummaryIndex>
 buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                                      const AnalysisConfig& cfg);
+                                      const AnalysisConfig& cfg, unsigned maxJobs);
 
 static std::shared_ptr<ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex>
 buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                                              const AnalysisConfig& cfg);
+                                              const AnalysisConfig& cfg, unsigned maxJobs);
+
+static std::shared_ptr<ctrace::stack::analysis::StackEscapeSummaryIndex>
+buildCrossTUStackEscapeSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
+                                    const AnalysisConfig& cfg, unsigned maxJobs);
 
 static void accumulateSummary(DiagnosticSummary& total, const DiagnosticSummary& add);
 
@@ -740,8 +833,8 @@ static AppStatus loadCompilationDatabase(const std::string& compileCommandsPath,
     }
 
     std::string error;
-    auto db =
-        ctrace::stack::analysis::CompilationDatabase::loadFromFile(compdbPath.string(), error);
+    auto db = ctrace::stack::analysis::CompilationDatabase::loadFromFile(
+        compdbPath.string(), error, resolveConfiguredJobs(cfg));
     if (!db)
     {
         return AppStatus::failure("Failed to load compile commands: " + error);
@@ -752,6 +845,64 @@ static AppStatus loadCompilationDatabase(const std::string& compileCommandsPath,
     return AppStatus::success();
 }
 
+// Reads the compiler's own frame sizes (-fstack-usage, -fcallgraph-info) so
+// --mode=abi reports real frames instead of estimating them from IR.
+static AppStatus loadFrameSizeTable(const std::vector<std::string>& inputFilenames,
+                                    AnalysisConfig& cfg)
+{
+    if (cfg.stackUsagePaths.empty() && !cfg.stackUsageFromCompdb)
+        return AppStatus::success();
+    if (cfg.mode != AnalysisMode::ABI)
+    {
+        coretrace::log(coretrace::Level::Warn,
+                       "--stack-usage/--stack-usage-from-compdb ignored: compiler frame sizes "
+                       "are only used with --mode=abi\n");
+        return AppStatus::success();
+    }
+    if (cfg.stackUsageFromCompdb && !cfg.compilationDatabase)
+    {
+        return AppStatus::failure("--stack-usage-from-compdb requires --compile-commands");
+    }
+
+    std::vector<std::string> files;
+    std::string error;
+    for (const std::string& path : cfg.stackUsagePaths)
+    {
+        if (!analysis::collectFrameSizeFiles(path, files, error))
+            return AppStatus::failure(error);
+    }
+    if (cfg.stackUsageFromCompdb)
+    {
+        for (const std::string& input : inputFilenames)
+        {
+            // A suffix match would read another TU's .su file.
+            const analysis::CompileCommand* command =
+                cfg.compilationDatabase->findExactCommandForFile(input);
+            if (!command)
+                continue;
+            std::vector<std::string> found = analysis::frameSizeFilesForCommand(*command, input);
+            files.insert(files.end(), found.begin(), found.end());
+        }
+    }
+
+    auto table = std::make_shared<analysis::FrameSizeTable>();
+    for (const std::string& file : files)
+    {
+        if (!table->addFile(file, error))
+            return AppStatus::failure(error);
+    }
+
+    coretrace::log(coretrace::Level::Info, "Loaded {} compiler frame size(s) from {} file(s)\n",
+                   table->entryCount(), table->fileCount());
+    if (table->fileCount() == 0)
+    {
+        coretrace::log(coretrace::Level::Warn,
+                       "No .su/.ci files found; frame sizes fall back to the IR estimate\n");
+    }
+    cfg.frameSizeTable = std::move(table);
+    return AppStatus::success();
+}
+
 static bool discoverInputsFromCompilationDatabase(std::vector<std::string>& inputFilenames,
                                                   const AnalysisConfig& cfg, bool includeCompdbDeps)
 {
@@ -832,6 +983,59 @@ static void excludeInputFiles(std::vector<std::string>& inputFilenames, const An
     inputFilenames.swap(filteredInputs);
 }
 
+static void dedupeInputsByCompilationDatabase(std::vector<std::string>& inputFilenames,
+                                              const AnalysisConfig& cfg)
+{
+    if (!cfg.compilationDatabase)
+        return;
+
+    const analysis::CompilationDatabaseStats& stats = cfg.compilationDatabase->stats();
+    coretrace::log(coretrace::Level::Info,
+                   "compdb dedupe: {} entry/entries collapsed into {} source file(s) "
+                   "({} source(s) with divergent analysis-relevant flags)\n",
+                   stats.entryCount, stats.entryCount - stats.collapsedEntryCount,
+                   stats.divergentSources.size());
+    for (const std::string& source : stats.divergentSources)
+    {
+        coretrace::log(coretrace::Level::Info,
+                       "compdb dedupe: {} has entries with different defines/includes/std/target; "
+                       "analyzing the most complete command only\n",
+                       source);
+    }
+
+    // Different spellings of one source (relative, symlinked) resolve to the same command and
+    // would otherwise be compiled and reported once per spelling. Only exact canonical matches
+    // count: a suffix match may belong to a different file that merely shares its tail, so
+    // such inputs are told apart by their normalized absolute path. The first spelling in
+    // input order is kept and the remaining inputs stay in their original order.
+    std::vector<std::string> uniqueInputs;
+    uniqueInputs.reserve(inputFilenames.size());
+    std::unordered_set<const analysis::CompileCommand*> seenCommands;
+    std::unordered_set<std::string> seenPaths;
+    std::size_t droppedCount = 0;
+    for (auto& file : inputFilenames)
+    {
+        const analysis::CompileCommand* command =
+            cfg.compilationDatabase->findExactCommandForFile(file);
+        const bool inserted = command ? seenCommands.insert(command).second
+                                      : seenPaths.insert(normalizePath(file)).second;
+        if (!inserted)
+        {
+            ++droppedCount;
+            continue;
+        }
+        uniqueInputs.push_back(std::move(file));
+    }
+    if (droppedCount > 0)
+    {
+        coretrace::log(coretrace::Level::Info,
+                       "compdb dedupe: skipped {} input file(s) resolving to an already "
+                       "selected source\n",
+                       droppedCount);
+    }
+    inputFilenames.swap(uniqueInputs);
+}
+
 static AppStatus configureDumpIRPath(const std::vector<std::string>& inputFilenames,
                                      AnalysisConfig& cfg)
 {
@@ -869,7 +1073,9 @@ static AppStatus configureDumpIRPath(const std::vector<std::string>& inputFilena
 static void printInterprocStatus(const AnalysisConfig& cfg, std::size_t inputCount,
                                  bool needsCrossTUResourceSummaries,
                                  bool needsCrossTUUninitializedSummaries,
-                                 bool needsCrossTUGlobalReadBeforeWriteSummaries)
+                                 bool needsCrossTUGlobalReadBeforeWriteSummaries,
+                                 bool needsCrossTUStackEscapeSummaries,
+                                 bool needsCrossTUStackSummaries)
 {
     if (!cfg.resourceModelPath.empty())
     {
@@ -909,6 +1115,20 @@ static void printInterprocStatus(const AnalysisConfig& cfg, std::size_t inputCou
                            inputCount);
         }
 
+        if (needsCrossTUStackEscapeSummaries)
+        {
+            coretrace::log(coretrace::Level::Info,
+                           "Stack pointer escape inter-procedural analysis: enabled (cross-TU "
+                           "summaries across {} files, jobs: {})\n",
+                           inputCount, resolveConfiguredJobs(cfg));
+        }
+        else if (!cfg.escapeCrossTU)
+        {
+            coretrace::log(coretrace::Level::Warn,
+                           "Stack pointer escape inter-procedural analysis: disabled by "
+                           "--no-escape-cross-tu (local TU only)\n");
+        }
+
         if (needsCrossTUUninitializedSummaries)
         {
             coretrace::log(
@@ -923,6 +1143,20 @@ static void printInterprocStatus(const AnalysisConfig& cfg, std::size_t inputCou
                            "Uninitialized inter-procedural analysis: disabled by "
                            "--no-uninitialized-cross-tu (local TU only)\n");
         }
+
+        if (needsCrossTUStackSummaries)
+        {
+            coretrace::log(coretrace::Level::Info,
+                           "Stack usage inter-procedural analysis: enabled (whole-program call "
+                           "graph across {} files)\n",
+                           inputCount);
+        }
+        else if (!cfg.stackCrossTU)
+        {
+            coretrace::log(coretrace::Level::Warn,
+                           "Stack usage inter-procedural analysis: disabled by "
+                           "--no-stack-cross-tu (local TU only)\n");
+        }
     }
 }
 
@@ -931,12 +1165,18 @@ static AppStatus analyzeWithSharedModuleLoading(const std::vector<std::string>&
                                                 bool needsCrossTUResourceSummaries,
                                                 bool needsCrossTUUninitializedSummaries,
                                                 bool needsCrossTUGlobalReadBeforeWriteSummaries,
+                                                bool needsCrossTUStackEscapeSummaries,
                                                 std::vector<AnalysisEntry>& results)
 {
     const analyzer::ScopedHotspot totalHotspot(cfg.timing, "app.shared_loading.total");
     std::vector<LoadedInputModule> loadedModules(inputFilenames.size());
     std::vector<std::string> loadErrors(inputFilenames.size());
     std::vector<char> loadSucceeded(inputFilenames.size(), 0);
+    SharedModulePrepPlan prepPlan;
+    prepPlan.resource = needsCrossTUResourceSummaries;
+    prepPlan.uninitialized = needsCrossTUUninitializedSummaries;
+    prepPlan.globalRead = needsCrossTUGlobalReadBeforeWriteSummaries;
+    prepPlan.stackEscape = needsCrossTUStackEscapeSummaries;
     auto loadSingleModule = [&](std::size_t index)
     {
         const analyzer::ScopedHotspot moduleLoadHotspot(cfg.timing,
@@ -962,8 +1202,10 @@ static AppStatus analyzeWithSharedModuleLoading(const std::vector<std::string>&
             loadErrors[index] = std::move(err);
             return;
         }
+        std::unique_ptr<SharedModulePrep> prep = prepareSharedModule(*load.module, cfg, prepPlan);
         loadedModules[index] = {inputFilename, std::move(moduleContext), std::move(load.module),
-                                std::move(load.frontendDiagnostics)};
+                                std::move(load.frontendDiagnostics), std::move(prep),
+                                std::make_unique<std::mutex>()};
         loadSucceeded[index] = 1;
     };
 
@@ -999,27 +1241,94 @@ static AppStatus analyzeWithSharedModuleLoading(const std::vector<std::string>&
     }
     loadedModules.swap(orderedLoadedModules);
 
+    // The four summary kinds do not read each other's index, so their builders
+    // run as concurrent tasks sharing the job budget; the per-module IR lock
+    // keeps each LLVMContext single-threaded. Analysis waits for all of them:
+    // every index is merged across modules and only final after its whole
+    // levelled build, and analyzeModule looks callees up in the full index.
+    std::vector<std::function<void(unsigned)>> summaryTasks;
+    std::shared_ptr<const analysis::ResourceLifetimeModuleStates> resourceStates;
+    std::shared_ptr<analysis::ResourceSummaryIndex> resourceIndex;
+    std::shared_ptr<analysis::UninitializedSummaryIndex> uninitializedIndex;
+    std::shared_ptr<analysis::GlobalReadBeforeWriteSummaryIndex> globalReadIndex;
+    std::shared_ptr<analysis::StackEscapeSummaryIndex> stackEscapeIndex;
     if (needsCrossTUResourceSummaries)
     {
-        const analyzer::ScopedHotspot hotspot(cfg.timing, "app.shared_loading.cross_tu_resource");
-        cfg.resourceSummaryIndex = buildCrossTUSummaryIndex(loadedModules, cfg);
+        summaryTasks.push_back(
+            [&](unsigned jobs)
+            {
+                const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                                      "app.shared_loading.cross_tu_resource");
+                resourceIndex = buildCrossTUSummaryIndex(loadedModules, cfg, jobs, resourceStates);
+            });
     }
     if (needsCrossTUUninitializedSummaries)
     {
-        const analyzer::ScopedHotspot hotspot(cfg.timing,
-                                              "app.shared_loading.cross_tu_uninitialized");
-        cfg.uninitializedSummaryIndex = buildCrossTUUninitializedSummaryIndex(loadedModules, cfg);
+        summaryTasks.push_back(
+            [&](unsigned jobs)
+            {
+                const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                                      "app.shared_loading.cross_tu_uninitialized");
+                uninitializedIndex =
+                    buildCrossTUUninitializedSummaryIndex(loadedModules, cfg, jobs);
+            });
     }
     if (needsCrossTUGlobalReadBeforeWriteSummaries)
     {
-        const analyzer::ScopedHotspot hotspot(cfg.timing,
-                                              "app.shared_loading.cross_tu_global_read");
-        cfg.globalReadBeforeWriteSummaryIndex =
-            buildCrossTUGlobalReadBeforeWriteSummaryIndex(loadedModules, cfg);
+        summaryTasks.push_back(
+            [&](unsigned jobs)
+            {
+                const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                                      "app.shared_loading.cross_tu_global_read");
+                globalReadIndex =
+                    buildCrossTUGlobalReadBeforeWriteSummaryIndex(loadedModules, cfg, jobs);
+            });
+    }
+    if (needsCrossTUStackEscapeSummaries)
+    {
+        summaryTasks.push_back(
+            [&](unsigned jobs)
+            {
+                const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                                      "app.shared_loading.cross_tu_stack_escape");
+                stackEscapeIndex = buildCrossTUStackEscapeSummaryIndex(loadedModules, cfg, jobs);
+            });
+    }
+    const unsigned jobsPerSummaryTask =
+        summaryTasks.empty()
+            ? loadJobs
+            : std::max(1u, loadJobs / static_cast<unsigned>(summaryTasks.size()));
+    runParallelWork(summaryTasks.size(), loadJobs,
+                    [&](std::size_t task) { summaryTasks[task](jobsPerSummaryTask); });
+    if (needsCrossTUResourceSummaries)
+    {
+        cfg.resourceSummaryIndex = std::move(resourceIndex);
+        cfg.resourceLifetimeStates = std::move(resourceStates);
     }
+    if (needsCrossTUUninitializedSummaries)
+        cfg.uninitializedSummaryIndex = std::move(uninitializedIndex);
+    if (needsCrossTUGlobalReadBeforeWriteSummaries)
+        cfg.globalReadBeforeWriteSummaryIndex = std::move(globalReadIndex);
+    if (needsCrossTUStackEscapeSummaries)
+        cfg.stackEscapeSummaryIndex = std::move(stackEscapeIndex);
 
+    // Summary preps are only read by the builders above; release them before
+    // the analysis phase so peak memory matches the unpipelined schedule.
     for (auto& loaded : loadedModules)
+        loaded.prep.reset();
+
+    struct SharedAnalysisSlot
+    {
+        std::unique_ptr<AnalysisResult> result;
+        std::string noFunctionMsg;
+    };
+
+    // Every summary index is final at this point and read-only, and each module
+    // owns its LLVMContext, so modules are analyzed independently.
+    std::vector<SharedAnalysisSlot> slots(loadedModules.size());
+    auto analyzeSingleModule = [&](std::size_t index)
     {
+        LoadedInputModule& loaded = loadedModules[index];
         AnalysisResult result;
         {
             const analyzer::ScopedHotspot hotspot(cfg.timing, "app.shared_loading.analyze_module");
@@ -1031,10 +1340,28 @@ static AppStatus analyzeWithSharedModuleLoading(const std::vector<std::string>&
                                       loaded.frontendDiagnostics.end());
         }
         stampResultFilePaths(result, loaded.filename);
-        const std::string emptyMsg = noFunctionMessage(result, loaded.filename, hasFilter);
-        if (!emptyMsg.empty())
-            logText(coretrace::Level::Info, emptyMsg);
-        results.emplace_back(loaded.filename, std::move(result));
+        slots[index].noFunctionMsg = noFunctionMessage(result, loaded.filename, hasFilter);
+        slots[index].result = std::make_unique<AnalysisResult>(std::move(result));
+    };
+
+    if (loadJobs <= 1 || loadedModules.size() <= 1)
+    {
+        for (std::size_t index = 0; index < loadedModules.size(); ++index)
+            analyzeSingleModule(index);
+    }
+    else
+    {
+        runParallelWork(loadedModules.size(), loadJobs,
+                        [&](std::size_t index) { analyzeSingleModule(index); });
+    }
+    // The reusable resource states are keyed by modules that die with this scope.
+    cfg.resourceLifetimeStates.reset();
+
+    for (std::size_t index = 0; index < loadedModules.size(); ++index)
+    {
+        if (!slots[index].noFunctionMsg.empty())
+            logText(coretrace::Level::Info, slots[index].noFunctionMsg);
+        results.emplace_back(loadedModules[index].filename, std::move(*slots[index].result));
     }
     return AppStatus::success();
 }
@@ -1466,38 +1793,133 @@ static std::string computeFunctionFilterSignature(const AnalysisConfig& cfg)
     return md5Hex(oss.str());
 }
 
-static std::string
-encodeSummaryEffectKey(const ctrace::stack::analysis::ResourceSummaryEffect& effect)
+struct SummaryFingerprint
 {
-    std::ostringstream oss;
-    oss << static_cast<int>(effect.action) << "|" << effect.argIndex << "|" << effect.offset << "|"
-        << (effect.viaPointerSlot ? 1 : 0) << "|" << effect.resourceKind;
-    return oss.str();
-}
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    bool operator==(const SummaryFingerprint& other) const
+    {
+        return low == other.low && high == other.high;
+    }
+
+    // Lane-wise wrapping sums keep combination order-independent.
+    void add(const SummaryFingerprint& other)
+    {
+        low += other.low;
+        high += other.high;
+    }
+
+    void subtract(const SummaryFingerprint& other)
+    {
+        low -= other.low;
+        high -= other.high;
+    }
+
+    std::string toHex() const
+    {
+        std::ostringstream oss;
+        oss << std::hex << std::setfill('0') << std::setw(16) << high << std::setw(16) << low;
+        return oss.str();
+    }
+};
 
-static std::string hashSummaryIndex(const ctrace::stack::analysis::ResourceSummaryIndex& index)
+// Canonical little-endian encoding hashed into one SummaryFingerprint lane pair.
+class FingerprintEncoder
 {
-    std::map<std::string, std::vector<std::string>> canonical;
-    for (const auto& entry : index.functions)
+  public:
+    void word(std::uint64_t value)
     {
-        std::vector<std::string> keys;
-        keys.reserve(entry.second.effects.size());
-        for (const auto& effect : entry.second.effects)
-            keys.push_back(encodeSummaryEffectKey(effect));
-        std::sort(keys.begin(), keys.end());
-        canonical.emplace(entry.first, std::move(keys));
+        for (std::size_t i = 0; i < 8; ++i)
+            bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
     }
 
-    std::ostringstream oss;
-    for (const auto& entry : canonical)
+    void string(llvm::StringRef value)
     {
-        oss << entry.first << "\n";
-        for (const auto& effectKey : entry.second)
-            oss << "  " << effectKey << "\n";
+        word(value.size());
+        bytes.append(value.bytes_begin(), value.bytes_end());
     }
-    return md5Hex(oss.str());
+
+    SummaryFingerprint finalize() const
+    {
+        const llvm::XXH128_hash_t digest = llvm::xxh3_128bits(bytes);
+        return {digest.low64, digest.high64};
+    }
+
+  private:
+    llvm::SmallVector<std::uint8_t, 64> bytes;
+};
+
+static SummaryFingerprint
+fingerprintSummaryEffect(const ctrace::stack::analysis::ResourceSummaryEffect& effect)
+{
+    FingerprintEncoder encoder;
+    encoder.word(static_cast<std::uint64_t>(effect.action));
+    encoder.word(effect.argIndex);
+    encoder.word(effect.offset);
+    encoder.word(effect.viaPointerSlot ? 1 : 0);
+    encoder.string(effect.resourceKind);
+    return encoder.finalize();
 }
 
+// Order-independent fingerprint of the global resource summary index. Each
+// function contributes XXH3-128(name, sum of its effect fingerprints) and the
+// index fingerprint is the sum of the contributions. Merges only append
+// effects, so a refresh hashes just the effects added since the previous
+// one and convergence checks cost O(touched functions).
+class ResourceIndexFingerprint
+{
+  public:
+    void refresh(const ctrace::stack::analysis::ResourceSummaryIndex& index,
+                 const std::string& name)
+    {
+        const auto fnIt = index.functions.find(name);
+        if (fnIt == index.functions.end())
+            return;
+        const auto& effects = fnIt->second.effects;
+        auto [it, inserted] = byFunction.try_emplace(name);
+        FunctionState& state = it->second;
+        if (!inserted && effects.size() == state.effectCount)
+            return;
+
+        for (std::size_t i = state.effectCount; i < effects.size(); ++i)
+            state.effects.add(fingerprintSummaryEffect(effects[i]));
+        state.effectCount = effects.size();
+
+        FingerprintEncoder encoder;
+        encoder.string(name);
+        encoder.word(state.effects.low);
+        encoder.word(state.effects.high);
+        combined.subtract(state.contribution);
+        state.contribution = encoder.finalize();
+        combined.add(state.contribution);
+    }
+
+    // Refreshes every function that a merge of `merged` may have touched.
+    void refreshFrom(const ctrace::stack::analysis::ResourceSummaryIndex& index,
+                     const ctrace::stack::analysis::ResourceSummaryIndex& merged)
+    {
+        for (const auto& entry : merged.functions)
+            refresh(index, entry.first);
+    }
+
+    const SummaryFingerprint& value() const
+    {
+        return combined;
+    }
+
+  private:
+    struct FunctionState
+    {
+        std::size_t effectCount = 0;
+        SummaryFingerprint effects;
+        SummaryFingerprint contribution;
+    };
+
+    std::unordered_map<std::string, FunctionState> byFunction;
+    SummaryFingerprint combined;
+};
+
 static std::string encodeSummaryActionName(ctrace::stack::analysis::ResourceSummaryAction action)
 {
     using Action = ctrace::stack::analysis::ResourceSummaryAction;
@@ -1526,14 +1948,61 @@ decodeSummaryActionName(llvm::StringRef value)
     return std::nullopt;
 }
 
-static bool writeSummaryCacheFile(const std::filesystem::path& cacheFile,
-                                  const ctrace::stack::analysis::ResourceSummaryIndex& index)
+// One schema tag per summary cache. It seeds the cache keys and tags the files,
+// so bump it when summary semantics or the file layout evolve; entries from
+// older analyzer builds are then neither looked up nor read back.
+constexpr llvm::StringLiteral kResourceCacheSchema = "cross-tu-resource-summary-v2";
+constexpr llvm::StringLiteral kUninitializedCacheSchema = "cross-tu-uninitialized-summary-v1";
+constexpr llvm::StringLiteral kGlobalReadCacheSchema = "cross-tu-global-read-summary-v1";
+constexpr llvm::StringLiteral kStackEscapeCacheSchema = "cross-tu-stack-escape-summary-v1";
+
+// Writes `root` tagged with `schema`, for readJsonCacheFile.
+static bool writeJsonCacheFile(const std::filesystem::path& cacheFile, llvm::StringRef schema,
+                               llvm::json::Object root)
 {
+    root["schema"] = schema;
     std::error_code ec;
     std::filesystem::create_directories(cacheFile.parent_path(), ec);
     if (ec)
         return false;
 
+    std::ofstream out(cacheFile, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out)
+        return false;
+    std::string payload;
+    llvm::raw_string_ostream os(payload);
+    os << llvm::formatv("{0:2}", llvm::json::Value(std::move(root)));
+    os.flush();
+    out << payload;
+    return out.good();
+}
+
+// Returns the parsed cache file when it is a JSON object tagged with `schema`.
+static std::optional<llvm::json::Value> readJsonCacheFile(const std::filesystem::path& cacheFile,
+                                                          llvm::StringRef schema)
+{
+    std::ifstream in(cacheFile, std::ios::in | std::ios::binary);
+    if (!in)
+        return std::nullopt;
+
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    auto parsed = llvm::json::parse(ss.str());
+    if (!parsed)
+        return std::nullopt;
+
+    const auto* obj = parsed->getAsObject();
+    if (!obj)
+        return std::nullopt;
+    auto fileSchema = obj->getString("schema");
+    if (!fileSchema || *fileSchema != schema)
+        return std::nullopt;
+    return std::move(*parsed);
+}
+
+static bool writeSummaryCacheFile(const std::filesystem::path& cacheFile,
+                                  const ctrace::stack::analysis::ResourceSummaryIndex& index)
+{
     llvm::json::Array functionArray;
     for (const auto& entry : index.functions)
     {
@@ -1556,41 +2025,18 @@ static bool writeSummaryCacheFile(const std::filesystem::path& cacheFile,
     }
 
     llvm::json::Object root;
-    root["schema"] = "resource-summary-cache-v2";
     root["functions"] = std::move(functionArray);
-
-    std::ofstream out(cacheFile, std::ios::out | std::ios::trunc | std::ios::binary);
-    if (!out)
-        return false;
-    std::string payload;
-    llvm::raw_string_ostream os(payload);
-    os << llvm::formatv("{0:2}", llvm::json::Value(std::move(root)));
-    os.flush();
-    out << payload;
-    return out.good();
+    return writeJsonCacheFile(cacheFile, kResourceCacheSchema, std::move(root));
 }
 
 static std::optional<ctrace::stack::analysis::ResourceSummaryIndex>
 readSummaryCacheFile(const std::filesystem::path& cacheFile)
 {
-    std::ifstream in(cacheFile, std::ios::in | std::ios::binary);
-    if (!in)
-        return std::nullopt;
-
-    std::ostringstream ss;
-    ss << in.rdbuf();
-    auto parsed = llvm::json::parse(ss.str());
+    const auto parsed = readJsonCacheFile(cacheFile, kResourceCacheSchema);
     if (!parsed)
         return std::nullopt;
 
-    const auto* obj = parsed->getAsObject();
-    if (!obj)
-        return std::nullopt;
-    auto schema = obj->getString("schema");
-    if (!schema || *schema != "resource-summary-cache-v2")
-        return std::nullopt;
-
-    const auto* functions = obj->getArray("functions");
+    const auto* functions = parsed->getAsObject()->getArray("functions");
     if (!functions)
         return std::nullopt;
 
@@ -1638,12 +2084,703 @@ readSummaryCacheFile(const std::filesystem::path& cacheFile)
     return index;
 }
 
-static std::shared_ptr<ctrace::stack::analysis::ResourceSummaryIndex>
-buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                         const AnalysisConfig& cfg)
+static bool crossTUSummaryDiskCacheEnabled(const AnalysisConfig& cfg)
 {
-    const analyzer::ScopedHotspot totalHotspot(cfg.timing, "app.cross_tu.resource_summary.total");
-    if (!cfg.resourceCrossTU || cfg.resourceModelPath.empty() || loadedModules.size() < 2)
+    return !cfg.resourceSummaryMemoryOnly && !cfg.resourceSummaryCacheDir.empty();
+}
+
+// Uninitialized and global read-before-write summaries share the resource
+// cache root, one subdirectory per phase.
+static std::filesystem::path crossTUSummaryCacheFile(const AnalysisConfig& cfg,
+                                                     llvm::StringRef phase,
+                                                     const std::string& cacheKey)
+{
+    return std::filesystem::path(cfg.resourceSummaryCacheDir) / phase.str() / (cacheKey + ".json");
+}
+
+static llvm::json::Array encodeUninitializedRanges(
+    const std::vector<ctrace::stack::analysis::UninitializedSummaryRange>& ranges)
+{
+    llvm::json::Array out;
+    for (const auto& range : ranges)
+        out.push_back(llvm::json::Array{static_cast<int64_t>(range.begin),
+                                        static_cast<int64_t>(range.end)});
+    return out;
+}
+
+static bool
+decodeUninitializedRanges(const llvm::json::Array* values,
+                          std::vector<ctrace::stack::analysis::UninitializedSummaryRange>& out)
+{
+    if (!values)
+        return false;
+    for (const auto& value : *values)
+    {
+        const auto* pair = value.getAsArray();
+        if (!pair || pair->size() != 2)
+            return false;
+        auto begin = (*pair)[0].getAsInteger();
+        auto end = (*pair)[1].getAsInteger();
+        if (!begin || !end)
+            return false;
+        out.push_back({static_cast<std::uint64_t>(*begin), static_cast<std::uint64_t>(*end)});
+    }
+    return true;
+}
+
+static bool
+writeUninitializedSummaryCacheFile(const std::filesystem::path& cacheFile,
+                                   const ctrace::stack::analysis::UninitializedSummaryIndex& index)
+{
+    llvm::json::Array functionArray;
+    for (const auto& entry : index.functions)
+    {
+        llvm::json::Array paramArray;
+        for (const auto& effect : entry.second.paramEffects)
+        {
+            llvm::json::Array slotWrites;
+            for (const auto& slotWrite : effect.pointerSlotWrites)
+            {
+                slotWrites.push_back(llvm::json::Array{
+                    static_cast<int64_t>(slotWrite.slotOffset),
+                    static_cast<int64_t>(slotWrite.writeSizeBytes)});
+            }
+
+            llvm::json::Object paramObj;
+            paramObj["readBeforeWrite"] = encodeUninitializedRanges(effect.readBeforeWriteRanges);
+            paramObj["writes"] = encodeUninitializedRanges(effect.writeRanges);
+            paramObj["pointerSlotWrites"] = std::move(slotWrites);
+            paramObj["unknownReadBeforeWrite"] =
+                static_cast<bool>(effect.hasUnknownReadBeforeWrite);
+            paramObj["unknownWrite"] = static_cast<bool>(effect.hasUnknownWrite);
+            paramArray.push_back(std::move(paramObj));
+        }
+
+        llvm::json::Object fnObj;
+        fnObj["name"] = entry.first;
+        fnObj["params"] = std::move(paramArray);
+        functionArray.push_back(std::move(fnObj));
+    }
+
+    llvm::json::Object root;
+    root["functions"] = std::move(functionArray);
+    return writeJsonCacheFile(cacheFile, kUninitializedCacheSchema, std::move(root));
+}
+
+static std::optional<ctrace::stack::analysis::UninitializedSummaryIndex>
+readUninitializedSummaryCacheFile(const std::filesystem::path& cacheFile)
+{
+    const auto parsed = readJsonCacheFile(cacheFile, kUninitializedCacheSchema);
+    if (!parsed)
+        return std::nullopt;
+
+    const auto* functions = parsed->getAsObject()->getArray("functions");
+    if (!functions)
+        return std::nullopt;
+
+    // Summaries are all-or-nothing: a partially decoded function would be
+    // indistinguishable from a genuinely weaker summary.
+    ctrace::stack::analysis::UninitializedSummaryIndex index;
+    for (const auto& fnValue : *functions)
+    {
+        const auto* fnObj = fnValue.getAsObject();
+        if (!fnObj)
+            return std::nullopt;
+        auto name = fnObj->getString("name");
+        const auto* params = fnObj->getArray("params");
+        if (!name || !params)
+            return std::nullopt;
+
+        ctrace::stack::analysis::UninitializedSummaryFunction fnSummary;
+        for (const auto& paramValue : *params)
+        {
+            const auto* paramObj = paramValue.getAsObject();
+            if (!paramObj)
+                return std::nullopt;
+            ctrace::stack::analysis::UninitializedSummaryParamEffect effect;
+            if (!decodeUninitializedRanges(paramObj->getArray("readBeforeWrite"),
+                                           effect.readBeforeWriteRanges) ||
+                !decodeUninitializedRanges(paramObj->getArray("writes"), effect.writeRanges))
+            {
+                return std::nullopt;
+            }
+            const auto* slotWrites = paramObj->getArray("pointerSlotWrites");
+            auto unknownRead = paramObj->getBoolean("unknownReadBeforeWrite");
+            auto unknownWrite = paramObj->getBoolean("unknownWrite");
+            if (!slotWrites || !unknownRead || !unknownWrite)
+                return std::nullopt;
+            for (const auto& slotValue : *slotWrites)
+            {
+                const auto* pair = slotValue.getAsArray();
+                if (!pair || pair->size() != 2)
+                    return std::nullopt;
+                auto slotOffset = (*pair)[0].getAsInteger();
+                auto writeSize = (*pair)[1].getAsInteger();
+                if (!slotOffset || !writeSize)
+                    return std::nullopt;
+                effect.pointerSlotWrites.push_back({static_cast<std::uint64_t>(*slotOffset),
+                                                    static_cast<std::uint64_t>(*writeSize)});
+            }
+            effect.hasUnknownReadBeforeWrite = *unknownRead;
+            effect.hasUnknownWrite = *unknownWrite;
+            fnSummary.paramEffects.push_back(std::move(effect));
+        }
+        index.functions[name->str()] = std::move(fnSummary);
+    }
+
+    return index;
+}
+
+// Hashes the external summaries a module can observe: only entries for its
+// own (sorted) callee names, so unrelated cross-TU changes keep its key.
+static std::string hashReferencedUninitializedSummaries(
+    const std::vector<std::string>& sortedCalleeNames,
+    const ctrace::stack::analysis::UninitializedSummaryIndex& index)
+{
+    std::ostringstream oss;
+    for (const std::string& callee : sortedCalleeNames)
+    {
+        const auto it = index.functions.find(callee);
+        if (it == index.functions.end())
+            continue;
+        oss << callee.size() << ":" << callee << "\n";
+        for (const auto& effect : it->second.paramEffects)
+        {
+            oss << "  p" << (effect.hasUnknownReadBeforeWrite ? 1 : 0)
+                << (effect.hasUnknownWrite ? 1 : 0) << " r";
+            for (const auto& range : effect.readBeforeWriteRanges)
+                oss << " " << range.begin << "-" << range.end;
+            oss << " w";
+            for (const auto& range : effect.writeRanges)
+                oss << " " << range.begin << "-" << range.end;
+            oss << " s";
+            for (const auto& slotWrite : effect.pointerSlotWrites)
+                oss << " " << slotWrite.slotOffset << "/" << slotWrite.writeSizeBytes;
+            oss << "\n";
+        }
+    }
+    return md5Hex(oss.str());
+}
+
+static bool writeGlobalReadSummaryCacheFile(
+    const std::filesystem::path& cacheFile,
+    const ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex& index)
+{
+    llvm::json::Array globalArray;
+    for (const auto& entry : index.globals)
+    {
+        llvm::json::Object globalObj;
+        globalObj["name"] = entry.first;
+        globalObj["zeroInitializedArray"] = entry.second.zeroInitializedArray;
+        globalObj["hasAnyWrite"] = entry.second.hasAnyWrite;
+        globalArray.push_back(std::move(globalObj));
+    }
+
+    llvm::json::Object root;
+    root["globals"] = std::move(globalArray);
+    return writeJsonCacheFile(cacheFile, kGlobalReadCacheSchema, std::move(root));
+}
+
+static std::optional<ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex>
+readGlobalReadSummaryCacheFile(const std::filesystem::path& cacheFile)
+{
+    const auto parsed = readJsonCacheFile(cacheFile, kGlobalReadCacheSchema);
+    if (!parsed)
+        return std::nullopt;
+
+    const auto* globals = parsed->getAsObject()->getArray("globals");
+    if (!globals)
+        return std::nullopt;
+
+    ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex index;
+    for (const auto& globalValue : *globals)
+    {
+        const auto* globalObj = globalValue.getAsObject();
+        if (!globalObj)
+            return std::nullopt;
+        auto name = globalObj->getString("name");
+        auto zeroInitializedArray = globalObj->getBoolean("zeroInitializedArray");
+        auto hasAnyWrite = globalObj->getBoolean("hasAnyWrite");
+        if (!name || !zeroInitializedArray || !hasAnyWrite)
+            return std::nullopt;
+        index.globals[name->str()] = {*zeroInitializedArray, *hasAnyWrite};
+    }
+
+    return index;
+}
+
+static bool
+writeStackEscapeSummaryCacheFile(const std::filesystem::path& cacheFile,
+                                 const ctrace::stack::analysis::StackEscapeSummaryIndex& index)
+{
+    llvm::json::Array functionArray;
+    for (const auto& entry : index.functions)
+    {
+        llvm::json::Array argArray;
+        for (const auto state : entry.second.args)
+            argArray.push_back(static_cast<int64_t>(state));
+
+        llvm::json::Object fnObj;
+        fnObj["name"] = entry.first;
+        fnObj["args"] = std::move(argArray);
+        functionArray.push_back(std::move(fnObj));
+    }
+
+    llvm::json::Object root;
+    root["functions"] = std::move(functionArray);
+    return writeJsonCacheFile(cacheFile, kStackEscapeCacheSchema, std::move(root));
+}
+
+static std::optional<ctrace::stack::analysis::StackEscapeSummaryIndex>
+readStackEscapeSummaryCacheFile(const std::filesystem::path& cacheFile)
+{
+    using ctrace::stack::analysis::StackEscapeArgState;
+
+    const auto parsed = readJsonCacheFile(cacheFile, kStackEscapeCacheSchema);
+    if (!parsed)
+        return std::nullopt;
+
+    const auto* functions = parsed->getAsObject()->getArray("functions");
+    if (!functions)
+        return std::nullopt;
+
+    ctrace::stack::analysis::StackEscapeSummaryIndex index;
+    for (const auto& fnValue : *functions)
+    {
+        const auto* fnObj = fnValue.getAsObject();
+        if (!fnObj)
+            return std::nullopt;
+        auto name = fnObj->getString("name");
+        const auto* args = fnObj->getArray("args");
+        if (!name || !args)
+            return std::nullopt;
+
+        ctrace::stack::analysis::StackEscapeSummaryFunction fnSummary;
+        for (const auto& argValue : *args)
+        {
+            auto state = argValue.getAsInteger();
+            if (!state || *state < static_cast<int64_t>(StackEscapeArgState::Unknown) ||
+                *state > static_cast<int64_t>(StackEscapeArgState::MayEscape))
+            {
+                return std::nullopt;
+            }
+            fnSummary.args.push_back(static_cast<StackEscapeArgState>(*state));
+        }
+        index.functions[name->str()] = std::move(fnSummary);
+    }
+
+    return index;
+}
+
+// Same role as hashReferencedUninitializedSummaries for escape summaries.
+static std::string hashReferencedStackEscapeSummaries(
+    const std::vector<std::string>& sortedCalleeNames,
+    const ctrace::stack::analysis::StackEscapeSummaryIndex& index)
+{
+    std::ostringstream oss;
+    for (const std::string& callee : sortedCalleeNames)
+    {
+        const auto it = index.functions.find(callee);
+        if (it == index.functions.end())
+            continue;
+        oss << callee.size() << ":" << callee << " ";
+        for (const auto state : it->second.args)
+            oss << static_cast<unsigned>(state);
+        oss << "\n";
+    }
+    return md5Hex(oss.str());
+}
+
+static void collectDefinedCanonicalNames(const llvm::Module& mod, std::vector<std::string>& out)
+{
+    for (const llvm::Function& F : mod)
+    {
+        if (F.isDeclaration() || !F.hasName() || F.getName().empty())
+            continue;
+        out.push_back(ctrace_tools::canonicalizeMangledName(F.getName().str()));
+    }
+}
+
+static void collectDirectCalleeNames(const llvm::Module& mod, const AnalysisConfig& cfg,
+                                       std::unordered_set<std::string>& out)
+{
+    const analysis::FunctionFilter filter = analysis::buildFunctionFilter(mod, cfg);
+    for (const llvm::Function& F : mod)
+    {
+        if (F.isDeclaration() || !filter.shouldAnalyze(F))
+            continue;
+        for (const llvm::BasicBlock& BB : F)
+        {
+            for (const llvm::Instruction& I : BB)
+            {
+                const auto* CB = llvm::dyn_cast<llvm::CallBase>(&I);
+                if (!CB)
+                    continue;
+                const llvm::Function* callee = CB->getCalledFunction();
+                if (!callee || !callee->hasName() || callee->getName().empty())
+                    continue;
+                out.insert(ctrace_tools::canonicalizeMangledName(callee->getName().str()));
+            }
+        }
+    }
+}
+
+static std::unique_ptr<SharedModulePrep> prepareSharedModule(llvm::Module& mod,
+                                                             const AnalysisConfig& cfg,
+                                                             SharedModulePrepPlan plan)
+{
+    if (!plan.resource && !plan.uninitialized && !plan.globalRead && !plan.stackEscape)
+        return nullptr;
+
+    const analyzer::ScopedHotspot hotspot(cfg.timing, "app.shared_loading.prepare_module");
+    auto prep = std::make_unique<SharedModulePrep>();
+    if (plan.resource || plan.uninitialized || plan.stackEscape)
+        collectDefinedCanonicalNames(mod, prep->definedNames);
+    const bool diskCache = crossTUSummaryDiskCacheEnabled(cfg);
+    if (plan.resource ||
+        (diskCache && (plan.uninitialized || plan.globalRead || plan.stackEscape)))
+    {
+        prep->irHash = hashModuleIR(mod);
+    }
+    if (plan.resource || plan.stackEscape)
+        collectDirectCalleeNames(mod, cfg, prep->directCalleeNames);
+    if (!plan.uninitialized && !plan.globalRead)
+        return prep;
+
+    const analysis::FunctionFilter filter = analysis::buildFunctionFilter(mod, cfg);
+    auto shouldAnalyze = [&](const llvm::Function& F) -> bool { return filter.shouldAnalyze(F); };
+    if (plan.uninitialized)
+    {
+        prep->uninitializedContext = analysis::prepareUninitializedModuleContext(mod, shouldAnalyze);
+        prep->uninitializedCalleeNames =
+            analysis::getCanonicalCalleeNames(*prep->uninitializedContext);
+    }
+    if (plan.globalRead)
+    {
+        // Global read-before-write summaries have no cross-TU inputs, so the
+        // module content and the function filter fully determine them.
+        std::filesystem::path cacheFile;
+        if (diskCache)
+        {
+            cacheFile = crossTUSummaryCacheFile(
+                cfg, "global-read",
+                md5Hex(std::string(kGlobalReadCacheSchema) + "|" +
+                       computeFunctionFilterSignature(cfg) + "|" + prep->irHash));
+            prep->globalReadSummary = readGlobalReadSummaryCacheFile(cacheFile);
+        }
+        if (!prep->globalReadSummary)
+        {
+            prep->globalReadSummary =
+                analysis::buildGlobalReadBeforeWriteSummaryIndex(mod, shouldAnalyze);
+            if (diskCache)
+                (void)writeGlobalReadSummaryCacheFile(cacheFile, *prep->globalReadSummary);
+        }
+    }
+    return prep;
+}
+
+// ── Levelled cross-TU summary builds ──
+// Resource, uninitialized and stack escape summaries share one schedule:
+// modules are grouped into SCCs of the single-def inter-module call graph
+// and SCCs into topological levels. The trivial SCCs of a level only read
+// summaries of lower levels and are built in parallel; cyclic SCCs iterate
+// until their members settle.
+//
+// Indirect calls add no edges. Every analysis already treats unresolved
+// callees conservatively inside the module, and flagging the (nearly
+// universal) virtual or std::function calls as cyclic would serialize the
+// whole schedule.
+struct CrossTUSccSchedule
+{
+    std::vector<std::unordered_set<std::size_t>> edges;
+    std::vector<std::vector<std::size_t>> sccOrder;
+    std::vector<std::vector<std::size_t>> levelGroups;
+    // Callees of each module that have a single definition; a cyclic SCC
+    // member is rebuilt only when one of them changed.
+    std::vector<std::unordered_set<std::string>> dependencyCalleeNames;
+
+    bool isTrivial(std::size_t sccIdx) const
+    {
+        const auto& scc = sccOrder[sccIdx];
+        return scc.size() == 1 && !edges[scc[0]].count(scc[0]);
+    }
+};
+
+static CrossTUSccSchedule
+buildCrossTUSccSchedule(const std::vector<std::unordered_set<std::string>>& moduleCalleeNames,
+                        const std::unordered_map<std::string, std::vector<std::size_t>>& definedBy)
+{
+    const std::size_t N = moduleCalleeNames.size();
+    CrossTUSccSchedule schedule;
+    schedule.edges = buildSingleDefFilteredEdges(N, moduleCalleeNames, definedBy);
+    schedule.sccOrder = computeTopologicalSCCOrder(N, schedule.edges);
+    const std::vector<unsigned> sccLevels = computeSCCLevels(schedule.sccOrder, schedule.edges, N);
+
+    unsigned maxLevel = 0;
+    for (unsigned lvl : sccLevels)
+        maxLevel = std::max(maxLevel, lvl);
+    schedule.levelGroups.resize(maxLevel + 1);
+    for (std::size_t s = 0; s < schedule.sccOrder.size(); ++s)
+        schedule.levelGroups[sccLevels[s]].push_back(s);
+
+    schedule.dependencyCalleeNames.resize(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (const std::string& callee : moduleCalleeNames[i])
+        {
+            const auto it = definedBy.find(callee);
+            if (it != definedBy.end() && it->second.size() == 1)
+                schedule.dependencyCalleeNames[i].insert(callee);
+        }
+    }
+    return schedule;
+}
+
+// Index operations of one summary kind. A kind that joins cyclic SCCs
+// after they settle keeps an SCC out of the global index while it
+// iterates, so early conservative states cannot stick; its members see the
+// previous iteration through refreshExternal instead. The other kinds
+// publish every iteration and rebuild only members whose dependencies
+// changed.
+template <typename Index> struct CrossTUSummaryTraits;
+
+template <> struct CrossTUSummaryTraits<analysis::ResourceSummaryIndex>
+{
+    static constexpr auto entries = &analysis::ResourceSummaryIndex::functions;
+    static constexpr auto mergeEntry = &analysis::mergeResourceSummaryEntry;
+    static constexpr auto mergeIndex = &analysis::mergeResourceSummaryIndex;
+    static constexpr auto equals = &analysis::resourceSummaryIndexEquals;
+    static constexpr auto changedNames = &analysis::computeChangedResourceFunctionNames;
+    static constexpr bool kJoinCyclicAfterSettle = false;
+};
+
+template <> struct CrossTUSummaryTraits<analysis::UninitializedSummaryIndex>
+{
+    static constexpr auto entries = &analysis::UninitializedSummaryIndex::functions;
+    static constexpr auto mergeEntry = &analysis::mergeUninitializedSummaryEntry;
+    static constexpr auto mergeIndex = &analysis::mergeUninitializedSummaryIndex;
+    static constexpr auto equals = &analysis::uninitializedSummaryIndexEquals;
+    static constexpr auto changedNames = &analysis::computeChangedUninitializedFunctionNames;
+    static constexpr bool kJoinCyclicAfterSettle = false;
+};
+
+template <> struct CrossTUSummaryTraits<analysis::StackEscapeSummaryIndex>
+{
+    static constexpr auto entries = &analysis::StackEscapeSummaryIndex::functions;
+    static constexpr auto mergeEntry = &analysis::mergeStackEscapeSummaryEntry;
+    static constexpr auto mergeIndex = &analysis::mergeStackEscapeSummaryIndex;
+    static constexpr auto equals = &analysis::stackEscapeSummaryIndexEquals;
+    static constexpr bool kJoinCyclicAfterSettle = true;
+};
+
+// Callbacks of one levelled build. `build` reads the external view that
+// `refreshExternal` prepared last and runs concurrently for the trivial
+// SCCs of a level. The cache hooks are optional and only see trivial SCCs;
+// `onMerged` runs after each join into the global index.
+template <typename Index> struct CrossTUSummaryHooks
+{
+    std::string_view label;
+    std::function<Index(std::size_t moduleIndex)> build;
+    // `pendingScc` is the previous iteration of the cyclic SCC being solved
+    // by a join-after-settle kind, otherwise null.
+    std::function<void(const Index& global, const Index* pendingScc)> refreshExternal;
+    std::function<bool(std::size_t moduleIndex, Index& out)> readCache;
+    std::function<void(std::size_t moduleIndex, const Index& summary)> writeCache;
+    std::function<void(const Index& global, const Index& merged)> onMerged;
+};
+
+struct CrossTUBuildStats
+{
+    std::size_t moduleAnalyses = 0;
+    std::size_t cacheHits = 0;
+};
+
+// One pass over every level of `schedule`; each module's final summary is
+// joined into `globalIndex` in level order.
+template <typename Index>
+static void runLevelledCrossTUBuild(const CrossTUSccSchedule& schedule,
+                                    const CrossTUSummaryHooks<Index>& hooks,
+                                    const AnalysisConfig& cfg, unsigned maxJobs,
+                                    Index& globalIndex, std::vector<Index>& moduleSummaries,
+                                    CrossTUBuildStats& stats)
+{
+    using Traits = CrossTUSummaryTraits<Index>;
+    using Clock = std::chrono::steady_clock;
+    constexpr unsigned kCrossTUMaxIterations = 12;
+    const auto& sccOrder = schedule.sccOrder;
+
+    auto joinIntoGlobal = [&](const Index& summary)
+    {
+        (void)Traits::mergeIndex(globalIndex, summary);
+        if (hooks.onMerged)
+            hooks.onMerged(globalIndex, summary);
+    };
+    auto dependsOnChanged = [&](std::size_t moduleIndex,
+                                const std::unordered_set<std::string>& changedNames)
+    {
+        for (const std::string& callee : schedule.dependencyCalleeNames[moduleIndex])
+        {
+            if (changedNames.count(callee))
+                return true;
+        }
+        return false;
+    };
+
+    for (unsigned level = 0; level < schedule.levelGroups.size(); ++level)
+    {
+        const auto& group = schedule.levelGroups[level];
+        if (group.empty())
+            continue;
+
+        const auto levelStart = Clock::now();
+        std::vector<std::size_t> trivialModules;
+        std::vector<std::size_t> cyclicSCCIndices;
+        for (std::size_t sccIdx : group)
+        {
+            if (schedule.isTrivial(sccIdx))
+                trivialModules.push_back(sccOrder[sccIdx][0]);
+            else
+                cyclicSCCIndices.push_back(sccIdx);
+        }
+        // Cyclic SCCs of a level run in sequence and each sees the joins of
+        // the previous ones, so their order must not depend on Tarjan's walk
+        // over unordered sets. Members are sorted: [0] is the smallest index.
+        std::sort(cyclicSCCIndices.begin(), cyclicSCCIndices.end(),
+                  [&](std::size_t a, std::size_t b) { return sccOrder[a][0] < sccOrder[b][0]; });
+
+        // Trivial SCCs of one level are independent and share one view.
+        hooks.refreshExternal(globalIndex, nullptr);
+        std::vector<std::size_t> missingTrivial;
+        for (std::size_t moduleIndex : trivialModules)
+        {
+            if (hooks.readCache && hooks.readCache(moduleIndex, moduleSummaries[moduleIndex]))
+                ++stats.cacheHits;
+            else
+                missingTrivial.push_back(moduleIndex);
+        }
+        runParallelWork(missingTrivial.size(), maxJobs,
+                        [&](std::size_t workIndex)
+                        {
+                            const std::size_t moduleIndex = missingTrivial[workIndex];
+                            moduleSummaries[moduleIndex] = hooks.build(moduleIndex);
+                        });
+        if (hooks.writeCache)
+        {
+            for (std::size_t moduleIndex : missingTrivial)
+                hooks.writeCache(moduleIndex, moduleSummaries[moduleIndex]);
+        }
+        stats.moduleAnalyses += missingTrivial.size();
+
+        std::vector<const Index*> trivialSummaries;
+        trivialSummaries.reserve(trivialModules.size());
+        for (std::size_t moduleIndex : trivialModules)
+            trivialSummaries.push_back(&moduleSummaries[moduleIndex]);
+        (void)mergeSummaryIndicesInOrder(globalIndex, Traits::entries, trivialSummaries, maxJobs,
+                                         Traits::mergeEntry);
+        if (hooks.onMerged)
+        {
+            for (const Index* summary : trivialSummaries)
+                hooks.onMerged(globalIndex, *summary);
+        }
+
+        std::size_t cyclicModuleCount = 0;
+        for (std::size_t sccIdx : cyclicSCCIndices)
+        {
+            const auto& scc = sccOrder[sccIdx];
+            cyclicModuleCount += scc.size();
+            Index prevSccMerged;
+            std::unordered_set<std::string> changedNames;
+            bool sccConverged = false;
+
+            for (unsigned sccIter = 0; sccIter < kCrossTUMaxIterations; ++sccIter)
+            {
+                hooks.refreshExternal(globalIndex,
+                                      Traits::kJoinCyclicAfterSettle ? &prevSccMerged : nullptr);
+                std::size_t rebuilt = 0;
+                for (std::size_t m : scc)
+                {
+                    if (!Traits::kJoinCyclicAfterSettle && sccIter > 0 &&
+                        !dependsOnChanged(m, changedNames))
+                    {
+                        continue;
+                    }
+                    moduleSummaries[m] = hooks.build(m);
+                    ++rebuilt;
+                }
+                stats.moduleAnalyses += rebuilt;
+
+                Index sccMerged;
+                for (std::size_t m : scc)
+                    (void)Traits::mergeIndex(sccMerged, moduleSummaries[m]);
+                const bool iterConverged = Traits::equals(sccMerged, prevSccMerged);
+                if constexpr (!Traits::kJoinCyclicAfterSettle)
+                    changedNames = Traits::changedNames(prevSccMerged, sccMerged);
+                prevSccMerged = std::move(sccMerged);
+
+                if (cfg.timing)
+                {
+                    coretrace::log(coretrace::Level::Info,
+                                   "  {} cyclic SCC (size={}) iteration {}{} (dirty={})\n",
+                                   hooks.label, scc.size(), sccIter + 1,
+                                   iterConverged ? " converged" : "", rebuilt);
+                }
+                if (iterConverged)
+                {
+                    sccConverged = true;
+                    break;
+                }
+                if constexpr (!Traits::kJoinCyclicAfterSettle)
+                {
+                    for (std::size_t m : scc)
+                        joinIntoGlobal(moduleSummaries[m]);
+                }
+            }
+
+            if (!sccConverged)
+            {
+                coretrace::log(coretrace::Level::Warn,
+                               "{} cross-TU: cyclic SCC (size={}) reached iteration cap ({})\n",
+                               hooks.label, scc.size(), kCrossTUMaxIterations);
+            }
+            for (std::size_t m : scc)
+                joinIntoGlobal(moduleSummaries[m]);
+        }
+
+        if (cfg.timing)
+        {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                                                  levelStart)
+                                .count();
+            coretrace::log(coretrace::Level::Info,
+                           "  {} level {}: {} trivial, {} cyclic ({} modules) in {} ms\n",
+                           hooks.label, level, trivialModules.size(), cyclicSCCIndices.size(),
+                           trivialModules.size() + cyclicModuleCount, ms);
+        }
+    }
+}
+
+static void logCrossTUSchedule(const CrossTUSccSchedule& schedule, std::string_view label)
+{
+    std::size_t trivialSCCCount = 0;
+    for (std::size_t s = 0; s < schedule.sccOrder.size(); ++s)
+    {
+        if (schedule.isTrivial(s))
+            ++trivialSCCCount;
+    }
+    coretrace::log(coretrace::Level::Info,
+                   "Cross-TU {} SCC worklist: {} SCCs ({} trivial, {} cyclic) in {} levels\n",
+                   label, schedule.sccOrder.size(), trivialSCCCount,
+                   schedule.sccOrder.size() - trivialSCCCount, schedule.levelGroups.size());
+}
+
+static std::shared_ptr<ctrace::stack::analysis::ResourceSummaryIndex>
+buildCrossTUSummaryIndex(
+    const std::vector<LoadedInputModule>& loadedModules, const AnalysisConfig& cfg,
+    unsigned maxJobs,
+    std::shared_ptr<const ctrace::stack::analysis::ResourceLifetimeModuleStates>& statesOut)
+{
+    const analyzer::ScopedHotspot totalHotspot(cfg.timing, "app.cross_tu.resource_summary.total");
+    if (!cfg.resourceCrossTU || cfg.resourceModelPath.empty() || loadedModules.size() < 2)
         return nullptr;
 
     using Clock = std::chrono::steady_clock;
@@ -1658,12 +2795,8 @@ buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
     const std::string modelContent = readFileAsString(cfg.resourceModelPath);
     const std::string modelHash =
         md5Hex(modelContent.empty() ? cfg.resourceModelPath : modelContent);
-    // Bump this when summary semantics evolve so on-disk cache entries from older
-    // analyzer builds are not reused with incompatible interpretation.
-    constexpr llvm::StringLiteral kCacheSchema = "cross-tu-resource-summary-v2";
     const bool allowDiskCache =
         !cfg.resourceSummaryMemoryOnly && !cfg.resourceSummaryCacheDir.empty();
-    const unsigned maxJobs = resolveConfiguredJobs(cfg);
     std::unordered_map<std::string, ctrace::stack::analysis::ResourceSummaryIndex> memoryCache;
     std::unordered_map<std::string, ctrace::stack::analysis::ResourceSummaryIndex> finalCacheWrites;
     std::vector<std::string> moduleIRHashes;
@@ -1673,7 +2806,15 @@ buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
     moduleCompileArgsHashes.reserve(loadedModules.size());
     for (const LoadedInputModule& loaded : loadedModules)
     {
-        moduleIRHashes.push_back(hashModuleIR(*loaded.module));
+        if (loaded.prep)
+        {
+            moduleIRHashes.push_back(loaded.prep->irHash);
+        }
+        else
+        {
+            const auto irLock = lockModuleIR(loaded);
+            moduleIRHashes.push_back(hashModuleIR(*loaded.module));
+        }
         moduleCompileArgsHashes.push_back(computeCompileArgsSignature(cfg, loaded.filename));
     }
 
@@ -1697,346 +2838,125 @@ buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
     std::unordered_map<std::string, std::vector<std::size_t>> definedBy;
     for (std::size_t i = 0; i < loadedModules.size(); ++i)
     {
-        for (const llvm::Function& F : *loadedModules[i].module)
+        std::vector<std::string> localNames;
+        const std::vector<std::string>* definedNames = &localNames;
+        if (loadedModules[i].prep)
         {
-            if (F.isDeclaration() || !F.hasName() || F.getName().empty())
-                continue;
-            const std::string canon = ctrace_tools::canonicalizeMangledName(F.getName().str());
-            definedBy[canon].push_back(i);
+            definedNames = &loadedModules[i].prep->definedNames;
         }
+        else
+        {
+            const auto irLock = lockModuleIR(loadedModules[i]);
+            collectDefinedCanonicalNames(*loadedModules[i].module, localNames);
+        }
+        for (const std::string& canon : *definedNames)
+            definedBy[canon].push_back(i);
     }
 
-    // Build single-def name set: functions defined in exactly one module.
-    // This is the same criterion used by buildSingleDefFilteredEdges for
-    // SCC edge construction.  Using it for dirty-marking ensures consistency:
-    // an SCC edge exists iff the corresponding callee can trigger dirty-marking.
-    std::unordered_set<std::string> singleDefNames;
-    for (const auto& [name, modules] : definedBy)
-    {
-        if (modules.size() == 1)
-            singleDefNames.insert(name);
-    }
-
-    // Pre-compute per-module callee name sets for delta-based convergence.
+    // Callees with a single definition are the SCC edges and the dirty-marking
+    // keys of buildCrossTUSccSchedule, so an edge exists iff its callee can
+    // mark the caller dirty.
     std::vector<std::unordered_set<std::string>> resourceModuleCalleeNames(loadedModules.size());
-    // Filtered version: only callees with single-def definitions.
-    // Consistent with SCC edge criterion (buildSingleDefFilteredEdges).
-    std::vector<std::unordered_set<std::string>> filteredResourceCalleeNames(loadedModules.size());
     for (std::size_t i = 0; i < loadedModules.size(); ++i)
     {
         const LoadedInputModule& loaded = loadedModules[i];
-        const analysis::FunctionFilter filter = analysis::buildFunctionFilter(*loaded.module, cfg);
-        for (const llvm::Function& F : *loaded.module)
+        if (loaded.prep)
         {
-            if (F.isDeclaration() || !filter.shouldAnalyze(F))
-                continue;
-            for (const llvm::BasicBlock& BB : F)
-            {
-                for (const llvm::Instruction& I : BB)
-                {
-                    const auto* CB = llvm::dyn_cast<llvm::CallBase>(&I);
-                    if (!CB)
-                        continue;
-                    const llvm::Function* callee = CB->getCalledFunction();
-                    if (!callee || !callee->hasName() || callee->getName().empty())
-                        continue;
-                    const std::string canon =
-                        ctrace_tools::canonicalizeMangledName(callee->getName().str());
-                    resourceModuleCalleeNames[i].insert(canon);
-                    if (singleDefNames.count(canon))
-                        filteredResourceCalleeNames[i].insert(canon);
-                }
-            }
+            resourceModuleCalleeNames[i] = loaded.prep->directCalleeNames;
         }
-    }
-
-    // ── SCC worklist for resource cross-TU convergence ──
-    constexpr unsigned kCrossTUMaxIterations = 12;
-    const std::size_t N = loadedModules.size();
-
-    const auto filteredEdges = buildSingleDefFilteredEdges(N, resourceModuleCalleeNames, definedBy);
-    const auto sccOrder = computeTopologicalSCCOrder(N, filteredEdges);
-    const auto sccLevels = computeSCCLevels(sccOrder, filteredEdges, N);
-
-    unsigned maxLevel = 0;
-    for (unsigned lvl : sccLevels)
-        maxLevel = std::max(maxLevel, lvl);
-
-    std::vector<std::vector<std::size_t>> levelGroups(maxLevel + 1);
-    for (std::size_t s = 0; s < sccOrder.size(); ++s)
-        levelGroups[sccLevels[s]].push_back(s);
-
-    // Classify SCCs for logging.
-    std::size_t trivialSCCCount = 0, cyclicSCCCount = 0;
-    for (std::size_t s = 0; s < sccOrder.size(); ++s)
-    {
-        const auto& scc = sccOrder[s];
-        if (scc.size() == 1 && !filteredEdges[scc[0]].count(scc[0]))
-            ++trivialSCCCount;
         else
-            ++cyclicSCCCount;
-    }
-
-    if (cfg.timing)
-    {
-        coretrace::log(coretrace::Level::Info,
-                       "Cross-TU resource SCC worklist: {} SCCs ({} trivial, {} cyclic) "
-                       "in {} levels\n",
-                       sccOrder.size(), trivialSCCCount, cyclicSCCCount, maxLevel + 1);
-    }
-
-    ctrace::stack::analysis::ResourceSummaryIndex globalIndex;
-    std::vector<ctrace::stack::analysis::ResourceSummaryIndex> moduleSummaries(N);
-    std::size_t totalModuleAnalyses = 0;
-
-    constexpr unsigned kCrossTUGlobalMaxIterations = 12;
-    bool globalConverged = false;
-    for (unsigned globalIter = 0; globalIter < kCrossTUGlobalMaxIterations; ++globalIter)
-    {
-        const std::string beforePassHash = hashSummaryIndex(globalIndex);
-        for (unsigned level = 0; level <= maxLevel; ++level)
         {
-            const auto& group = levelGroups[level];
-            if (group.empty())
-                continue;
-
-            const auto levelStart = Clock::now();
-            const std::string externalHash = hashSummaryIndex(globalIndex);
-
-            auto buildModuleSummary =
-                [&](std::size_t moduleIndex) -> ctrace::stack::analysis::ResourceSummaryIndex
-            {
-                const analyzer::ScopedHotspot hotspot(cfg.timing,
-                                                      "app.cross_tu.resource_summary.build_module");
-                const LoadedInputModule& loaded = loadedModules[moduleIndex];
-                analysis::FunctionFilter filter =
-                    analysis::buildFunctionFilter(*loaded.module, cfg);
-                auto shouldAnalyze = [&](const llvm::Function& F) -> bool
-                { return filter.shouldAnalyze(F); };
-                return analysis::buildResourceLifetimeSummaryIndex(
-                    *loaded.module, shouldAnalyze, cfg.resourceModelPath, &globalIndex);
-            };
-
-            // Try cache for each module at this level, collect modules that need building.
-            auto tryCacheForModule = [&](std::size_t moduleIndex) -> bool
-            {
-                const std::string cacheKeyPayload = std::string(kCacheSchema) + "|" + modelHash +
-                                                    "|" + externalHash + "|" + filterHash + "|" +
-                                                    moduleCompileArgsHashes[moduleIndex] + "|" +
-                                                    moduleIRHashes[moduleIndex];
-                const std::string cacheKey = md5Hex(cacheKeyPayload);
-
-                if (const auto memIt = memoryCache.find(cacheKey); memIt != memoryCache.end())
-                {
-                    moduleSummaries[moduleIndex] = memIt->second;
-                    return true;
-                }
-                if (allowDiskCache)
-                {
-                    const std::filesystem::path cacheFile =
-                        std::filesystem::path(cfg.resourceSummaryCacheDir) / (cacheKey + ".json");
-                    auto cached = readSummaryCacheFile(cacheFile);
-                    if (cached)
-                    {
-                        moduleSummaries[moduleIndex] = std::move(*cached);
-                        memoryCache.insert_or_assign(cacheKey, moduleSummaries[moduleIndex]);
-                        return true;
-                    }
-                }
-                return false;
-            };
-
-            auto cacheAndStoreModule = [&](std::size_t moduleIndex)
-            {
-                const std::string cacheKeyPayload = std::string(kCacheSchema) + "|" + modelHash +
-                                                    "|" + externalHash + "|" + filterHash + "|" +
-                                                    moduleCompileArgsHashes[moduleIndex] + "|" +
-                                                    moduleIRHashes[moduleIndex];
-                const std::string cacheKey = md5Hex(cacheKeyPayload);
-                memoryCache.insert_or_assign(cacheKey, moduleSummaries[moduleIndex]);
-                finalCacheWrites.insert_or_assign(cacheKey, moduleSummaries[moduleIndex]);
-            };
-
-            // Collect trivial and cyclic SCCs.
-            std::vector<std::size_t> trivialModules;
-            std::vector<std::size_t> cyclicSCCIndices;
-
-            for (std::size_t sccIdx : group)
-            {
-                const auto& scc = sccOrder[sccIdx];
-                const bool isTrivial = scc.size() == 1 && !filteredEdges[scc[0]].count(scc[0]);
-                if (isTrivial)
-                    trivialModules.push_back(scc[0]);
-                else
-                    cyclicSCCIndices.push_back(sccIdx);
-            }
-
-            // Sort cyclic SCCs by minimum module index for deterministic processing order.
-            // Cyclic SCCs at the same level are processed sequentially, and each SCC sees
-            // the globalIndex effects of previously processed SCCs. Non-deterministic ordering
-            // (from Tarjan DFS over unordered_set) causes different summaries between runs.
-            // SCC members are already sorted, so sccOrder[sccIdx][0] is the minimum index.
-            std::sort(cyclicSCCIndices.begin(), cyclicSCCIndices.end(),
-                      [&](std::size_t a, std::size_t b)
-                      { return sccOrder[a][0] < sccOrder[b][0]; });
-
-            // Process trivial SCCs: try cache, then build missing ones in parallel.
-            std::vector<std::size_t> missingTrivial;
-            for (std::size_t moduleIndex : trivialModules)
-            {
-                if (!tryCacheForModule(moduleIndex))
-                    missingTrivial.push_back(moduleIndex);
-            }
-
-            if (!missingTrivial.empty())
-            {
-                if (maxJobs <= 1 || missingTrivial.size() <= 1)
-                {
-                    for (std::size_t moduleIndex : missingTrivial)
-                        moduleSummaries[moduleIndex] = buildModuleSummary(moduleIndex);
-                }
-                else
-                {
-                    runParallelWork(missingTrivial.size(), maxJobs,
-                                    [&](std::size_t slot)
-                                    {
-                                        const std::size_t moduleIndex = missingTrivial[slot];
-                                        moduleSummaries[moduleIndex] =
-                                            buildModuleSummary(moduleIndex);
-                                    });
-                }
-                for (std::size_t moduleIndex : missingTrivial)
-                    cacheAndStoreModule(moduleIndex);
-            }
-            totalModuleAnalyses += missingTrivial.size();
-
-            // Merge trivial SCCs into globalIndex.
-            for (std::size_t moduleIndex : trivialModules)
-            {
-                (void)analysis::mergeResourceSummaryIndex(globalIndex,
-                                                          moduleSummaries[moduleIndex]);
-            }
-
-            // Process cyclic SCCs with internal iteration.
-            for (std::size_t sccIdx : cyclicSCCIndices)
-            {
-                const auto& scc = sccOrder[sccIdx];
-                std::vector<analysis::ResourceSummaryIndex> sccPrevSummaries(N);
-                std::unordered_set<std::string> sccChangedNames;
-                bool sccConverged = false;
-
-                for (unsigned sccIter = 0; sccIter < kCrossTUMaxIterations; ++sccIter)
-                {
-                    std::vector<std::size_t> dirtyInSCC;
-                    if (sccIter == 0)
-                    {
-                        dirtyInSCC = std::vector<std::size_t>(scc.begin(), scc.end());
-                    }
-                    else
-                    {
-                        for (std::size_t m : scc)
-                        {
-                            bool isDirty = false;
-                            for (const std::string& callee : filteredResourceCalleeNames[m])
-                            {
-                                if (sccChangedNames.count(callee))
-                                {
-                                    isDirty = true;
-                                    break;
-                                }
-                            }
-                            if (isDirty)
-                                dirtyInSCC.push_back(m);
-                            else
-                                moduleSummaries[m] = sccPrevSummaries[m];
-                        }
-                    }
-
-                    for (std::size_t m : dirtyInSCC)
-                        moduleSummaries[m] = buildModuleSummary(m);
-                    totalModuleAnalyses += dirtyInSCC.size();
-
-                    analysis::ResourceSummaryIndex sccMerged;
-                    for (std::size_t m : scc)
-                        (void)analysis::mergeResourceSummaryIndex(sccMerged, moduleSummaries[m]);
-
-                    analysis::ResourceSummaryIndex prevSccMerged;
-                    for (std::size_t m : scc)
-                    {
-                        (void)analysis::mergeResourceSummaryIndex(prevSccMerged,
-                                                                  sccPrevSummaries[m]);
-                    }
-                    const bool iterConverged =
-                        analysis::resourceSummaryIndexEquals(sccMerged, prevSccMerged);
-
-                    sccChangedNames =
-                        analysis::computeChangedResourceFunctionNames(prevSccMerged, sccMerged);
-
-                    for (std::size_t m : scc)
-                        sccPrevSummaries[m] = moduleSummaries[m];
-
-                    if (cfg.timing)
-                    {
-                        coretrace::log(
-                            coretrace::Level::Info,
-                            "  Resource cyclic SCC (size={}) iteration {}{} (dirty={})\n",
-                            scc.size(), sccIter + 1, iterConverged ? " converged" : "",
-                            dirtyInSCC.size());
-                    }
-
-                    if (iterConverged)
-                    {
-                        sccConverged = true;
-                        break;
-                    }
-
-                    for (std::size_t m : scc)
-                        (void)analysis::mergeResourceSummaryIndex(globalIndex, moduleSummaries[m]);
-                }
-
-                if (!sccConverged)
-                {
-                    coretrace::log(coretrace::Level::Warn,
-                                   "Resource cross-TU: cyclic SCC (size={}) reached "
-                                   "iteration cap ({})\n",
-                                   scc.size(), kCrossTUMaxIterations);
-                }
+            const auto irLock = lockModuleIR(loaded);
+            collectDirectCalleeNames(*loaded.module, cfg, resourceModuleCalleeNames[i]);
+        }
+    }
 
-                for (std::size_t m : scc)
-                    (void)analysis::mergeResourceSummaryIndex(globalIndex, moduleSummaries[m]);
-            }
+    const std::size_t N = loadedModules.size();
+    const CrossTUSccSchedule schedule =
+        buildCrossTUSccSchedule(resourceModuleCalleeNames, definedBy);
+    if (cfg.timing)
+        logCrossTUSchedule(schedule, "resource");
 
-            if (cfg.timing)
-            {
-                const auto levelEnd = Clock::now();
-                const auto ms =
-                    std::chrono::duration_cast<std::chrono::milliseconds>(levelEnd - levelStart)
-                        .count();
-                coretrace::log(
-                    coretrace::Level::Info,
-                    "  Resource level {}: {} trivial, {} cyclic ({} modules) in {} ms\n", level,
-                    trivialModules.size(), cyclicSCCIndices.size(),
-                    trivialModules.size() +
-                        [&]()
-                        {
-                            std::size_t n = 0;
-                            for (std::size_t s : cyclicSCCIndices)
-                                n += sccOrder[s].size();
-                            return n;
-                        }(),
-                    ms);
-            }
+    ctrace::stack::analysis::ResourceSummaryIndex globalIndex;
+    ResourceIndexFingerprint globalFingerprint;
+    std::vector<ctrace::stack::analysis::ResourceSummaryIndex> moduleSummaries(N);
+    // Latest converged per-function state of each rebuilt module, handed to the
+    // analysis phase; a stale entry is detected and recomputed there.
+    std::vector<ctrace::stack::analysis::ResourceLifetimeModuleState> moduleStates(N);
+    CrossTUBuildStats stats;
+
+    // Cache keys of a level cover the global index as it stood at its start.
+    std::string externalHash;
+    std::vector<std::string> pendingCacheKeys(N);
+    CrossTUSummaryHooks<analysis::ResourceSummaryIndex> hooks;
+    hooks.label = "Resource";
+    hooks.build = [&](std::size_t moduleIndex)
+    {
+        const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                              "app.cross_tu.resource_summary.build_module");
+        const LoadedInputModule& loaded = loadedModules[moduleIndex];
+        const auto irLock = lockModuleIR(loaded);
+        analysis::FunctionFilter filter = analysis::buildFunctionFilter(*loaded.module, cfg);
+        auto shouldAnalyze = [&](const llvm::Function& F) -> bool
+        { return filter.shouldAnalyze(F); };
+        return analysis::buildResourceLifetimeSummaryIndex(*loaded.module, shouldAnalyze,
+                                                           cfg.resourceModelPath, &globalIndex,
+                                                           &moduleStates[moduleIndex]);
+    };
+    hooks.refreshExternal =
+        [&](const analysis::ResourceSummaryIndex&, const analysis::ResourceSummaryIndex*)
+    { externalHash = globalFingerprint.value().toHex(); };
+    hooks.readCache = [&](std::size_t moduleIndex, analysis::ResourceSummaryIndex& out)
+    {
+        const std::string cacheKeyPayload =
+            std::string(kResourceCacheSchema) + "|" + modelHash + "|" + externalHash + "|" +
+            filterHash + "|" + moduleCompileArgsHashes[moduleIndex] + "|" +
+            moduleIRHashes[moduleIndex];
+        const std::string& cacheKey = pendingCacheKeys[moduleIndex] = md5Hex(cacheKeyPayload);
+
+        if (const auto memIt = memoryCache.find(cacheKey); memIt != memoryCache.end())
+        {
+            out = memIt->second;
+            return true;
         }
+        if (!allowDiskCache)
+            return false;
+        const std::filesystem::path cacheFile =
+            std::filesystem::path(cfg.resourceSummaryCacheDir) / (cacheKey + ".json");
+        auto cached = readSummaryCacheFile(cacheFile);
+        if (!cached)
+            return false;
+        out = std::move(*cached);
+        memoryCache.insert_or_assign(cacheKey, out);
+        return true;
+    };
+    hooks.writeCache =
+        [&](std::size_t moduleIndex, const analysis::ResourceSummaryIndex& summary)
+    {
+        memoryCache.insert_or_assign(pendingCacheKeys[moduleIndex], summary);
+        finalCacheWrites.insert_or_assign(pendingCacheKeys[moduleIndex], summary);
+    };
+    hooks.onMerged = [&](const analysis::ResourceSummaryIndex& global,
+                         const analysis::ResourceSummaryIndex& merged)
+    { globalFingerprint.refreshFrom(global, merged); };
+
+    constexpr unsigned kCrossTUGlobalMaxIterations = 12;
+    bool globalConverged = false;
+    for (unsigned globalIter = 0; globalIter < kCrossTUGlobalMaxIterations; ++globalIter)
+    {
+        const SummaryFingerprint beforePassFingerprint = globalFingerprint.value();
+        runLevelledCrossTUBuild(schedule, hooks, cfg, maxJobs, globalIndex, moduleSummaries,
+                                stats);
 
-        const std::string afterPassHash = hashSummaryIndex(globalIndex);
+        const bool passConverged = globalFingerprint.value() == beforePassFingerprint;
         if (cfg.timing)
         {
             coretrace::log(coretrace::Level::Info,
                            "Resource global convergence pass {}{} (summary size: {})\n",
-                           globalIter + 1, (afterPassHash == beforePassHash) ? " converged" : "",
+                           globalIter + 1, passConverged ? " converged" : "",
                            globalIndex.functions.size());
         }
-        if (afterPassHash == beforePassHash)
+        if (passConverged)
         {
             globalConverged = true;
             break;
@@ -2067,16 +2987,23 @@ buildCrossTUSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
             std::chrono::duration_cast<std::chrono::milliseconds>(buildEnd - buildStart).count();
         coretrace::log(coretrace::Level::Info,
                        "Cross-TU resource summary build done in {} ms "
-                       "({} SCCs, {} module analyses)\n",
-                       ms, sccOrder.size(), totalModuleAnalyses);
+                       "({} SCCs, {} module analyses, {} cache hit(s))\n",
+                       ms, schedule.sccOrder.size(), stats.moduleAnalyses, stats.cacheHits);
     }
 
+    auto states = std::make_shared<analysis::ResourceLifetimeModuleStates>();
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (moduleStates[i].opaque)
+            states->byModule.emplace(loadedModules[i].module.get(), std::move(moduleStates[i]));
+    }
+    statesOut = std::move(states);
     return std::make_shared<analysis::ResourceSummaryIndex>(std::move(globalIndex));
 }
 
 static std::shared_ptr<ctrace::stack::analysis::GlobalReadBeforeWriteSummaryIndex>
 buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                                              const AnalysisConfig& cfg)
+                                              const AnalysisConfig& cfg, unsigned maxJobs)
 {
     const analyzer::ScopedHotspot totalHotspot(cfg.timing,
                                                "app.cross_tu.global_read_before_write.total");
@@ -2092,7 +3019,6 @@ buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModul
                        loadedModules.size());
     }
 
-    const unsigned maxJobs = resolveConfiguredJobs(cfg);
     std::vector<analysis::GlobalReadBeforeWriteSummaryIndex> moduleSummaries(loadedModules.size());
 
     auto buildModuleSummary =
@@ -2101,6 +3027,9 @@ buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModul
         const analyzer::ScopedHotspot hotspot(cfg.timing,
                                               "app.cross_tu.global_read_before_write.build_module");
         const LoadedInputModule& loaded = loadedModules[moduleIndex];
+        if (loaded.prep && loaded.prep->globalReadSummary)
+            return *loaded.prep->globalReadSummary;
+        const auto irLock = lockModuleIR(loaded);
         const analysis::FunctionFilter filter = analysis::buildFunctionFilter(*loaded.module, cfg);
         auto shouldAnalyze = [&](const llvm::Function& F) -> bool
         { return filter.shouldAnalyze(F); };
@@ -2119,10 +3048,14 @@ buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModul
     }
 
     analysis::GlobalReadBeforeWriteSummaryIndex globalIndex;
+    std::vector<const analysis::GlobalReadBeforeWriteSummaryIndex*> summaryRefs;
+    summaryRefs.reserve(moduleSummaries.size());
     for (const auto& moduleSummary : moduleSummaries)
-    {
-        (void)analysis::mergeGlobalReadBeforeWriteSummaryIndex(globalIndex, moduleSummary);
-    }
+        summaryRefs.push_back(&moduleSummary);
+    (void)mergeSummaryIndicesInOrder(globalIndex,
+                                     &analysis::GlobalReadBeforeWriteSummaryIndex::globals,
+                                     summaryRefs, maxJobs,
+                                     &analysis::mergeGlobalReadBeforeWriteSummaryEntry);
 
     if (cfg.timing)
     {
@@ -2140,7 +3073,7 @@ buildCrossTUGlobalReadBeforeWriteSummaryIndex(const std::vector<LoadedInputModul
 
 static std::shared_ptr<ctrace::stack::analysis::UninitializedSummaryIndex>
 buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
-                                      const AnalysisConfig& cfg)
+                                      const AnalysisConfig& cfg, unsigned maxJobs)
 {
     const analyzer::ScopedHotspot totalHotspot(cfg.timing, "app.cross_tu.uninitialized.total");
     if (!cfg.uninitializedCrossTU || loadedModules.size() < 2)
@@ -2155,59 +3088,49 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
                        loadedModules.size());
     }
 
-    // Same fixed-point budget policy as resource summaries.
-    constexpr unsigned kCrossTUMaxIterations = 12;
-    const unsigned maxJobs = resolveConfiguredJobs(cfg);
     std::vector<analysis::PreparedUninitializedModuleContext> preparedModules;
     preparedModules.reserve(loadedModules.size());
-    for (const LoadedInputModule& loaded : loadedModules)
+    // Pre-compute per-module callee name sets for delta-based convergence.
+    std::vector<std::unordered_set<std::string>> moduleCalleeNames(loadedModules.size());
+    for (std::size_t i = 0; i < loadedModules.size(); ++i)
     {
+        const LoadedInputModule& loaded = loadedModules[i];
+        if (loaded.prep && loaded.prep->uninitializedContext)
+        {
+            preparedModules.push_back(*loaded.prep->uninitializedContext);
+            moduleCalleeNames[i] = loaded.prep->uninitializedCalleeNames;
+            continue;
+        }
+        const auto irLock = lockModuleIR(loaded);
         const analysis::FunctionFilter filter = analysis::buildFunctionFilter(*loaded.module, cfg);
         auto shouldAnalyze = [&](const llvm::Function& F) -> bool
         { return filter.shouldAnalyze(F); };
         preparedModules.push_back(
             analysis::prepareUninitializedModuleContext(*loaded.module, shouldAnalyze));
-    }
-    // Pre-compute per-module callee name sets for delta-based convergence.
-    std::vector<std::unordered_set<std::string>> moduleCalleeNames(loadedModules.size());
-    for (std::size_t i = 0; i < loadedModules.size(); ++i)
         moduleCalleeNames[i] = analysis::getCanonicalCalleeNames(preparedModules[i]);
+    }
 
-    // Build definedBy map and single-def name set for SCC + dirty-marking.
-    // Same criterion as buildSingleDefFilteredEdges: a function is single-def
-    // if exactly one module defines it.  Multi-def functions (inline, template,
-    // weak) produce identical summaries in all TUs and don't create real
-    // cross-module data dependencies.
+    // Build the definedBy map for SCC edges and dirty-marking. A function is
+    // single-def if exactly one module defines it. Multi-def functions (inline,
+    // template, weak) produce identical summaries in all TUs and don't create
+    // real cross-module data dependencies.
     const std::size_t N = loadedModules.size();
     std::unordered_map<std::string, std::vector<std::size_t>> definedBy;
     for (std::size_t i = 0; i < N; ++i)
     {
-        for (const llvm::Function& F : *loadedModules[i].module)
+        std::vector<std::string> localNames;
+        const std::vector<std::string>* definedNames = &localNames;
+        if (loadedModules[i].prep)
         {
-            if (F.isDeclaration() || !F.hasName() || F.getName().empty())
-                continue;
-            const std::string canon = ctrace_tools::canonicalizeMangledName(F.getName().str());
-            definedBy[canon].push_back(i);
+            definedNames = &loadedModules[i].prep->definedNames;
         }
-    }
-
-    std::unordered_set<std::string> singleDefNames;
-    for (const auto& [name, modules] : definedBy)
-    {
-        if (modules.size() == 1)
-            singleDefNames.insert(name);
-    }
-
-    // Per-module filtered callee sets: only callees with single-def
-    // definitions.  Consistent with SCC edge criterion.
-    std::vector<std::unordered_set<std::string>> filteredModuleCalleeNames(N);
-    for (std::size_t i = 0; i < N; ++i)
-    {
-        for (const std::string& callee : moduleCalleeNames[i])
+        else
         {
-            if (singleDefNames.count(callee))
-                filteredModuleCalleeNames[i].insert(callee);
+            const auto irLock = lockModuleIR(loadedModules[i]);
+            collectDefinedCanonicalNames(*loadedModules[i].module, localNames);
         }
+        for (const std::string& canon : *definedNames)
+            definedBy[canon].push_back(i);
     }
 
     // ── SCC instrumentation: diagnose inter-module call graph structure ──
@@ -2236,9 +3159,8 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
         }
 
         // 3. Tarjan's algorithm on module indices → SCCs
-        //    (Reuses the ModuleTarjan struct extracted to file scope.)
-        ModuleTarjan tarjan;
-        tarjan.run(N, moduleEdges);
+        //    (Reuses the computeModuleSCCs helper extracted to file scope.)
+        const auto moduleSCCs = computeModuleSCCs(N, moduleEdges);
 
         // 4. Classify and log SCC distribution.
         std::size_t trivialSCCs = 0;  // size == 1, no self-edge
@@ -2247,7 +3169,7 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
         std::size_t maxSCCSize = 0;
         std::size_t totalModulesInCyclicSCCs = 0;
 
-        for (const auto& scc : tarjan.sccs)
+        for (const auto& scc : moduleSCCs)
         {
             if (scc.size() == 1)
             {
@@ -2274,11 +3196,11 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
                        "  Cyclic (size>1, need iteration): {}\n"
                        "  Max cyclic SCC size: {}\n"
                        "  Total modules in cyclic SCCs: {}\n",
-                       N, tarjan.sccs.size(), trivialSCCs, selfLoopSCCs, cyclicSCCs, maxSCCSize,
+                       N, moduleSCCs.size(), trivialSCCs, selfLoopSCCs, cyclicSCCs, maxSCCSize,
                        totalModulesInCyclicSCCs);
 
         // Log cyclic SCCs with module names for investigation.
-        for (const auto& scc : tarjan.sccs)
+        for (const auto& scc : moduleSCCs)
         {
             if (scc.size() > 1)
             {
@@ -2383,12 +3305,11 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
         for (const auto& e : diagFilteredEdges)
             filteredTotalEdges += e.size();
 
-        ModuleTarjan filteredTarjan;
-        filteredTarjan.run(N, diagFilteredEdges);
+        const auto filteredSCCs = computeModuleSCCs(N, diagFilteredEdges);
 
         std::size_t fTrivial = 0, fSelfLoop = 0, fCyclic = 0;
         std::size_t fMaxSCC = 0, fTotalInCyclic = 0;
-        for (const auto& scc : filteredTarjan.sccs)
+        for (const auto& scc : filteredSCCs)
         {
             if (scc.size() == 1)
             {
@@ -2415,9 +3336,9 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
             "    Max cyclic SCC size: {}\n"
             "    Modules in cyclic SCCs: {}\n",
             filteredTotalEdges, N > 1 ? (100.0 * filteredTotalEdges / (N * (N - 1))) : 0.0,
-            filteredTarjan.sccs.size(), fTrivial, fSelfLoop, fCyclic, fMaxSCC, fTotalInCyclic);
+            filteredSCCs.size(), fTrivial, fSelfLoop, fCyclic, fMaxSCC, fTotalInCyclic);
 
-        for (const auto& scc : filteredTarjan.sccs)
+        for (const auto& scc : filteredSCCs)
         {
             if (scc.size() > 1)
             {
@@ -2438,259 +3359,242 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
     }
     // ── End SCC instrumentation ──
 
-    // ── SCC worklist: topological processing of inter-module dependencies ──
-    // Build single-def filtered edge graph and compute topological SCC order.
-    // This replaces the global fixed-point loop with ordered SCC processing:
-    // - Trivial SCCs (no cycles): processed once, no iteration needed
-    // - Cyclic SCCs: iterate internally until convergence
-    const auto filteredEdges = buildSingleDefFilteredEdges(N, moduleCalleeNames, definedBy);
-    const auto sccOrder = computeTopologicalSCCOrder(N, filteredEdges);
-    const auto sccLevels = computeSCCLevels(sccOrder, filteredEdges, N);
-
-    // Note on indirect calls (function pointers):
-    // Virtually all C++ modules contain indirect calls (virtual dispatch,
-    // std::function, etc.), so flagging them as "conservatively cyclic" would
-    // negate the SCC worklist benefit. The uninit/resource analysis already
-    // handles indirect calls conservatively within each module (unresolved
-    // callees are treated as unknown). The SCC graph only tracks *resolved*
-    // inter-module edges, so indirect calls don't affect the topological order.
-    // No special treatment is needed.
-
-    // Compute max level for grouping.
-    unsigned maxLevel = 0;
-    for (unsigned lvl : sccLevels)
-        maxLevel = std::max(maxLevel, lvl);
+    const CrossTUSccSchedule schedule = buildCrossTUSccSchedule(moduleCalleeNames, definedBy);
+    if (cfg.timing)
+        logCrossTUSchedule(schedule, "uninitialized");
+
+    // Persistent per-module cache for trivial SCCs. A key covers the module
+    // content, the function filter and the external summaries of the module's
+    // own callees as seen at its level; cyclic SCCs always rebuild.
+    const bool allowDiskCache = crossTUSummaryDiskCacheEnabled(cfg);
+    std::vector<std::string> moduleCacheKeyBases;
+    std::vector<std::vector<std::string>> sortedModuleCalleeNames;
+    if (allowDiskCache)
+    {
+        const std::string filterHash = computeFunctionFilterSignature(cfg);
+        moduleCacheKeyBases.reserve(N);
+        sortedModuleCalleeNames.resize(N);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const LoadedInputModule& loaded = loadedModules[i];
+            std::string irHash = loaded.prep ? loaded.prep->irHash : std::string();
+            if (irHash.empty())
+            {
+                const auto irLock = lockModuleIR(loaded);
+                irHash = hashModuleIR(*loaded.module);
+            }
+            moduleCacheKeyBases.push_back(std::string(kUninitializedCacheSchema) + "|" +
+                                          filterHash + "|" + irHash);
+            sortedModuleCalleeNames[i].assign(moduleCalleeNames[i].begin(),
+                                              moduleCalleeNames[i].end());
+            std::sort(sortedModuleCalleeNames[i].begin(), sortedModuleCalleeNames[i].end());
+        }
+    }
+    std::unordered_map<std::string, analysis::UninitializedSummaryIndex> finalCacheWrites;
 
-    // Group SCCs by topological level for parallel processing.
-    std::vector<std::vector<std::size_t>> levelGroups(maxLevel + 1);
-    for (std::size_t s = 0; s < sccOrder.size(); ++s)
-        levelGroups[sccLevels[s]].push_back(s);
+    analysis::UninitializedSummaryIndex globalIndex;
+    std::vector<analysis::UninitializedSummaryIndex> moduleSummaries(N);
+    CrossTUBuildStats stats;
 
-    // Classify SCCs for logging.
-    std::size_t trivialSCCCount = 0;
-    std::size_t cyclicSCCCount = 0;
-    for (std::size_t s = 0; s < sccOrder.size(); ++s)
+    analysis::PreparedUninitializedExternalSummaries preparedExternal;
+    std::vector<std::string> pendingCacheKeys(N);
+    CrossTUSummaryHooks<analysis::UninitializedSummaryIndex> hooks;
+    hooks.label = "Uninitialized";
+    hooks.build = [&](std::size_t moduleIndex)
     {
-        const auto& scc = sccOrder[s];
-        const bool isTrivial = scc.size() == 1 && !filteredEdges[scc[0]].count(scc[0]);
-        if (isTrivial)
-            ++trivialSCCCount;
-        else
-            ++cyclicSCCCount;
+        const analyzer::ScopedHotspot hotspot(cfg.timing,
+                                              "app.cross_tu.uninitialized.build_module");
+        const LoadedInputModule& loaded = loadedModules[moduleIndex];
+        const auto irLock = lockModuleIR(loaded);
+        return analysis::buildUninitializedSummaryIndex(
+            *loaded.module, &preparedModules[moduleIndex], &preparedExternal);
+    };
+    hooks.refreshExternal =
+        [&](const analysis::UninitializedSummaryIndex& global,
+            const analysis::UninitializedSummaryIndex*)
+    { preparedExternal = analysis::prepareUninitializedExternalSummaries(&global); };
+    if (allowDiskCache)
+    {
+        hooks.readCache = [&](std::size_t moduleIndex, analysis::UninitializedSummaryIndex& out)
+        {
+            pendingCacheKeys[moduleIndex] = md5Hex(
+                moduleCacheKeyBases[moduleIndex] + "|" +
+                hashReferencedUninitializedSummaries(sortedModuleCalleeNames[moduleIndex],
+                                                     globalIndex));
+            auto cached = readUninitializedSummaryCacheFile(
+                crossTUSummaryCacheFile(cfg, "uninitialized", pendingCacheKeys[moduleIndex]));
+            if (!cached)
+                return false;
+            out = std::move(*cached);
+            return true;
+        };
+        hooks.writeCache =
+            [&](std::size_t moduleIndex, const analysis::UninitializedSummaryIndex& summary)
+        { finalCacheWrites.insert_or_assign(pendingCacheKeys[moduleIndex], summary); };
+    }
+
+    runLevelledCrossTUBuild(schedule, hooks, cfg, maxJobs, globalIndex, moduleSummaries, stats);
+
+    for (const auto& entry : finalCacheWrites)
+    {
+        (void)writeUninitializedSummaryCacheFile(
+            crossTUSummaryCacheFile(cfg, "uninitialized", entry.first), entry.second);
     }
 
     if (cfg.timing)
     {
+        const auto buildEnd = Clock::now();
+        const auto ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(buildEnd - buildStart).count();
         coretrace::log(coretrace::Level::Info,
-                       "Cross-TU uninitialized SCC worklist: {} SCCs ({} trivial, {} cyclic) "
-                       "in {} levels\n",
-                       sccOrder.size(), trivialSCCCount, cyclicSCCCount, maxLevel + 1);
+                       "Cross-TU uninitialized summary build done in {} ms "
+                       "({} SCCs, {} module analyses, {} cache hit(s))\n",
+                       ms, schedule.sccOrder.size(), stats.moduleAnalyses, stats.cacheHits);
     }
 
-    // ── Process SCCs level by level ──
-    analysis::UninitializedSummaryIndex globalIndex;
-    std::vector<analysis::UninitializedSummaryIndex> moduleSummaries(N);
-    std::size_t totalModuleAnalyses = 0;
+    return std::make_shared<analysis::UninitializedSummaryIndex>(std::move(globalIndex));
+}
 
-    for (unsigned level = 0; level <= maxLevel; ++level)
-    {
-        const auto& group = levelGroups[level];
-        if (group.empty())
-            continue;
+static std::shared_ptr<ctrace::stack::analysis::StackEscapeSummaryIndex>
+buildCrossTUStackEscapeSummaryIndex(const std::vector<LoadedInputModule>& loadedModules,
+                                    const AnalysisConfig& cfg, unsigned maxJobs)
+{
+    const analyzer::ScopedHotspot totalHotspot(cfg.timing, "app.cross_tu.stack_escape.total");
+    if (loadedModules.size() < 2)
+        return nullptr;
 
-        const auto levelStart = Clock::now();
+    using Clock = std::chrono::steady_clock;
+    const auto buildStart = Clock::now();
+    if (cfg.timing)
+    {
+        coretrace::log(coretrace::Level::Info,
+                       "Building cross-TU stack escape summaries for {} module(s)...\n",
+                       loadedModules.size());
+    }
 
-        // Prepare external summaries once per level — all SCCs at this level
-        // see the same accumulated globalIndex (they are independent).
-        const analysis::PreparedUninitializedExternalSummaries preparedExternal =
-            analysis::prepareUninitializedExternalSummaries(&globalIndex);
+    const std::size_t N = loadedModules.size();
 
-        auto buildModuleSummary =
-            [&](std::size_t moduleIndex) -> analysis::UninitializedSummaryIndex
+    std::vector<std::unordered_set<std::string>> moduleCalleeNames(N);
+    std::unordered_map<std::string, std::vector<std::size_t>> definedBy;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const LoadedInputModule& loaded = loadedModules[i];
+        std::vector<std::string> localNames;
+        const std::vector<std::string>* definedNames = &localNames;
+        if (loaded.prep)
         {
-            const analyzer::ScopedHotspot hotspot(cfg.timing,
-                                                  "app.cross_tu.uninitialized.build_module");
-            const LoadedInputModule& loaded = loadedModules[moduleIndex];
-            return analysis::buildUninitializedSummaryIndex(
-                *loaded.module, &preparedModules[moduleIndex], &preparedExternal);
-        };
-
-        // Collect all trivial SCC modules at this level for parallel batch processing.
-        std::vector<std::size_t> trivialModules;
-        std::vector<std::size_t> cyclicSCCIndices;
-
-        for (std::size_t sccIdx : group)
+            moduleCalleeNames[i] = loaded.prep->directCalleeNames;
+            definedNames = &loaded.prep->definedNames;
+        }
+        else
         {
-            const auto& scc = sccOrder[sccIdx];
-            const bool isTrivial = scc.size() == 1 && !filteredEdges[scc[0]].count(scc[0]);
-            if (isTrivial)
-                trivialModules.push_back(scc[0]);
-            else
-                cyclicSCCIndices.push_back(sccIdx);
+            const auto irLock = lockModuleIR(loaded);
+            collectDirectCalleeNames(*loaded.module, cfg, moduleCalleeNames[i]);
+            collectDefinedCanonicalNames(*loaded.module, localNames);
         }
+        for (const std::string& canon : *definedNames)
+            definedBy[canon].push_back(i);
+    }
 
-        // Sort cyclic SCCs by minimum module index for deterministic processing order.
-        std::sort(cyclicSCCIndices.begin(), cyclicSCCIndices.end(),
-                  [&](std::size_t a, std::size_t b) { return sccOrder[a][0] < sccOrder[b][0]; });
+    const CrossTUSccSchedule schedule = buildCrossTUSccSchedule(moduleCalleeNames, definedBy);
+    if (cfg.timing)
+        logCrossTUSchedule(schedule, "stack escape");
 
-        // Process trivial SCCs in parallel.
-        if (!trivialModules.empty())
+    // Trivial SCCs are cached per module, keyed like uninitialized summaries
+    // plus the escape model content.
+    const bool allowDiskCache = crossTUSummaryDiskCacheEnabled(cfg);
+    std::vector<std::string> moduleCacheKeyBases;
+    std::vector<std::vector<std::string>> sortedModuleCalleeNames;
+    if (allowDiskCache)
+    {
+        const std::string filterHash = computeFunctionFilterSignature(cfg);
+        std::string modelHash;
+        if (!cfg.escapeModelPath.empty())
         {
-            if (maxJobs <= 1 || trivialModules.size() <= 1)
-            {
-                for (std::size_t moduleIndex : trivialModules)
-                    moduleSummaries[moduleIndex] = buildModuleSummary(moduleIndex);
-            }
-            else
-            {
-                runParallelWork(trivialModules.size(), maxJobs,
-                                [&](std::size_t slot)
-                                {
-                                    const std::size_t moduleIndex = trivialModules[slot];
-                                    moduleSummaries[moduleIndex] = buildModuleSummary(moduleIndex);
-                                });
-            }
-            totalModuleAnalyses += trivialModules.size();
+            const std::string modelContent = readFileAsString(cfg.escapeModelPath);
+            modelHash = md5Hex(modelContent.empty() ? cfg.escapeModelPath : modelContent);
         }
-
-        // Merge trivial SCC summaries into globalIndex.
-        for (std::size_t moduleIndex : trivialModules)
-            (void)analysis::mergeUninitializedSummaryIndex(globalIndex,
-                                                           moduleSummaries[moduleIndex]);
-
-        // Process cyclic SCCs (or modules with indirect calls) with internal iteration.
-        for (std::size_t sccIdx : cyclicSCCIndices)
+        moduleCacheKeyBases.reserve(N);
+        sortedModuleCalleeNames.resize(N);
+        for (std::size_t i = 0; i < N; ++i)
         {
-            const auto& scc = sccOrder[sccIdx];
-
-            // Internal convergence loop for this SCC.
-            std::vector<analysis::UninitializedSummaryIndex> sccPrevSummaries(N);
-            std::unordered_set<std::string> sccChangedNames;
-            bool sccConverged = false;
-
-            for (unsigned sccIter = 0; sccIter < kCrossTUMaxIterations; ++sccIter)
-            {
-                // Re-prepare external summaries with current globalIndex
-                // (which includes upstream SCCs + any changes from prev SCC iterations).
-                const analysis::PreparedUninitializedExternalSummaries sccExternal =
-                    analysis::prepareUninitializedExternalSummaries(&globalIndex);
-
-                // Rebind buildModuleSummary to use sccExternal.
-                auto buildSCCModuleSummary =
-                    [&](std::size_t moduleIndex) -> analysis::UninitializedSummaryIndex
-                {
-                    const analyzer::ScopedHotspot hotspot(
-                        cfg.timing, "app.cross_tu.uninitialized.build_module");
-                    const LoadedInputModule& loaded = loadedModules[moduleIndex];
-                    return analysis::buildUninitializedSummaryIndex(
-                        *loaded.module, &preparedModules[moduleIndex], &sccExternal);
-                };
-
-                // Delta-based dirty-marking within the SCC.
-                std::vector<std::size_t> dirtyInSCC;
-                if (sccIter == 0)
-                {
-                    dirtyInSCC = std::vector<std::size_t>(scc.begin(), scc.end());
-                }
-                else
-                {
-                    for (std::size_t m : scc)
-                    {
-                        bool isDirty = false;
-                        for (const std::string& callee : filteredModuleCalleeNames[m])
-                        {
-                            if (sccChangedNames.count(callee))
-                            {
-                                isDirty = true;
-                                break;
-                            }
-                        }
-                        if (isDirty)
-                            dirtyInSCC.push_back(m);
-                        else
-                            moduleSummaries[m] = sccPrevSummaries[m];
-                    }
-                }
-
-                for (std::size_t m : dirtyInSCC)
-                    moduleSummaries[m] = buildSCCModuleSummary(m);
-                totalModuleAnalyses += dirtyInSCC.size();
-
-                // Build SCC-local merged index to check convergence.
-                analysis::UninitializedSummaryIndex sccMerged;
-                for (std::size_t m : scc)
-                    (void)analysis::mergeUninitializedSummaryIndex(sccMerged, moduleSummaries[m]);
-
-                // Check if SCC summaries changed from previous iteration.
-                analysis::UninitializedSummaryIndex prevSccMerged;
-                for (std::size_t m : scc)
-                    (void)analysis::mergeUninitializedSummaryIndex(prevSccMerged,
-                                                                   sccPrevSummaries[m]);
-                const bool iterConverged =
-                    analysis::uninitializedSummaryIndexEquals(sccMerged, prevSccMerged);
-
-                sccChangedNames =
-                    analysis::computeChangedUninitializedFunctionNames(prevSccMerged, sccMerged);
-
-                for (std::size_t m : scc)
-                    sccPrevSummaries[m] = moduleSummaries[m];
-
-                if (cfg.timing)
-                {
-                    coretrace::log(coretrace::Level::Info,
-                                   "  Cyclic SCC (size={}) iteration {}{} (dirty={})\n", scc.size(),
-                                   sccIter + 1, iterConverged ? " converged" : "",
-                                   dirtyInSCC.size());
-                }
-
-                if (iterConverged)
-                {
-                    sccConverged = true;
-                    break;
-                }
-
-                // Update globalIndex with intermediate SCC state for next iteration's
-                // prepareExternalSummaries.
-                for (std::size_t m : scc)
-                    (void)analysis::mergeUninitializedSummaryIndex(globalIndex, moduleSummaries[m]);
-            }
-
-            if (!sccConverged)
+            const LoadedInputModule& loaded = loadedModules[i];
+            std::string irHash = loaded.prep ? loaded.prep->irHash : std::string();
+            if (irHash.empty())
             {
-                coretrace::log(coretrace::Level::Warn,
-                               "Uninitialized cross-TU: cyclic SCC (size={}) reached "
-                               "iteration cap ({})\n",
-                               scc.size(), kCrossTUMaxIterations);
+                const auto irLock = lockModuleIR(loaded);
+                irHash = hashModuleIR(*loaded.module);
             }
-
-            // Merge final SCC summaries into globalIndex.
-            for (std::size_t m : scc)
-                (void)analysis::mergeUninitializedSummaryIndex(globalIndex, moduleSummaries[m]);
+            moduleCacheKeyBases.push_back(std::string(kStackEscapeCacheSchema) + "|" +
+                                          filterHash + "|" + modelHash + "|" + irHash);
+            sortedModuleCalleeNames[i].assign(moduleCalleeNames[i].begin(),
+                                              moduleCalleeNames[i].end());
+            std::sort(sortedModuleCalleeNames[i].begin(), sortedModuleCalleeNames[i].end());
         }
-
-        if (cfg.timing)
+    }
+    std::unordered_map<std::string, analysis::StackEscapeSummaryIndex> finalCacheWrites;
+
+    analysis::StackEscapeSummaryIndex globalIndex;
+    std::vector<analysis::StackEscapeSummaryIndex> moduleSummaries(N);
+    CrossTUBuildStats stats;
+
+    // Cyclic SCC members see upstream summaries plus the previous iteration
+    // of their own SCC.
+    const analysis::StackEscapeSummaryIndex* external = &globalIndex;
+    analysis::StackEscapeSummaryIndex sccExternal;
+    std::vector<std::string> pendingCacheKeys(N);
+    CrossTUSummaryHooks<analysis::StackEscapeSummaryIndex> hooks;
+    hooks.label = "Stack escape";
+    hooks.build = [&](std::size_t moduleIndex)
+    {
+        const analyzer::ScopedHotspot hotspot(cfg.timing, "app.cross_tu.stack_escape.build_module");
+        const auto irLock = lockModuleIR(loadedModules[moduleIndex]);
+        llvm::Module& mod = *loadedModules[moduleIndex].module;
+        const analysis::FunctionFilter filter = analysis::buildFunctionFilter(mod, cfg);
+        auto shouldAnalyze = [&](const llvm::Function& F) -> bool
+        { return filter.shouldAnalyze(F); };
+        return analysis::buildStackEscapeSummaryIndex(mod, shouldAnalyze, cfg.escapeModelPath,
+                                                      external);
+    };
+    hooks.refreshExternal = [&](const analysis::StackEscapeSummaryIndex& global,
+                                const analysis::StackEscapeSummaryIndex* pendingScc)
+    {
+        if (!pendingScc)
         {
-            const auto levelEnd = Clock::now();
-            const auto ms =
-                std::chrono::duration_cast<std::chrono::milliseconds>(levelEnd - levelStart)
-                    .count();
-            coretrace::log(
-                coretrace::Level::Info,
-                "  Level {}: {} trivial SCCs, {} cyclic SCCs ({} modules) in {} ms\n", level,
-                trivialModules.size(), cyclicSCCIndices.size(),
-                trivialModules.size() +
-                    [&]()
-                    {
-                        std::size_t n = 0;
-                        for (std::size_t s : cyclicSCCIndices)
-                            n += sccOrder[s].size();
-                        return n;
-                    }(),
-                ms);
+            external = &global;
+            return;
         }
+        sccExternal = global;
+        (void)analysis::mergeStackEscapeSummaryIndex(sccExternal, *pendingScc);
+        external = &sccExternal;
+    };
+    if (allowDiskCache)
+    {
+        hooks.readCache = [&](std::size_t moduleIndex, analysis::StackEscapeSummaryIndex& out)
+        {
+            pendingCacheKeys[moduleIndex] =
+                md5Hex(moduleCacheKeyBases[moduleIndex] + "|" +
+                       hashReferencedStackEscapeSummaries(sortedModuleCalleeNames[moduleIndex],
+                                                          globalIndex));
+            auto cached = readStackEscapeSummaryCacheFile(
+                crossTUSummaryCacheFile(cfg, "stack-escape", pendingCacheKeys[moduleIndex]));
+            if (!cached)
+                return false;
+            out = std::move(*cached);
+            return true;
+        };
+        hooks.writeCache =
+            [&](std::size_t moduleIndex, const analysis::StackEscapeSummaryIndex& summary)
+        { finalCacheWrites.insert_or_assign(pendingCacheKeys[moduleIndex], summary); };
     }
 
-    // No indirect-call cleanup pass needed — see note above on indirect calls.
+    runLevelledCrossTUBuild(schedule, hooks, cfg, maxJobs, globalIndex, moduleSummaries, stats);
+
+    for (const auto& entry : finalCacheWrites)
+    {
+        (void)writeStackEscapeSummaryCacheFile(
+            crossTUSummaryCacheFile(cfg, "stack-escape", entry.first), entry.second);
+    }
 
     if (cfg.timing)
     {
@@ -2698,12 +3602,52 @@ buildCrossTUUninitializedSummaryIndex(const std::vector<LoadedInputModule>& load
         const auto ms =
             std::chrono::duration_cast<std::chrono::milliseconds>(buildEnd - buildStart).count();
         coretrace::log(coretrace::Level::Info,
-                       "Cross-TU uninitialized summary build done in {} ms "
-                       "({} SCCs, {} module analyses)\n",
-                       ms, sccOrder.size(), totalModuleAnalyses);
+                       "Cross-TU stack escape summary build done in {} ms "
+                       "({} SCCs in {} levels, {} module analyses, {} cache hit(s))\n",
+                       ms, schedule.sccOrder.size(), schedule.levelGroups.size(),
+                       stats.moduleAnalyses, stats.cacheHits);
     }
 
-    return std::make_shared<analysis::UninitializedSummaryIndex>(std::move(globalIndex));
+    return std::make_shared<analysis::StackEscapeSummaryIndex>(std::move(globalIndex));
+}
+
+// Links the stack summaries every module exported during its analysis into
+// one call graph, so maxStack and the stack limit check follow calls across
+// translation units. All modules are already released at this point.
+static void applyCrossTUStackSummaries(std::vector<AnalysisEntry>& results,
+                                       const AnalysisConfig& cfg)
+{
+    std::vector<std::shared_ptr<const analysis::ModuleStackSummary>> summaries;
+    std::vector<std::size_t> resultIndices;
+    for (std::size_t index = 0; index < results.size(); ++index)
+    {
+        AnalysisResult& result = results[index].second;
+        if (!result.stackSummary)
+            continue;
+        summaries.push_back(std::move(result.stackSummary));
+        resultIndices.push_back(index);
+    }
+    if (summaries.size() < 2)
+        return;
+
+    using Clock = std::chrono::steady_clock;
+    const auto linkStart = Clock::now();
+    const analysis::WholeProgramStack program =
+        analysis::linkWholeProgramStack(std::move(summaries));
+    for (std::size_t module = 0; module < resultIndices.size(); ++module)
+        analyzer::applyWholeProgramStack(results[resultIndices[module]].second, program, module);
+
+    if (cfg.timing)
+    {
+        const auto ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - linkStart)
+                .count();
+        coretrace::log(coretrace::Level::Info,
+                       "Cross-TU stack link done in {} ms ({} function(s), {} cross-TU call(s) "
+                       "resolved, {} external)\n",
+                       ms, program.totals.size(), program.resolvedExternalCalls,
+                       program.unresolvedExternalCalls);
+    }
 }
 
 static void accumulateSummary(DiagnosticSummary& total, const DiagnosticSummary& add)
@@ -2725,8 +3669,10 @@ struct RunPlan
     std::uint64_t needsCrossTUResourceSummaries : 1 = false;
     std::uint64_t needsCrossTUUninitializedSummaries : 1 = false;
     std::uint64_t needsCrossTUGlobalReadBeforeWriteSummaries : 1 = false;
+    std::uint64_t needsCrossTUStackEscapeSummaries : 1 = false;
+    std::uint64_t needsCrossTUStackSummaries : 1 = false;
     std::uint64_t needsSharedModuleLoading : 1 = false;
-    std::uint64_t reservedFlags : 59 = 0;
+    std::uint64_t reservedFlags : 57 = 0;
 };
 
 class RunPlanBuilder
@@ -2759,6 +3705,19 @@ class RunPlanBuilder
 
         plan.normalizedFilters = buildNormalizedPathFilters(plan.cfg);
         excludeInputFiles(plan.inputFilenames, plan.cfg, plan.normalizedFilters);
+        if (parsedArgs_.compdbDedupe)
+            dedupeInputsByCompilationDatabase(plan.inputFilenames, plan.cfg);
+
+        if (plan.cfg.compilePCH && plan.cfg.compileIRCacheDir.empty())
+        {
+            coretrace::log(coretrace::Level::Warn,
+                           "--compile-pch ignored: precompiled headers are stored under "
+                           "--compile-ir-cache-dir, which is not set\n");
+        }
+
+        AppStatus frameSizeStatus = loadFrameSizeTable(plan.inputFilenames, plan.cfg);
+        if (!frameSizeStatus.isOk())
+            return AppResult<RunPlan>::failure(std::move(frameSizeStatus.error));
 
         if (compdbInputsAutoDiscovered && !parsedArgs_.analysisProfileExplicit &&
             plan.inputFilenames.size() > 1)
@@ -2789,9 +3748,17 @@ class RunPlanBuilder
         plan.needsCrossTUUninitializedSummaries =
             plan.cfg.uninitializedCrossTU && plan.inputFilenames.size() > 1;
         plan.needsCrossTUGlobalReadBeforeWriteSummaries = plan.inputFilenames.size() > 1;
+        plan.needsCrossTUStackEscapeSummaries =
+            plan.cfg.escapeCrossTU && plan.inputFilenames.size() > 1;
+        // Stack summaries are exported by each module's own analysis, so they
+        // do not require the shared loading schedule.
+        plan.needsCrossTUStackSummaries =
+            plan.cfg.stackCrossTU && plan.inputFilenames.size() > 1;
+        plan.cfg.stackSummaryExport = plan.needsCrossTUStackSummaries;
         plan.needsSharedModuleLoading = plan.needsCrossTUResourceSummaries ||
                                         plan.needsCrossTUUninitializedSummaries ||
-                                        plan.needsCrossTUGlobalReadBeforeWriteSummaries;
+                                        plan.needsCrossTUGlobalReadBeforeWriteSummaries ||
+                                        plan.needsCrossTUStackEscapeSummaries;
         return AppResult<RunPlan>::success(std::move(plan));
     }
 
@@ -2815,7 +3782,8 @@ class SharedModuleLoadingExecutionStrategy final : public AnalysisExecutionStrat
         return analyzeWithSharedModuleLoading(
             plan.inputFilenames, plan.cfg, plan.hasFilter, plan.needsCrossTUResourceSummaries,
             plan.needsCrossTUUninitializedSummaries,
-            plan.needsCrossTUGlobalReadBeforeWriteSummaries, results);
+            plan.needsCrossTUGlobalReadBeforeWriteSummaries,
+            plan.needsCrossTUStackEscapeSummaries, results);
     }
 };
 
@@ -2891,6 +3859,7 @@ class AnalyzerApp
   public:
     AppResult<int> run(ctrace::stack::cli::ParsedArguments parsedArgs) const
     {
+        analysis::resetFileSnapshotCache();
         RunPlanBuilder planBuilder(std::move(parsedArgs));
         AppResult<RunPlan> planResult = planBuilder.build();
         if (!planResult.isOk())
@@ -2900,15 +3869,84 @@ class AnalyzerApp
         printInterprocStatus(plan.cfg, plan.inputFilenames.size(),
                              plan.needsCrossTUResourceSummaries,
                              plan.needsCrossTUUninitializedSummaries,
-                             plan.needsCrossTUGlobalReadBeforeWriteSummaries);
+                             plan.needsCrossTUGlobalReadBeforeWriteSummaries,
+                             plan.needsCrossTUStackEscapeSummaries,
+                             plan.needsCrossTUStackSummaries);
+
+        auto& smtQueryCache = analysis::smt::SmtQueryCache::instance();
+        const bool persistSmtQueries = plan.cfg.smtEnabled && !plan.cfg.smtCacheDir.empty();
+        if (persistSmtQueries)
+        {
+            std::string cacheError;
+            if (!smtQueryCache.loadPersistent(plan.cfg.smtCacheDir, cacheError))
+                coretrace::log(coretrace::Level::Warn, "SMT query cache disabled: {}\n",
+                               cacheError);
+        }
+
+        auto& smtCapture = analysis::smt::SmtQueryCapture::instance();
+        const bool captureSmtQueries = plan.cfg.smtEnabled && !plan.cfg.smtCapturePath.empty();
+        if (captureSmtQueries)
+        {
+            std::string captureError;
+            if (!smtCapture.open(plan.cfg.smtCapturePath, captureError))
+                return AppResult<int>::failure(std::move(captureError));
+        }
 
         std::vector<AnalysisEntry> results;
         results.reserve(plan.inputFilenames.size());
         std::unique_ptr<AnalysisExecutionStrategy> executionStrategy = makeExecutionStrategy(plan);
         AppStatus executionStatus = executionStrategy->execute(plan, results);
+        if (captureSmtQueries)
+        {
+            std::string captureError;
+            if (!smtCapture.close(captureError))
+                coretrace::log(coretrace::Level::Warn, "{}\n", captureError);
+            else
+                coretrace::log(coretrace::Level::Info, "SMT capture: {} query(ies) written to {}\n",
+                               smtCapture.recordedCount(), plan.cfg.smtCapturePath);
+        }
         if (!executionStatus.isOk())
             return AppResult<int>::failure(std::move(executionStatus.error));
 
+        if (plan.needsCrossTUStackSummaries)
+        {
+            const analyzer::ScopedHotspot hotspot(plan.cfg.timing, "app.cross_tu_stack");
+            applyCrossTUStackSummaries(results, plan.cfg);
+        }
+
+        if (persistSmtQueries)
+        {
+            std::string cacheError;
+            if (!smtQueryCache.flushPersistent(cacheError))
+                coretrace::log(coretrace::Level::Warn, "SMT query cache not saved: {}\n",
+                               cacheError);
+        }
+        if (plan.cfg.timing && plan.cfg.smtEnabled)
+        {
+            const analysis::smt::SmtQueryCacheStats stats = smtQueryCache.stats();
+            coretrace::log(coretrace::Level::Info,
+                           "SMT query cache: {} lookup(s), {} hit(s) ({:.1f}%), {} entries "
+                           "loaded from disk\n",
+                           stats.lookups, stats.hits,
+                           stats.lookups ? (100.0 * stats.hits / stats.lookups) : 0.0,
+                           stats.persistentEntries);
+            const analysis::smt::PresolveStats presolve = analysis::smt::presolveStats();
+            const std::uint64_t decided = presolve.decidedSat + presolve.decidedUnsat;
+            coretrace::log(coretrace::Level::Info,
+                           "SMT presolve: {} query(ies), {} decided ({:.1f}%: {} sat, {} unsat), "
+                           "residual IR {} -> {} node(s)\n",
+                           presolve.queries, decided,
+                           presolve.queries ? (100.0 * decided / presolve.queries) : 0.0,
+                           presolve.decidedSat, presolve.decidedUnsat,
+                           presolve.residualInputNodes, presolve.residualNodes);
+            for (const analysis::smt::SmtBackendWins& entry :
+                 analysis::smt::concurrentSolveWins())
+            {
+                coretrace::log(coretrace::Level::Info, "SMT concurrent solve wins: {} = {}\n",
+                               entry.backendName, entry.wins);
+            }
+        }
+
         std::unique_ptr<OutputStrategy> outputStrategy = makeOutputStrategy(plan.outputFormat);
         const int exitCode = outputStrategy->emit(plan, results);
 
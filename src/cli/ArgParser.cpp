@@ -46,7 +46,7 @@ namespace ctrace::stack::cli
             }
 
           private:
-            static constexpr std::array<OptionCandidate, 57> kCandidates = {
+            static constexpr std::array<OptionCandidate, 67> kCandidates = {
                 {{"-h", "-h"},
                  {"--help", "--help"},
                  {"--demangle", "--demangle"},
@@ -67,6 +67,7 @@ namespace ctrace::stack::cli
                  {"--compdb-fast", "--compdb-fast"},
                  {"--analysis-profile", "--analysis-profile"},
                  {"--include-compdb-deps", "--include-compdb-deps"},
+                 {"--compdb-dedupe", "--compdb-dedupe"},
                  {"--jobs", "--jobs"},
                  {"--timing", "--timing"},
                  {"--smt", "--smt=on"},
@@ -78,6 +79,8 @@ namespace ctrace::stack::cli
                  {"--smt-timeout-ms", "--smt-timeout-ms"},
                  {"--smt-budget-nodes", "--smt-budget-nodes"},
                  {"--smt-rules", "--smt-rules"},
+                 {"--smt-cache-dir", "--smt-cache-dir"},
+                 {"--smt-capture", "--smt-capture"},
                  {"--resource-model", "--resource-model"},
                  {"--escape-model", "--escape-model"},
                  {"--buffer-model", "--buffer-model"},
@@ -85,9 +88,16 @@ namespace ctrace::stack::cli
                  {"--no-resource-cross-tu", "--no-resource-cross-tu"},
                  {"--uninitialized-cross-tu", "--uninitialized-cross-tu"},
                  {"--no-uninitialized-cross-tu", "--no-uninitialized-cross-tu"},
+                 {"--stack-cross-tu", "--stack-cross-tu"},
+                 {"--no-stack-cross-tu", "--no-stack-cross-tu"},
+                 {"--escape-cross-tu", "--escape-cross-tu"},
+                 {"--no-escape-cross-tu", "--no-escape-cross-tu"},
+                 {"--stack-usage", "--stack-usage"},
+                 {"--stack-usage-from-compdb", "--stack-usage-from-compdb"},
                  {"--resource-summary-cache-dir", "--resource-summary-cache-dir"},
                  {"--resource-summary-cache-memory-only", "--resource-summary-cache-memory-only"},
                  {"--compile-ir-cache-dir", "--compile-ir-cache-dir"},
+                 {"--compile-pch", "--compile-pch"},
                  {"--compile-ir-format", "--compile-ir-format"},
                  {"--compile-ir-format=bc", "--compile-ir-format=bc"},
                  {"--compile-ir-format=ll", "--compile-ir-format=ll"},
@@ -697,7 +707,21 @@ namespace ctrace::stack::cli
             return std::nullopt;
         }
 
-        constexpr std::array<SmtOptionSpec, 7> kSmtOptionSpecs = {{
+        SmtOptionApplyResult applySmtCacheDirOption(AnalysisConfig& cfg, const std::string& value,
+                                                    SmtOptionSource)
+        {
+            cfg.smtCacheDir = value;
+            return std::nullopt;
+        }
+
+        SmtOptionApplyResult applySmtCaptureOption(AnalysisConfig& cfg, const std::string& value,
+                                                   SmtOptionSource)
+        {
+            cfg.smtCapturePath = value;
+            return std::nullopt;
+        }
+
+        constexpr std::array<SmtOptionSpec, 9> kSmtOptionSpecs = {{
             {"smt", "--smt", &applySmtSwitchOption, false},
             {"smt-backend", "--smt-backend", &applySmtBackendOption, true},
             {"smt-secondary-backend", "--smt-secondary-backend", &applySmtSecondaryBackendOption,
@@ -706,6 +730,8 @@ namespace ctrace::stack::cli
             {"smt-timeout-ms", "--smt-timeout-ms", &applySmtTimeoutOption, true},
             {"smt-budget-nodes", "--smt-budget-nodes", &applySmtBudgetOption, true},
             {"smt-rules", "--smt-rules", &applySmtRulesOption, true},
+            {"smt-cache-dir", "--smt-cache-dir", &applySmtCacheDirOption, false},
+            {"smt-capture", "--smt-capture", &applySmtCaptureOption, false},
         }};
 
         const SmtOptionSpec* findSmtOptionByConfigKey(std::string_view key)
@@ -797,28 +823,58 @@ namespace ctrace::stack::cli
             cfg.uninitializedCrossTU = value;
         }
 
+        void setConfigStackCrossTU(AnalysisConfig& cfg, bool value)
+        {
+            cfg.stackCrossTU = value;
+        }
+
+        void setConfigEscapeCrossTU(AnalysisConfig& cfg, bool value)
+        {
+            cfg.escapeCrossTU = value;
+        }
+
+        void setConfigStackUsageFromCompdb(AnalysisConfig& cfg, bool value)
+        {
+            cfg.stackUsageFromCompdb = value;
+        }
+
         void setConfigResourceSummaryMemoryOnly(AnalysisConfig& cfg, bool value)
         {
             cfg.resourceSummaryMemoryOnly = value;
         }
 
+        void setConfigCompilePCH(AnalysisConfig& cfg, bool value)
+        {
+            cfg.compilePCH = value;
+        }
+
         void setParsedIncludeCompdbDeps(ParsedArguments& parsed, bool value)
         {
             parsed.includeCompdbDeps = value;
         }
 
-        constexpr std::array<BoolConfigSpec<AnalysisConfig>, 7> kConfigBoolSpecs = {{
+        void setParsedCompdbDedupe(ParsedArguments& parsed, bool value)
+        {
+            parsed.compdbDedupe = value;
+        }
+
+        constexpr std::array<BoolConfigSpec<AnalysisConfig>, 11> kConfigBoolSpecs = {{
             {"timing", &setConfigTiming},
             {"warnings-only", &setConfigWarningsOnly},
             {"quiet", &setConfigQuiet},
             {"demangle", &setConfigDemangle},
             {"resource-cross-tu", &setConfigResourceCrossTU},
             {"uninitialized-cross-tu", &setConfigUninitializedCrossTU},
+            {"stack-cross-tu", &setConfigStackCrossTU},
+            {"escape-cross-tu", &setConfigEscapeCrossTU},
+            {"stack-usage-from-compdb", &setConfigStackUsageFromCompdb},
             {"resource-summary-cache-memory-only", &setConfigResourceSummaryMemoryOnly},
+            {"compile-pch", &setConfigCompilePCH},
         }};
 
-        constexpr std::array<BoolConfigSpec<ParsedArguments>, 1> kParsedBoolSpecs = {{
+        constexpr std::array<BoolConfigSpec<ParsedArguments>, 2> kParsedBoolSpecs = {{
             {"include-compdb-deps", &setParsedIncludeCompdbDeps},
+            {"compdb-dedupe", &setParsedCompdbDedupe},
         }};
 
         template <typename Owner, std::size_t N>
@@ -911,6 +967,11 @@ namespace ctrace::stack::cli
                 cfg.bufferModelPath = resolveConfigRelativePath(value, configDir);
                 return true;
             }
+            if (key == "stack-usage")
+            {
+                cfg.stackUsagePaths.push_back(resolveConfigRelativePath(value, configDir));
+                return true;
+            }
             if (key == "compile-commands" || key == "compdb")
             {
                 parsed.compileCommandsPath = resolveConfigRelativePath(value, configDir);
@@ -962,6 +1023,16 @@ namespace ctrace::stack::cli
                     return false;
                 }
             }
+            if (key == "smt-cache-dir")
+            {
+                cfg.smtCacheDir = resolveConfigRelativePath(value, configDir);
+                return true;
+            }
+            if (key == "smt-capture")
+            {
+                cfg.smtCapturePath = resolveConfigRelativePath(value, configDir);
+                return true;
+            }
             if (const SmtOptionSpec* smtSpec = findSmtOptionByConfigKey(key))
             {
                 if (std::optional<std::string> localError =
@@ -1391,6 +1462,11 @@ namespace ctrace::stack::cli
                 parsed.includeCompdbDeps = true;
                 continue;
             }
+            if (argStr == "--compdb-dedupe")
+            {
+                parsed.compdbDedupe = true;
+                continue;
+            }
             {
                 std::string value;
                 std::string error;
@@ -1443,6 +1519,17 @@ namespace ctrace::stack::cli
                     continue;
                 }
             }
+            {
+                std::string value;
+                std::string error;
+                if (consumeLongOptionValue(argStr, "--stack-usage", i, argc, argv, value, error))
+                {
+                    if (!error.empty())
+                        return makeError(error);
+                    cfg.stackUsagePaths.emplace_back(std::move(value));
+                    continue;
+                }
+            }
             {
                 std::string value;
                 std::string error;
@@ -1474,6 +1561,31 @@ namespace ctrace::stack::cli
                 cfg.uninitializedCrossTU = false;
                 continue;
             }
+            if (argStr == "--stack-cross-tu")
+            {
+                cfg.stackCrossTU = true;
+                continue;
+            }
+            if (argStr == "--no-stack-cross-tu")
+            {
+                cfg.stackCrossTU = false;
+                continue;
+            }
+            if (argStr == "--escape-cross-tu")
+            {
+                cfg.escapeCrossTU = true;
+                continue;
+            }
+            if (argStr == "--no-escape-cross-tu")
+            {
+                cfg.escapeCrossTU = false;
+                continue;
+            }
+            if (argStr == "--stack-usage-from-compdb")
+            {
+                cfg.stackUsageFromCompdb = true;
+                continue;
+            }
             {
                 std::string value;
                 std::string error;
@@ -1498,6 +1610,11 @@ namespace ctrace::stack::cli
                     continue;
                 }
             }
+            if (argStr == "--compile-pch")
+            {
+                cfg.compilePCH = true;
+                continue;
+            }
             {
                 std::string value;
                 std::string error;
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: Apache-2.0
+// Callees of cross-tu-escape-use.c. cross_tu_keep captures its argument
+// (MayEscape), cross_tu_peek only reads through it (NoEscape).
+static const char* g_kept;
+
+void cross_tu_keep(const char* p)
+{
+    g_kept = p;
+}
+
+int cross_tu_peek(const char* p)
+{
+    return p[0];
+}
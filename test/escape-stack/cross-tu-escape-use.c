@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: Apache-2.0
+// Alone, both callees are opaque and the forwarders stay Unknown. Analyzed
+// with cross-tu-escape-def.c, forward_keep inherits MayEscape and
+// forward_peek short-circuits to NoEscape.
+extern void cross_tu_keep(const char* p);
+extern int cross_tu_peek(const char* p);
+
+void forward_keep(const char* p)
+{
+    cross_tu_keep(p);
+}
+
+int forward_peek(const char* p)
+{
+    return cross_tu_peek(p);
+}
+
+int cross_tu_escape_use(void)
+{
+    char buf[8] = "abc";
+    forward_keep(buf);
+    return forward_peek(buf);
+}
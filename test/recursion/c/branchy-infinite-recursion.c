@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+// Twenty reconverging branches give the base-case search about a million
+// paths. It used to run out of its state budget, answer "inconclusive" and
+// miss that neither final branch returns without recursing.
+int probe(void);
+void note(void);
+
+// at line 16, column 9
+// [ !Info! ] recursive or mutually recursive function detected
+
+// at line 16, column 9
+// [!!!Error] unconditional self recursion detected (no base case)
+// ↳ this will eventually overflow the stack at runtime
+void churn(void)
+{
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        note();
+    if (probe() < probe())
+        churn();
+    else
+        churn();
+}
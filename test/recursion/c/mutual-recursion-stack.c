@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: Apache-2.0
+// ping and pong form one call-graph SCC that exits into leaf:
+// total(ping) = total(pong) = local(ping) + local(pong)
+//                             + max( max(local(ping), local(pong)), total(leaf) )
+// total(main) = local(main) + total(ping)
+
+int leaf(int seed)
+{
+    int scratch[128] = {0};
+    scratch[0] = seed;
+    return scratch[0] + scratch[127];
+}
+
+int pong(int depth);
+
+// at line 20, column 9
+// [ !Info! ] recursive or mutually recursive function detected
+int ping(int depth)
+{
+    int frame[16] = {0};
+    frame[0] = depth;
+    if (depth <= 0)
+        return frame[0];
+    return pong(depth - 1) + frame[15];
+}
+
+// at line 31, column 9
+// [ !Info! ] recursive or mutually recursive function detected
+int pong(int depth)
+{
+    int frame[8] = {0};
+    frame[0] = depth;
+    if (depth <= 0)
+        return leaf(depth) + frame[0];
+    return ping(depth - 1) + frame[7];
+}
+
+int main(void)
+{
+    return ping(8);
+}
@@ -3,3 +3,5 @@
 
 int mtu_worker(int x);
 int mtu_entry(void);
+int mtu_deep_stack(int seed);
+int mtu_shallow_wrapper(int seed);
@@ -0,0 +1,9 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "mtu_api.h"
+
+int mtu_deep_stack(int seed)
+{
+    int frame[1024] = {0};
+    frame[0] = seed;
+    return frame[0] + frame[1023];
+}
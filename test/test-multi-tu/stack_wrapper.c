@@ -0,0 +1,7 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "mtu_api.h"
+
+int mtu_shallow_wrapper(int seed)
+{
+    return mtu_deep_stack(seed + 1);
+}
@@ -1,18 +1,46 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "StackUsageAnalyzer.hpp"
+#include "analysis/CompileCommands.hpp"
+#include "analysis/DataflowWorklist.hpp"
+#include "analysis/FileSnapshotCache.hpp"
+#include "analysis/FrameSizeTable.hpp"
 #include "analysis/InputPipeline.hpp"
+#include "analysis/ModelRegistry.hpp"
 #include "analysis/Reachability.hpp"
 #include "analysis/StackBufferAnalysis.hpp"
+#include "analysis/StackPointerEscape.hpp"
+#include "analysis/StronglyConnectedComponents.hpp"
+#include "analysis/smt/ConstraintPresolver.hpp"
+#include "analysis/smt/SmtCapture.hpp"
+#include "analysis/smt/SmtQueryCache.hpp"
+#include "analysis/smt/SolverOrchestrator.hpp"
+#ifdef CTRACE_STACK_ENABLE_Z3_BACKEND
+#include "analysis/smt/backends/Z3Backend.hpp"
+#endif
 #include "analyzer/LocationResolver.hpp"
 #include "analyzer/ModulePreparationService.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <random>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/BitVector.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
@@ -240,6 +268,1254 @@ namespace
 
         return true;
     }
+    bool testCompilationDatabaseLookup(const std::filesystem::path& repoRoot, TestReport& report)
+    {
+        (void)repoRoot;
+        std::error_code ec;
+        const std::filesystem::path root =
+            std::filesystem::temp_directory_path(ec) / "ct_compdb_lookup_unit_test";
+        std::filesystem::remove_all(root, ec);
+        std::filesystem::create_directories(root / "proj/src", ec);
+        std::filesystem::create_directories(root / "proj/lib/a", ec);
+        std::filesystem::create_directories(root / "proj/lib/b", ec);
+
+        const std::filesystem::path compdbPath = root / "proj/compile_commands.json";
+        {
+            std::ofstream out(compdbPath);
+            out << "[\n"
+                << "  {\"directory\": \"src\", \"file\": \"main.c\", "
+                << "\"arguments\": [\"clang\", \"-DMAIN\", \"-c\", \"main.c\"]},\n"
+                << "  {\"directory\": \"lib/a\", \"file\": \"util.c\", "
+                << "\"command\": \"clang -DLIB_A -c util.c -o util.o\"},\n"
+                << "  {\"directory\": \"lib/b\", \"file\": \"util.c\", "
+                << "\"command\": \"clang -DLIB_B -c util.c\"}\n"
+                << "]\n";
+        }
+
+        std::string error;
+        const auto db =
+            ctrace::stack::analysis::CompilationDatabase::loadFromFile(compdbPath.string(), error);
+        report.expect(db != nullptr, "CompilationDatabase: loads fixture database " + error);
+        if (!db)
+            return false;
+
+        report.expect(db->listSourceFiles().size() == 3,
+                      "CompilationDatabase: keeps one entry per source file");
+
+        const auto* exact = db->findCommandForFile((root / "proj/src/main.c").string());
+        report.expect(exact != nullptr && !exact->arguments.empty() &&
+                          exact->arguments.front() == "-DMAIN",
+                      "CompilationDatabase: exact lookup strips compiler token");
+        report.expect(exact != nullptr &&
+                          std::find(exact->arguments.begin(), exact->arguments.end(), "main.c") ==
+                              exact->arguments.end(),
+                      "CompilationDatabase: input file argument is stripped");
+
+        const auto* moved = db->findCommandForFile((root / "moved/src/main.c").string());
+        report.expect(moved == exact, "CompilationDatabase: unique path suffix resolves command");
+        report.expect(db->findExactCommandForFile((root / "proj/src/main.c").string()) == exact,
+                      "CompilationDatabase: exact lookup finds the listed source");
+        report.expect(db->findExactCommandForFile((root / "moved/src/main.c").string()) == nullptr,
+                      "CompilationDatabase: exact lookup ignores suffix matches");
+
+        const auto* viaDir = db->findCommandForFile((root / "other/a/util.c").string());
+        report.expect(viaDir != nullptr && !viaDir->arguments.empty() &&
+                          viaDir->arguments.front() == "-DLIB_A",
+                      "CompilationDatabase: longest suffix disambiguates same basename");
+
+        const auto* ambiguous = db->findCommandForFile((root / "other/c/util.c").string());
+        report.expect(ambiguous == nullptr,
+                      "CompilationDatabase: ambiguous suffix yields no command");
+
+        std::filesystem::remove_all(root, ec);
+        return true;
+    }
+
+    ctrace::stack::analysis::StackEscapeArgState
+    escapeArgState(const ctrace::stack::analysis::StackEscapeSummaryIndex& index,
+                   const std::string& name)
+    {
+        const auto it = index.functions.find(name);
+        if (it == index.functions.end() || it->second.args.empty())
+            return ctrace::stack::analysis::StackEscapeArgState::Unknown;
+        return it->second.args.front();
+    }
+
+    bool testStackEscapeCrossTUSummaries(const std::filesystem::path& repoRoot, TestReport& report)
+    {
+        using ctrace::stack::analysis::StackEscapeArgState;
+        using ctrace::stack::analysis::StackEscapeSummaryIndex;
+
+        const ctrace::stack::AnalysisConfig config;
+        LoadedModule defModule;
+        LoadedModule useModule;
+        std::string loadError;
+        if (!loadModuleFromSource(repoRoot / "test/escape-stack/cross-tu-escape-def.c", config,
+                                  defModule, loadError) ||
+            !loadModuleFromSource(repoRoot / "test/escape-stack/cross-tu-escape-use.c", config,
+                                  useModule, loadError))
+        {
+            report.expect(false, "StackEscape cross-TU setup: failed to load module: " + loadError);
+            return false;
+        }
+
+        auto analyzeAll = [](const llvm::Function&) { return true; };
+        const StackEscapeSummaryIndex defIndex =
+            ctrace::stack::analysis::buildStackEscapeSummaryIndex(*defModule.module, analyzeAll);
+        report.expect(escapeArgState(defIndex, "cross_tu_keep") == StackEscapeArgState::MayEscape,
+                      "StackEscape cross-TU: storing callee exports MayEscape");
+        report.expect(escapeArgState(defIndex, "cross_tu_peek") == StackEscapeArgState::NoEscape,
+                      "StackEscape cross-TU: reading callee exports NoEscape");
+
+        const StackEscapeSummaryIndex localIndex =
+            ctrace::stack::analysis::buildStackEscapeSummaryIndex(*useModule.module, analyzeAll);
+        report.expect(escapeArgState(localIndex, "forward_keep") == StackEscapeArgState::Unknown &&
+                          escapeArgState(localIndex, "forward_peek") ==
+                              StackEscapeArgState::Unknown,
+                      "StackEscape cross-TU: forwarders of opaque callees stay Unknown");
+
+        const StackEscapeSummaryIndex linkedIndex =
+            ctrace::stack::analysis::buildStackEscapeSummaryIndex(*useModule.module, analyzeAll,
+                                                                  "", &defIndex);
+        report.expect(escapeArgState(linkedIndex, "forward_keep") ==
+                          StackEscapeArgState::MayEscape,
+                      "StackEscape cross-TU: MayEscape propagates through a forwarder");
+        report.expect(escapeArgState(linkedIndex, "forward_peek") == StackEscapeArgState::NoEscape,
+                      "StackEscape cross-TU: NoEscape callee short-circuits the forwarder");
+        return true;
+    }
+
+    ctrace::stack::analysis::smt::SmtQuery makeBoundQuery(ctrace::stack::analysis::smt::SymbolId id,
+                                                          const std::string& name,
+                                                          std::int64_t bound)
+    {
+        using namespace ctrace::stack::analysis::smt;
+        SmtQuery query;
+        query.ir.symbols.push_back(SymbolInfo{.id = id, .debugName = name, .sourceToken = 0});
+        query.ir.nodes.push_back(ExprNode{.kind = ExprKind::Symbol, .symbol = id, .bitWidth = 32});
+        query.ir.nodes.push_back(
+            ExprNode{.kind = ExprKind::Constant, .constant = bound, .bitWidth = 32});
+        query.ir.nodes.push_back(
+            ExprNode{.kind = ExprKind::Ult, .bitWidth = 1, .lhs = 0, .rhs = 1});
+        query.ir.assertions.push_back(2);
+        return query;
+    }
+
+    std::size_t countLines(const std::filesystem::path& path)
+    {
+        std::ifstream in(path);
+        std::string line;
+        std::size_t count = 0;
+        while (std::getline(in, line))
+            ++count;
+        return count;
+    }
+
+    bool testSmtQueryCache(const std::filesystem::path&, TestReport& report)
+    {
+        using namespace ctrace::stack::analysis::smt;
+
+        const SolverOrchestratorConfig config;
+        const std::string key = SmtQueryCache::makeKey(makeBoundQuery(7, "x", 5), config);
+        report.expect(key == SmtQueryCache::makeKey(makeBoundQuery(99, "y", 5), config),
+                      "SmtQueryCache: alpha-renamed queries share a key");
+        const std::string otherKey = SmtQueryCache::makeKey(makeBoundQuery(7, "x", 6), config);
+        report.expect(key != otherKey, "SmtQueryCache: a different bound changes the key");
+
+        std::error_code ec;
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path(ec) / "ct_smt_query_cache_unit_test";
+        std::filesystem::remove_all(dir, ec);
+        const std::filesystem::path file =
+            dir / (std::string(SmtQueryCache::kPersistentSchema) + ".txt");
+
+        std::string error;
+        {
+            SmtQueryCache cache;
+            report.expect(cache.loadPersistent(dir.string(), error),
+                          "SmtQueryCache: creates the cache directory " + error);
+            cache.store(key, SmtDecision{.answers = {}, .status = SmtStatus::Unsat});
+            cache.store(otherKey, SmtDecision{.answers = {}, .status = SmtStatus::Timeout});
+
+            const std::optional<SmtDecision> hit = cache.lookup(key);
+            report.expect(hit && hit->status == SmtStatus::Unsat,
+                          "SmtQueryCache: stored Unsat decision is a hit");
+            report.expect(!cache.lookup(otherKey), "SmtQueryCache: timeouts are not cached");
+            const SmtQueryCacheStats stats = cache.stats();
+            report.expect(stats.lookups == 2 && stats.hits == 1,
+                          "SmtQueryCache: counts lookups and hits");
+            report.expect(cache.flushPersistent(error) && countLines(file) == 1,
+                          "SmtQueryCache: flush appends the new decision " + error);
+        }
+
+        // A torn line, a foreign line and a duplicate are all skipped on load.
+        {
+            std::ofstream out(file, std::ios::app);
+            out << key.substr(0, 10) << "\n" << "not a cache line\n" << key << " u\n";
+        }
+
+        {
+            SmtQueryCache cache;
+            report.expect(cache.loadPersistent(dir.string(), error) &&
+                              cache.stats().persistentEntries == 1,
+                          "SmtQueryCache: reload keeps only well-formed distinct entries");
+            const std::optional<SmtDecision> hit = cache.lookup(key);
+            report.expect(hit && hit->status == SmtStatus::Unsat,
+                          "SmtQueryCache: decision survives the on-disk round trip");
+
+            cache.store(otherKey, SmtDecision{.answers = {}, .status = SmtStatus::Sat});
+            report.expect(cache.flushPersistent(error) && countLines(file) == 2,
+                          "SmtQueryCache: flush compacts a file with more waste than entries");
+        }
+
+        std::filesystem::remove_all(dir, ec);
+        return true;
+    }
+
+    bool testPortfolioRaceIsDeterministic(const std::filesystem::path&, TestReport& report)
+    {
+        using namespace ctrace::stack::analysis::smt;
+
+        // x * x == 2 over 32 bits: no square is 2 mod 4, so an exact backend
+        // answers Unsat, which the presolver cannot see, while the interval
+        // backend has no bound to refute and answers an inexact Sat.
+        SmtQuery query;
+        query.ir.symbols.push_back(SymbolInfo{.id = 1, .debugName = "x", .sourceToken = 0});
+        query.ir.nodes.push_back(ExprNode{.kind = ExprKind::Symbol, .symbol = 1, .bitWidth = 32});
+        query.ir.nodes.push_back(
+            ExprNode{.kind = ExprKind::Mul, .bitWidth = 32, .lhs = 0, .rhs = 0});
+        query.ir.nodes.push_back(
+            ExprNode{.kind = ExprKind::Constant, .constant = 2, .bitWidth = 32});
+        query.ir.nodes.push_back(ExprNode{.kind = ExprKind::Eq, .bitWidth = 1, .lhs = 1, .rhs = 2});
+        query.ir.assertions.push_back(3);
+        query.timeoutMs = 5000;
+        // Redundant bounds keep the interval backend busy past z3's answer,
+        // where a race that cancelled it would report Unsat instead.
+        for (int i = 0; i < 200000; ++i)
+            query.ir.intervals.push_back(
+                IntervalConstraint{.symbol = 1, .lower = 0, .upper = 0, .hasLower = true});
+
+        const SolverOrchestrator orchestrator(SolverOrchestratorConfig{
+            .primaryBackend = "z3", .mode = SolverMode::Portfolio, .workerThreads = 2});
+        const SmtStatus first = orchestrator.solve(query).status;
+        bool stable = true;
+        for (int run = 0; run < 64 && stable; ++run)
+            stable = orchestrator.solve(query).status == first;
+        report.expect(stable, "SolverOrchestrator: portfolio z3+interval status is stable");
+#ifdef CTRACE_STACK_ENABLE_Z3_BACKEND
+        report.expect(first == SmtStatus::Unknown,
+                      "SolverOrchestrator: exact Unsat and inexact Sat aggregate to Unknown");
+#endif
+        return true;
+    }
+
+    namespace smt = ctrace::stack::analysis::smt;
+
+    struct ConstraintBuilder
+    {
+        smt::ConstraintIR ir;
+
+        smt::ExprId add(const smt::ExprNode& node)
+        {
+            ir.nodes.push_back(node);
+            return static_cast<smt::ExprId>(ir.nodes.size() - 1);
+        }
+
+        smt::ExprId symbol(smt::SymbolId id, std::uint32_t width)
+        {
+            return add(
+                smt::ExprNode{.kind = smt::ExprKind::Symbol, .symbol = id, .bitWidth = width});
+        }
+
+        smt::ExprId constant(std::int64_t value, std::uint32_t width)
+        {
+            return add(smt::ExprNode{
+                .kind = smt::ExprKind::Constant, .constant = value, .bitWidth = width});
+        }
+
+        smt::ExprId binary(smt::ExprKind kind, smt::ExprId lhs, smt::ExprId rhs,
+                           std::uint32_t width = 1)
+        {
+            return add(smt::ExprNode{.kind = kind, .bitWidth = width, .lhs = lhs, .rhs = rhs});
+        }
+
+        smt::ExprId unary(smt::ExprKind kind, smt::ExprId operand, std::uint32_t width = 1)
+        {
+            return add(smt::ExprNode{.kind = kind, .bitWidth = width, .lhs = operand});
+        }
+
+        smt::ExprId ite(smt::ExprId cond, smt::ExprId onTrue, smt::ExprId onFalse,
+                        std::uint32_t width)
+        {
+            return add(smt::ExprNode{.kind = smt::ExprKind::Ite,
+                                     .bitWidth = width,
+                                     .lhs = cond,
+                                     .rhs = onTrue,
+                                     .extra = onFalse});
+        }
+
+        void require(smt::ExprId assertion)
+        {
+            ir.assertions.push_back(assertion);
+        }
+    };
+
+    // The Z3 backend's semantics on one assignment; booleans are 1-bit.
+    llvm::APInt evaluateNode(const smt::ConstraintIR& ir, smt::ExprId id,
+                             const std::map<smt::SymbolId, llvm::APInt>& env)
+    {
+        using smt::ExprKind;
+        const smt::ExprNode& node = ir.nodes[id];
+        const std::uint32_t width = node.bitWidth == 0 ? 1 : node.bitWidth;
+        auto operand = [&](smt::ExprId operandId) { return evaluateNode(ir, operandId, env); };
+        auto truth = [](bool value) { return llvm::APInt(1, value ? 1 : 0); };
+
+        switch (node.kind)
+        {
+        case ExprKind::Symbol:
+            return env.at(node.symbol);
+        case ExprKind::Constant:
+            return llvm::APInt(64, static_cast<std::uint64_t>(node.constant)).zextOrTrunc(width);
+        case ExprKind::Ite:
+            return operand(node.lhs).getBoolValue() ? operand(node.rhs) : operand(node.extra);
+        case ExprKind::Not:
+            return truth(!operand(node.lhs).getBoolValue());
+        case ExprKind::ZExt:
+            return operand(node.lhs).zextOrTrunc(width);
+        case ExprKind::SExt:
+            return operand(node.lhs).sextOrTrunc(width);
+        case ExprKind::Trunc:
+            return operand(node.lhs).trunc(width);
+        default:
+            break;
+        }
+
+        const llvm::APInt l = operand(node.lhs);
+        const llvm::APInt r = operand(node.rhs);
+        switch (node.kind)
+        {
+        case ExprKind::Add:
+            return l + r;
+        case ExprKind::Sub:
+            return l - r;
+        case ExprKind::Mul:
+            return l * r;
+        case ExprKind::Shl:
+            return l.shl(r);
+        case ExprKind::LShr:
+            return l.lshr(r);
+        case ExprKind::AShr:
+            return l.ashr(r);
+        case ExprKind::Eq:
+            return truth(l == r);
+        case ExprKind::Ne:
+            return truth(l != r);
+        case ExprKind::Ult:
+            return truth(l.ult(r));
+        case ExprKind::Ule:
+            return truth(l.ule(r));
+        case ExprKind::Ugt:
+            return truth(l.ugt(r));
+        case ExprKind::Uge:
+            return truth(l.uge(r));
+        case ExprKind::Slt:
+            return truth(l.slt(r));
+        case ExprKind::Sle:
+            return truth(l.sle(r));
+        case ExprKind::Sgt:
+            return truth(l.sgt(r));
+        case ExprKind::Sge:
+            return truth(l.sge(r));
+        case ExprKind::And:
+            return truth(l.getBoolValue() && r.getBoolValue());
+        default:
+            return truth(l.getBoolValue() || r.getBoolValue());
+        }
+    }
+
+    // Exhaustive satisfiability over two 4-bit symbols (ids 1 and 2).
+    bool satisfiableOver4Bits(const smt::ConstraintIR& ir)
+    {
+        for (std::uint64_t x = 0; x < 16; ++x)
+        {
+            for (std::uint64_t y = 0; y < 16; ++y)
+            {
+                const std::map<smt::SymbolId, llvm::APInt> env = {{1, llvm::APInt(4, x)},
+                                                                  {2, llvm::APInt(4, y)}};
+                if (std::all_of(ir.assertions.begin(), ir.assertions.end(),
+                                [&](smt::ExprId assertion)
+                                { return evaluateNode(ir, assertion, env).getBoolValue(); }))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    // Well-sorted random queries over two 4-bit symbols, biased towards
+    // comparisons with constants so that bound propagation gets exercised.
+    class RandomConstraintGenerator
+    {
+      public:
+        explicit RandomConstraintGenerator(unsigned seed) : rng(seed) {}
+
+        smt::ConstraintIR next()
+        {
+            builder = ConstraintBuilder{};
+            x = builder.symbol(1, 4);
+            y = builder.symbol(2, 4);
+            const unsigned count = 1 + pick(3);
+            for (unsigned i = 0; i < count; ++i)
+                builder.require(boolean(3));
+            return std::move(builder.ir);
+        }
+
+      private:
+        unsigned pick(unsigned count)
+        {
+            return std::uniform_int_distribution<unsigned>(0, count - 1)(rng);
+        }
+
+        smt::ExprId bitVector(unsigned depth)
+        {
+            using smt::ExprKind;
+            static constexpr ExprKind kArithmetic[] = {ExprKind::Add, ExprKind::Sub,
+                                                       ExprKind::Mul, ExprKind::Shl,
+                                                       ExprKind::LShr, ExprKind::AShr};
+            switch (depth == 0 ? pick(2) : pick(5))
+            {
+            case 0:
+                return pick(2) ? x : y;
+            case 1:
+                return builder.constant(static_cast<std::int64_t>(pick(24)) - 8, 4);
+            case 2:
+                return builder.binary(kArithmetic[pick(6)], bitVector(depth - 1),
+                                      bitVector(depth - 1), 4);
+            case 3:
+                return builder.ite(boolean(depth - 1), bitVector(depth - 1), bitVector(depth - 1),
+                                   4);
+            default:
+            {
+                const smt::ExprId wide = builder.unary(
+                    pick(2) ? ExprKind::ZExt : ExprKind::SExt, bitVector(depth - 1), 8);
+                const smt::ExprId sum =
+                    builder.binary(pick(2) ? ExprKind::Add : ExprKind::Sub, wide,
+                                   builder.constant(static_cast<std::int64_t>(pick(256)), 8), 8);
+                return builder.unary(ExprKind::Trunc, sum, 4);
+            }
+            }
+        }
+
+        smt::ExprId boolean(unsigned depth)
+        {
+            using smt::ExprKind;
+            static constexpr ExprKind kComparisons[] = {
+                ExprKind::Eq,  ExprKind::Ne,  ExprKind::Ult, ExprKind::Ule, ExprKind::Ugt,
+                ExprKind::Uge, ExprKind::Slt, ExprKind::Sle, ExprKind::Sgt, ExprKind::Sge};
+            const unsigned operandDepth = depth == 0 ? 0 : depth - 1;
+            switch (depth == 0 ? 0 : pick(4))
+            {
+            case 1:
+                return builder.binary(pick(2) ? ExprKind::And : ExprKind::Or,
+                                      boolean(depth - 1), boolean(depth - 1));
+            case 2:
+                return builder.unary(ExprKind::Not, boolean(depth - 1));
+            default:
+            {
+                const smt::ExprId lhs = bitVector(operandDepth);
+                const smt::ExprId rhs = pick(2)
+                                            ? builder.constant(
+                                                  static_cast<std::int64_t>(pick(24)) - 8, 4)
+                                            : bitVector(operandDepth);
+                return builder.binary(kComparisons[pick(10)], lhs, rhs);
+            }
+            }
+        }
+
+        std::mt19937 rng;
+        ConstraintBuilder builder;
+        smt::ExprId x = 0;
+        smt::ExprId y = 0;
+    };
+
+    bool testConstraintPresolver(const std::filesystem::path&, TestReport& report)
+    {
+        using smt::ExprKind;
+        using smt::PresolveOutcome;
+
+        {
+            // (2^63 - 1) + 1 == 2^63 is exact at 65 bits, not a wrap.
+            constexpr std::int64_t kMax = std::numeric_limits<std::int64_t>::max();
+            constexpr std::int64_t kMin = std::numeric_limits<std::int64_t>::min();
+            ConstraintBuilder b;
+            const smt::ExprId sum =
+                b.binary(ExprKind::Add, b.constant(kMax, 65), b.constant(1, 65), 65);
+            b.require(b.binary(ExprKind::Eq, sum, b.constant(kMin, 65)));
+            report.expect(smt::presolveConstraints(b.ir).outcome == PresolveOutcome::Sat,
+                          "ConstraintPresolver: folds 65-bit constants without wrapping");
+        }
+        {
+            // 2^64 does not fit an ExprNode constant: the sum must stay symbolic.
+            ConstraintBuilder b;
+            const smt::ExprId sum =
+                b.binary(ExprKind::Add, b.constant(-1, 65), b.constant(1, 65), 65);
+            b.require(b.binary(ExprKind::Eq, sum, b.constant(0, 65)));
+            const smt::PresolveResult result = smt::presolveConstraints(b.ir);
+            report.expect(result.outcome == PresolveOutcome::Residual && result.residual,
+                          "ConstraintPresolver: keeps 65-bit results wider than 64 bits");
+        }
+        {
+            ConstraintBuilder b;
+            const smt::ExprId x = b.symbol(1, 32);
+            const smt::ExprId yes =
+                b.binary(ExprKind::Eq, b.constant(3, 32), b.constant(3, 32));
+            const smt::ExprId picked = b.ite(yes, x, b.constant(7, 32), 32);
+            b.require(b.binary(ExprKind::Ult, picked, b.constant(10, 32)));
+            const smt::PresolveResult result = smt::presolveConstraints(b.ir);
+            report.expect(result.outcome == PresolveOutcome::Residual && result.residual &&
+                              std::none_of(result.residual->nodes.begin(),
+                                           result.residual->nodes.end(),
+                                           [](const smt::ExprNode& node)
+                                           { return node.kind == ExprKind::Ite; }),
+                          "ConstraintPresolver: Ite with a constant condition selects a branch");
+
+            ConstraintBuilder refuted;
+            const smt::ExprId no =
+                refuted.binary(ExprKind::Ne, refuted.constant(3, 32), refuted.constant(3, 32));
+            const smt::ExprId value =
+                refuted.ite(no, refuted.symbol(1, 32), refuted.constant(7, 32), 32);
+            refuted.require(refuted.binary(ExprKind::Ult, value, refuted.constant(5, 32)));
+            report.expect(smt::presolveConstraints(refuted.ir).outcome == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: folds Ite over a constant false condition");
+        }
+        {
+            // 0 <= x <= 10 makes x + 5 <= 15 and x - 3 <= 7.
+            auto boundedQuery = [](ExprKind kind, std::int64_t k, std::int64_t limit)
+            {
+                ConstraintBuilder b;
+                const smt::ExprId x = b.symbol(1, 32);
+                b.require(b.binary(ExprKind::Sge, x, b.constant(0, 32)));
+                b.require(b.binary(ExprKind::Sle, x, b.constant(10, 32)));
+                const smt::ExprId shifted = b.binary(kind, x, b.constant(k, 32), 32);
+                b.require(b.binary(ExprKind::Sgt, shifted, b.constant(limit, 32)));
+                return smt::presolveConstraints(b.ir).outcome;
+            };
+            report.expect(boundedQuery(ExprKind::Add, 5, 20) == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: Add propagates bounds to refute");
+            report.expect(boundedQuery(ExprKind::Sub, 3, 7) == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: Sub propagates bounds to refute");
+            report.expect(boundedQuery(ExprKind::Add, 5, 12) == PresolveOutcome::Residual,
+                          "ConstraintPresolver: reachable bound stays for the backend");
+
+            // 100 <= x (8 bits) lets x + 100 wrap negative: no refutation.
+            ConstraintBuilder wrap;
+            const smt::ExprId x = wrap.symbol(1, 8);
+            wrap.require(wrap.binary(ExprKind::Sge, x, wrap.constant(100, 8)));
+            const smt::ExprId sum = wrap.binary(ExprKind::Add, x, wrap.constant(100, 8), 8);
+            wrap.require(wrap.binary(ExprKind::Slt, sum, wrap.constant(0, 8)));
+            report.expect(smt::presolveConstraints(wrap.ir).outcome == PresolveOutcome::Residual,
+                          "ConstraintPresolver: a wrapping Add is not bounded");
+        }
+        {
+            ConstraintBuilder b;
+            const smt::ExprId x = b.symbol(1, 32);
+            b.require(b.binary(ExprKind::Sgt, x, b.constant(10, 32)));
+            b.require(b.binary(ExprKind::Slt, x, b.constant(5, 32)));
+            report.expect(smt::presolveConstraints(b.ir).outcome == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: disjoint bounds refute the query");
+
+            ConstraintBuilder pinned;
+            const smt::ExprId v = pinned.symbol(1, 32);
+            pinned.require(pinned.binary(ExprKind::Sge, v, pinned.constant(3, 32)));
+            pinned.require(pinned.binary(ExprKind::Sle, v, pinned.constant(3, 32)));
+            pinned.require(pinned.binary(ExprKind::Ne, v, pinned.constant(3, 32)));
+            report.expect(smt::presolveConstraints(pinned.ir).outcome == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: disequality empties a pinned bound");
+        }
+        {
+            // Symbols sharing a debug name are one solver constant.
+            auto intervalQuery = [](const std::string& secondName)
+            {
+                ConstraintBuilder b;
+                b.ir.symbols = {
+                    smt::SymbolInfo{.id = 1, .debugName = "n", .sourceToken = 0},
+                    smt::SymbolInfo{.id = 2, .debugName = secondName, .sourceToken = 0}};
+                b.symbol(1, 32);
+                b.symbol(2, 32);
+                b.ir.intervals = {smt::IntervalConstraint{.symbol = 1,
+                                                          .lower = 0,
+                                                          .upper = 5,
+                                                          .hasLower = true,
+                                                          .hasUpper = true},
+                                  smt::IntervalConstraint{.symbol = 2,
+                                                          .lower = 10,
+                                                          .upper = 20,
+                                                          .hasLower = true,
+                                                          .hasUpper = true}};
+                return smt::presolveConstraints(b.ir).outcome;
+            };
+            report.expect(intervalQuery("n") == PresolveOutcome::Unsat,
+                          "ConstraintPresolver: homonym intervals intersect");
+            report.expect(intervalQuery("m") == PresolveOutcome::Sat,
+                          "ConstraintPresolver: distinct symbols keep their intervals");
+        }
+        {
+            auto dispatchedUnchanged = [](const smt::ConstraintIR& ir)
+            {
+                const smt::PresolveResult result = smt::presolveConstraints(ir);
+                return result.outcome == PresolveOutcome::Residual && !result.residual;
+            };
+            ConstraintBuilder dangling;
+            dangling.require(42);
+            ConstraintBuilder anonymous;
+            anonymous.require(anonymous.binary(ExprKind::Eq, anonymous.symbol(0, 32),
+                                               anonymous.constant(1, 32)));
+            ConstraintBuilder mixed;
+            mixed.require(
+                mixed.binary(ExprKind::Eq, mixed.symbol(1, 8), mixed.constant(1, 16)));
+            report.expect(dispatchedUnchanged(dangling.ir) && dispatchedUnchanged(anonymous.ir) &&
+                              dispatchedUnchanged(mixed.ir),
+                          "ConstraintPresolver: malformed IR is dispatched unchanged");
+        }
+
+        // Every decision and residual must agree with exhaustive evaluation.
+        RandomConstraintGenerator generator(20240601);
+        int mismatches = 0;
+        int decided = 0;
+        constexpr int kRandomQueries = 3000;
+        for (int i = 0; i < kRandomQueries; ++i)
+        {
+            const smt::ConstraintIR ir = generator.next();
+            const bool expected = satisfiableOver4Bits(ir);
+            const smt::PresolveResult result = smt::presolveConstraints(ir);
+            bool agrees = true;
+            switch (result.outcome)
+            {
+            case PresolveOutcome::Sat:
+            case PresolveOutcome::Unsat:
+                ++decided;
+                agrees = expected == (result.outcome == PresolveOutcome::Sat);
+                break;
+            case PresolveOutcome::Residual:
+                agrees = !result.residual || satisfiableOver4Bits(*result.residual) == expected;
+                break;
+            }
+            if (!agrees && mismatches++ == 0)
+                std::cerr << "ConstraintPresolver: random query #" << i << " disagrees\n";
+        }
+        report.expect(mismatches == 0 && decided > 0,
+                      "ConstraintPresolver: random 4-bit queries agree with exhaustive "
+                      "evaluation");
+        return true;
+    }
+
+    bool testSmtCaptureRoundTrip(const std::filesystem::path&, TestReport& report)
+    {
+        using smt::ExprKind;
+
+        ConstraintBuilder b;
+        b.ir.symbols = {
+            smt::SymbolInfo{.id = 7, .debugName = "len with space:1", .sourceToken = 0},
+            smt::SymbolInfo{.id = 9, .debugName = "", .sourceToken = 0}};
+        const smt::ExprId len = b.symbol(7, 64);
+        const smt::ExprId bound = b.constant(-3, 64);
+        b.require(b.binary(ExprKind::Slt, len, bound));
+        b.ir.intervals = {smt::IntervalConstraint{.symbol = 7, .lower = -5, .hasLower = true}};
+        b.ir.entryCondition = 2;
+        const smt::SmtQuery query{
+            .ir = b.ir, .ruleId = "stack-buffer", .budgetNodes = 123, .timeoutMs = 45};
+
+        std::error_code ec;
+        const std::filesystem::path file =
+            std::filesystem::temp_directory_path(ec) / "ct_smt_capture_unit_test.txt";
+        auto writeCapture = [&](const std::string& body)
+        {
+            std::ofstream out(file, std::ios::binary | std::ios::trunc);
+            out << smt::kSmtCaptureSchema << "\n" << body;
+        };
+        const std::string record =
+            smt::serializeSmtCaptureRecord(query, smt::SmtStatus::Unsat, 1500);
+
+        writeCapture(record + "\n" + record);
+        std::vector<smt::SmtCaptureRecord> records;
+        std::string error;
+        const bool loaded = smt::readSmtCaptureFile(file.string(), records, error);
+        report.expect(loaded && records.size() == 2,
+                      "SmtCapture: reads back every record " + error);
+        if (loaded && !records.empty())
+        {
+            const smt::SmtCaptureRecord& back = records.front();
+            const smt::ConstraintIR& ir = back.query.ir;
+            report.expect(back.status == smt::SmtStatus::Unsat && back.elapsedMicros == 1500 &&
+                              back.query.ruleId == "stack-buffer" &&
+                              back.query.budgetNodes == 123 && back.query.timeoutMs == 45,
+                          "SmtCapture: round-trips the record header");
+            report.expect(ir.symbols.size() == 2 && ir.symbols[0].debugName == "len with space:1" &&
+                              ir.symbols[1].id == 9 && ir.symbols[1].debugName.empty() &&
+                              ir.nodes.size() == 3 && ir.nodes[1].constant == -3 &&
+                              ir.nodes[2].kind == ExprKind::Slt &&
+                              ir.assertions == b.ir.assertions &&
+                              ir.intervals.size() == 1 && ir.intervals[0].lower == -5 &&
+                              ir.intervals[0].hasLower && !ir.intervals[0].hasUpper &&
+                              ir.entryCondition == std::optional<smt::ExprId>(2),
+                          "SmtCapture: round-trips the constraint IR");
+        }
+
+        // Truncated lines and counts larger than the line fail cleanly.
+        const std::string corruptRecords[] = {
+            record.substr(0, record.size() / 2) + "\n", "sat 1 1 1 0: S 99999999999\n",
+            "sat 1 1 1 99999999999:x S 0 N 0 A 0 I 0 E -\n"};
+        for (const std::string& corrupt : corruptRecords)
+        {
+            writeCapture(record + corrupt);
+            records.clear();
+            error.clear();
+            report.expect(!smt::readSmtCaptureFile(file.string(), records, error) &&
+                              error.find("record 2") != std::string::npos,
+                          "SmtCapture: rejects a corrupt record without desync");
+        }
+
+        std::filesystem::remove(file, ec);
+        return true;
+    }
+
+#ifdef CTRACE_STACK_ENABLE_Z3_BACKEND
+    bool testZ3SessionReuse(const std::filesystem::path&, TestReport& report)
+    {
+        using smt::ExprKind;
+        using smt::SmtStatus;
+
+        const smt::Z3Backend backend;
+        // One `x <kind> value` assertion per bound, over the 16-bit symbol x.
+        auto makeQuery = [](const std::vector<std::pair<ExprKind, std::int64_t>>& bounds,
+                            std::uint32_t timeoutMs)
+        {
+            ConstraintBuilder b;
+            const smt::ExprId x = b.symbol(1, 16);
+            for (const auto& [kind, value] : bounds)
+                b.require(b.binary(kind, x, b.constant(value, 16)));
+            return smt::SmtQuery{
+                .ir = std::move(b.ir), .ruleId = "z3-session", .timeoutMs = timeoutMs};
+        };
+        auto solve = [&](const smt::SmtQuery& query)
+        { return backend.solve(query, nullptr).status; };
+        auto stats = [] { return smt::Z3Backend::threadSessionStats(); };
+
+        const smt::SmtQuery window = makeQuery({{ExprKind::Ugt, 2}, {ExprKind::Ult, 5}}, 50);
+        const smt::SmtQuery disjoint = makeQuery({{ExprKind::Ult, 5}, {ExprKind::Ugt, 7}}, 50);
+
+        // Guard literals are keyed by constraint, not by query.
+        const bool firstSat = solve(window) == SmtStatus::Sat;
+        const smt::Z3SessionStats afterFirst = stats();
+        const bool repeatSat = solve(window) == SmtStatus::Sat;
+        const smt::Z3SessionStats afterRepeat = stats();
+        report.expect(firstSat && repeatSat &&
+                          afterRepeat.guardsCreated == afterFirst.guardsCreated &&
+                          afterRepeat.trackedConstraints == afterFirst.trackedConstraints,
+                      "Z3Backend: a repeated query reuses its guard literals");
+        const bool disjointUnsat = solve(disjoint) == SmtStatus::Unsat;
+        report.expect(disjointUnsat && stats().guardsCreated == afterRepeat.guardsCreated + 1,
+                      "Z3Backend: a constraint shared across queries keeps its guard");
+        report.expect(solve(window) == SmtStatus::Sat,
+                      "Z3Backend: guards of other queries stay unassumed");
+
+        // Each query tracks one fresh `x != k`; the cap clears the solver, not the context.
+        const smt::Z3SessionStats beforeCap = stats();
+        std::uint64_t peakTracked = 0;
+        bool capAnswersSat = true;
+        bool resetSeen = false;
+        for (std::int64_t k = 100; k < 1200 && !resetSeen; ++k)
+        {
+            if (solve(makeQuery({{ExprKind::Ne, k}}, 50)) != SmtStatus::Sat)
+                capAnswersSat = false;
+            const smt::Z3SessionStats current = stats();
+            peakTracked = std::max(peakTracked, current.trackedConstraints);
+            resetSeen = current.solverResets > beforeCap.solverResets;
+        }
+        const smt::Z3SessionStats afterCap = stats();
+        report.expect(resetSeen && peakTracked <= 1024 && afterCap.trackedConstraints == 1,
+                      "Z3Backend: the session drops its guards at the 1024-guard cap");
+        report.expect(capAnswersSat && afterCap.contextsCreated == beforeCap.contextsCreated &&
+                          solve(window) == SmtStatus::Sat &&
+                          solve(disjoint) == SmtStatus::Unsat,
+                      "Z3Backend: answers stay exact across the cap reset");
+
+        // A reused session applies each query's timeout; 0 restores "no timeout".
+        const smt::Z3SessionStats beforeTimeouts = stats();
+        const bool shortSat =
+            solve(makeQuery({{ExprKind::Ugt, 2}, {ExprKind::Ult, 5}}, 20)) == SmtStatus::Sat;
+        const smt::Z3SessionStats afterShort = stats();
+        const bool unboundedSat =
+            solve(makeQuery({{ExprKind::Ugt, 2}, {ExprKind::Ult, 5}}, 0)) == SmtStatus::Sat;
+        const smt::Z3SessionStats afterUnbounded = stats();
+        report.expect(shortSat && unboundedSat &&
+                          afterShort.appliedTimeoutMs == std::optional<std::uint32_t>(20) &&
+                          afterUnbounded.appliedTimeoutMs == std::optional<std::uint32_t>(0),
+                      "Z3Backend: a reused session applies each query's timeout");
+        report.expect(afterUnbounded.contextsCreated == beforeTimeouts.contextsCreated &&
+                          afterUnbounded.solverResets == beforeTimeouts.solverResets &&
+                          afterUnbounded.guardsCreated == beforeTimeouts.guardsCreated,
+                      "Z3Backend: a timeout change keeps the session and its guards");
+        return true;
+    }
+#endif
+
+    bool testStronglyConnectedComponents(const std::filesystem::path&, TestReport& report)
+    {
+        namespace analysis = ctrace::stack::analysis;
+        using Graph = std::vector<std::vector<std::uint32_t>>;
+
+        // Emission order per node, and whether every cross-component edge
+        // points at an earlier component.
+        auto decompose = [](const Graph& graph, std::vector<std::uint32_t>& componentOf)
+        {
+            componentOf.assign(graph.size(), std::numeric_limits<std::uint32_t>::max());
+            std::uint32_t next = 0;
+            analysis::forEachStronglyConnectedComponent(
+                static_cast<std::uint32_t>(graph.size()),
+                [&](std::uint32_t v) -> const std::vector<std::uint32_t>& { return graph[v]; },
+                [&](std::span<const std::uint32_t> members)
+                {
+                    for (const std::uint32_t v : members)
+                        componentOf[v] = next;
+                    ++next;
+                });
+            bool successorsFirst = true;
+            for (std::uint32_t v = 0; v < graph.size(); ++v)
+            {
+                for (const std::uint32_t w : graph[v])
+                    successorsFirst = successorsFirst && componentOf[w] <= componentOf[v];
+            }
+            return successorsFirst;
+        };
+
+        std::mt19937 rng(20240715);
+        std::size_t mismatches = 0;
+        for (int round = 0; round < 300; ++round)
+        {
+            const std::uint32_t n = 1 + rng() % 24;
+            Graph graph(n);
+            const std::uint32_t edges = rng() % (3 * n);
+            for (std::uint32_t e = 0; e < edges; ++e)
+                graph[rng() % n].push_back(rng() % n);
+
+            std::vector<std::vector<char>> reach(n, std::vector<char>(n, 0));
+            for (std::uint32_t v = 0; v < n; ++v)
+            {
+                reach[v][v] = 1;
+                for (const std::uint32_t w : graph[v])
+                    reach[v][w] = 1;
+            }
+            for (std::uint32_t k = 0; k < n; ++k)
+                for (std::uint32_t i = 0; i < n; ++i)
+                    for (std::uint32_t j = 0; j < n; ++j)
+                        reach[i][j] = reach[i][j] || (reach[i][k] && reach[k][j]);
+
+            std::vector<std::uint32_t> componentOf;
+            bool agrees = decompose(graph, componentOf);
+            for (std::uint32_t i = 0; i < n; ++i)
+                for (std::uint32_t j = 0; j < n; ++j)
+                    agrees = agrees && ((componentOf[i] == componentOf[j]) ==
+                                        (reach[i][j] && reach[j][i]));
+            mismatches += agrees ? 0 : 1;
+        }
+        report.expect(mismatches == 0,
+                      "SCC: random graphs match mutual reachability, successors first");
+
+        // A recursive walk would need one native frame per node here.
+        constexpr std::uint32_t kChain = 1000000;
+        Graph chain(kChain);
+        for (std::uint32_t v = 0; v + 1 < kChain; ++v)
+            chain[v].push_back(v + 1);
+        std::vector<std::uint32_t> componentOf;
+        report.expect(decompose(chain, componentOf) && componentOf.front() == kChain - 1 &&
+                          componentOf.back() == 0,
+                      "SCC: a million-deep chain comes out callees first");
+        chain.back().push_back(0);
+        decompose(chain, componentOf);
+        report.expect(std::all_of(componentOf.begin(), componentOf.end(),
+                                  [](std::uint32_t c) { return c == 0; }),
+                      "SCC: a million-deep cycle is a single component");
+
+        // Skipped nodes are neither roots nor edge targets.
+        const Graph cycle = {{1}, {2}, {0}};
+        std::vector<std::vector<std::uint32_t>> components;
+        analysis::forEachStronglyConnectedComponent(
+            3, [&](std::uint32_t v) -> const std::vector<std::uint32_t>& { return cycle[v]; },
+            [](std::uint32_t v) { return v == 1; },
+            [&](std::span<const std::uint32_t> members)
+            { components.emplace_back(members.begin(), members.end()); });
+        report.expect(components == std::vector<std::vector<std::uint32_t>>{{0}, {2}},
+                      "SCC: skipped nodes break the cycle they were on");
+        return true;
+    }
+    bool testFrameSizeParsing(const std::filesystem::path&, TestReport& report)
+    {
+        namespace analysis = ctrace::stack::analysis;
+
+        std::string_view file;
+        std::string_view rest;
+        unsigned line = 0;
+        report.expect(analysis::splitLocation("C:\\src\\a.cc:12:5:ns::f(int)", file, line, rest) &&
+                          file == "C:\\src\\a.cc" && line == 12 && rest == "ns::f(int)",
+                      "FrameSizeTable: location split skips the drive letter and the column");
+        report.expect(analysis::splitLocation("a.c:7:compute", file, line, rest) &&
+                          file == "a.c" && line == 7 && rest == "compute",
+                      "FrameSizeTable: location split without a column");
+        report.expect(!analysis::splitLocation("compute", file, line, rest) &&
+                          !analysis::splitLocation(":12:compute", file, line, rest),
+                      "FrameSizeTable: no location prefix is reported as such");
+
+        analysis::FrameSizeEntry gcc;
+        report.expect(analysis::parseStackUsageLine(
+                          "/tmp/build/widget.cc:42:6:void ns::Widget<int>::draw(int) const"
+                          "\t96\tstatic",
+                          gcc) &&
+                          gcc.file == "widget.cc" && gcc.line == 42 &&
+                          gcc.name == "void ns::Widget<int>::draw(int) const" &&
+                          gcc.bytes == 96 && !gcc.dynamic && !gcc.bounded,
+                      "FrameSizeTable: GCC line with a printable C++ name");
+
+        analysis::FrameSizeEntry clang;
+        report.expect(analysis::parseStackUsageLine("widget.c:9:_Z4drawi\t48\tdynamic,bounded",
+                                                    clang) &&
+                          clang.file == "widget.c" && clang.line == 9 &&
+                          clang.name == "_Z4drawi" && clang.bytes == 48 && clang.dynamic &&
+                          clang.bounded,
+                      "FrameSizeTable: clang line with a bounded dynamic frame");
+
+        analysis::FrameSizeEntry bare;
+        report.expect(analysis::parseStackUsageLine("compute\t16\tdynamic", bare) &&
+                          bare.file.empty() && bare.line == 0 && bare.name == "compute" &&
+                          bare.bytes == 16 && bare.dynamic && !bare.bounded,
+                      "FrameSizeTable: line without debug locations");
+
+        analysis::FrameSizeEntry windows;
+        report.expect(analysis::parseStackUsageLine("C:\\work\\main.c:3:5:main\t64\tstatic",
+                                                    windows) &&
+                          windows.file == "main.c" && windows.line == 3 && windows.name == "main",
+                      "FrameSizeTable: Windows path keeps its drive letter out of the name");
+
+        analysis::FrameSizeEntry malformed;
+        report.expect(!analysis::parseStackUsageLine("compute", malformed) &&
+                          !analysis::parseStackUsageLine("compute\tmany\tstatic", malformed) &&
+                          !analysis::parseStackUsageLine("a.c:3:5:\t8\tstatic", malformed),
+                      "FrameSizeTable: malformed lines are rejected");
+
+        analysis::FrameSizeEntry node;
+        report.expect(analysis::parseCallGraphInfoNode(
+                          "node: { title: \"_Z3fooi\" label: \"foo(int)\\nsrc/foo.cc:3:5\\n"
+                          "48 bytes (dynamic,bounded)\\n2 call sites\" }",
+                          node) &&
+                          node.name == "_Z3fooi" && node.file == "foo.cc" && node.line == 3 &&
+                          node.bytes == 48 && node.dynamic && node.bounded,
+                      "FrameSizeTable: .ci definition node");
+        analysis::FrameSizeEntry declaration;
+        report.expect(!analysis::parseCallGraphInfoNode(
+                          "node: { title: \"printf\" label: \"printf\\n<built-in>\" "
+                          "shape : ellipse }",
+                          declaration),
+                      "FrameSizeTable: .ci declaration nodes carry no frame");
+
+        // -o<path> is an output, -objc* flags are not.
+        std::error_code ec;
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path(ec) / "ct_frame_size_unit_test";
+        std::filesystem::create_directories(dir / "build", ec);
+        std::ofstream(dir / "build" / "a.su") << "a.c:1:f\t8\tstatic\n";
+        std::ofstream(dir / "a.su") << "a.c:1:f\t16\tstatic\n";
+        const std::string built = (dir / "build" / "a.su").string();
+        const std::string beside = (dir / "a.su").string();
+        auto filesFor = [&](std::vector<std::string> arguments)
+        {
+            const analysis::CompileCommand command{.directory = dir.string(),
+                                                   .arguments = std::move(arguments)};
+            return analysis::frameSizeFilesForCommand(command, "a.c");
+        };
+        report.expect(filesFor({"cc", "-c", "a.c", "-o", "build/a.o"}) ==
+                              std::vector<std::string>{built} &&
+                          filesFor({"cc", "-c", "a.c", "-obuild/a.o"}) ==
+                              std::vector<std::string>{built} &&
+                          filesFor({"cc", "-c", "a.c", "--output=build/a.o"}) ==
+                              std::vector<std::string>{built},
+                      "FrameSizeTable: .su found next to the -o object");
+        report.expect(filesFor({"clang", "-objcmt-migrate-literals", "-c", "a.c"}) ==
+                              std::vector<std::string>{beside} &&
+                          filesFor({"clang", "-c", "a.c"}) == std::vector<std::string>{beside},
+                      "FrameSizeTable: -objc* flags are not taken for -o<path>");
+
+        analysis::FrameSizeTable table;
+        std::string error;
+        report.expect(table.addFile(built, error) && table.entryCount() == 1 &&
+                          table.find("f", "/elsewhere/a.c", 1) &&
+                          table.find("f", "/elsewhere/a.c", 1)->bytes == 8 &&
+                          !table.find("f", "/elsewhere/b.c", 1),
+                      "FrameSizeTable: lookup keeps same-named functions of other files apart");
+        report.expect(table.addFile(built, error) && table.entryCount() == 1,
+                      "FrameSizeTable: a file named twice is read once");
+
+        // clang without debug info prints bare names; two TUs each define a static helper.
+        std::ofstream(dir / "left.su") << "helper\t32\tstatic\n";
+        std::ofstream(dir / "right.c.su") << "helper\t96\tstatic\n";
+        analysis::FrameSizeTable bareTable;
+        const bool loaded = bareTable.addFile((dir / "left.su").string(), error) &&
+                            bareTable.addFile((dir / "right.c.su").string(), error);
+        const analysis::FrameSizeEntry* left = bareTable.find("helper", "/src/left.c", 0);
+        const analysis::FrameSizeEntry* right = bareTable.find("helper", "/src/right.c", 0);
+        report.expect(loaded && left && left->bytes == 32 && right && right->bytes == 96,
+                      "FrameSizeTable: file-less records belong to the TU of their .su file");
+        report.expect(!bareTable.find("helper", "/src/other.c", 0),
+                      "FrameSizeTable: file-less records of several TUs are ambiguous");
+        std::filesystem::remove_all(dir, ec);
+        return true;
+    }
+
+    struct RegistryTestModel
+    {
+        std::string text;
+    };
+
+    int registryTestParses = 0;
+
+    bool parseRegistryTestModel(const std::string& path, RegistryTestModel& out,
+                                std::string& error)
+    {
+        ++registryTestParses;
+        std::ifstream in(path);
+        if (!in)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::getline(in, out.text);
+        return true;
+    }
+
+    bool testModelRegistry(const std::filesystem::path&, TestReport& report)
+    {
+        namespace analysis = ctrace::stack::analysis;
+        auto& registry = analysis::ModelRegistry<RegistryTestModel>::instance();
+
+        std::error_code ec;
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path(ec) / "ct_model_registry_unit_test";
+        std::filesystem::remove_all(dir, ec);
+        std::filesystem::create_directories(dir, ec);
+        const std::string first = (dir / "first.model").string();
+        const std::string second = (dir / "second.model").string();
+        std::ofstream(first) << "alpha\n";
+        std::ofstream(second) << "alpha\n";
+
+        std::string error;
+        const auto firstModel = registry.load(first, &parseRegistryTestModel, error);
+        const auto secondModel = registry.load(second, &parseRegistryTestModel, error);
+        report.expect(firstModel && firstModel->text == "alpha" && firstModel == secondModel &&
+                          registryTestParses == 1 && registry.contentCount() == 1,
+                      "ModelRegistry: paths with equal content share one parsed model");
+        report.expect(registry.load(first, &parseRegistryTestModel, error) == firstModel &&
+                          registryTestParses == 1,
+                      "ModelRegistry: an unchanged file is not parsed again");
+
+        // Same size, later mtime: only the stamp tells the edit apart.
+        std::ofstream(first) << "gamma\n";
+        std::filesystem::last_write_time(
+            first, std::filesystem::last_write_time(second, ec) + std::chrono::seconds(5), ec);
+        const auto reloaded = registry.load(first, &parseRegistryTestModel, error);
+        report.expect(reloaded && reloaded->text == "gamma" && registryTestParses == 2 &&
+                          registry.contentCount() == 2,
+                      "ModelRegistry: a file is parsed again after its mtime changes");
+        report.expect(registry.load(second, &parseRegistryTestModel, error) == secondModel,
+                      "ModelRegistry: a reload keeps other paths on their own content");
+
+        std::ofstream(second) << "gamma\n";
+        std::filesystem::last_write_time(
+            second, std::filesystem::last_write_time(first, ec) + std::chrono::seconds(5), ec);
+        report.expect(registry.load(second, &parseRegistryTestModel, error) == reloaded &&
+                          registryTestParses == 2 && registry.contentCount() == 1,
+                      "ModelRegistry: content no path refers to any more is evicted");
+
+        std::filesystem::remove_all(dir, ec);
+        return true;
+    }
+
+    bool testFileSnapshotCache(const std::filesystem::path&, TestReport& report)
+    {
+        namespace analysis = ctrace::stack::analysis;
+
+        std::error_code ec;
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path(ec) / "ct_file_snapshot_unit_test";
+        std::filesystem::remove_all(dir, ec);
+        std::filesystem::create_directories(dir, ec);
+        std::vector<std::string> paths;
+        for (int i = 0; i < 40; ++i)
+        {
+            paths.push_back((dir / ("dep" + std::to_string(i) + ".h")).generic_string());
+            std::ofstream(paths.back()) << "int dep" << i << ";\n";
+        }
+
+        analysis::FileSnapshotCache cache;
+        std::vector<analysis::FileSnapshot> expected;
+        for (const std::string& path : paths)
+        {
+            if (const auto snapshot = cache.capture(path))
+                expected.push_back(*snapshot);
+        }
+        report.expect(expected.size() == paths.size() && cache.areCurrent(expected),
+                      "FileSnapshotCache: a batch spread over the shards validates");
+
+        // A batch mixing cached and never seen paths stats only the new ones.
+        analysis::FileSnapshotCache cold;
+        (void)cold.capture(paths.front());
+        report.expect(cold.areCurrent(expected),
+                      "FileSnapshotCache: uncached paths of a batch are stat'ed");
+
+        analysis::FileSnapshot missing{.path = (dir / "missing.h").generic_string()};
+        std::vector<analysis::FileSnapshot> withMissing = expected;
+        withMissing.push_back(missing);
+        report.expect(!cache.areCurrent(withMissing),
+                      "FileSnapshotCache: a missing dependency is not current");
+
+        // Grow one file and move its mtime: a fresh cache sees the edit, the
+        // warm one keeps its snapshot until told otherwise.
+        const std::string& edited = paths[7];
+        std::ofstream(edited, std::ios::app) << "int grown;\n";
+        std::filesystem::last_write_time(
+            edited, std::filesystem::last_write_time(edited, ec) + std::chrono::seconds(5), ec);
+        analysis::FileSnapshotCache fresh;
+        report.expect(!fresh.areCurrent(expected),
+                      "FileSnapshotCache: a changed file makes the batch stale");
+        report.expect(cache.areCurrent(expected),
+                      "FileSnapshotCache: snapshots are reused for the rest of a run");
+
+        const auto refreshed = cache.refresh(edited);
+        report.expect(refreshed && refreshed->size > expected[7].size &&
+                          !cache.areCurrent(expected),
+                      "FileSnapshotCache: refresh replaces the cached snapshot");
+        std::vector<analysis::FileSnapshot> updated = expected;
+        updated[7] = *refreshed;
+        report.expect(cache.areCurrent(updated),
+                      "FileSnapshotCache: a batch with the refreshed snapshot validates");
+
+        std::filesystem::remove(paths[3], ec);
+        report.expect(cache.areCurrent(updated),
+                      "FileSnapshotCache: a deleted file stays cached until clear");
+        cache.clear();
+        report.expect(!cache.areCurrent(updated) && !cache.capture(paths[3]),
+                      "FileSnapshotCache: clear drops every cached snapshot");
+
+        std::filesystem::remove_all(dir, ec);
+        return true;
+    }
+
+    // Nested loops sharing exits, a switch with repeated and backward
+    // targets, an irreducible pair and an unreachable block.
+    std::string loopHeavyFunctionIR(unsigned depth)
+    {
+        std::string ir = "define void @loops(i1 %a, i1 %b, i32 %s) {\nentry:\n  br label %h0\n";
+        for (unsigned i = 0; i < depth; ++i)
+        {
+            const std::string h = "h" + std::to_string(i);
+            const std::string next = i + 1 < depth ? "h" + std::to_string(i + 1) : "body";
+            ir += h + ":\n  br i1 %a, label %" + next + ", label %l" + std::to_string(i) + "\n";
+        }
+        ir += "body:\n  switch i32 %s, label %l" + std::to_string(depth - 1) +
+              " [ i32 0, label %h0\n    i32 1, label %irrA\n    i32 2, label %irrA ]\n";
+        for (unsigned i = depth; i-- > 0;)
+        {
+            const std::string outer = i == 0 ? "irrB" : "l" + std::to_string(i - 1);
+            ir += "l" + std::to_string(i) + ":\n  br i1 %b, label %h" + std::to_string(i) +
+                  ", label %" + outer + "\n";
+        }
+        ir += "irrA:\n  br i1 %a, label %irrB, label %exit\n";
+        ir += "irrB:\n  br i1 %b, label %irrA, label %exit\n";
+        ir += "exit:\n  ret void\ndead:\n  br label %irrB\n}\n";
+        return ir;
+    }
+
+    bool testForwardDataflowMatchesSweep(const std::filesystem::path&, TestReport& report)
+    {
+        namespace analysis = ctrace::stack::analysis;
+        constexpr unsigned kFacts = 12;
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic err;
+        std::unique_ptr<llvm::Module> module =
+            llvm::parseAssemblyString(loopHeavyFunctionIR(24), err, context);
+        report.expect(module != nullptr, "ForwardDataflowOrder: loop-heavy IR parses");
+        if (!module)
+            return false;
+        const llvm::Function& F = *module->getFunction("loops");
+
+        // A must-analysis over kFacts facts: each block generates one fact
+        // and kills another, predecessors meet by intersection.
+        llvm::DenseMap<const llvm::BasicBlock*, unsigned> layoutIndex;
+        for (const llvm::BasicBlock& BB : F)
+            layoutIndex[&BB] = layoutIndex.size();
+        auto transfer = [&](const llvm::BasicBlock* BB, llvm::BitVector state)
+        {
+            const unsigned idx = layoutIndex.lookup(BB);
+            state.reset((idx * 5 + 3) % kFacts);
+            state.set(idx % kFacts);
+            return state;
+        };
+        const llvm::BitVector top(kFacts, true);
+        const llvm::BitVector bottom(kFacts, false);
+
+        // Reference: the former engine, sweeping every reachable block in
+        // layout order until a sweep changes nothing.
+        const analysis::ForwardDataflowOrder order(F);
+        std::map<const llvm::BasicBlock*, llvm::BitVector> sweepOut;
+        for (std::uint32_t idx = 0; idx < order.size(); ++idx)
+            sweepOut[order.block(idx)] = top;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (const llvm::BasicBlock& BB : F)
+            {
+                if (order.indexOf(&BB) == analysis::ForwardDataflowOrder::kUnreachable)
+                    continue;
+                llvm::BitVector in = &BB == &F.getEntryBlock() ? bottom : top;
+                for (const llvm::BasicBlock* pred : llvm::predecessors(&BB))
+                {
+                    if (const auto it = sweepOut.find(pred); it != sweepOut.end())
+                        in &= it->second;
+                }
+                llvm::BitVector out = transfer(&BB, std::move(in));
+                if (out != sweepOut[&BB])
+                {
+                    sweepOut[&BB] = std::move(out);
+                    changed = true;
+                }
+            }
+        }
+
+        std::vector<llvm::BitVector> outState(order.size(), top);
+        std::uint64_t visits = 0;
+        const bool converged = order.runForward(
+            [&](std::uint32_t idx)
+            {
+                ++visits;
+                llvm::BitVector in = idx == 0 ? bottom : top;
+                for (const std::uint32_t pred : order.predecessors(idx))
+                    in &= outState[pred];
+                llvm::BitVector out = transfer(order.block(idx), std::move(in));
+                if (out == outState[idx])
+                    return false;
+                outState[idx] = std::move(out);
+                return true;
+            },
+            order.visitBudget(kFacts + 1));
+
+        bool matches = converged;
+        for (std::uint32_t idx = 0; idx < order.size(); ++idx)
+            matches = matches && outState[idx] == sweepOut[order.block(idx)];
+        report.expect(order.size() + 1 == F.size() && matches,
+                      "ForwardDataflowOrder: worklist fixpoint matches the layout sweep");
+        report.expect(visits <= order.visitBudget(kFacts + 1) &&
+                          order.visitBudget(kFacts + 1) <= 4 * order.size() * (kFacts + 1),
+                      "ForwardDataflowOrder: visit budget is linear in the blocks");
+        return true;
+    }
 } // namespace
 
 int main(int argc, char** argv)
@@ -256,6 +1532,20 @@ int main(int argc, char** argv)
     (void)testLocationResolver(repoRoot, report);
     (void)testReachabilityService(repoRoot, report);
     (void)testModulePreparationService(repoRoot, report);
+    (void)testCompilationDatabaseLookup(repoRoot, report);
+    (void)testStackEscapeCrossTUSummaries(repoRoot, report);
+    (void)testSmtQueryCache(repoRoot, report);
+    (void)testPortfolioRaceIsDeterministic(repoRoot, report);
+    (void)testConstraintPresolver(repoRoot, report);
+    (void)testSmtCaptureRoundTrip(repoRoot, report);
+#ifdef CTRACE_STACK_ENABLE_Z3_BACKEND
+    (void)testZ3SessionReuse(repoRoot, report);
+#endif
+    (void)testStronglyConnectedComponents(repoRoot, report);
+    (void)testFrameSizeParsing(repoRoot, report);
+    (void)testModelRegistry(repoRoot, report);
+    (void)testFileSnapshotCache(repoRoot, report);
+    (void)testForwardDataflowMatchesSweep(repoRoot, report);
 
     if (report.failures == 0)
     {
@@ -0,0 +1,338 @@
+// SPDX-License-Identifier: Apache-2.0
+// smt_replay: replays a --smt-capture file against any solver configuration
+// and reports latency percentiles, timeout rates and disagreements with the
+// decisions recorded at capture time. The query cache is bypassed, so every
+// query reaches the orchestrator (presolve included).
+#include "analysis/smt/SmtCapture.hpp"
+#include "analysis/smt/SolverOrchestrator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace ctrace::stack::analysis::smt;
+
+namespace
+{
+    struct ReplayOptions
+    {
+        SolverOrchestratorConfig solver;
+        std::string capturePath;
+        std::vector<std::string> rules;
+        std::optional<std::uint64_t> budgetNodes;
+        std::optional<std::uint32_t> timeoutMs;
+        unsigned threads = 1;
+        unsigned repeat = 1;
+        std::uint64_t failOnDisagreement : 1 = false;
+        std::uint64_t reservedFlags : 63 = 0;
+    };
+
+    struct ReplaySample
+    {
+        std::uint64_t micros = 0;
+        SmtStatus status = SmtStatus::Unknown;
+    };
+
+    struct LatencySummary
+    {
+        std::uint64_t p50 = 0;
+        std::uint64_t p90 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t max = 0;
+        double mean = 0.0;
+    };
+
+    void printHelp()
+    {
+        llvm::outs()
+            << "smt_replay - replay SMT queries recorded with --smt-capture\n\n"
+            << "Usage:\n"
+            << "  smt_replay <capture-file> [options]\n\n"
+            << "Options:\n"
+            << "  --backend=<name>       Primary backend (interval|z3|cvc5, default: interval)\n"
+            << "  --secondary-backend=<name>  Secondary backend for coupled modes\n"
+            << "  --mode=<mode>          single|portfolio|cross-check|dual-consensus\n"
+            << "  --timeout-ms=<N>       Override the captured per-query timeout\n"
+            << "  --budget-nodes=<N>     Override the captured per-query node budget\n"
+            << "  --rules=<csv>          Only replay queries of these rule ids\n"
+            << "  --threads=<N>          Solve queries on N threads (default: 1)\n"
+            << "  --repeat=<N>           Replay the capture N times (default: 1)\n"
+            << "  --fail-on-disagreement Exit with 2 if a Sat/Unsat answer flips\n"
+            << "  -h, --help             Show this help\n";
+    }
+
+    template <typename T> bool parseNumber(std::string_view text, T& out)
+    {
+        const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+        return ec == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseMode(std::string_view text, SolverMode& out)
+    {
+        if (text == "single")
+            out = SolverMode::Single;
+        else if (text == "portfolio")
+            out = SolverMode::Portfolio;
+        else if (text == "cross-check")
+            out = SolverMode::CrossCheck;
+        else if (text == "dual-consensus")
+            out = SolverMode::DualConsensus;
+        else
+            return false;
+        return true;
+    }
+
+    std::vector<std::string> splitCsv(std::string_view text)
+    {
+        std::vector<std::string> parts;
+        while (!text.empty())
+        {
+            const std::size_t comma = text.find(',');
+            const std::string_view part = text.substr(0, comma);
+            if (!part.empty())
+                parts.emplace_back(part);
+            if (comma == std::string_view::npos)
+                break;
+            text.remove_prefix(comma + 1);
+        }
+        return parts;
+    }
+
+    // Returns an error message, or an empty string on success.
+    std::string parseArguments(int argc, char** argv, ReplayOptions& options, bool& help)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const std::size_t eq = arg.find('=');
+            const std::string_view name = arg.substr(0, eq);
+            const std::string_view value =
+                eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1);
+
+            bool valid = true;
+            if (arg == "-h" || arg == "--help")
+                help = true;
+            else if (arg == "--fail-on-disagreement")
+                options.failOnDisagreement = true;
+            else if (name == "--backend")
+                options.solver.primaryBackend = std::string(value);
+            else if (name == "--secondary-backend")
+                options.solver.secondaryBackend = std::string(value);
+            else if (name == "--mode")
+                valid = parseMode(value, options.solver.mode);
+            else if (name == "--timeout-ms")
+                valid = parseNumber(value, options.timeoutMs.emplace());
+            else if (name == "--budget-nodes")
+                valid = parseNumber(value, options.budgetNodes.emplace());
+            else if (name == "--rules")
+                options.rules = splitCsv(value);
+            else if (name == "--threads")
+                valid = parseNumber(value, options.threads) && options.threads > 0;
+            else if (name == "--repeat")
+                valid = parseNumber(value, options.repeat) && options.repeat > 0;
+            else if (!arg.starts_with("-") && options.capturePath.empty())
+                options.capturePath = std::string(arg);
+            else
+                return "unknown argument '" + std::string(arg) + "'";
+
+            if (!valid)
+                return "invalid value for '" + std::string(name) + "'";
+        }
+        if (!help && options.capturePath.empty())
+            return "missing capture file";
+        return {};
+    }
+
+    bool isDefinitive(SmtStatus status)
+    {
+        return status == SmtStatus::Sat || status == SmtStatus::Unsat;
+    }
+
+    LatencySummary summarize(std::vector<std::uint64_t> micros)
+    {
+        LatencySummary summary;
+        if (micros.empty())
+            return summary;
+        std::sort(micros.begin(), micros.end());
+        // Nearest-rank percentiles.
+        auto percentile = [&](double p)
+        {
+            const auto rank = static_cast<std::size_t>(p * static_cast<double>(micros.size()));
+            return micros[std::min(rank, micros.size() - 1)];
+        };
+        summary.p50 = percentile(0.50);
+        summary.p90 = percentile(0.90);
+        summary.p99 = percentile(0.99);
+        summary.max = micros.back();
+        double total = 0.0;
+        for (std::uint64_t value : micros)
+            total += static_cast<double>(value);
+        summary.mean = total / static_cast<double>(micros.size());
+        return summary;
+    }
+
+    void printLatency(std::string_view label, const LatencySummary& summary)
+    {
+        llvm::outs() << label << " (us): p50 " << summary.p50 << "  p90 " << summary.p90
+                     << "  p99 " << summary.p99 << "  max " << summary.max << "  mean "
+                     << llvm::format("%.1f", summary.mean) << "\n";
+    }
+
+    double percentOf(std::uint64_t part, std::uint64_t whole)
+    {
+        return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    ReplayOptions options;
+    bool help = false;
+    const std::string argError = parseArguments(argc, argv, options, help);
+    if (help)
+    {
+        printHelp();
+        return 0;
+    }
+    if (!argError.empty())
+    {
+        llvm::errs() << "smt_replay: " << argError << "\n";
+        printHelp();
+        return 1;
+    }
+
+    std::vector<SmtCaptureRecord> records;
+    std::string loadError;
+    if (!readSmtCaptureFile(options.capturePath, records, loadError))
+    {
+        llvm::errs() << "smt_replay: " << loadError << "\n";
+        return 1;
+    }
+    if (!options.rules.empty())
+    {
+        std::erase_if(records,
+                      [&](const SmtCaptureRecord& record)
+                      {
+                          return std::find(options.rules.begin(), options.rules.end(),
+                                           record.query.ruleId) == options.rules.end();
+                      });
+    }
+    for (SmtCaptureRecord& record : records)
+    {
+        if (options.timeoutMs)
+            record.query.timeoutMs = *options.timeoutMs;
+        if (options.budgetNodes)
+            record.query.budgetNodes = *options.budgetNodes;
+    }
+
+    options.solver.workerThreads = options.threads;
+    const SolverOrchestrator orchestrator(options.solver);
+    const std::size_t queryCount = records.size();
+    std::vector<ReplaySample> samples(queryCount * options.repeat);
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]()
+    {
+        for (std::size_t slot = next.fetch_add(1); slot < samples.size();
+             slot = next.fetch_add(1))
+        {
+            const SmtQuery& query = records[slot % queryCount].query;
+            const auto start = std::chrono::steady_clock::now();
+            const SmtDecision decision = orchestrator.solve(query);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            samples[slot] = ReplaySample{.micros = static_cast<std::uint64_t>(elapsed.count()),
+                                         .status = decision.status};
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < options.threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& thread : workers)
+        thread.join();
+    const auto wallMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - wallStart)
+                                .count();
+
+    std::map<SmtStatus, std::uint64_t> statusCounts;
+    std::vector<std::uint64_t> replayMicros;
+    std::vector<std::uint64_t> capturedMicros;
+    std::map<std::string, std::vector<std::uint64_t>> microsByRule;
+    std::map<std::string, std::uint64_t> timeoutsByRule;
+    replayMicros.reserve(samples.size());
+    for (std::size_t slot = 0; slot < samples.size(); ++slot)
+    {
+        const ReplaySample& sample = samples[slot];
+        const std::string& ruleId = records[slot % queryCount].query.ruleId;
+        ++statusCounts[sample.status];
+        replayMicros.push_back(sample.micros);
+        microsByRule[ruleId].push_back(sample.micros);
+        if (sample.status == SmtStatus::Timeout)
+            ++timeoutsByRule[ruleId];
+    }
+
+    // Agreement is judged on the first pass; later passes only add samples.
+    std::uint64_t conflicting = 0;
+    std::uint64_t lost = 0;
+    std::uint64_t gained = 0;
+    for (std::size_t i = 0; i < queryCount; ++i)
+    {
+        const SmtStatus captured = records[i].status;
+        const SmtStatus replayed = samples[i].status;
+        capturedMicros.push_back(records[i].elapsedMicros);
+        if (isDefinitive(captured) && isDefinitive(replayed) && captured != replayed)
+            ++conflicting;
+        else if (isDefinitive(captured) && !isDefinitive(replayed))
+            ++lost;
+        else if (!isDefinitive(captured) && isDefinitive(replayed))
+            ++gained;
+    }
+
+    const std::uint64_t total = samples.size();
+    llvm::outs() << "smt_replay: " << queryCount << " query(ies) from " << options.capturePath
+                 << ", backend=" << options.solver.primaryBackend
+                 << (options.solver.secondaryBackend.empty()
+                         ? std::string()
+                         : "+" + options.solver.secondaryBackend)
+                 << ", threads=" << options.threads << ", repeat=" << options.repeat << "\n";
+    llvm::outs() << "wall time: " << llvm::format("%.1f", static_cast<double>(wallMicros) / 1000.0)
+                 << " ms ("
+                 << llvm::format("%.0f", wallMicros ? 1e6 * static_cast<double>(total) /
+                                                          static_cast<double>(wallMicros)
+                                                    : 0.0)
+                 << " queries/s)\n";
+    printLatency("replay latency", summarize(replayMicros));
+    printLatency("captured latency", summarize(capturedMicros));
+    llvm::outs() << "status:";
+    for (SmtStatus status : {SmtStatus::Sat, SmtStatus::Unsat, SmtStatus::Unknown,
+                             SmtStatus::Timeout, SmtStatus::Error})
+        llvm::outs() << " " << smtStatusName(status) << " " << statusCounts[status];
+    llvm::outs() << "  (timeout rate "
+                 << llvm::format("%.2f", percentOf(statusCounts[SmtStatus::Timeout], total))
+                 << "%)\n";
+    llvm::outs() << "vs capture: " << conflicting << " conflicting (sat<->unsat), " << lost
+                 << " lost (definitive -> inconclusive), " << gained
+                 << " gained (inconclusive -> definitive)\n";
+    for (const auto& [ruleId, micros] : microsByRule)
+    {
+        const LatencySummary summary = summarize(micros);
+        llvm::outs() << "  rule " << (ruleId.empty() ? "<none>" : ruleId) << ": "
+                     << micros.size() << " sample(s), p50 " << summary.p50 << " us, p99 "
+                     << summary.p99 << " us, timeouts " << timeoutsByRule[ruleId] << "\n";
+    }
+
+    return options.failOnDisagreement && conflicting != 0 ? 2 : 0;
+}